@@ -0,0 +1,170 @@
+/**
+ * \file arena.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo arena.hpp, sendo este responsavel pelas arenas de memoria
+ * transitoria.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "arena.hpp"	//rayTracing::Arena
+#include "memoria.hpp"	//rayTracing::aloca_alinhado
+#ifdef ARENA_DEPURACAO
+#include <string.h>	//memset
+#include <iostream>	//std::cerr
+#endif
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \struct BlocoArena
+   *
+   * \brief Cabecalho de um bloco da arena. Os dados comecam LINHA_CACHE bytes depois do cabecalho, alinhados a linha de cache.
+   */
+  struct BlocoArena{
+    BlocoArena* anterior;	///< Bloco encadeado antes deste (NULL no primeiro)
+    size_t capacidade;		///< Bytes de dados do bloco
+  };
+
+  /**
+   * \fn static unsigned char* dados_bloco(BlocoArena* b);
+   *
+   * \brief Retorna o inicio dos dados do bloco.
+   */
+  static unsigned char*
+  dados_bloco(BlocoArena* b){
+    return (unsigned char*) b + LINHA_CACHE;
+  }
+
+  //------------------------------
+  //	Metodos privados
+  //------------------------------
+  /**
+   * \fn void Arena::novo_bloco(size_t capacidade);
+   *
+   * \brief Encadeia um novo bloco com a capacidade dada. Se nao houver memoria, o bloco atual e mantido.
+   */
+  void
+  Arena::novo_bloco(size_t capacidade){
+    capacidade = arredonda_linha_cache(capacidade);
+    BlocoArena* b = (BlocoArena*) aloca_alinhado(LINHA_CACHE + capacidade);
+    if (b == NULL){
+      return;
+    }
+    b->anterior = bloco;
+    b->capacidade = capacidade;
+    if (bloco != NULL){
+      usado_anteriores += usado;
+    }
+    bloco = b;
+    usado = 0;
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn Arena::Arena(size_t capacidade);
+   *
+   * \brief Construtor da classe.
+   */
+  Arena::Arena(size_t capacidade){
+    bloco = NULL;
+    usado = 0;
+    usado_anteriores = 0;
+    maximo = 0;
+    novo_bloco(capacidade);
+  }
+
+  /**
+   * \fn Arena::~Arena();
+   *
+   * \brief Destrutor da classe.
+   */
+  Arena::~Arena(){
+#ifdef ARENA_DEPURACAO
+    std::cerr << "arena " << (void*) this << ": pico de " << maximo << " bytes" << std::endl;
+#endif
+    while (bloco != NULL){
+      BlocoArena* anterior = bloco->anterior;
+      libera_alinhado(bloco);
+      bloco = anterior;
+    }
+  }
+
+  /**
+   * \fn void* Arena::alocar(size_t bytes, size_t alinhamento);
+   *
+   * \brief Aloca bytes no bloco atual ou, se ele nao couber, em um novo bloco com o dobro da capacidade.
+   */
+  void*
+  Arena::alocar(size_t bytes, size_t alinhamento){
+    size_t inicio = (usado + alinhamento - 1) & ~(alinhamento - 1);
+    if (bloco == NULL || inicio + bytes > bloco->capacidade){
+      size_t capacidade = (bloco != NULL) ? 2 * bloco->capacidade : 0;
+      if (capacidade < bytes){
+	capacidade = bytes;
+      }
+      BlocoArena* anterior = bloco;
+      novo_bloco(capacidade);
+      if (bloco == anterior){
+	return NULL;
+      }
+      inicio = 0;
+    }
+    usado = inicio + bytes;
+    if (usado_anteriores + usado > maximo){
+      maximo = usado_anteriores + usado;
+    }
+    return dados_bloco(bloco) + inicio;
+  }
+
+  /**
+   * \fn void Arena::reiniciar();
+   *
+   * \brief Libera tudo o que foi alocado. Se houver varios blocos, eles sao trocados por um unico bloco com a capacidade somada, de
+   * modo que o proximo uso de mesmo tamanho nao precise de outro bloco.
+   */
+  void
+  Arena::reiniciar(){
+    if (bloco != NULL && bloco->anterior != NULL){
+      size_t capacidade = 0;
+      while (bloco != NULL){
+	BlocoArena* anterior = bloco->anterior;
+	capacidade += bloco->capacidade;
+	libera_alinhado(bloco);
+	bloco = anterior;
+      }
+      usado = 0;
+      usado_anteriores = 0;
+      novo_bloco(capacidade);
+      return;
+    }
+#ifdef ARENA_DEPURACAO
+    if (bloco != NULL){
+      memset(dados_bloco(bloco), 0xCD, usado);
+    }
+#endif
+    usado = 0;
+    usado_anteriores = 0;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
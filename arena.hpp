@@ -0,0 +1,141 @@
+/**
+ * \file arena.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo arena.cpp, sendo este
+ * responsavel pelas arenas de memoria transitoria. Uma arena entrega blocos por incremento de um ponteiro e os libera todos de uma vez
+ * ao ser reiniciada (no fim de um ladrilho ou de um quadro). Cada thread usa a sua propria arena, entao nao ha disputa pelo alocador
+ * global, e depois dos primeiros quadros a arena ja tem o tamanho do pico e nao recorre mais ao heap.
+ *
+ * Compilada com ARENA_DEPURACAO, a arena preenche a memoria liberada com 0xCD (para revelar usos apos reiniciar) e informa o seu
+ * pico de uso ao ser destruida.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _ARENA_HPP
+#define _ARENA_HPP
+
+#include <stddef.h>	//size_t
+#include "memoria.hpp"	//rayTracing::LINHA_CACHE
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  struct BlocoArena;
+
+  /**
+   * \class Arena
+   *
+   * \brief Alocador por incremento, usado por uma unica thread. Se um bloco esgota, outro maior e encadeado; ao reiniciar, os blocos
+   * sao fundidos em um so, com a capacidade somada.
+   */
+  class Arena{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    BlocoArena* bloco;		///< Bloco atual (os anteriores estao encadeados a ele)
+    size_t usado;		///< Bytes usados no bloco atual
+    size_t usado_anteriores;	///< Bytes usados nos blocos anteriores desde o ultimo reinicio
+    size_t maximo;		///< Pico de bytes usados entre dois reinicios
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    /**
+     * \fn void novo_bloco(size_t capacidade);
+     *
+     * \brief Encadeia um novo bloco com a capacidade dada.
+     */
+    void novo_bloco(size_t capacidade);
+
+    //Copia nao permitida
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn Arena(size_t capacidade = 64 * 1024);
+     *
+     * \brief Construtor da classe.
+     *
+     * \param capacidade - capacidade inicial em bytes
+     */
+    Arena(size_t capacidade = 64 * 1024);
+
+    /**
+     * \fn ~Arena();
+     *
+     * \brief Destrutor da classe. Libera todos os blocos.
+     */
+    ~Arena();
+
+    /**
+     * \fn void* alocar(size_t bytes, size_t alinhamento = LINHA_CACHE);
+     *
+     * \brief Aloca bytes na arena. O bloco vale ate o proximo reiniciar.
+     *
+     * \param alinhamento - potencia de 2 ate LINHA_CACHE
+     *
+     * \return O bloco alocado ou NULL se nao houver memoria.
+     */
+    void* alocar(size_t bytes, size_t alinhamento = LINHA_CACHE);
+
+    /**
+     * \fn template <class T> T* alocar_vetor(size_t n);
+     *
+     * \brief Aloca um vetor de n elementos de um tipo sem construtor (os elementos nao sao inicializados).
+     */
+    template <class T> T* alocar_vetor(size_t n);
+
+    /**
+     * \fn void reiniciar();
+     *
+     * \brief Libera tudo o que foi alocado desde o ultimo reinicio.
+     */
+    void reiniciar();
+
+    /**
+     * \fn size_t pico() const;
+     *
+     * \brief Retorna o maior numero de bytes usados entre dois reinicios.
+     */
+    size_t pico() const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  template <class T> inline T*
+  Arena::alocar_vetor(size_t n){
+    return (T*) alocar(n * sizeof(T));
+  }
+
+  inline size_t
+  Arena::pico() const{
+    return maximo;
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
@@ -0,0 +1,1214 @@
+/**
+ * \file bvh.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo bvh.hpp, sendo este responsavel pela construcao da hierarquia
+ * de volumes envolventes pela heuristica de area de superficie ou pela curva de Morton, sequencial ou com as threads de um
+ * escalonador, e pelo colapso da arvore binaria em uma BVH larga com caixas quantizadas.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include <math.h>		//floor, ceil, frexp, ldexp, nextafterf
+#include <string.h>		//memcpy, memset
+#include <sys/time.h>		//gettimeofday
+#include <algorithm>		//std::sort, std::merge
+#include <vector>		//std::vector
+#include "bvh.hpp"		//rayTracing::BVH
+#include "escalonador.hpp"	//rayTracing::Escalonador
+#include "memoria.hpp"		//rayTracing::aloca_alinhado
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //Numero maximo de primitivas em uma folha
+  static const int MAX_PRIMITIVAS_FOLHA = 8;
+  //Numero de primitivas a partir do qual a construcao por Morton deixa de criar folhas
+  static const int MAX_PRIMITIVAS_FOLHA_MORTON = 4;
+  //Custo de atravessar um no em relacao ao custo de testar uma primitiva
+  static const double CUSTO_TRAVESSIA = 1.0;
+  //Primitivas de cada bloco das varreduras paralelas
+  static const int BLOCO_PARALELO = 16384;
+  //Menor subarvore entregue inteira a uma thread
+  static const int MENOR_SUBARVORE = 4096;
+  //Menor expoente do passo da quantizacao das caixas da BVH larga
+  static const int EXPOENTE_MINIMO = -120;
+  //Maior coordenada que a BVH larga quantiza (a origem dos nos e um float)
+  static const double COORDENADA_MAXIMA = 1e30;
+
+  /**
+   * \struct Referencia
+   *
+   * \brief Primitiva durante a construcao. As referencias sao permutadas no proprio vetor, de modo que as varreduras de um no leiam
+   * memoria contigua.
+   */
+  struct Referencia{
+    Caixa caixa;	///< Caixa da primitiva
+    int indice;		///< Indice original da primitiva
+  };
+
+  /**
+   * \struct Construcao
+   *
+   * \brief Dados compartilhados pelas funcoes e tarefas de uma construcao.
+   */
+  struct Construcao{
+    Referencia* referencias;	///< Primitivas, na ordem da hierarquia ao fim da construcao
+    const uint64_t* chaves;	///< Codigo de Morton e indice de cada posicao, ordenados (apenas BVH_MORTON)
+    NoBVH* nos;			///< Vetor de nos
+    int bins;			///< Intervalos da SAH em cada eixo
+  };
+
+  /**
+   * \struct BinsSAH
+   *
+   * \brief Caixa e contagem de cada intervalo dos tres eixos.
+   */
+  struct BinsSAH{
+    Caixa caixas[3][BINS_BVH_MAXIMO];	///< Caixa das primitivas de cada intervalo
+    int contagem[3][BINS_BVH_MAXIMO];	///< Numero de primitivas de cada intervalo
+
+    /**
+     * \fn void zerar(int bins);
+     *
+     * \brief Esvazia os bins primeiros intervalos de cada eixo.
+     */
+    void zerar(int bins){
+      for (int e = 0; e < 3; e++){
+	for (int b = 0; b < bins; b++){
+	  caixas[e][b] = Caixa();
+	  contagem[e][b] = 0;
+	}
+      }
+    }
+
+    /**
+     * \fn void somar(const BinsSAH& outros, int bins);
+     *
+     * \brief Acumula os intervalos de outra varredura.
+     */
+    void somar(const BinsSAH& outros, int bins){
+      for (int e = 0; e < 3; e++){
+	for (int b = 0; b < bins; b++){
+	  caixas[e][b].expandir(outros.caixas[e][b]);
+	  contagem[e][b] += outros.contagem[e][b];
+	}
+      }
+    }
+  };
+
+  /**
+   * \struct Divisao
+   *
+   * \brief Avaliacao de um no pela SAH.
+   */
+  struct Divisao{
+    Caixa caixa;		///< Caixa das primitivas do no
+    Caixa caixa_centros;	///< Caixa dos centros das primitivas do no
+    bool folha;			///< Indica que o no deve ser folha sem avaliar cortes
+    double custo;		///< Custo do melhor corte (sem a travessia e sem dividir pela area)
+    int eixo;			///< Eixo do melhor corte (-1 se os centros coincidem)
+    int corte;			///< Intervalo que inicia o lado direito do melhor corte
+  };
+
+  /**
+   * \struct Subarvore
+   *
+   * \brief Subarvore construida inteira por uma thread, a partir de um no reservado.
+   */
+  struct Subarvore{
+    int no;		///< Posicao reservada para a raiz da subarvore
+    int inicio;		///< Primeira referencia
+    int fim;		///< Posicao seguinte a ultima
+    int profundidade;	///< Profundidade da raiz da subarvore
+    Divisao raiz;	///< Caixas da raiz (apenas BVH_SAH)
+  };
+
+  /**
+   * \fn static double centro(const Caixa& caixa, int eixo);
+   *
+   * \brief Retorna a coordenada do centro da caixa no eixo x (0), y (1) ou z (2), igual a de Caixa::centro().
+   */
+  static double
+  centro(const Caixa& caixa, int eixo){
+    return (caixa.min[eixo] + caixa.max[eixo]) * 0.5;
+  }
+
+  /**
+   * \fn static void acumular(Caixa* a, const Caixa& b);
+   *
+   * \brief Equivale a a->expandir(b), escrito com selecoes em vez de desvios para as varreduras das primitivas.
+   */
+  static inline void
+  acumular(Caixa* a, const Caixa& b){
+    for (int e = 0; e < 3; e++){
+      a->min[e] = (b.min[e] < a->min[e]) ? b.min[e] : a->min[e];
+      a->max[e] = (b.max[e] > a->max[e]) ? b.max[e] : a->max[e];
+    }
+  }
+
+  /**
+   * \fn static void acumular_centro(Caixa* a, const Caixa& b);
+   *
+   * \brief Equivale a a->expandir(b.centro()).
+   */
+  static inline void
+  acumular_centro(Caixa* a, const Caixa& b){
+    for (int e = 0; e < 3; e++){
+      double m = centro(b, e);
+      a->min[e] = (m < a->min[e]) ? m : a->min[e];
+      a->max[e] = (m > a->max[e]) ? m : a->max[e];
+    }
+  }
+
+  /**
+   * \fn static double segundos_agora();
+   *
+   * \brief Retorna o tempo de parede atual, em segundos.
+   */
+  static double
+  segundos_agora(){
+    struct timeval agora;
+    gettimeofday(&agora, NULL);
+    return agora.tv_sec + agora.tv_usec * 1e-6;
+  }
+
+  /**
+   * \fn static int numero_blocos(int n, int maximo);
+   *
+   * \brief Retorna em quantos blocos de pelo menos BLOCO_PARALELO primitivas as n primitivas sao divididas, limitado a maximo.
+   */
+  static int
+  numero_blocos(int n, int maximo){
+    int blocos = (n + BLOCO_PARALELO - 1) / BLOCO_PARALELO;
+    return (blocos < maximo) ? blocos : maximo;
+  }
+
+  /**
+   * \fn static int limite_bloco(int inicio, int fim, int b, int n_blocos);
+   *
+   * \brief Retorna a primeira posicao do bloco b de [inicio, fim) dividido em n_blocos blocos (b = n_blocos retorna fim).
+   */
+  static int
+  limite_bloco(int inicio, int fim, int b, int n_blocos){
+    return inicio + (int)((int64_t)(fim - inicio) * b / n_blocos);
+  }
+
+  /**
+   * \fn static void varrer_caixas(const Construcao& c, int inicio, int fim, Caixa* caixa, Caixa* caixa_centros);
+   *
+   * \brief Expande as caixas com as primitivas e os centros das posicoes [inicio, fim).
+   */
+  static void
+  varrer_caixas(const Construcao& c, int inicio, int fim, Caixa* caixa, Caixa* caixa_centros){
+    for (int k = inicio; k < fim; k++){
+      acumular(caixa, c.referencias[k].caixa);
+      acumular_centro(caixa_centros, c.referencias[k].caixa);
+    }
+  }
+
+  /**
+   * \fn static int intervalo(double coordenada, double minimo, double escala, int bins);
+   *
+   * \brief Retorna o intervalo de um centro em um eixo.
+   */
+  static int
+  intervalo(double coordenada, double minimo, double escala, int bins){
+    int b = (int)((coordenada - minimo) * escala);
+    return (b >= bins) ? bins - 1 : b;
+  }
+
+  /**
+   * \fn static void distribuir_bins(const Construcao& c, int inicio, int fim, const Caixa& caixa_centros, BinsSAH* bins);
+   *
+   * \brief Acumula as primitivas das posicoes [inicio, fim) nos intervalos de cada eixo em que os centros nao coincidem, em uma
+   * unica passada pelas referencias.
+   */
+  static void
+  distribuir_bins(const Construcao& c, int inicio, int fim, const Caixa& caixa_centros, BinsSAH* bins){
+    int eixos[3], n_eixos = 0;
+    double escala[3];
+    for (int eixo = 0; eixo < 3; eixo++){
+      double extensao = caixa_centros.max[eixo] - caixa_centros.min[eixo];
+      if (extensao > 0.0){
+	escala[n_eixos] = c.bins / extensao;
+	eixos[n_eixos++] = eixo;
+      }
+    }
+    for (int k = inicio; k < fim; k++){
+      const Caixa& p = c.referencias[k].caixa;
+      for (int i = 0; i < n_eixos; i++){
+	int eixo = eixos[i];
+	int b = intervalo(centro(p, eixo), caixa_centros.min[eixo], escala[i], c.bins);
+	bins->contagem[eixo][b]++;
+	acumular(&bins->caixas[eixo][b], p);
+      }
+    }
+  }
+
+  /**
+   * \fn static void escolher_corte(const Construcao& c, const BinsSAH& bins, Divisao* d);
+   *
+   * \brief Avalia o custo SAH de cada um dos bins - 1 planos de corte de cada eixo com varreduras da esquerda para a direita e da
+   * direita para a esquerda e guarda o mais barato.
+   */
+  static void
+  escolher_corte(const Construcao& c, const BinsSAH& bins, Divisao* d){
+    d->custo = 1e300;
+    d->eixo = -1;
+    d->corte = 0;
+    for (int eixo = 0; eixo < 3; eixo++){
+      if (d->caixa_centros.max[eixo] - d->caixa_centros.min[eixo] <= 0.0){
+	continue;
+      }
+
+      //Varredura da direita para a esquerda: area e contagem a direita de cada corte (intervalos vazios nao mudam a caixa)
+      double area_direita[BINS_BVH_MAXIMO];
+      int n_direita[BINS_BVH_MAXIMO];
+      Caixa acumulada;
+      int acumulado = 0;
+      double area = 0.0;
+      for (int b = c.bins - 1; b > 0; b--){
+	if (bins.contagem[eixo][b] > 0){
+	  acumulada.expandir(bins.caixas[eixo][b]);
+	  acumulado += bins.contagem[eixo][b];
+	  area = acumulada.area();
+	}
+	area_direita[b] = area;
+	n_direita[b] = acumulado;
+      }
+
+      //Varredura da esquerda para a direita: custo do corte entre os bins b-1 e b
+      acumulada = Caixa();
+      acumulado = 0;
+      area = 0.0;
+      for (int b = 1; b < c.bins; b++){
+	if (bins.contagem[eixo][b - 1] > 0){
+	  acumulada.expandir(bins.caixas[eixo][b - 1]);
+	  acumulado += bins.contagem[eixo][b - 1];
+	  area = acumulada.area();
+	}
+	if (acumulado == 0 || n_direita[b] == 0){
+	  continue;
+	}
+	double custo = area * acumulado + area_direita[b] * n_direita[b];
+	if (custo < d->custo){
+	  d->custo = custo;
+	  d->eixo = eixo;
+	  d->corte = b;
+	}
+      }
+    }
+  }
+
+  /**
+   * \class TarefaReferencias
+   *
+   * \brief Preenche as referencias das primitivas, na ordem dada (ou na original), um bloco por item.
+   */
+  class TarefaReferencias : public Tarefa{
+    const Caixa* caixas;
+    const uint64_t* chaves;
+    Referencia* referencias;
+    int n;
+    int n_blocos;
+  public:
+    TarefaReferencias(const Caixa* _caixas, const uint64_t* _chaves, Referencia* _referencias, int _n, int _n_blocos) :
+      caixas(_caixas), chaves(_chaves), referencias(_referencias), n(_n), n_blocos(_n_blocos){}
+
+    void executar(int item, int){
+      int fim = limite_bloco(0, n, item + 1, n_blocos);
+      for (int k = limite_bloco(0, n, item, n_blocos); k < fim; k++){
+	int p = (chaves != NULL) ? (int)(uint32_t) chaves[k] : k;
+	referencias[k].caixa = caixas[p];
+	referencias[k].indice = p;
+      }
+    }
+  };
+
+  /**
+   * \class TarefaVarredura
+   *
+   * \brief Calcula a caixa das primitivas e dos centros de cada bloco de um no.
+   */
+  class TarefaVarredura : public Tarefa{
+    const Construcao& c;
+    int inicio, fim, n_blocos;
+    Caixa* caixas;
+    Caixa* caixas_centros;
+  public:
+    TarefaVarredura(const Construcao& _c, int _inicio, int _fim, int _n_blocos, Caixa* _caixas, Caixa* _caixas_centros) :
+      c(_c), inicio(_inicio), fim(_fim), n_blocos(_n_blocos), caixas(_caixas), caixas_centros(_caixas_centros){}
+
+    void executar(int item, int){
+      varrer_caixas(c, limite_bloco(inicio, fim, item, n_blocos), limite_bloco(inicio, fim, item + 1, n_blocos),
+		    &caixas[item], &caixas_centros[item]);
+    }
+  };
+
+  /**
+   * \class TarefaBins
+   *
+   * \brief Distribui as primitivas de cada bloco de um no em intervalos proprios do bloco.
+   */
+  class TarefaBins : public Tarefa{
+    const Construcao& c;
+    int inicio, fim, n_blocos;
+    const Caixa& caixa_centros;
+    BinsSAH* bins;
+  public:
+    TarefaBins(const Construcao& _c, int _inicio, int _fim, int _n_blocos, const Caixa& _caixa_centros, BinsSAH* _bins) :
+      c(_c), inicio(_inicio), fim(_fim), n_blocos(_n_blocos), caixa_centros(_caixa_centros), bins(_bins){}
+
+    void executar(int item, int){
+      bins[item].zerar(c.bins);
+      distribuir_bins(c, limite_bloco(inicio, fim, item, n_blocos), limite_bloco(inicio, fim, item + 1, n_blocos), caixa_centros,
+		      &bins[item]);
+    }
+  };
+
+  /**
+   * \fn static void medir(const Construcao& c, int inicio, int fim, Escalonador* escalonador, Divisao* d);
+   *
+   * \brief Calcula a caixa das primitivas e a dos centros das posicoes [inicio, fim). Com um escalonador, a varredura e dividida em
+   * blocos; como as caixas dos blocos sao combinadas exatamente, o resultado e o mesmo da varredura sequencial.
+   */
+  static void
+  medir(const Construcao& c, int inicio, int fim, Escalonador* escalonador, Divisao* d){
+    int n_blocos = (escalonador != NULL) ? numero_blocos(fim - inicio, 4 * escalonador->trabalhadores()) : 1;
+    d->caixa = Caixa();
+    d->caixa_centros = Caixa();
+    if (n_blocos > 1){
+      std::vector<Caixa> caixas(n_blocos), caixas_centros(n_blocos);
+      TarefaVarredura varredura(c, inicio, fim, n_blocos, &caixas[0], &caixas_centros[0]);
+      escalonador->executar(&varredura, n_blocos);
+      for (int b = 0; b < n_blocos; b++){
+	d->caixa.expandir(caixas[b]);
+	d->caixa_centros.expandir(caixas_centros[b]);
+      }
+    }
+    else{
+      varrer_caixas(c, inicio, fim, &d->caixa, &d->caixa_centros);
+    }
+  }
+
+  /**
+   * \fn static void avaliar(const Construcao& c, int inicio, int fim, int profundidade, Escalonador* escalonador, BinsSAH* bins,
+   * Divisao* d);
+   *
+   * \brief Escolhe o corte do no que contem as posicoes [inicio, fim), cujas caixas ja estao em d, usando bins como rascunho. Com um
+   * escalonador, a distribuicao nos intervalos e dividida em blocos, combinados exatamente como em medir.
+   */
+  static void
+  avaliar(const Construcao& c, int inicio, int fim, int profundidade, Escalonador* escalonador, BinsSAH* bins, Divisao* d){
+    int n = fim - inicio;
+    int n_blocos = (escalonador != NULL) ? numero_blocos(n, 4 * escalonador->trabalhadores()) : 1;
+
+    //A ultima camada da pilha das consultas e reservada; a partir dela tudo vira folha
+    d->folha = (n == 1 || profundidade >= BVH::PROFUNDIDADE_MAXIMA - 2);
+    if (d->folha){
+      return;
+    }
+
+    bins->zerar(c.bins);
+    if (n_blocos > 1){
+      BinsSAH* parciais = new BinsSAH[n_blocos];
+      TarefaBins distribuicao(c, inicio, fim, n_blocos, d->caixa_centros, parciais);
+      escalonador->executar(&distribuicao, n_blocos);
+      for (int b = 0; b < n_blocos; b++){
+	bins->somar(parciais[b], c.bins);
+      }
+      delete[] parciais;
+    }
+    else{
+      distribuir_bins(c, inicio, fim, d->caixa_centros, bins);
+    }
+    escolher_corte(c, *bins, d);
+  }
+
+  /**
+   * \fn static int dividir(const Construcao& c, NoBVH& no, int inicio, int fim, const Divisao& d, Divisao* filhos);
+   *
+   * \brief Aplica a avaliacao ao no. Se nenhum corte for mais barato que a folha, e a folha couber em MAX_PRIMITIVAS_FOLHA, o no vira
+   * folha; se os centros coincidirem, as primitivas sao divididas ao meio; senao sao particionadas pelo plano escolhido, e as caixas
+   * dos dois filhos sao acumuladas durante a particao.
+   *
+   * \return A primeira posicao do filho direito, com as caixas dos filhos em filhos[0] e filhos[1], ou -1 se o no virou folha.
+   */
+  static int
+  dividir(const Construcao& c, NoBVH& no, int inicio, int fim, const Divisao& d, Divisao* filhos){
+    int n = fim - inicio;
+    no.caixa = d.caixa;
+    if (!d.folha){
+      if (d.eixo < 0){
+	//Todos os centros coincidem: nao ha corte espacial possivel
+	if (n > MAX_PRIMITIVAS_FOLHA){
+	  int meio = inicio + n / 2;
+	  medir(c, inicio, meio, NULL, &filhos[0]);
+	  medir(c, meio, fim, NULL, &filhos[1]);
+	  return meio;
+	}
+      }
+      else{
+	double area = d.caixa.area();
+	double custo_folha = (double) n;
+	double custo_corte = (area > 0.0) ? CUSTO_TRAVESSIA + d.custo / area : custo_folha;
+	if (custo_corte < custo_folha || n > MAX_PRIMITIVAS_FOLHA){
+	  //Particionando as primitivas pelo plano escolhido
+	  double minimo = d.caixa_centros.min[d.eixo];
+	  double escala = c.bins / (d.caixa_centros.max[d.eixo] - minimo);
+	  for (int f = 0; f < 2; f++){
+	    filhos[f].caixa = Caixa();
+	    filhos[f].caixa_centros = Caixa();
+	  }
+	  int i = inicio, j = fim - 1;
+	  while (i <= j){
+	    const Caixa& p = c.referencias[i].caixa;
+	    if (intervalo(centro(p, d.eixo), minimo, escala, c.bins) < d.corte){
+	      acumular(&filhos[0].caixa, p);
+	      acumular_centro(&filhos[0].caixa_centros, p);
+	      i++;
+	    }
+	    else{
+	      acumular(&filhos[1].caixa, p);
+	      acumular_centro(&filhos[1].caixa_centros, p);
+	      std::swap(c.referencias[i], c.referencias[j]);
+	      j--;
+	    }
+	  }
+	  return i;
+	}
+      }
+    }
+    no.indice = inicio;
+    no.n_primitivas = n;
+    return -1;
+  }
+
+  /**
+   * \fn static int construir_sah(const Construcao& c, int* proximo_no, int inicio, int fim, int profundidade, BinsSAH* bins,
+   * Divisao* d);
+   *
+   * \brief Constroi recursivamente, na thread que chama, o no que contem as referencias [inicio, fim), cujas caixas estao em d, e a
+   * sua subarvore, a partir do no *proximo_no. Os intervalos de todos os nos usam o mesmo rascunho bins.
+   *
+   * \return O indice do no criado.
+   */
+  static int
+  construir_sah(const Construcao& c, int* proximo_no, int inicio, int fim, int profundidade, BinsSAH* bins, Divisao* d){
+    int indice_no = (*proximo_no)++;
+    NoBVH& no = c.nos[indice_no];
+    avaliar(c, inicio, fim, profundidade, NULL, bins, d);
+    Divisao filhos[2];
+    int meio = dividir(c, no, inicio, fim, *d, filhos);
+    if (meio < 0){
+      return indice_no;
+    }
+    construir_sah(c, proximo_no, inicio, meio, profundidade + 1, bins, &filhos[0]);
+    int direito = construir_sah(c, proximo_no, meio, fim, profundidade + 1, bins, &filhos[1]);
+    no.indice = direito;
+    no.n_primitivas = 0;
+    return indice_no;
+  }
+
+  /**
+   * \fn static int corte_morton(const Construcao& c, int inicio, int fim, int profundidade);
+   *
+   * \brief Escolhe o corte das posicoes [inicio, fim), ordenadas pelo codigo de Morton: a primeira posicao em que o bit mais alto que
+   * difere entre a primeira e a ultima chave vale 1, encontrada por busca binaria. Codigos iguais sao divididos ao meio.
+   *
+   * \return A primeira posicao do filho direito, ou -1 se o no deve ser folha.
+   */
+  static int
+  corte_morton(const Construcao& c, int inicio, int fim, int profundidade){
+    int n = fim - inicio;
+    if (n <= MAX_PRIMITIVAS_FOLHA_MORTON || profundidade >= BVH::PROFUNDIDADE_MAXIMA - 2){
+      return -1;
+    }
+    uint32_t primeiro = (uint32_t)(c.chaves[inicio] >> 32);
+    uint32_t ultimo = (uint32_t)(c.chaves[fim - 1] >> 32);
+    if (primeiro == ultimo){
+      return (n <= MAX_PRIMITIVAS_FOLHA) ? -1 : inicio + n / 2;
+    }
+    int bit = 31;
+    while ((((primeiro ^ ultimo) >> bit) & 1) == 0){
+      bit--;
+    }
+    int a = inicio, b = fim - 1;
+    while (a < b){
+      int m = (a + b) / 2;
+      if (((c.chaves[m] >> (32 + bit)) & 1) != 0){
+	b = m;
+      }
+      else{
+	a = m + 1;
+      }
+    }
+    return a;
+  }
+
+  /**
+   * \fn static void folha_morton(const Construcao& c, NoBVH& no, int inicio, int fim);
+   *
+   * \brief Transforma o no em folha das posicoes [inicio, fim).
+   */
+  static void
+  folha_morton(const Construcao& c, NoBVH& no, int inicio, int fim){
+    no.caixa = Caixa();
+    for (int k = inicio; k < fim; k++){
+      no.caixa.expandir(c.referencias[k].caixa);
+    }
+    no.indice = inicio;
+    no.n_primitivas = fim - inicio;
+  }
+
+  /**
+   * \fn static int construir_morton(const Construcao& c, int* proximo_no, int inicio, int fim, int profundidade);
+   *
+   * \brief Constroi recursivamente, na thread que chama, a subarvore das posicoes [inicio, fim) pela curva de Morton, a partir do no
+   * *proximo_no. As caixas sao calculadas das folhas para a raiz.
+   *
+   * \return O indice do no criado.
+   */
+  static int
+  construir_morton(const Construcao& c, int* proximo_no, int inicio, int fim, int profundidade){
+    int indice_no = (*proximo_no)++;
+    NoBVH& no = c.nos[indice_no];
+    int meio = corte_morton(c, inicio, fim, profundidade);
+    if (meio < 0){
+      folha_morton(c, no, inicio, fim);
+      return indice_no;
+    }
+    int esquerdo = construir_morton(c, proximo_no, inicio, meio, profundidade + 1);
+    int direito = construir_morton(c, proximo_no, meio, fim, profundidade + 1);
+    no.caixa = c.nos[esquerdo].caixa;
+    no.caixa.expandir(c.nos[direito].caixa);
+    no.indice = direito;
+    no.n_primitivas = 0;
+    return indice_no;
+  }
+
+  /**
+   * \class TarefaSubarvores
+   *
+   * \brief Constroi cada subarvore pendente na posicao reservada para ela.
+   */
+  class TarefaSubarvores : public Tarefa{
+    const Construcao& c;
+    std::vector<Subarvore>& subarvores;
+    MetodoBVH metodo;
+  public:
+    TarefaSubarvores(const Construcao& _c, std::vector<Subarvore>& _subarvores, MetodoBVH _metodo) :
+      c(_c), subarvores(_subarvores), metodo(_metodo){}
+
+    void executar(int item, int){
+      Subarvore& s = subarvores[item];
+      int proximo_no = s.no;
+      if (metodo == BVH_MORTON){
+	construir_morton(c, &proximo_no, s.inicio, s.fim, s.profundidade);
+      }
+      else{
+	BinsSAH* bins = new BinsSAH;
+	construir_sah(c, &proximo_no, s.inicio, s.fim, s.profundidade, bins, &s.raiz);
+	delete bins;
+      }
+    }
+  };
+
+  /**
+   * \fn static void construir_topo(const Construcao& c, MetodoBVH metodo, Escalonador* escalonador, int indice_no, int inicio,
+   * int fim, int profundidade, Divisao* d, int limiar, std::vector<Subarvore>& subarvores, std::vector<int>& internos);
+   *
+   * \brief Constroi na thread que chama os nos com mais de limiar primitivas (na SAH, com as caixas do no em d), com as varreduras
+   * de cada no divididas entre as
+   * threads. Uma subarvore de m primitivas tem no maximo 2m - 1 nos, entao o filho esquerdo de um no de [inicio, fim) fica no no
+   * seguinte e o direito 2 * (meio - inicio) nos depois dele, e as subarvores menores podem ser construidas em paralelo sem se
+   * sobrepor. Os nos internos criados sao guardados em pre-ordem.
+   */
+  static void
+  construir_topo(const Construcao& c, MetodoBVH metodo, Escalonador* escalonador, int indice_no, int inicio, int fim, int profundidade,
+		 Divisao* d, int limiar, std::vector<Subarvore>& subarvores, std::vector<int>& internos){
+    if (fim - inicio <= limiar){
+      Subarvore s;
+      s.no = indice_no;
+      s.inicio = inicio;
+      s.fim = fim;
+      s.profundidade = profundidade;
+      s.raiz = *d;
+      subarvores.push_back(s);
+      return;
+    }
+    NoBVH& no = c.nos[indice_no];
+    Divisao filhos[2];
+    int meio;
+    if (metodo == BVH_MORTON){
+      meio = corte_morton(c, inicio, fim, profundidade);
+      if (meio < 0){
+	folha_morton(c, no, inicio, fim);
+      }
+    }
+    else{
+      BinsSAH* bins = new BinsSAH;
+      avaliar(c, inicio, fim, profundidade, escalonador, bins, d);
+      delete bins;
+      meio = dividir(c, no, inicio, fim, *d, filhos);
+    }
+    if (meio < 0){
+      return;
+    }
+    no.indice = indice_no + 2 * (meio - inicio);
+    no.n_primitivas = 0;
+    internos.push_back(indice_no);
+    construir_topo(c, metodo, escalonador, indice_no + 1, inicio, meio, profundidade + 1, &filhos[0], limiar, subarvores, internos);
+    construir_topo(c, metodo, escalonador, no.indice, meio, fim, profundidade + 1, &filhos[1], limiar, subarvores, internos);
+  }
+
+  /**
+   * \class TarefaChaves
+   *
+   * \brief Calcula a chave de Morton (codigo nos 32 bits altos, indice nos baixos) de cada primitiva, um bloco por item.
+   */
+  class TarefaChaves : public Tarefa{
+    const Caixa* caixas;
+    uint64_t* chaves;
+    int n, n_blocos;
+    const Caixa& caixa_centros;
+    double escala[3];
+  public:
+    TarefaChaves(const Caixa* _caixas, uint64_t* _chaves, int _n, int _n_blocos, const Caixa& _caixa_centros) :
+      caixas(_caixas), chaves(_chaves), n(_n), n_blocos(_n_blocos), caixa_centros(_caixa_centros){
+      for (int e = 0; e < 3; e++){
+	double extensao = caixa_centros.max[e] - caixa_centros.min[e];
+	escala[e] = (extensao > 0.0) ? 1024.0 / extensao : 0.0;
+      }
+    }
+
+    void executar(int item, int){
+      int fim = limite_bloco(0, n, item + 1, n_blocos);
+      for (int k = limite_bloco(0, n, item, n_blocos); k < fim; k++){
+	uint32_t q[3];
+	for (int e = 0; e < 3; e++){
+	  int v = (int)((centro(caixas[k], e) - caixa_centros.min[e]) * escala[e]);
+	  q[e] = (v > 1023) ? 1023 : v;
+	}
+	chaves[k] = ((uint64_t) codigo_morton(q[0], q[1], q[2]) << 32) | (uint32_t) k;
+      }
+    }
+  };
+
+  /**
+   * \class TarefaOrdenacao
+   *
+   * \brief Ordena cada bloco de chaves.
+   */
+  class TarefaOrdenacao : public Tarefa{
+    uint64_t* chaves;
+    int n, n_blocos;
+  public:
+    TarefaOrdenacao(uint64_t* _chaves, int _n, int _n_blocos) : chaves(_chaves), n(_n), n_blocos(_n_blocos){}
+
+    void executar(int item, int){
+      std::sort(chaves + limite_bloco(0, n, item, n_blocos), chaves + limite_bloco(0, n, item + 1, n_blocos));
+    }
+  };
+
+  /**
+   * \class TarefaIntercalacao
+   *
+   * \brief Intercala pares de sequencias ordenadas de largura blocos cada.
+   */
+  class TarefaIntercalacao : public Tarefa{
+    const uint64_t* origem;
+    uint64_t* destino;
+    int n, n_blocos, largura;
+  public:
+    TarefaIntercalacao(const uint64_t* _origem, uint64_t* _destino, int _n, int _n_blocos, int _largura) :
+      origem(_origem), destino(_destino), n(_n), n_blocos(_n_blocos), largura(_largura){}
+
+    void executar(int item, int){
+      int b = 2 * largura * item;
+      int a = limite_bloco(0, n, b, n_blocos);
+      int m = limite_bloco(0, n, std::min(b + largura, n_blocos), n_blocos);
+      int f = limite_bloco(0, n, std::min(b + 2 * largura, n_blocos), n_blocos);
+      std::merge(origem + a, origem + m, origem + m, origem + f, destino + a);
+    }
+  };
+
+  /**
+   * \fn void ordenar_chaves(uint64_t* chaves, int n, Escalonador* escalonador);
+   *
+   * \brief Ordena chaves de 64 bits: um bloco por thread com std::sort e rodadas de intercalacao aos pares.
+   */
+  void
+  ordenar_chaves(uint64_t* chaves, int n, Escalonador* escalonador){
+    int n_blocos = (escalonador != NULL) ? numero_blocos(n, escalonador->trabalhadores()) : 1;
+    if (n_blocos <= 1){
+      std::sort(chaves, chaves + n);
+      return;
+    }
+    TarefaOrdenacao ordenacao(chaves, n, n_blocos);
+    escalonador->executar(&ordenacao, n_blocos);
+
+    uint64_t* auxiliar = (uint64_t*) aloca_alinhado((size_t) n * sizeof(uint64_t));
+    if (auxiliar == NULL){
+      //Sem memoria para a intercalacao: os blocos ja ordenados sao ordenados juntos
+      std::sort(chaves, chaves + n);
+      return;
+    }
+    uint64_t* origem = chaves;
+    uint64_t* destino = auxiliar;
+    for (int largura = 1; largura < n_blocos; largura *= 2){
+      TarefaIntercalacao intercalacao(origem, destino, n, n_blocos, largura);
+      escalonador->executar(&intercalacao, (n_blocos + 2 * largura - 1) / (2 * largura));
+      std::swap(origem, destino);
+    }
+    if (origem != chaves){
+      memcpy(chaves, origem, n * sizeof(uint64_t));
+    }
+    libera_alinhado(auxiliar);
+  }
+
+  /**
+   * \fn static void quantizar(const Caixa& caixa, const Caixa* filhos, int n, CaixasQuantizadas* c);
+   *
+   * \brief Quantiza as caixas dos n filhos de um no em relacao a caixa do no. Em cada eixo, a origem e o canto minimo do no
+   * arredondado para baixo em float e o passo e a menor potencia de dois com a qual 255 passos alcancam o canto maximo. Os cantos dos
+   * filhos sao arredondados para fora e conferidos com a mesma conta da decodificacao, de modo que a caixa decodificada sempre
+   * contem a original.
+   */
+  static void
+  quantizar(const Caixa& caixa, const Caixa* filhos, int n, CaixasQuantizadas* c){
+    memset(c, 0, sizeof(CaixasQuantizadas));
+    c->n_filhos = (unsigned char) n;
+    for (int e = 0; e < 3; e++){
+      float origem = (float) caixa.min[e];
+      if ((double) origem > caixa.min[e]){
+	origem = nextafterf(origem, -1e38f);
+      }
+      int expoente;
+      frexp((caixa.max[e] - (double) origem) / 255.0, &expoente);
+      if (expoente < EXPOENTE_MINIMO){
+	expoente = EXPOENTE_MINIMO;
+      }
+      while ((double) origem + 255 * ldexp(1.0, expoente) < caixa.max[e]){
+	expoente++;
+      }
+      double passo = ldexp(1.0, expoente);
+      c->origem[e] = origem;
+      c->expoente[e] = (signed char) expoente;
+      for (int i = 0; i < n; i++){
+	int q = (int) floor((filhos[i].min[e] - (double) origem) / passo);
+	if (q < 0) q = 0;
+	if (q > 255) q = 255;
+	while (q > 0 && (double) origem + q * passo > filhos[i].min[e]){
+	  q--;
+	}
+	c->minimo[e][i] = (unsigned char) q;
+	q = (int) ceil((filhos[i].max[e] - (double) origem) / passo);
+	if (q < 0) q = 0;
+	if (q > 255) q = 255;
+	while (q < 255 && (double) origem + q * passo < filhos[i].max[e]){
+	  q++;
+	}
+	c->maximo[e][i] = (unsigned char) q;
+      }
+    }
+  }
+
+  //------------------------------
+  //	Metodos privados
+  //------------------------------
+  /**
+   * \fn void BVH::compactar();
+   *
+   * \brief Percorre a arvore em pre-ordem, a partir da raiz no no 0. Nessa ordem os indices antigos sao crescentes e o novo indice de
+   * cada no nunca passa do antigo, entao os nos sao movidos no proprio vetor sem sobrescrever um no ainda nao visitado; o filho
+   * direito e corrigido quando e alcancado. O vetor e entao copiado para uma alocacao do tamanho exato.
+   */
+  void
+  BVH::compactar(){
+    EstatisticasBVH& e = estatisticas_construcao;
+    e.nos = e.folhas = e.profundidade = 0;
+    e.custo_sah = 0.0;
+
+    //Pilha de (indice antigo, novo indice do pai de um filho direito ou -1, profundidade)
+    std::vector<int> pilha;
+    pilha.push_back(0);
+    pilha.push_back(-1);
+    pilha.push_back(0);
+    while (!pilha.empty()){
+      int profundidade = pilha.back(); pilha.pop_back();
+      int pai = pilha.back(); pilha.pop_back();
+      int antigo = pilha.back(); pilha.pop_back();
+      int novo = e.nos++;
+      if (pai >= 0){
+	nos[pai].indice = novo;
+      }
+      NoBVH no = nos[antigo];
+      nos[novo] = no;
+      if (profundidade > e.profundidade){
+	e.profundidade = profundidade;
+      }
+      if (no.n_primitivas > 0){
+	e.folhas++;
+	e.custo_sah += no.caixa.area() * no.n_primitivas;
+      }
+      else{
+	e.custo_sah += CUSTO_TRAVESSIA * no.caixa.area();
+	pilha.push_back(no.indice);
+	pilha.push_back(novo);
+	pilha.push_back(profundidade + 1);
+	pilha.push_back(antigo + 1);
+	pilha.push_back(-1);
+	pilha.push_back(profundidade + 1);
+      }
+    }
+    double area_raiz = nos[0].caixa.area();
+    e.custo_sah = (area_raiz > 0.0) ? e.custo_sah / area_raiz : 0.0;
+
+    n_nos = e.nos;
+    NoBVH* exatos = (NoBVH*) aloca_alinhado(n_nos * sizeof(NoBVH));
+    if (exatos == NULL){
+      //Sem memoria para a copia: o vetor original, maior, continua valido
+      return;
+    }
+    memcpy(exatos, nos, n_nos * sizeof(NoBVH));
+    libera_alinhado(nos);
+    nos = exatos;
+  }
+
+  /**
+   * \fn void BVH::alargar(int largura);
+   *
+   * \brief Cada no largo nasce de um no interno da arvore binaria: os seus dois filhos sao os candidatos iniciais e o candidato
+   * interno de maior area e substituido pelos seus dois filhos ate haver largura candidatos ou apenas folhas. As folhas binarias viram
+   * filhos folha do no largo e os candidatos internos geram os nos largos seguintes, em pre-ordem. Como cada no largo consome pelo
+   * menos um no interno, ha no maximo (n_nos - 1) / 2 deles. Sem memoria para os nos largos, a arvore continua binaria; se apenas
+   * a copia de tamanho exato falhar, os vetores maiores sao mantidos.
+   */
+  void
+  BVH::alargar(int largura){
+    if (largura > LARGURA_BVH_MAXIMA) largura = LARGURA_BVH_MAXIMA;
+    //Coordenadas fora do alcance do float nao podem ser quantizadas: a arvore continua binaria
+    for (int e = 0; e < 3; e++){
+      if (!(nos[0].caixa.min[e] >= -COORDENADA_MAXIMA && nos[0].caixa.max[e] <= COORDENADA_MAXIMA)){
+	return;
+      }
+    }
+    int maximo = (n_nos > 1) ? (n_nos - 1) / 2 : 1;
+    CaixasQuantizadas* caixas = (CaixasQuantizadas*) aloca_alinhado(maximo * sizeof(CaixasQuantizadas));
+    FilhosLargos* filhos = (FilhosLargos*) aloca_alinhado(maximo * sizeof(FilhosLargos));
+    if (caixas == NULL || filhos == NULL){
+      libera_alinhado(caixas);
+      libera_alinhado(filhos);
+      return;
+    }
+
+    //Pilha de (no binario, no largo pai ou -1, posicao no pai)
+    std::vector<int> pilha;
+    pilha.push_back(0);
+    pilha.push_back(-1);
+    pilha.push_back(0);
+    int n_largos = 0;
+    while (!pilha.empty()){
+      int posicao = pilha.back(); pilha.pop_back();
+      int pai = pilha.back(); pilha.pop_back();
+      int binario = pilha.back(); pilha.pop_back();
+      int largo = n_largos++;
+      if (pai >= 0){
+	filhos[pai].indice[posicao] = largo;
+      }
+
+      int candidatos[LARGURA_BVH_MAXIMA];
+      int n = 0;
+      if (nos[binario].n_primitivas > 0){
+	//Apenas uma folha na raiz
+	candidatos[n++] = binario;
+      }
+      else{
+	candidatos[n++] = binario + 1;
+	candidatos[n++] = nos[binario].indice;
+      }
+      while (n < largura){
+	int maior = -1;
+	double area_maior = -1.0;
+	for (int i = 0; i < n; i++){
+	  const NoBVH& no = nos[candidatos[i]];
+	  if (no.n_primitivas == 0 && no.caixa.area() > area_maior){
+	    maior = i;
+	    area_maior = no.caixa.area();
+	  }
+	}
+	if (maior < 0){
+	  break;
+	}
+	int substituido = candidatos[maior];
+	for (int i = n; i > maior + 1; i--){
+	  candidatos[i] = candidatos[i - 1];
+	}
+	candidatos[maior] = substituido + 1;
+	candidatos[maior + 1] = nos[substituido].indice;
+	n++;
+      }
+
+      Caixa caixas_filhos[LARGURA_BVH_MAXIMA];
+      FilhosLargos& f = filhos[largo];
+      for (int i = 0; i < LARGURA_BVH_MAXIMA; i++){
+	f.indice[i] = 0;
+	f.n_primitivas[i] = 0;
+      }
+      for (int i = 0; i < n; i++){
+	caixas_filhos[i] = nos[candidatos[i]].caixa;
+      }
+      quantizar(nos[binario].caixa, caixas_filhos, n, &caixas[largo]);
+
+      //Os candidatos internos sao empilhados do ultimo para o primeiro, para que o primeiro seja o no largo seguinte
+      for (int i = n - 1; i >= 0; i--){
+	const NoBVH& no = nos[candidatos[i]];
+	if (no.n_primitivas > 0){
+	  f.indice[i] = no.indice;
+	  f.n_primitivas[i] = no.n_primitivas;
+	}
+	else{
+	  pilha.push_back(candidatos[i]);
+	  pilha.push_back(largo);
+	  pilha.push_back(i);
+	}
+      }
+    }
+
+    //Os vetores sao reduzidos ao tamanho exato e os nos binarios, liberados
+    caixas_largas = (CaixasQuantizadas*) aloca_alinhado(n_largos * sizeof(CaixasQuantizadas));
+    filhos_largos = (FilhosLargos*) aloca_alinhado(n_largos * sizeof(FilhosLargos));
+    if (caixas_largas == NULL || filhos_largos == NULL){
+      libera_alinhado(caixas_largas);
+      libera_alinhado(filhos_largos);
+      caixas_largas = caixas;
+      filhos_largos = filhos;
+    }
+    else{
+      memcpy(caixas_largas, caixas, n_largos * sizeof(CaixasQuantizadas));
+      memcpy(filhos_largos, filhos, n_largos * sizeof(FilhosLargos));
+      libera_alinhado(caixas);
+      libera_alinhado(filhos);
+    }
+    //Nos de usar_nos pertencem a outro: apenas deixam de ser consultados
+    if (!nos_externos){
+      libera_alinhado(nos);
+    }
+    nos_externos = false;
+    nos = NULL;
+    n_nos = n_largos;
+    estatisticas_construcao.largura = largura;
+    estatisticas_construcao.nos_largos = n_largos;
+  }
+
+  /**
+   * \fn void BVH::liberar();
+   *
+   * \brief Libera os vetores da hierarquia.
+   */
+  void
+  BVH::liberar(){
+    if (!nos_externos){
+      libera_alinhado(nos);
+    }
+    libera_alinhado(ordem_primitivas);
+    libera_alinhado(caixas_largas);
+    libera_alinhado(filhos_largos);
+    nos_externos = false;
+    nos = NULL;
+    ordem_primitivas = NULL;
+    caixas_largas = NULL;
+    filhos_largos = NULL;
+    n_nos = 0;
+    n_primitivas = 0;
+    estatisticas_construcao = EstatisticasBVH();
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn BVH::BVH();
+   *
+   * \brief Construtor da classe. A hierarquia inicial e vazia.
+   */
+  BVH::BVH(){
+    nos = NULL;
+    ordem_primitivas = NULL;
+    caixas_largas = NULL;
+    filhos_largos = NULL;
+    n_nos = 0;
+    n_primitivas = 0;
+    nos_externos = false;
+    estatisticas_construcao = EstatisticasBVH();
+  }
+
+  /**
+   * \fn BVH::~BVH();
+   *
+   * \brief Destrutor da classe.
+   */
+  BVH::~BVH(){
+    liberar();
+  }
+
+  /**
+   * \fn bool BVH::construir(const Caixa* caixas, int n, const OpcoesBVH& opcoes);
+   *
+   * \brief Constroi a hierarquia sobre n primitivas. Uma arvore binaria com n folhas de pelo menos uma primitiva tem no maximo
+   * 2n - 1 nos, entao o vetor de nos e alocado uma unica vez e reduzido ao tamanho exato no fim. Com mais de uma thread, os nos do
+   * topo sao construidos com varreduras paralelas e as subarvores de ate n / (8 * threads) primitivas (pelo menos MENOR_SUBARVORE)
+   * sao divididas entre as threads.
+   *
+   * \return false se faltar memoria; a hierarquia fica vazia.
+   */
+  bool
+  BVH::construir(const Caixa* caixas, int n, const OpcoesBVH& opcoes){
+    liberar();
+    if (n <= 0){
+      return true;
+    }
+    double inicio = segundos_agora();
+    Escalonador* escalonador = opcoes.escalonador;
+    int threads = (escalonador != NULL) ? escalonador->trabalhadores() : 1;
+    if (threads <= 1){
+      escalonador = NULL;
+    }
+
+    n_primitivas = n;
+    nos = (NoBVH*) aloca_alinhado((2 * n - 1) * sizeof(NoBVH));
+    ordem_primitivas = (int*) aloca_alinhado(n * sizeof(int));
+    int n_blocos = (escalonador != NULL) ? numero_blocos(n, 4 * threads) : 1;
+
+    Construcao c;
+    c.referencias = (Referencia*) aloca_alinhado(n * sizeof(Referencia));
+    if (nos == NULL || ordem_primitivas == NULL || c.referencias == NULL){
+      libera_alinhado(c.referencias);
+      liberar();
+      return false;
+    }
+    c.chaves = NULL;
+    c.nos = nos;
+    c.bins = opcoes.bins;
+    if (c.bins < 2) c.bins = 2;
+    if (c.bins > BINS_BVH_MAXIMO) c.bins = BINS_BVH_MAXIMO;
+
+    //Na construcao por Morton, as referencias ja sao criadas na ordem da curva
+    uint64_t* chaves = NULL;
+    if (opcoes.metodo == BVH_MORTON){
+      Caixa caixa_centros;
+      for (int k = 0; k < n; k++){
+	caixa_centros.expandir(caixas[k].centro());
+      }
+      chaves = (uint64_t*) aloca_alinhado(n * sizeof(uint64_t));
+      if (chaves == NULL){
+	libera_alinhado(c.referencias);
+	liberar();
+	return false;
+      }
+      TarefaChaves tarefa_chaves(caixas, chaves, n, n_blocos, caixa_centros);
+      if (n_blocos > 1){
+	escalonador->executar(&tarefa_chaves, n_blocos);
+      }
+      else{
+	tarefa_chaves.executar(0, 0);
+      }
+      ordenar_chaves(chaves, n, escalonador);
+      c.chaves = chaves;
+    }
+    TarefaReferencias tarefa_referencias(caixas, chaves, c.referencias, n, n_blocos);
+    if (n_blocos > 1){
+      escalonador->executar(&tarefa_referencias, n_blocos);
+    }
+    else{
+      tarefa_referencias.executar(0, 0);
+    }
+
+    Divisao raiz;
+    if (opcoes.metodo == BVH_SAH){
+      medir(c, 0, n, escalonador, &raiz);
+    }
+    int limiar = n / (8 * threads);
+    if (limiar < MENOR_SUBARVORE) limiar = MENOR_SUBARVORE;
+    if (escalonador == NULL || n <= limiar){
+      int proximo_no = 0;
+      if (opcoes.metodo == BVH_MORTON){
+	construir_morton(c, &proximo_no, 0, n, 0);
+      }
+      else{
+	BinsSAH* bins = new BinsSAH;
+	construir_sah(c, &proximo_no, 0, n, 0, bins, &raiz);
+	delete bins;
+      }
+    }
+    else{
+      std::vector<Subarvore> subarvores;
+      std::vector<int> internos;
+      construir_topo(c, opcoes.metodo, escalonador, 0, 0, n, 0, &raiz, limiar, subarvores, internos);
+      TarefaSubarvores tarefa_subarvores(c, subarvores, opcoes.metodo);
+      escalonador->executar(&tarefa_subarvores, (int) subarvores.size());
+
+      //Na construcao por Morton, as caixas do topo dependem das subarvores
+      if (opcoes.metodo == BVH_MORTON){
+	for (int k = (int) internos.size() - 1; k >= 0; k--){
+	  NoBVH& no = nos[internos[k]];
+	  no.caixa = nos[internos[k] + 1].caixa;
+	  no.caixa.expandir(nos[no.indice].caixa);
+	}
+      }
+    }
+    for (int k = 0; k < n; k++){
+      ordem_primitivas[k] = c.referencias[k].indice;
+    }
+    libera_alinhado(chaves);
+    libera_alinhado(c.referencias);
+
+    compactar();
+    estatisticas_construcao.largura = 2;
+    if (opcoes.largura > 2){
+      alargar(opcoes.largura);
+    }
+    estatisticas_construcao.threads = threads;
+    estatisticas_construcao.segundos = segundos_agora() - inicio;
+    return true;
+  }
+
+  /**
+   * \fn void BVH::usar_nos(const NoBVH* nos_prontos, int n_nos_prontos, int n, int largura);
+   *
+   * \brief Passa a consultar um vetor de nos ja construido, sem copia-lo. As consultas e alargar nunca alteram os nos, entao o vetor
+   * pode ficar em memoria somente leitura.
+   */
+  void
+  BVH::usar_nos(const NoBVH* nos_prontos, int n_nos_prontos, int n, int largura){
+    liberar();
+    nos = const_cast<NoBVH*>(nos_prontos);
+    n_nos = n_nos_prontos;
+    n_primitivas = n;
+    nos_externos = true;
+    estatisticas_construcao.nos = n_nos;
+    estatisticas_construcao.largura = 2;
+    if (largura > 2 && n_nos > 0){
+      alargar(largura);
+    }
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
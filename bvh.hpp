@@ -0,0 +1,786 @@
+/**
+ * \file bvh.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo bvh.cpp, sendo este
+ * responsavel pela hierarquia de volumes envolventes (BVH) utilizada para acelerar a busca da interseccao mais proxima. A hierarquia e
+ * construida pela heuristica de area de superficie (SAH), ou a partir da ordenacao das primitivas pela curva de Morton, e armazenada
+ * em um vetor plano de nos, em profundidade: o filho esquerdo de um no interno e sempre o no seguinte e o filho direito e indicado
+ * pelo proprio no. Com um escalonador, a construcao usa as threads da renderizacao. Opcionalmente, a arvore binaria e colapsada em uma
+ * BVH larga, de 4 ou 8 filhos por no, com as caixas dos filhos quantizadas em 8 bits: os nos ocupam bem menos memoria e todos os
+ * filhos de um no sao testados de uma vez pelos nucleos vetoriais.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _BVH_HPP
+#define _BVH_HPP
+
+#include <stddef.h>	//size_t
+#include <stdint.h>	//uint32_t, uint64_t
+#include <math.h>	//ldexp
+#include "vetor.hpp"	//rayTracing::Vetor
+#include "pacote.hpp"	//rayTracing::PacoteRaios
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  class Escalonador;
+
+  /**
+   * \struct Caixa
+   *
+   * \brief Caixa alinhada aos eixos, dada pelos cantos minimo e maximo.
+   */
+  struct Caixa{
+    double min[3];	///< Canto minimo (x, y, z)
+    double max[3];	///< Canto maximo (x, y, z)
+
+    /**
+     * \fn Caixa();
+     *
+     * \brief Construtor da classe. A caixa inicial e vazia (min > max), de modo que qualquer expansao a substitui.
+     */
+    Caixa(){
+      for (int e = 0; e < 3; e++){
+	min[e] = 1e300;
+	max[e] = -1e300;
+      }
+    }
+
+    /**
+     * \fn Caixa(const Vetor& _min, const Vetor& _max);
+     *
+     * \brief Construtor da classe a partir dos cantos.
+     */
+    Caixa(const Vetor& _min, const Vetor& _max){
+      min[0] = _min.vx(); min[1] = _min.vy(); min[2] = _min.vz();
+      max[0] = _max.vx(); max[1] = _max.vy(); max[2] = _max.vz();
+    }
+
+    /**
+     * \fn void expandir(const Caixa& c);
+     *
+     * \brief Expande a caixa para conter a caixa c.
+     */
+    void expandir(const Caixa& c){
+      for (int e = 0; e < 3; e++){
+	if (c.min[e] < min[e]) min[e] = c.min[e];
+	if (c.max[e] > max[e]) max[e] = c.max[e];
+      }
+    }
+
+    /**
+     * \fn void expandir(const Vetor& p);
+     *
+     * \brief Expande a caixa para conter o ponto p.
+     */
+    void expandir(const Vetor& p){
+      expandir(Caixa(p, p));
+    }
+
+    /**
+     * \fn Vetor centro() const;
+     *
+     * \brief Retorna o centro da caixa.
+     */
+    Vetor centro() const{
+      return Vetor((min[0] + max[0]) * 0.5, (min[1] + max[1]) * 0.5, (min[2] + max[2]) * 0.5);
+    }
+
+    /**
+     * \fn double area() const;
+     *
+     * \brief Retorna a area da superficie da caixa (zero para a caixa vazia).
+     */
+    double area() const{
+      double dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+      if (dx < 0.0 || dy < 0.0 || dz < 0.0){
+	return 0.0;
+      }
+      return 2.0 * (dx * dy + dy * dz + dz * dx);
+    }
+  };
+
+  /**
+   * \struct NoBVH
+   *
+   * \brief No da hierarquia. Se n_primitivas > 0 o no e uma folha com as primitivas [indice, indice + n_primitivas) da ordem da BVH;
+   * caso contrario e um no interno cujo filho esquerdo e o no seguinte e o filho direito e o no indice.
+   */
+  struct NoBVH{
+    Caixa caixa;	///< Caixa envolvente do no
+    int indice;		///< Primeira primitiva (folha) ou filho direito (no interno)
+    int n_primitivas;	///< Numero de primitivas da folha (0 para no interno)
+  };
+
+  /**
+   * \struct FilhosLargos
+   *
+   * \brief Filhos de um no da BVH larga, guardados a parte das suas caixas (CaixasQuantizadas): a travessia le esta linha de cache
+   * apenas para empilhar os filhos que o raio atinge.
+   */
+  struct FilhosLargos{
+    int indice[LARGURA_BVH_MAXIMA];		///< Primeira primitiva (folha) ou no largo do filho
+    int n_primitivas[LARGURA_BVH_MAXIMA];	///< Numero de primitivas da folha (0 para no interno)
+  };
+
+  /**
+   * \enum MetodoBVH
+   *
+   * \brief Metodo de construcao da hierarquia.
+   */
+  enum MetodoBVH{
+    BVH_SAH = 0,	///< Cortes escolhidos pela heuristica de area de superficie, avaliada em intervalos (bins) dos centros
+    BVH_MORTON = 1	///< Primitivas ordenadas pelo codigo de Morton dos centros e cortadas no bit mais alto que muda (mais rapido)
+  };
+
+  /**
+   * \brief Numero padrao de intervalos avaliados pela SAH em cada eixo.
+   */
+  const int BINS_BVH_PADRAO = 16;
+
+  /**
+   * \brief Maior numero de intervalos avaliados pela SAH em cada eixo.
+   */
+  const int BINS_BVH_MAXIMO = 64;
+
+  /**
+   * \struct OpcoesBVH
+   *
+   * \brief Opcoes da construcao da hierarquia. O numero de bins e o botao entre qualidade e tempo da SAH: mais intervalos encontram
+   * cortes melhores, com uma varredura mais cara por no.
+   */
+  struct OpcoesBVH{
+    MetodoBVH metodo;		///< Metodo de construcao
+    int bins;			///< Intervalos da SAH em cada eixo (2 a BINS_BVH_MAXIMO)
+    Escalonador* escalonador;	///< Threads da construcao (NULL constroi apenas na thread que chama)
+    int largura;		///< Filhos por no consultado: 2 (arvore binaria), 4 ou 8 (BVH larga, com caixas quantizadas)
+
+    /**
+     * \fn OpcoesBVH();
+     *
+     * \brief Construtor da classe. SAH com BINS_BVH_PADRAO intervalos, sem threads, arvore binaria.
+     */
+    OpcoesBVH(){
+      metodo = BVH_SAH;
+      bins = BINS_BVH_PADRAO;
+      escalonador = NULL;
+      largura = 2;
+    }
+  };
+
+  /**
+   * \struct EstatisticasBVH
+   *
+   * \brief Estatisticas da ultima construcao da hierarquia.
+   */
+  struct EstatisticasBVH{
+    int nos;		///< Numero de nos da arvore binaria
+    int folhas;		///< Numero de folhas
+    int profundidade;	///< Profundidade da folha mais funda (a raiz tem profundidade 0)
+    double custo_sah;	///< Custo SAH da arvore, relativo a area da raiz (custo de testar uma primitiva = 1)
+    double segundos;	///< Tempo de parede da construcao
+    int threads;	///< Numero de threads usadas
+    int largura;	///< Filhos por no da arvore consultada
+    int nos_largos;	///< Numero de nos da BVH larga (0 se a arvore consultada e a binaria)
+  };
+
+  /**
+   * \fn uint32_t codigo_morton(uint32_t x, uint32_t y, uint32_t z);
+   *
+   * \brief Codigo de Morton de 30 bits: intercala os 10 bits baixos de x, y e z.
+   */
+  uint32_t codigo_morton(uint32_t x, uint32_t y, uint32_t z);
+
+  /**
+   * \fn void ordenar_chaves(uint64_t* chaves, int n, Escalonador* escalonador);
+   *
+   * \brief Ordena chaves de 64 bits. Com um escalonador, cada thread ordena um bloco e os blocos sao intercalados aos pares, em
+   * paralelo; o vetor auxiliar da intercalacao ocupa mais 8 bytes por chave.
+   */
+  void ordenar_chaves(uint64_t* chaves, int n, Escalonador* escalonador);
+
+  /**
+   * \class BVH
+   *
+   * \brief Hierarquia de volumes envolventes sobre um conjunto de primitivas quaisquer, descritas apenas por suas caixas. Depois da
+   * construcao as primitivas devem ser reordenadas segundo ordem(), de modo que as primitivas de uma folha fiquem contiguas; as
+   * consultas informam a posicao da primitiva nessa ordem.
+   */
+  class BVH{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    NoBVH* nos;		///< Vetor plano de nos (a raiz e o no 0; NULL se a arvore foi colapsada em uma BVH larga)
+    int n_nos;		///< Numero de nos da arvore consultada (binaria ou larga)
+    CaixasQuantizadas* caixas_largas;	///< Caixas dos filhos de cada no da BVH larga, em pre-ordem (NULL na arvore binaria)
+    FilhosLargos* filhos_largos;	///< Filhos de cada no da BVH larga
+    int* ordem_primitivas;	///< Indice original da primitiva de cada posicao
+    int n_primitivas;	///< Numero de primitivas
+    bool nos_externos;	///< Indica que os nos pertencem a outro (usar_nos) e nao sao liberados
+    EstatisticasBVH estatisticas_construcao;	///< Estatisticas da ultima construcao
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    /**
+     * \fn void compactar();
+     *
+     * \brief Renumera os nos em profundidade, eliminando as posicoes que as subarvores construidas em paralelo reservaram e nao
+     * usaram, e calcula as estatisticas da arvore.
+     */
+    void compactar();
+
+    /**
+     * \fn void alargar(int largura);
+     *
+     * \brief Colapsa a arvore binaria em uma BVH larga de ate largura filhos por no e libera os nos binarios. Sem memoria para os nos
+     * largos, a arvore binaria e mantida (estatisticas().largura continua 2).
+     */
+    void alargar(int largura);
+
+    /**
+     * \fn void liberar();
+     *
+     * \brief Libera os vetores da hierarquia.
+     */
+    void liberar();
+
+    /**
+     * \fn static bool intercepta_caixa(const Caixa& c, const Vetor& origem, const Vetor& inverso, double t_max, double* t_entrada);
+     *
+     * \brief Teste do raio contra a caixa pelo metodo das placas (slabs), no intervalo [0, t_max].
+     *
+     * \param inverso - inverso de cada componente da direcao do raio
+     * \param t_entrada - t em que o raio entra na caixa
+     */
+    static bool intercepta_caixa(const Caixa& c, const Vetor& origem, const Vetor& inverso, double t_max, double* t_entrada);
+
+    /**
+     * \fn static void caixas_filhos(const CaixasQuantizadas& c, double min[][3], double max[][3]);
+     *
+     * \brief Decodifica as caixas quantizadas dos filhos de um no largo.
+     */
+    static void caixas_filhos(const CaixasQuantizadas& c, double min[][3], double max[][3]);
+
+    /**
+     * \fn template <class Teste> int mais_proxima_larga(const Vetor& origem, const Vetor& direcao, const Teste& teste, double* t) const;
+     *
+     * \brief mais_proxima na BVH larga.
+     */
+    template <class Teste>
+    int mais_proxima_larga(const Vetor& origem, const Vetor& direcao, const Teste& teste, double* t) const;
+
+    /**
+     * \fn template <class Teste> bool alguma_larga(const Vetor& origem, const Vetor& direcao, double t_max, const Teste& teste) const;
+     *
+     * \brief alguma na BVH larga.
+     */
+    template <class Teste>
+    bool alguma_larga(const Vetor& origem, const Vetor& direcao, double t_max, const Teste& teste) const;
+
+    /**
+     * \fn template <class Teste> void mais_proxima_pacote_larga(PacoteRaios& p, const Teste& teste) const;
+     *
+     * \brief mais_proxima_pacote na BVH larga.
+     */
+    template <class Teste>
+    void mais_proxima_pacote_larga(PacoteRaios& p, const Teste& teste) const;
+
+    //Copia nao permitida
+    BVH(const BVH&);
+    BVH& operator=(const BVH&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \brief Profundidade maxima da hierarquia (e tamanho da pilha das consultas).
+     */
+    static const int PROFUNDIDADE_MAXIMA = 64;
+
+    /**
+     * \fn BVH();
+     *
+     * \brief Construtor da classe. A hierarquia inicial e vazia.
+     */
+    BVH();
+
+    /**
+     * \fn ~BVH();
+     *
+     * \brief Destrutor da classe.
+     */
+    ~BVH();
+
+    /**
+     * \fn bool construir(const Caixa* caixas, int n, const OpcoesBVH& opcoes = OpcoesBVH());
+     *
+     * \brief Constroi a hierarquia sobre n primitivas. Com a SAH e as opcoes padrao, a arvore construida com ou sem threads e a
+     * mesma. Com opcoes.largura 4 ou 8, a arvore binaria e colapsada em uma BVH larga; as consultas tem o mesmo contrato.
+     *
+     * \param caixas - caixa envolvente de cada primitiva
+     * \param n - numero de primitivas
+     * \param opcoes - metodo, qualidade, threads e largura da construcao
+     *
+     * \return false se faltar memoria; a hierarquia fica vazia.
+     */
+    bool construir(const Caixa* caixas, int n, const OpcoesBVH& opcoes = OpcoesBVH());
+
+    /**
+     * \fn void usar_nos(const NoBVH* nos_prontos, int n_nos_prontos, int n, int largura = 2);
+     *
+     * \brief Passa a consultar um vetor de nos ja construido (por exemplo, mapeado de um arquivo de cache), sem copia-lo. O vetor deve
+     * existir enquanto a hierarquia for usada, e as n primitivas ja devem estar na ordem da hierarquia: ordem() retorna NULL. Com
+     * largura maior que 2, a arvore e colapsada em nos largos proprios, como em construir, e o vetor deixa de ser consultado.
+     */
+    void usar_nos(const NoBVH* nos_prontos, int n_nos_prontos, int n, int largura = 2);
+
+    /**
+     * \fn const EstatisticasBVH& estatisticas() const;
+     *
+     * \brief Retorna as estatisticas da ultima construcao. Para nos de usar_nos, apenas o numero de nos e informado.
+     */
+    const EstatisticasBVH& estatisticas() const;
+
+    /**
+     * \fn int numero_nos() const;
+     *
+     * \brief Retorna o numero de nos da arvore consultada (binaria ou larga).
+     */
+    int numero_nos() const;
+
+    /**
+     * \fn size_t bytes_nos() const;
+     *
+     * \brief Retorna a memoria ocupada pelos nos da arvore consultada.
+     */
+    size_t bytes_nos() const;
+
+    /**
+     * \fn const NoBVH& no(int k) const;
+     *
+     * \brief Retorna o no k da arvore binaria (apenas se ela nao foi colapsada em uma BVH larga).
+     */
+    const NoBVH& no(int k) const;
+
+    /**
+     * \fn const int* ordem() const;
+     *
+     * \brief Retorna, para cada posicao da hierarquia, o indice original da primitiva.
+     */
+    const int* ordem() const;
+
+    /**
+     * \fn template <class Teste> int mais_proxima(const Vetor& origem, const Vetor& direcao, const Teste& teste, double* t) const;
+     *
+     * \brief Busca a primitiva com a menor interseccao positiva ao longo do raio origem + t*direcao. Os filhos sao visitados do mais
+     * proximo para o mais distante e as caixas alem da melhor interseccao ja encontrada sao descartadas.
+     *
+     * \param teste - objeto com o metodo int operator()(int inicio, int n, double t_max, double* t) const, que testa de uma vez as
+     * primitivas [inicio, inicio + n) de uma folha (na ordem da hierarquia) e retorna a posicao da mais proxima com interseccao antes
+     * de t_max, guardando o seu t, ou -1
+     * \param t - t da interseccao encontrada
+     *
+     * \return A posicao da primitiva interceptada ou -1.
+     */
+    template <class Teste>
+    int mais_proxima(const Vetor& origem, const Vetor& direcao, const Teste& teste, double* t) const;
+
+    /**
+     * \fn template <class Teste> bool alguma(const Vetor& origem, const Vetor& direcao, double t_max, const Teste& teste) const;
+     *
+     * \brief Verifica se alguma primitiva intercepta o raio no intervalo (0, t_max). A busca termina na primeira interseccao (raios de
+     * sombra).
+     *
+     * \param teste - mesmo contrato de mais_proxima
+     */
+    template <class Teste>
+    bool alguma(const Vetor& origem, const Vetor& direcao, double t_max, const Teste& teste) const;
+
+    /**
+     * \fn template <class Teste> void mais_proxima_pacote(PacoteRaios& p, const Teste& teste) const;
+     *
+     * \brief Versao de mais_proxima para um pacote de raios coerentes: um no e visitado se algum raio do pacote atinge a sua caixa, e
+     * as folhas testam o pacote inteiro contra cada primitiva. Ao final, p.t e p.indice contem a interseccao mais proxima de cada raio.
+     *
+     * \param p - pacote de raios, com t[k] iniciado com o t maximo de cada raio e indice[k] com -1
+     * \param teste - objeto com o metodo void operator()(int k, PacoteRaios& p) const, que atualiza o pacote com a primitiva k
+     */
+    template <class Teste>
+    void mais_proxima_pacote(PacoteRaios& p, const Teste& teste) const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline uint32_t
+  codigo_morton(uint32_t x, uint32_t y, uint32_t z){
+    uint32_t v[3] = { x, y, z };
+    for (int e = 0; e < 3; e++){
+      v[e] &= 0x3ff;
+      v[e] = (v[e] | (v[e] << 16)) & 0x030000ff;
+      v[e] = (v[e] | (v[e] << 8)) & 0x0300f00f;
+      v[e] = (v[e] | (v[e] << 4)) & 0x030c30c3;
+      v[e] = (v[e] | (v[e] << 2)) & 0x09249249;
+    }
+    return v[0] | (v[1] << 1) | (v[2] << 2);
+  }
+
+  inline const EstatisticasBVH&
+  BVH::estatisticas() const{
+    return estatisticas_construcao;
+  }
+
+  inline int
+  BVH::numero_nos() const{
+    return n_nos;
+  }
+
+  inline size_t
+  BVH::bytes_nos() const{
+    if (caixas_largas != NULL){
+      return (size_t) n_nos * (sizeof(CaixasQuantizadas) + sizeof(FilhosLargos));
+    }
+    return (size_t) n_nos * sizeof(NoBVH);
+  }
+
+  inline const NoBVH&
+  BVH::no(int k) const{
+    return nos[k];
+  }
+
+  inline const int*
+  BVH::ordem() const{
+    return ordem_primitivas;
+  }
+
+  inline bool
+  BVH::intercepta_caixa(const Caixa& c, const Vetor& origem, const Vetor& inverso, double t_max, double* t_entrada){
+    double o[3] = { origem.vx(), origem.vy(), origem.vz() };
+    double inv[3] = { inverso.vx(), inverso.vy(), inverso.vz() };
+    double t0 = 0.0, t1 = t_max;
+    for (int e = 0; e < 3; e++){
+      double a = (c.min[e] - o[e]) * inv[e];
+      double b = (c.max[e] - o[e]) * inv[e];
+      if (a > b){ double aux = a; a = b; b = aux; }
+      if (a > t0) t0 = a;
+      if (b < t1) t1 = b;
+    }
+
+    *t_entrada = t0;
+    return t0 <= t1;
+  }
+
+  inline void
+  BVH::caixas_filhos(const CaixasQuantizadas& c, double min[][3], double max[][3]){
+    for (int e = 0; e < 3; e++){
+      double passo = ldexp(1.0, c.expoente[e]);
+      for (int i = 0; i < c.n_filhos; i++){
+	min[i][e] = (double) c.origem[e] + c.minimo[e][i] * passo;
+	max[i][e] = (double) c.origem[e] + c.maximo[e][i] * passo;
+      }
+    }
+  }
+
+  template <class Teste>
+  int
+  BVH::mais_proxima(const Vetor& origem, const Vetor& direcao, const Teste& teste, double* t) const{
+    if (caixas_largas != NULL){
+      return mais_proxima_larga(origem, direcao, teste, t);
+    }
+    int melhor = -1;
+    double t_melhor = 1e300;
+    if (n_nos == 0){
+      return melhor;
+    }
+    Vetor inverso(1.0 / direcao.vx(), 1.0 / direcao.vy(), 1.0 / direcao.vz());
+
+    int pilha[PROFUNDIDADE_MAXIMA];
+    int topo = 0;
+    double t_entrada;
+    if (!intercepta_caixa(nos[0].caixa, origem, inverso, t_melhor, &t_entrada)){
+      return melhor;
+    }
+    pilha[topo++] = 0;
+    while (topo > 0){
+      const NoBVH& no = nos[pilha[--topo]];
+      if (no.n_primitivas > 0){
+	double tk;
+	int k = teste(no.indice, no.n_primitivas, t_melhor, &tk);
+	if (k >= 0){
+	  t_melhor = tk;
+	  melhor = k;
+	}
+	continue;
+      }
+      int esquerdo = (int)(&no - nos) + 1;
+      int direito = no.indice;
+      double t_esquerdo, t_direito;
+      bool acerta_esquerdo = intercepta_caixa(nos[esquerdo].caixa, origem, inverso, t_melhor, &t_esquerdo);
+      bool acerta_direito = intercepta_caixa(nos[direito].caixa, origem, inverso, t_melhor, &t_direito);
+      if (acerta_esquerdo && acerta_direito){
+	//O filho mais proximo e empilhado por ultimo para ser visitado primeiro
+	if (t_esquerdo <= t_direito){
+	  pilha[topo++] = direito;
+	  pilha[topo++] = esquerdo;
+	}
+	else{
+	  pilha[topo++] = esquerdo;
+	  pilha[topo++] = direito;
+	}
+      }
+      else if (acerta_esquerdo){
+	pilha[topo++] = esquerdo;
+      }
+      else if (acerta_direito){
+	pilha[topo++] = direito;
+      }
+    }
+    *t = t_melhor;
+    return melhor;
+  }
+
+  template <class Teste>
+  bool
+  BVH::alguma(const Vetor& origem, const Vetor& direcao, double t_max, const Teste& teste) const{
+    if (caixas_largas != NULL){
+      return alguma_larga(origem, direcao, t_max, teste);
+    }
+    if (n_nos == 0){
+      return false;
+    }
+    Vetor inverso(1.0 / direcao.vx(), 1.0 / direcao.vy(), 1.0 / direcao.vz());
+
+    int pilha[PROFUNDIDADE_MAXIMA];
+    int topo = 0;
+    double t_entrada;
+    pilha[topo++] = 0;
+    while (topo > 0){
+      const NoBVH& no = nos[pilha[--topo]];
+      if (!intercepta_caixa(no.caixa, origem, inverso, t_max, &t_entrada)){
+	continue;
+      }
+      if (no.n_primitivas > 0){
+	double tk;
+	if (teste(no.indice, no.n_primitivas, t_max, &tk) >= 0){
+	  return true;
+	}
+	continue;
+      }
+      pilha[topo++] = no.indice;
+      pilha[topo++] = (int)(&no - nos) + 1;
+    }
+    return false;
+  }
+
+  template <class Teste>
+  void
+  BVH::mais_proxima_pacote(PacoteRaios& p, const Teste& teste) const{
+    if (caixas_largas != NULL){
+      mais_proxima_pacote_larga(p, teste);
+      return;
+    }
+    if (n_nos == 0){
+      return;
+    }
+    int pilha[PROFUNDIDADE_MAXIMA];
+    int topo = 0;
+    double t_entrada;
+    if (!intercepta_caixa_pacote(p, nos[0].caixa.min, nos[0].caixa.max, &t_entrada)){
+      return;
+    }
+    pilha[topo++] = 0;
+    while (topo > 0){
+      const NoBVH& no = nos[pilha[--topo]];
+      if (no.n_primitivas > 0){
+	for (int k = no.indice; k < no.indice + no.n_primitivas; k++){
+	  teste(k, p);
+	}
+	continue;
+      }
+      int esquerdo = (int)(&no - nos) + 1;
+      int direito = no.indice;
+      double t_esquerdo, t_direito;
+      bool acerta_esquerdo = intercepta_caixa_pacote(p, nos[esquerdo].caixa.min, nos[esquerdo].caixa.max, &t_esquerdo);
+      bool acerta_direito = intercepta_caixa_pacote(p, nos[direito].caixa.min, nos[direito].caixa.max, &t_direito);
+      if (acerta_esquerdo && acerta_direito){
+	//O filho mais proximo do pacote e empilhado por ultimo para ser visitado primeiro
+	if (t_esquerdo <= t_direito){
+	  pilha[topo++] = direito;
+	  pilha[topo++] = esquerdo;
+	}
+	else{
+	  pilha[topo++] = esquerdo;
+	  pilha[topo++] = direito;
+	}
+      }
+      else if (acerta_esquerdo){
+	pilha[topo++] = esquerdo;
+      }
+      else if (acerta_direito){
+	pilha[topo++] = direito;
+      }
+    }
+  }
+
+  template <class Teste>
+  int
+  BVH::mais_proxima_larga(const Vetor& origem, const Vetor& direcao, const Teste& teste, double* t) const{
+    int melhor = -1;
+    double t_melhor = 1e300;
+    double o[3] = { origem.vx(), origem.vy(), origem.vz() };
+    double inverso[3] = { 1.0 / direcao.vx(), 1.0 / direcao.vy(), 1.0 / direcao.vz() };
+
+    //Cada entrada da pilha e um no largo (n = 0) ou uma folha [indice, indice + n), com o t em que o raio entra na sua caixa
+    int pilha_indice[PROFUNDIDADE_MAXIMA * LARGURA_BVH_MAXIMA];
+    int pilha_n[PROFUNDIDADE_MAXIMA * LARGURA_BVH_MAXIMA];
+    double pilha_t[PROFUNDIDADE_MAXIMA * LARGURA_BVH_MAXIMA];
+    int topo = 0;
+    pilha_indice[topo] = 0;
+    pilha_n[topo] = 0;
+    pilha_t[topo++] = 0.0;
+    while (topo > 0){
+      --topo;
+      //A caixa pode ter ficado alem da melhor interseccao encontrada depois de empilhada
+      if (pilha_t[topo] > t_melhor){
+	continue;
+      }
+      if (pilha_n[topo] > 0){
+	double tk;
+	int k = teste(pilha_indice[topo], pilha_n[topo], t_melhor, &tk);
+	if (k >= 0){
+	  t_melhor = tk;
+	  melhor = k;
+	}
+	continue;
+      }
+      int no = pilha_indice[topo];
+      double t_filhos[LARGURA_BVH_MAXIMA];
+      int mascara = intercepta_caixas_quantizadas(caixas_largas[no], o, inverso, t_melhor, t_filhos);
+
+      //Os filhos atingidos sao ordenados do mais distante para o mais proximo, que e empilhado por ultimo para ser visitado primeiro
+      int ordem[LARGURA_BVH_MAXIMA];
+      int n = 0;
+      for (int i = 0; mascara != 0; i++, mascara >>= 1){
+	if (mascara & 1){
+	  int j = n++;
+	  while (j > 0 && t_filhos[ordem[j - 1]] <= t_filhos[i]){
+	    ordem[j] = ordem[j - 1];
+	    j--;
+	  }
+	  ordem[j] = i;
+	}
+      }
+      const FilhosLargos& f = filhos_largos[no];
+      for (int j = 0; j < n; j++){
+	pilha_indice[topo] = f.indice[ordem[j]];
+	pilha_n[topo] = f.n_primitivas[ordem[j]];
+	pilha_t[topo++] = t_filhos[ordem[j]];
+      }
+    }
+    *t = t_melhor;
+    return melhor;
+  }
+
+  template <class Teste>
+  bool
+  BVH::alguma_larga(const Vetor& origem, const Vetor& direcao, double t_max, const Teste& teste) const{
+    double o[3] = { origem.vx(), origem.vy(), origem.vz() };
+    double inverso[3] = { 1.0 / direcao.vx(), 1.0 / direcao.vy(), 1.0 / direcao.vz() };
+
+    int pilha_indice[PROFUNDIDADE_MAXIMA * LARGURA_BVH_MAXIMA];
+    int pilha_n[PROFUNDIDADE_MAXIMA * LARGURA_BVH_MAXIMA];
+    int topo = 0;
+    pilha_indice[topo] = 0;
+    pilha_n[topo++] = 0;
+    while (topo > 0){
+      --topo;
+      if (pilha_n[topo] > 0){
+	double tk;
+	if (teste(pilha_indice[topo], pilha_n[topo], t_max, &tk) >= 0){
+	  return true;
+	}
+	continue;
+      }
+      int no = pilha_indice[topo];
+      double t_filhos[LARGURA_BVH_MAXIMA];
+      int mascara = intercepta_caixas_quantizadas(caixas_largas[no], o, inverso, t_max, t_filhos);
+
+      //Os filhos atingidos sao empilhados do ultimo para o primeiro: a ordem de visita e a da arvore binaria
+      const FilhosLargos& f = filhos_largos[no];
+      for (int i = LARGURA_BVH_MAXIMA - 1; i >= 0; i--){
+	if (mascara & (1 << i)){
+	  pilha_indice[topo] = f.indice[i];
+	  pilha_n[topo++] = f.n_primitivas[i];
+	}
+      }
+    }
+    return false;
+  }
+
+  template <class Teste>
+  void
+  BVH::mais_proxima_pacote_larga(PacoteRaios& p, const Teste& teste) const{
+    int pilha_indice[PROFUNDIDADE_MAXIMA * LARGURA_BVH_MAXIMA];
+    int pilha_n[PROFUNDIDADE_MAXIMA * LARGURA_BVH_MAXIMA];
+    int topo = 0;
+    pilha_indice[topo] = 0;
+    pilha_n[topo++] = 0;
+    while (topo > 0){
+      --topo;
+      if (pilha_n[topo] > 0){
+	for (int k = pilha_indice[topo]; k < pilha_indice[topo] + pilha_n[topo]; k++){
+	  teste(k, p);
+	}
+	continue;
+      }
+      int no = pilha_indice[topo];
+      const CaixasQuantizadas& c = caixas_largas[no];
+
+      //Cada filho e testado pelo nucleo de caixas do pacote e os atingidos sao empilhados do mais distante para o mais proximo
+      double min[LARGURA_BVH_MAXIMA][3], max[LARGURA_BVH_MAXIMA][3];
+      caixas_filhos(c, min, max);
+      double t_filhos[LARGURA_BVH_MAXIMA];
+      int ordem[LARGURA_BVH_MAXIMA];
+      int n = 0;
+      for (int i = 0; i < c.n_filhos; i++){
+	if (intercepta_caixa_pacote(p, min[i], max[i], &t_filhos[i])){
+	  int j = n++;
+	  while (j > 0 && t_filhos[ordem[j - 1]] <= t_filhos[i]){
+	    ordem[j] = ordem[j - 1];
+	    j--;
+	  }
+	  ordem[j] = i;
+	}
+      }
+      const FilhosLargos& f = filhos_largos[no];
+      for (int j = 0; j < n; j++){
+	pilha_indice[topo] = f.indice[ordem[j]];
+	pilha_n[topo++] = f.n_primitivas[ordem[j]];
+      }
+    }
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
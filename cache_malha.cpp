@@ -0,0 +1,396 @@
+/**
+ * \file cache_malha.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo cache_malha.hpp, sendo este responsavel pelo cache binario
+ * das malhas de triangulos.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "cache_malha.hpp"	//rayTracing::MalhaMapeada
+#include "cena.hpp"		//rayTracing::Cena
+#include "cena_compilada.hpp"	//rayTracing::CenaCompilada
+#include "leitor_obj.hpp"	//rayTracing::carregar_obj
+#include "memoria.hpp"		//rayTracing::arredonda_linha_cache
+#include <stdio.h>		//fopen, fwrite, rename, snprintf
+#include <string.h>		//memcmp, memset
+#include <fcntl.h>		//open
+#include <unistd.h>		//close, getpid
+#include <sys/mman.h>		//mmap, munmap
+#include <sys/stat.h>		//fstat
+#include <vector>		//vector
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //Assinatura do inicio do arquivo de cache
+  static const char ASSINATURA_MALHA[8] = { 'R', 'T', 'M', 'A', 'L', 'H', 'A', '\0' };
+  //Marca gravada em marca_bytes; lida como os bytes 04 03 02 01 em um arquivo little-endian
+  static const uint32_t MARCA_BYTES = 0x01020304;
+  //Base e primo do hash FNV-1a de 64 bits
+  static const uint64_t FNV_BASE = 0xcbf29ce484222325UL;
+  static const uint64_t FNV_PRIMO = 0x100000001b3UL;
+  //Tamanho do bloco lido do arquivo a cada fread
+  static const size_t TAMANHO_BLOCO_HASH = 1 << 20;
+
+  /**
+   * \fn static bool maquina_little_endian();
+   *
+   * \brief Indica se a maquina guarda inteiros em little-endian, a ordem do formato do cache.
+   */
+  static bool
+  maquina_little_endian(){
+    uint32_t marca = MARCA_BYTES;
+    return *(const unsigned char*) &marca == 0x04;
+  }
+
+  /**
+   * \fn static void posicionar_secoes(CabecalhoMalha& c);
+   *
+   * \brief Calcula a posicao de cada secao a partir dos numeros de vertices, triangulos e nos do cabecalho. A mesma conta valida um
+   * cache na abertura.
+   */
+  static void
+  posicionar_secoes(CabecalhoMalha& c){
+    uint64_t posicao = arredonda_linha_cache(sizeof(CabecalhoMalha));
+    c.pos_vertices = posicao;
+    posicao += arredonda_linha_cache(3 * (size_t) c.n_vertices * sizeof(double));
+    c.pos_triangulos = posicao;
+    posicao += arredonda_linha_cache(3 * (size_t) c.n_triangulos * sizeof(int32_t));
+    c.pos_soa = posicao;
+    c.passo_soa = arredonda_linha_cache(((size_t) c.n_triangulos + LARGURA_ESFERAS - 1) * sizeof(double));
+    posicao += 9 * c.passo_soa;
+    c.pos_nos = posicao;
+    posicao += (size_t) c.n_nos * sizeof(NoBVH);
+    c.tamanho_total = posicao;
+  }
+
+  /**
+   * \fn static bool completar(FILE* arquivo, uint64_t posicao);
+   *
+   * \brief Preenche o arquivo com zeros ate a posicao dada (inicio da proxima secao).
+   */
+  static bool
+  completar(FILE* arquivo, uint64_t posicao){
+    static const char zeros[LINHA_CACHE] = { 0 };
+    long atual = ftell(arquivo);
+    if (atual < 0 || (uint64_t) atual > posicao){
+      return false;
+    }
+    size_t falta = (size_t) (posicao - atual);
+    while (falta > 0){
+      size_t n = (falta < LINHA_CACHE) ? falta : LINHA_CACHE;
+      if (fwrite(zeros, 1, n, arquivo) != n){
+	return false;
+      }
+      falta -= n;
+    }
+    return true;
+  }
+
+  /**
+   * \fn bool hash_arquivo(const char* nome_arquivo, uint64_t* hash, uint64_t* tamanho);
+   *
+   * \brief Calcula o hash FNV-1a de 64 bits e o tamanho de um arquivo, lendo-o em blocos.
+   *
+   * \return false se o arquivo nao pode ser lido.
+   */
+  bool
+  hash_arquivo(const char* nome_arquivo, uint64_t* hash, uint64_t* tamanho){
+    FILE* arquivo = fopen(nome_arquivo, "rb");
+    if (arquivo == NULL){
+      return false;
+    }
+    unsigned char* bloco = new unsigned char[TAMANHO_BLOCO_HASH];
+    uint64_t h = FNV_BASE;
+    uint64_t total = 0;
+    size_t lidos;
+    while ((lidos = fread(bloco, 1, TAMANHO_BLOCO_HASH, arquivo)) > 0){
+      for (size_t k = 0; k < lidos; k++){
+	h = (h ^ bloco[k]) * FNV_PRIMO;
+      }
+      total += lidos;
+    }
+    delete[] bloco;
+    bool erro = ferror(arquivo) != 0;
+    fclose(arquivo);
+    *hash = h;
+    *tamanho = total;
+    return !erro;
+  }
+
+  /**
+   * \fn static bool nos_validos(const NoBVH* nos, int n_nos, int n_triangulos);
+   *
+   * \brief Confere os nos mapeados antes que as consultas confiem neles. Os nos sao percorridos em profundidade, filho esquerdo
+   * primeiro, e o k-esimo no visitado deve ser o no k: assim cada no pertence a arvore exatamente uma vez, o filho direito vem depois
+   * da subarvore esquerda e nao ha ciclos. As folhas devem citar triangulos existentes e a profundidade deve caber na pilha das
+   * consultas, como na construcao.
+   *
+   * \return false se algum no estiver corrompido.
+   */
+  static bool
+  nos_validos(const NoBVH* nos, int n_nos, int n_triangulos){
+    if (n_nos == 0){
+      return true;
+    }
+    //Pilha de (no, profundidade)
+    std::vector<int> pilha;
+    pilha.push_back(0);
+    pilha.push_back(0);
+    int proximo = 0;
+    while (!pilha.empty()){
+      int profundidade = pilha.back(); pilha.pop_back();
+      int i = pilha.back(); pilha.pop_back();
+      if (i != proximo || i >= n_nos || profundidade > BVH::PROFUNDIDADE_MAXIMA - 2){
+	return false;
+      }
+      proximo++;
+      const NoBVH& no = nos[i];
+      if (no.n_primitivas > 0){
+	if (no.indice < 0 || (int64_t) no.indice + no.n_primitivas > n_triangulos){
+	  return false;
+	}
+      }
+      else if (no.n_primitivas < 0 || no.indice <= i + 1 || no.indice >= n_nos){
+	return false;
+      }
+      else{
+	pilha.push_back(no.indice);
+	pilha.push_back(profundidade + 1);
+	pilha.push_back(i + 1);
+	pilha.push_back(profundidade + 1);
+      }
+    }
+    return proximo == n_nos;
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn MalhaMapeada::MalhaMapeada();
+   *
+   * \brief Construtor da classe. A malha inicial esta fechada.
+   */
+  MalhaMapeada::MalhaMapeada(){
+    mapa = NULL;
+    tamanho_mapa = 0;
+    cabecalho = NULL;
+  }
+
+  /**
+   * \fn MalhaMapeada::~MalhaMapeada();
+   *
+   * \brief Destrutor da classe. Desfaz o mapeamento.
+   */
+  MalhaMapeada::~MalhaMapeada(){
+    fechar();
+  }
+
+  /**
+   * \fn bool MalhaMapeada::abrir(const char* nome_cache, uint64_t hash_fonte, uint64_t tamanho_fonte, double escala,
+   * const Vetor& deslocamento);
+   *
+   * \brief Mapeia o arquivo de cache, somente leitura. Apenas o cabecalho e os nos da BVH sao lidos aqui (os nos, para conferir
+   * que estao integros); as demais secoes sao lidas do disco pelo sistema quando a renderizacao as consulta.
+   *
+   * \return false se o cache nao existe, e de outra versao, esta desatualizado ou tem nos corrompidos; a malha fica fechada.
+   */
+  bool
+  MalhaMapeada::abrir(const char* nome_cache, uint64_t hash_fonte, uint64_t tamanho_fonte, double escala, const Vetor& deslocamento){
+    fechar();
+    if (!maquina_little_endian()){
+      return false;
+    }
+    int descritor = open(nome_cache, O_RDONLY);
+    if (descritor < 0){
+      return false;
+    }
+    struct stat estado;
+    if (fstat(descritor, &estado) != 0 || (size_t) estado.st_size < sizeof(CabecalhoMalha)){
+      close(descritor);
+      return false;
+    }
+    void* m = mmap(NULL, (size_t) estado.st_size, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor);
+    if (m == MAP_FAILED){
+      return false;
+    }
+    const CabecalhoMalha* c = (const CabecalhoMalha*) m;
+
+    //As posicoes das secoes sao recalculadas a partir dos numeros de elementos e comparadas com as gravadas
+    CabecalhoMalha esperado;
+    memset(&esperado, 0, sizeof(esperado));
+    esperado.n_vertices = c->n_vertices;
+    esperado.n_triangulos = c->n_triangulos;
+    esperado.n_nos = c->n_nos;
+    bool valido = memcmp(c->assinatura, ASSINATURA_MALHA, sizeof(ASSINATURA_MALHA)) == 0 && c->versao == VERSAO_CACHE_MALHA &&
+      c->marca_bytes == MARCA_BYTES && c->tamanho_no == sizeof(NoBVH) &&
+      c->n_vertices >= 0 && c->n_triangulos >= 0 && c->n_nos >= 0 && c->n_nos <= 2 * c->n_triangulos;
+    if (valido){
+      posicionar_secoes(esperado);
+      valido = c->pos_vertices == esperado.pos_vertices && c->pos_triangulos == esperado.pos_triangulos &&
+	c->pos_soa == esperado.pos_soa && c->passo_soa == esperado.passo_soa && c->pos_nos == esperado.pos_nos &&
+	c->tamanho_total == esperado.tamanho_total && c->tamanho_total == (uint64_t) estado.st_size;
+    }
+    valido = valido && c->hash_fonte == hash_fonte && c->tamanho_fonte == tamanho_fonte && c->escala == escala &&
+      c->deslocamento[0] == deslocamento.vx() && c->deslocamento[1] == deslocamento.vy() && c->deslocamento[2] == deslocamento.vz();
+    valido = valido && nos_validos((const NoBVH*) ((const char*) m + c->pos_nos), c->n_nos, c->n_triangulos);
+    if (!valido){
+      munmap(m, (size_t) estado.st_size);
+      return false;
+    }
+    mapa = m;
+    tamanho_mapa = (size_t) estado.st_size;
+    cabecalho = c;
+    return true;
+  }
+
+  /**
+   * \fn void MalhaMapeada::fechar();
+   *
+   * \brief Desfaz o mapeamento.
+   */
+  void
+  MalhaMapeada::fechar(){
+    if (mapa != NULL){
+      munmap(mapa, tamanho_mapa);
+    }
+    mapa = NULL;
+    tamanho_mapa = 0;
+    cabecalho = NULL;
+  }
+
+  /**
+   * \fn bool MalhaMapeada::gravar(const char* nome_cache, uint64_t hash_fonte, uint64_t tamanho_fonte, double escala,
+   * const Vetor& deslocamento, const ArmazemPrimitivas& armazem, const CenaCompilada& cena);
+   *
+   * \brief Grava o cache de uma malha em um arquivo temporario e o renomeia para nome_cache.
+   *
+   * \return false se o arquivo nao pode ser gravado.
+   */
+  bool
+  MalhaMapeada::gravar(const char* nome_cache, uint64_t hash_fonte, uint64_t tamanho_fonte, double escala, const Vetor& deslocamento,
+		       const ArmazemPrimitivas& armazem, const CenaCompilada& cena){
+    if (!maquina_little_endian()){
+      return false;
+    }
+    CabecalhoMalha c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.assinatura, ASSINATURA_MALHA, sizeof(ASSINATURA_MALHA));
+    c.versao = VERSAO_CACHE_MALHA;
+    c.marca_bytes = MARCA_BYTES;
+    c.hash_fonte = hash_fonte;
+    c.tamanho_fonte = tamanho_fonte;
+    c.escala = escala;
+    c.deslocamento[0] = deslocamento.vx();
+    c.deslocamento[1] = deslocamento.vy();
+    c.deslocamento[2] = deslocamento.vz();
+    c.tamanho_no = sizeof(NoBVH);
+    c.n_vertices = armazem.numero_vertices();
+    c.n_triangulos = cena.numero_triangulos();
+    c.n_nos = cena.bvh_triangulos().numero_nos();
+    posicionar_secoes(c);
+
+    char temporario[4096];
+    if (snprintf(temporario, sizeof(temporario), "%s.%d.tmp", nome_cache, (int) getpid()) >= (int) sizeof(temporario)){
+      return false;
+    }
+    FILE* arquivo = fopen(temporario, "wb");
+    if (arquivo == NULL){
+      return false;
+    }
+    bool ok = fwrite(&c, sizeof(c), 1, arquivo) == 1;
+
+    ok = ok && completar(arquivo, c.pos_vertices);
+    ok = ok && fwrite(armazem.vertices(), sizeof(double), 3 * (size_t) c.n_vertices, arquivo) == 3 * (size_t) c.n_vertices;
+
+    //Os triangulos sao gravados na ordem da BVH, a mesma dos vetores SoA
+    ok = ok && completar(arquivo, c.pos_triangulos);
+    const int* ordem = cena.bvh_triangulos().ordem();
+    for (int k = 0; ok && k < c.n_triangulos; k++){
+      ok = fwrite(armazem.triangulos() + 3 * ordem[k], sizeof(int32_t), 3, arquivo) == 3;
+    }
+
+    TriangulosSoA tri = cena.triangulos();
+    const double* soa[9] = { tri.v0x, tri.v0y, tri.v0z, tri.e1x, tri.e1y, tri.e1z, tri.e2x, tri.e2y, tri.e2z };
+    size_t n_soa = (size_t) c.n_triangulos + LARGURA_ESFERAS - 1;
+    for (int k = 0; ok && k < 9; k++){
+      ok = completar(arquivo, c.pos_soa + k * c.passo_soa) && fwrite(soa[k], sizeof(double), n_soa, arquivo) == n_soa;
+    }
+
+    ok = ok && completar(arquivo, c.pos_nos);
+    if (c.n_nos > 0){
+      ok = ok && fwrite(&cena.bvh_triangulos().no(0), sizeof(NoBVH), c.n_nos, arquivo) == (size_t) c.n_nos;
+    }
+    ok = (fclose(arquivo) == 0) && ok;
+    if (!ok || rename(temporario, nome_cache) != 0){
+      remove(temporario);
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * \fn bool carregar_obj_cache(const char* nome_obj, const char* nome_cache, MalhaMapeada& malha, double escala,
+   * const Vetor& deslocamento, bool* do_cache, int* linha_erro, const char** mensagem_erro);
+   *
+   * \brief Abre a malha de um arquivo OBJ pelo cache, refazendo o cache quando o hash do OBJ nao confere ou o cache esta corrompido.
+   *
+   * \return false se o OBJ nao pode ser lido ou o cache nao pode ser gravado.
+   */
+  bool
+  carregar_obj_cache(const char* nome_obj, const char* nome_cache, MalhaMapeada& malha, double escala, const Vetor& deslocamento,
+		     bool* do_cache, int* linha_erro, const char** mensagem_erro){
+    if (do_cache != NULL) *do_cache = false;
+    uint64_t hash, tamanho;
+    if (!hash_arquivo(nome_obj, &hash, &tamanho)){
+      if (linha_erro != NULL) *linha_erro = 0;
+      if (mensagem_erro != NULL) *mensagem_erro = "nao foi possivel abrir o arquivo";
+      return false;
+    }
+    if (malha.abrir(nome_cache, hash, tamanho, escala, deslocamento)){
+      if (do_cache != NULL) *do_cache = true;
+      return true;
+    }
+
+    //Cache ausente ou desatualizado: a malha e lida e compilada sozinha, e o resultado e gravado
+    Cena cena_malha;
+    ArmazemPrimitivas& armazem = cena_malha.primitivas();
+    if (!carregar_obj(nome_obj, armazem, 0, escala, deslocamento, linha_erro, mensagem_erro)){
+      return false;
+    }
+    CenaCompilada compilada;
+    if (!compilada.compilar(&cena_malha)){
+      if (linha_erro != NULL) *linha_erro = 0;
+      if (mensagem_erro != NULL) *mensagem_erro = "sem memoria para compilar a malha";
+      return false;
+    }
+    if (!MalhaMapeada::gravar(nome_cache, hash, tamanho, escala, deslocamento, armazem, compilada) ||
+	!malha.abrir(nome_cache, hash, tamanho, escala, deslocamento)){
+      if (linha_erro != NULL) *linha_erro = 0;
+      if (mensagem_erro != NULL) *mensagem_erro = "nao foi possivel gravar o cache da malha";
+      return false;
+    }
+    return true;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
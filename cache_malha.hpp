@@ -0,0 +1,278 @@
+/**
+ * \file cache_malha.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo cache_malha.cpp, sendo
+ * este responsavel pelo cache binario das malhas de triangulos. Na primeira leitura de um arquivo OBJ a malha ja triangulada, os
+ * vetores SoA do teste de interseccao e a BVH construida sao gravados em um arquivo binario; nas execucoes seguintes esse arquivo e
+ * mapeado em memoria (mmap) e usado diretamente pela cena compilada, sem copia e sem reconstrucao, com as paginas lidas do disco
+ * apenas quando tocadas. O cache e invalidado pelo hash do arquivo OBJ.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _CACHE_MALHA_HPP
+#define _CACHE_MALHA_HPP
+
+#include <stddef.h>		//size_t
+#include <stdint.h>		//uint32_t, uint64_t
+#include "vetor.hpp"		//rayTracing::Vetor
+#include "bvh.hpp"		//rayTracing::NoBVH
+#include "nucleos.hpp"		//rayTracing::TriangulosSoA
+#include "primitivas.hpp"	//rayTracing::ArmazemPrimitivas
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  class CenaCompilada;
+
+  /**
+   * \brief Versao do formato do cache. Deve ser incrementada a cada mudanca do formato ou da construcao da BVH, para que caches
+   * antigos sejam refeitos.
+   */
+  const uint32_t VERSAO_CACHE_MALHA = 1;
+
+  /**
+   * \struct CabecalhoMalha
+   *
+   * \brief Cabecalho de 128 bytes do arquivo de cache, seguido das secoes, cada uma alinhada a linha de cache: vertices (x, y, z em
+   * double), triangulos (tres indices int32, na ordem da BVH), os nove vetores SoA de CenaCompilada::triangulos() (cada um com
+   * passo_soa bytes) e os nos da BVH. Todos os campos sao little-endian; o formato nao e lido nem gravado em maquinas big-endian.
+   */
+  struct CabecalhoMalha{
+    char assinatura[8];		///< "RTMALHA" e '\\0'
+    uint32_t versao;		///< VERSAO_CACHE_MALHA
+    uint32_t marca_bytes;	///< 0x01020304, para reconhecer a ordem dos bytes
+    uint64_t hash_fonte;	///< Hash FNV-1a de 64 bits do arquivo OBJ
+    uint64_t tamanho_fonte;	///< Tamanho do arquivo OBJ em bytes
+    double escala;		///< Escala aplicada aos vertices
+    double deslocamento[3];	///< Translacao aplicada aos vertices
+    uint32_t tamanho_no;	///< sizeof(NoBVH) de quem gravou
+    int32_t n_vertices;		///< Numero de vertices
+    int32_t n_triangulos;	///< Numero de triangulos
+    int32_t n_nos;		///< Numero de nos da BVH
+    uint64_t pos_vertices;	///< Posicao da secao de vertices
+    uint64_t pos_triangulos;	///< Posicao da secao de triangulos
+    uint64_t pos_soa;		///< Posicao do primeiro vetor SoA
+    uint64_t passo_soa;		///< Bytes de cada vetor SoA
+    uint64_t pos_nos;		///< Posicao da secao de nos
+    uint64_t tamanho_total;	///< Tamanho do arquivo
+  };
+
+  /**
+   * \fn bool hash_arquivo(const char* nome_arquivo, uint64_t* hash, uint64_t* tamanho);
+   *
+   * \brief Calcula o hash FNV-1a de 64 bits e o tamanho de um arquivo.
+   *
+   * \return false se o arquivo nao pode ser lido.
+   */
+  bool hash_arquivo(const char* nome_arquivo, uint64_t* hash, uint64_t* tamanho);
+
+  /**
+   * \class MalhaMapeada
+   *
+   * \brief Malha de triangulos mapeada de um arquivo de cache. Os vetores retornados apontam para o mapeamento e so valem enquanto a
+   * malha estiver aberta.
+   */
+  class MalhaMapeada{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    void* mapa;				///< Inicio do mapeamento (NULL se fechada)
+    size_t tamanho_mapa;		///< Tamanho do mapeamento
+    const CabecalhoMalha* cabecalho;	///< Cabecalho, no inicio do mapeamento
+
+    //Copia nao permitida
+    MalhaMapeada(const MalhaMapeada&);
+    MalhaMapeada& operator=(const MalhaMapeada&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn MalhaMapeada();
+     *
+     * \brief Construtor da classe. A malha inicial esta fechada.
+     */
+    MalhaMapeada();
+
+    /**
+     * \fn ~MalhaMapeada();
+     *
+     * \brief Destrutor da classe. Desfaz o mapeamento.
+     */
+    ~MalhaMapeada();
+
+    /**
+     * \fn bool abrir(const char* nome_cache, uint64_t hash_fonte, uint64_t tamanho_fonte, double escala, const Vetor& deslocamento);
+     *
+     * \brief Mapeia o arquivo de cache, somente leitura. O cache so e aceito se o formato, a versao, a ordem dos bytes e o tamanho
+     * das secoes estiverem corretos, se o hash e o tamanho do OBJ, a escala e o deslocamento forem os informados e se os nos da BVH
+     * formarem uma arvore valida (filhos dentro do vetor, folhas dentro dos triangulos, profundidade dentro da pilha das consultas).
+     *
+     * \return false se o cache nao existe, e de outra versao, esta desatualizado ou tem nos corrompidos; a malha fica fechada.
+     */
+    bool abrir(const char* nome_cache, uint64_t hash_fonte, uint64_t tamanho_fonte, double escala, const Vetor& deslocamento);
+
+    /**
+     * \fn void fechar();
+     *
+     * \brief Desfaz o mapeamento.
+     */
+    void fechar();
+
+    /**
+     * \fn static bool gravar(const char* nome_cache, uint64_t hash_fonte, uint64_t tamanho_fonte, double escala,
+     * const Vetor& deslocamento, const ArmazemPrimitivas& armazem, const CenaCompilada& cena);
+     *
+     * \brief Grava o cache de uma malha. O armazem deve conter apenas os triangulos da malha, e a cena deve ter sido compilada a partir
+     * dele. O arquivo e escrito com outro nome e renomeado no fim, de modo que um leitor concorrente nunca veja um cache incompleto.
+     *
+     * \return false se o arquivo nao pode ser gravado.
+     */
+    static bool gravar(const char* nome_cache, uint64_t hash_fonte, uint64_t tamanho_fonte, double escala, const Vetor& deslocamento,
+		       const ArmazemPrimitivas& armazem, const CenaCompilada& cena);
+
+    /**
+     * \fn bool aberta() const;
+     *
+     * \brief Indica se ha um cache mapeado.
+     */
+    bool aberta() const;
+
+    /**
+     * \fn int numero_vertices() const;
+     *
+     * \brief Retorna o numero de vertices.
+     */
+    int numero_vertices() const;
+
+    /**
+     * \fn const double* vertices() const;
+     *
+     * \brief Retorna as coordenadas x, y e z de cada vertice, em sequencia.
+     */
+    const double* vertices() const;
+
+    /**
+     * \fn int numero_triangulos() const;
+     *
+     * \brief Retorna o numero de triangulos.
+     */
+    int numero_triangulos() const;
+
+    /**
+     * \fn const int* triangulos() const;
+     *
+     * \brief Retorna os indices dos tres vertices de cada triangulo, na ordem da BVH.
+     */
+    const int* triangulos() const;
+
+    /**
+     * \fn TriangulosSoA triangulos_soa() const;
+     *
+     * \brief Retorna os vetores SoA dos triangulos, na ordem da BVH e com o mesmo preenchimento de CenaCompilada::triangulos().
+     */
+    TriangulosSoA triangulos_soa() const;
+
+    /**
+     * \fn int numero_nos() const;
+     *
+     * \brief Retorna o numero de nos da BVH.
+     */
+    int numero_nos() const;
+
+    /**
+     * \fn const NoBVH* nos() const;
+     *
+     * \brief Retorna os nos da BVH.
+     */
+    const NoBVH* nos() const;
+  };
+
+  /**
+   * \fn bool carregar_obj_cache(const char* nome_obj, const char* nome_cache, MalhaMapeada& malha, double escala = 1.0,
+   * const Vetor& deslocamento = Vetor(), bool* do_cache = NULL, int* linha_erro = NULL, const char** mensagem_erro = NULL);
+   *
+   * \brief Abre a malha de um arquivo OBJ pelo cache: se o cache estiver valido ele e apenas mapeado; caso contrario o OBJ e lido
+   * com carregar_obj, a BVH e construida, o cache e gravado e entao mapeado.
+   *
+   * \param do_cache - recebe true se o cache ja estava valido
+   * \param linha_erro, mensagem_erro - como em carregar_obj
+   *
+   * \return false se o OBJ nao pode ser lido ou o cache nao pode ser gravado.
+   */
+  bool carregar_obj_cache(const char* nome_obj, const char* nome_cache, MalhaMapeada& malha, double escala = 1.0,
+			  const Vetor& deslocamento = Vetor(), bool* do_cache = NULL, int* linha_erro = NULL,
+			  const char** mensagem_erro = NULL);
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline bool
+  MalhaMapeada::aberta() const{
+    return mapa != NULL;
+  }
+
+  inline int
+  MalhaMapeada::numero_vertices() const{
+    return cabecalho->n_vertices;
+  }
+
+  inline const double*
+  MalhaMapeada::vertices() const{
+    return (const double*) ((const char*) mapa + cabecalho->pos_vertices);
+  }
+
+  inline int
+  MalhaMapeada::numero_triangulos() const{
+    return cabecalho->n_triangulos;
+  }
+
+  inline const int*
+  MalhaMapeada::triangulos() const{
+    return (const int*) ((const char*) mapa + cabecalho->pos_triangulos);
+  }
+
+  inline TriangulosSoA
+  MalhaMapeada::triangulos_soa() const{
+    const char* soa = (const char*) mapa + cabecalho->pos_soa;
+    size_t passo = cabecalho->passo_soa;
+    TriangulosSoA tri;
+    tri.v0x = (const double*) (soa + 0 * passo); tri.v0y = (const double*) (soa + 1 * passo); tri.v0z = (const double*) (soa + 2 * passo);
+    tri.e1x = (const double*) (soa + 3 * passo); tri.e1y = (const double*) (soa + 4 * passo); tri.e1z = (const double*) (soa + 5 * passo);
+    tri.e2x = (const double*) (soa + 6 * passo); tri.e2y = (const double*) (soa + 7 * passo); tri.e2z = (const double*) (soa + 8 * passo);
+    return tri;
+  }
+
+  inline int
+  MalhaMapeada::numero_nos() const{
+    return cabecalho->n_nos;
+  }
+
+  inline const NoBVH*
+  MalhaMapeada::nos() const{
+    return (const NoBVH*) ((const char*) mapa + cabecalho->pos_nos);
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
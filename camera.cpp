@@ -0,0 +1,250 @@
+/**
+ * \file camera.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo camera.hpp, sendo este responsavel pela geracao dos raios
+ * primarios a partir de uma camera montada uma unica vez por quadro.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "camera.hpp"	//rayTracing::Camera
+#include <math.h>	//tan
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \fn static void multiplica_matrizes(const double m[16], const double n[16], double r[16]);
+   *
+   * \brief Calcula r = m * n para matrizes 4x4 armazenadas por coluna (convencao do OpenGL).
+   */
+  static void
+  multiplica_matrizes(const double m[16], const double n[16], double r[16]){
+    for (int col = 0; col < 4; col++){
+      for (int lin = 0; lin < 4; lin++){
+	r[col*4 + lin] = m[0*4 + lin] * n[col*4 + 0] + m[1*4 + lin] * n[col*4 + 1]
+	  + m[2*4 + lin] * n[col*4 + 2] + m[3*4 + lin] * n[col*4 + 3];
+      }
+    }
+  }
+
+  /**
+   * \fn static bool inverte_matriz(const double m[16], double inv[16]);
+   *
+   * \brief Inverte uma matriz 4x4 pela matriz adjunta.
+   *
+   * \return false se a matriz nao for inversivel.
+   */
+  static bool
+  inverte_matriz(const double m[16], double inv[16]){
+    double t[16];
+    t[0] = m[5]*m[10]*m[15] - m[5]*m[11]*m[14] - m[9]*m[6]*m[15] + m[9]*m[7]*m[14] + m[13]*m[6]*m[11] - m[13]*m[7]*m[10];
+    t[4] = -m[4]*m[10]*m[15] + m[4]*m[11]*m[14] + m[8]*m[6]*m[15] - m[8]*m[7]*m[14] - m[12]*m[6]*m[11] + m[12]*m[7]*m[10];
+    t[8] = m[4]*m[9]*m[15] - m[4]*m[11]*m[13] - m[8]*m[5]*m[15] + m[8]*m[7]*m[13] + m[12]*m[5]*m[11] - m[12]*m[7]*m[9];
+    t[12] = -m[4]*m[9]*m[14] + m[4]*m[10]*m[13] + m[8]*m[5]*m[14] - m[8]*m[6]*m[13] - m[12]*m[5]*m[10] + m[12]*m[6]*m[9];
+    t[1] = -m[1]*m[10]*m[15] + m[1]*m[11]*m[14] + m[9]*m[2]*m[15] - m[9]*m[3]*m[14] - m[13]*m[2]*m[11] + m[13]*m[3]*m[10];
+    t[5] = m[0]*m[10]*m[15] - m[0]*m[11]*m[14] - m[8]*m[2]*m[15] + m[8]*m[3]*m[14] + m[12]*m[2]*m[11] - m[12]*m[3]*m[10];
+    t[9] = -m[0]*m[9]*m[15] + m[0]*m[11]*m[13] + m[8]*m[1]*m[15] - m[8]*m[3]*m[13] - m[12]*m[1]*m[11] + m[12]*m[3]*m[9];
+    t[13] = m[0]*m[9]*m[14] - m[0]*m[10]*m[13] - m[8]*m[1]*m[14] + m[8]*m[2]*m[13] + m[12]*m[1]*m[10] - m[12]*m[2]*m[9];
+    t[2] = m[1]*m[6]*m[15] - m[1]*m[7]*m[14] - m[5]*m[2]*m[15] + m[5]*m[3]*m[14] + m[13]*m[2]*m[7] - m[13]*m[3]*m[6];
+    t[6] = -m[0]*m[6]*m[15] + m[0]*m[7]*m[14] + m[4]*m[2]*m[15] - m[4]*m[3]*m[14] - m[12]*m[2]*m[7] + m[12]*m[3]*m[6];
+    t[10] = m[0]*m[5]*m[15] - m[0]*m[7]*m[13] - m[4]*m[1]*m[15] + m[4]*m[3]*m[13] + m[12]*m[1]*m[7] - m[12]*m[3]*m[5];
+    t[14] = -m[0]*m[5]*m[14] + m[0]*m[6]*m[13] + m[4]*m[1]*m[14] - m[4]*m[2]*m[13] - m[12]*m[1]*m[6] + m[12]*m[2]*m[5];
+    t[3] = -m[1]*m[6]*m[11] + m[1]*m[7]*m[10] + m[5]*m[2]*m[11] - m[5]*m[3]*m[10] - m[9]*m[2]*m[7] + m[9]*m[3]*m[6];
+    t[7] = m[0]*m[6]*m[11] - m[0]*m[7]*m[10] - m[4]*m[2]*m[11] + m[4]*m[3]*m[10] + m[8]*m[2]*m[7] - m[8]*m[3]*m[6];
+    t[11] = -m[0]*m[5]*m[11] + m[0]*m[7]*m[9] + m[4]*m[1]*m[11] - m[4]*m[3]*m[9] - m[8]*m[1]*m[7] + m[8]*m[3]*m[5];
+    t[15] = m[0]*m[5]*m[10] - m[0]*m[6]*m[9] - m[4]*m[1]*m[10] + m[4]*m[2]*m[9] + m[8]*m[1]*m[6] - m[8]*m[2]*m[5];
+
+    double det = m[0]*t[0] + m[1]*t[4] + m[2]*t[8] + m[3]*t[12];
+    if (det == 0.0){
+      return false;
+    }
+    for (int k = 0; k < 16; k++){
+      inv[k] = t[k] / det;
+    }
+    return true;
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn Camera::Camera();
+   *
+   * \brief Construtor da classe. A camera inicial e ortografica com a janela no plano z = 0.
+   */
+  Camera::Camera(){
+    for (int k = 0; k < 4; k++){
+      a[k] = 0.0;
+      b[k] = 0.0;
+      c[k] = 0.0;
+    }
+    a[3] = 1.0;
+    b[0] = 1.0;
+    c[1] = 1.0;
+  }
+
+  /**
+   * \fn bool Camera::de_matrizes(const Vetor& lookfrom, const double model[16], const double proj[16], const int view[4], double winZ);
+   *
+   * \brief Monta a camera a partir das matrizes modelview, projection e viewport. A coordenada normalizada do gluUnProject
+   * \f$ n = (2(x - v_0)/v_2 - 1, 2(y - v_1)/v_3 - 1, 2 winZ - 1, 1) \f$ e afim em x e y, portanto \f$ M^{-1} n \f$ tambem e:
+   * as colunas de \f$ M^{-1} \f$ sao combinadas uma unica vez em A, B e C.
+   */
+  bool
+  Camera::de_matrizes(const Vetor& lookfrom, const double model[16], const double proj[16], const int view[4], double winZ){
+    double final[16], inv[16];
+    multiplica_matrizes(proj, model, final);
+    if (!inverte_matriz(final, inv)){
+      return false;
+    }
+    origem = lookfrom;
+
+    double sx = 2.0 / view[2];
+    double sy = 2.0 / view[3];
+    double nx0 = -2.0 * view[0] / view[2] - 1.0;	//Coordenada normalizada de x = 0
+    double ny0 = -2.0 * view[1] / view[3] - 1.0;	//Coordenada normalizada de y = 0
+    double nz = 2.0 * winZ - 1.0;
+    for (int lin = 0; lin < 4; lin++){
+      b[lin] = inv[0*4 + lin] * sx;
+      c[lin] = inv[1*4 + lin] * sy;
+      a[lin] = inv[0*4 + lin] * nx0 + inv[1*4 + lin] * ny0 + inv[2*4 + lin] * nz + inv[3*4 + lin];
+    }
+    return true;
+  }
+
+  /**
+   * \fn bool Camera::de_lookat(const Vetor& lookfrom, const Vetor& lookat, const Vetor& up, double fov, int lado, int altura);
+   *
+   * \brief Monta uma camera perspectiva a partir de lookfrom, lookat, up e da abertura vertical. A base e recusada se w x up for
+   * nulo diante de |up| (up paralelo a w), pois u seria NaN.
+   */
+  bool
+  Camera::de_lookat(const Vetor& lookfrom, const Vetor& lookat, const Vetor& up, double fov, int lado, int altura){
+    const double pi = 3.14159265358979323846;
+    const double seno_minimo = 1e-9;	//Seno minimo do angulo entre up e a direcao de visao
+
+    //Base ortonormal da camera: w aponta para a cena, u para a direita e v para cima
+    if (!((lookat - lookfrom).norma() > 0.0)){
+      return false;
+    }
+    Vetor w = (lookat - lookfrom).normalizado();
+    Vetor lateral = w.produto_vetorial(up);
+    if (!(lateral.norma() > seno_minimo * up.norma())){
+      return false;
+    }
+    Vetor u = lateral.normalizado();
+    Vetor v = u.produto_vetorial(w);
+    origem = lookfrom;
+
+    double meia_altura = tan((fov * pi / 180.0) / 2.0);
+    double meio_lado = meia_altura * lado / altura;
+    Vetor du = u * (2.0 * meio_lado / lado);
+    Vetor dv = v * (2.0 * meia_altura / altura);
+    Vetor canto = lookfrom + w - (u * meio_lado) - (v * meia_altura);
+
+    a[0] = canto.vx(); a[1] = canto.vy(); a[2] = canto.vz(); a[3] = 1.0;
+    b[0] = du.vx(); b[1] = du.vy(); b[2] = du.vz(); b[3] = 0.0;
+    c[0] = dv.vx(); c[1] = dv.vy(); c[2] = dv.vz(); c[3] = 0.0;
+    return true;
+  }
+
+  /**
+   * \fn bool Camera::de_janela_ortografica(const Vetor& lookfrom, int lado, int altura);
+   *
+   * \brief Monta a camera com as matrizes do visualizador (glOrtho(0, lado, 0, altura, -1, 1) e modelview identidade), sem OpenGL.
+   * As matrizes estao na ordem por colunas do OpenGL.
+   */
+  bool
+  Camera::de_janela_ortografica(const Vetor& lookfrom, int lado, int altura){
+    if (lado <= 0 || altura <= 0){
+      return false;
+    }
+    double model[16], proj[16];
+    for (int k = 0; k < 16; k++){
+      model[k] = (k % 5 == 0) ? 1.0 : 0.0;
+      proj[k] = 0.0;
+    }
+    proj[0] = 2.0 / lado;
+    proj[5] = 2.0 / altura;
+    proj[10] = -1.0;
+    proj[12] = -1.0;
+    proj[13] = -1.0;
+    proj[15] = 1.0;
+    int view[4] = {0, 0, lado, altura};
+    return de_matrizes(lookfrom, model, proj, view, 1.0);
+  }
+
+  /**
+   * \fn const Vetor& Camera::posicao() const;
+   *
+   * \brief Retorna a posicao da camera (origem dos raios primarios).
+   */
+  const Vetor&
+  Camera::posicao() const{
+    return origem;
+  }
+
+  /**
+   * \fn Vetor Camera::alvo(double x, double y) const;
+   *
+   * \brief Retorna o ponto de mundo (lookat) da coordenada de janela (x, y).
+   */
+  Vetor
+  Camera::alvo(double x, double y) const{
+    //Mesma ordem de operacoes de alvos_linha, para que os dois caminhos gerem pontos identicos
+    double w = (a[3] + y * c[3]) + x * b[3];
+    return Vetor(((a[0] + y * c[0]) + x * b[0]) / w,
+		 ((a[1] + y * c[1]) + x * b[1]) / w,
+		 ((a[2] + y * c[2]) + x * b[2]) / w);
+  }
+
+  /**
+   * \fn Vetor Camera::direcao(double x, double y) const;
+   *
+   * \brief Retorna a direcao (nao normalizada) do raio primario da coordenada de janela (x, y).
+   */
+  Vetor
+  Camera::direcao(double x, double y) const{
+    return alvo(x, y) - origem;
+  }
+
+  /**
+   * \fn void Camera::alvos_linha(double y, int x0, int n, double* ax, double* ay, double* az) const;
+   *
+   * \brief Calcula os pontos de mundo de n pixels consecutivos de uma linha da janela. Os termos que dependem apenas de y sao
+   * calculados fora do laco.
+   */
+  void
+  Camera::alvos_linha(double y, int x0, int n, double* ax, double* ay, double* az) const{
+    double lx = a[0] + y * c[0];
+    double ly = a[1] + y * c[1];
+    double lz = a[2] + y * c[2];
+    double lw = a[3] + y * c[3];
+    for (int k = 0; k < n; k++){
+      double x = (double)(x0 + k);
+      double w = lw + x * b[3];
+      ax[k] = (lx + x * b[0]) / w;
+      ay[k] = (ly + x * b[1]) / w;
+      az[k] = (lz + x * b[2]) / w;
+    }
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
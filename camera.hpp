@@ -0,0 +1,146 @@
+/**
+ * \file camera.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo camera.cpp, sendo este
+ * responsavel pela geracao dos raios primarios. A camera e montada uma unica vez por quadro (a partir das matrizes do OpenGL ou de
+ * lookfrom/lookat/up/fov) e depois fornece o ponto do plano de projecao de cada pixel com poucas multiplicacoes e somas, sem inverter
+ * matrizes por pixel como o gluUnProject.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _CAMERA_HPP
+#define _CAMERA_HPP
+
+#include "vetor.hpp"	//rayTracing::Vetor
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \class Camera
+   *
+   * \brief Gera os pontos de mundo (lookat de cada pixel) e as direcoes dos raios primarios. O ponto de mundo de uma coordenada de
+   * janela (x, y) e dado em coordenadas homogeneas por \f$ P = A + xB + yC \f$, seguido da divisao por \f$ P_w \f$.
+   */
+  class Camera{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    Vetor origem;	///< Posicao da camera (lookfrom)
+    double a[4];	///< Ponto homogeneo da coordenada de janela (0, 0)
+    double b[4];	///< Variacao do ponto homogeneo por unidade de x da janela
+    double c[4];	///< Variacao do ponto homogeneo por unidade de y da janela
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn Camera();
+     *
+     * \brief Construtor da classe. A camera inicial e ortografica com a janela no plano z = 0.
+     */
+    Camera();
+
+    /**
+     * \fn bool de_matrizes(const Vetor& lookfrom, const double model[16], const double proj[16], const int view[4], double winZ);
+     *
+     * \brief Monta a camera a partir das matrizes modelview, projection e viewport (mesma convencao do gluUnProject). A matriz
+     * (projection * modelview) e invertida uma unica vez.
+     *
+     * \param lookfrom - posicao da camera
+     * \param model, proj, view - matrizes modelview, projection e viewport
+     * \param winZ - profundidade de janela do plano de projecao (1.0 e o plano distante)
+     *
+     * \return false se a matriz nao for inversivel.
+     */
+    bool de_matrizes(const Vetor& lookfrom, const double model[16], const double proj[16], const int view[4], double winZ);
+
+    /**
+     * \fn bool de_lookat(const Vetor& lookfrom, const Vetor& lookat, const Vetor& up, double fov, int lado, int altura);
+     *
+     * \brief Monta uma camera perspectiva. A janela [0, lado] x [0, altura] e mapeada no plano a distancia unitaria de lookfrom na
+     * direcao de lookat, com o eixo y da janela crescendo para cima.
+     *
+     * \param lookfrom - posicao da camera
+     * \param lookat - posicao para onde esta apontada a camera
+     * \param up - direcao "para cima" da camera
+     * \param fov - abertura vertical em graus
+     * \param lado, altura - dimensoes da janela em pixels
+     *
+     * \return false, sem alterar a camera, se a base da camera for degenerada: lookat igual a lookfrom ou up nulo ou paralelo a
+     * direcao de visao.
+     */
+    bool de_lookat(const Vetor& lookfrom, const Vetor& lookat, const Vetor& up, double fov, int lado, int altura);
+
+    /**
+     * \fn bool de_janela_ortografica(const Vetor& lookfrom, int lado, int altura);
+     *
+     * \brief Monta a camera com as mesmas matrizes que o visualizador usa na janela: modelview identidade, projecao
+     * glOrtho(0, lado, 0, altura, -1, 1) e viewport (0, 0, lado, altura), com os pontos de mundo no plano distante. Permite
+     * renderizar sem um contexto OpenGL a mesma imagem que o visualizador mostra.
+     *
+     * \param lookfrom - posicao da camera
+     * \param lado, altura - dimensoes da janela em pixels
+     *
+     * \return false se as dimensoes nao forem positivas.
+     */
+    bool de_janela_ortografica(const Vetor& lookfrom, int lado, int altura);
+
+    /**
+     * \fn const Vetor& posicao() const;
+     *
+     * \brief Retorna a posicao da camera (origem dos raios primarios).
+     */
+    const Vetor& posicao() const;
+
+    /**
+     * \fn Vetor alvo(double x, double y) const;
+     *
+     * \brief Retorna o ponto de mundo (lookat) da coordenada de janela (x, y).
+     */
+    Vetor alvo(double x, double y) const;
+
+    /**
+     * \fn Vetor direcao(double x, double y) const;
+     *
+     * \brief Retorna a direcao (nao normalizada) do raio primario da coordenada de janela (x, y), isto e, alvo(x, y) - posicao().
+     */
+    Vetor direcao(double x, double y) const;
+
+    /**
+     * \fn void alvos_linha(double y, int x0, int n, double* ax, double* ay, double* az) const;
+     *
+     * \brief Calcula os pontos de mundo de n pixels consecutivos de uma linha da janela. O laco nao possui dependencias entre as
+     * iteracoes e e vetorizado pelo compilador.
+     *
+     * \param y - coordenada y da janela
+     * \param x0 - primeira coordenada x
+     * \param n - numero de pixels
+     * \param ax, ay, az - coordenadas dos pontos (vetores com n posicoes)
+     */
+    void alvos_linha(double y, int x0, int n, double* ax, double* ay, double* az) const;
+  };
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
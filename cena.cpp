@@ -17,7 +17,6 @@
  
 #include "cena.hpp"		//rayTracing::Cena
 #include <iostream>	//std
-#include <list>		//list
 
 /** 
  * \defgroup RayTracingNameSpace Namespace rayTracing.
@@ -44,6 +43,9 @@ namespace rayTracing{
     background_g = 0.0;
     background_b = 0.0;
 		
+    //Constante ambiente
+    ka = 0.0;
+		
     //Atualizando tamanho
     n = 300;
     m = 300;
@@ -101,30 +103,40 @@ namespace rayTracing{
   }
 	
   /**
-   * \fn void Cena::incluir_objetos_pilha(Objeto* o);
+   * \fn bool Cena::incluir_objetos_pilha(const Objeto* o);
    *
-   * \brief Inclue um objeto na pilha.
+   * \brief Inclue um objeto na pilha. O material do objeto entra na tabela de materiais (sem repeticoes) e a geometria vai para o
+   * vetor do seu tipo.
    *
    * \param o - ponteiro para o objeto que devera ser colocado na pilha
+   *
+   * \return false se nao houver memoria no armazem.
    */
-  void 
-  Cena::incluir_objetos_pilha(Objeto* o){
-    obj.push_front(o);
+  bool 
+  Cena::incluir_objetos_pilha(const Objeto* o){
+    int material;
+    switch (o->tipo_primitiva()){
+    case PRIMITIVA_ESFERA:
+      material = armazem.incluir_material(o->cor_esfera(), o->kd_esfera(), o->ks_esfera(), o->brilho_esfera());
+      return material >= 0 && armazem.incluir_esfera(o->posicao_esfera(), o->raio(), material) != PRIMITIVA_NENHUMA;
+    case PRIMITIVA_PLANO:
+      material = armazem.incluir_material(o->cor_plano(), o->kd_plano(), o->ks_plano(), o->brilho_plano());
+      return material >= 0 && armazem.incluir_plano(o->posicao_plano(), o->normal_plano(), material) != PRIMITIVA_NENHUMA;
+    default:	//Triangulos entram pelas malhas (carregar_obj), direto no armazem
+      return true;
+    }
   }
 	
   /**
-   * \fn Objeto* Cena::excluir_objetos_pilha();
+   * \fn bool Cena::excluir_objetos_pilha();
    *
-   * \brief Exclue um objeto na pilha.
+   * \brief Exclue o ultimo objeto incluido na pilha.
+   *
+   * \return false se a pilha estava vazia.
    */
-  Objeto* 
+  bool 
   Cena::excluir_objetos_pilha(){
-    if (obj.size() != 0){
-      Objeto* aux = obj.front();
-      obj.pop_front();
-      return aux;
-    }
-    else return NULL;
+    return armazem.excluir_ultima();
   }
 	
   /**
@@ -136,7 +148,27 @@ namespace rayTracing{
    */
   int 
   Cena::size_objetos_pilha(){
-    return obj.size();
+    return armazem.numero_primitivas();
+  }
+	
+  /**
+   * \fn ArmazemPrimitivas& Cena::primitivas();
+   *
+   * \brief Permite incluir primitivas e materiais diretamente no armazem, sem passar por um Objeto.
+   */
+  ArmazemPrimitivas&
+  Cena::primitivas(){
+    return armazem;
+  }
+
+  /**
+   * \fn const ArmazemPrimitivas& Cena::primitivas() const;
+   *
+   * \brief Permite percorrer as primitivas da cena sem altera-la, podendo ser usado por varias threads ao mesmo tempo.
+   */
+  const ArmazemPrimitivas& 
+  Cena::primitivas() const{
+    return armazem;
   }
 	
   /**
@@ -19,8 +19,8 @@
 #define _CENA_HPP
 
 #include "objeto.hpp"	//rayTracing::Objeto
+#include "primitivas.hpp"	//rayTracing::ArmazemPrimitivas
 #include <iostream>	//std
-#include <list>		//list
 //#include "ImageClass.h"
 
 /** 
@@ -44,7 +44,7 @@ namespace rayTracing{
     //	Atributos privados
     //------------------------------
   private:
-    std::list<Objeto*> obj;	///< Pilha de objetos
+    ArmazemPrimitivas armazem;	///< Primitivas e materiais da cena
 			
     //Definindo cor do background
     double background_r; ///< cor r do background
@@ -105,20 +105,25 @@ namespace rayTracing{
     double cor_background_b();
 		
     /**
-     * \fn void incluir_objetos_pilha(Objeto* o);
+     * \fn bool incluir_objetos_pilha(const Objeto* o);
      *
-     * \brief Inclue um objeto na pilha.
+     * \brief Inclue um objeto na pilha. O material e a geometria do objeto sao copiados para o armazem de primitivas, de modo que o
+     * objeto pode ser descartado ou reutilizado em seguida.
      *
      * \param o - ponteiro para o objeto que devera ser colocado na pilha
+     *
+     * \return false se nao houver memoria no armazem.
      */
-    void incluir_objetos_pilha(Objeto* o);
+    bool incluir_objetos_pilha(const Objeto* o);
 		
     /**
-     * \fn Objeto* excluir_objetos_pilha();
+     * \fn bool excluir_objetos_pilha();
+     *
+     * \brief Exclue o ultimo objeto incluido na pilha.
      *
-     * \brief Exclue um objeto na pilha.
+     * \return false se a pilha estava vazia.
      */
-    Objeto* excluir_objetos_pilha();
+    bool excluir_objetos_pilha();
 		
     /**
      * \fn int size_objetos_pilha();
@@ -129,6 +134,20 @@ namespace rayTracing{
      */
     int size_objetos_pilha();
 		
+    /**
+     * \fn ArmazemPrimitivas& primitivas();
+     *
+     * \brief Permite incluir primitivas e materiais diretamente no armazem, sem passar por um Objeto.
+     */
+    ArmazemPrimitivas& primitivas();
+
+    /**
+     * \fn const ArmazemPrimitivas& primitivas() const;
+     *
+     * \brief Permite percorrer as primitivas da cena sem altera-la, podendo ser usado por varias threads ao mesmo tempo.
+     */
+    const ArmazemPrimitivas& primitivas() const;
+		
 		
     /**
      * \fn void atualizar_ka(double _ka);
@@ -0,0 +1,391 @@
+/**
+ * \file cena_compilada.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo cena_compilada.hpp, sendo este responsavel pela versao somente
+ * leitura da cena utilizada durante a renderizacao.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "cena_compilada.hpp"	//rayTracing::CenaCompilada
+#include "memoria.hpp"		//rayTracing::aloca_alinhado
+#include "nucleos.hpp"		//rayTracing::LARGURA_ESFERAS
+#include "raio.hpp"		//rayTracing::intercepta_plano
+#include "cache_malha.hpp"	//rayTracing::MalhaMapeada
+#include <string.h>		//memset
+#include <new>		//std::nothrow
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //------------------------------
+  //	Metodos privados
+  //------------------------------
+  /**
+   * \fn void CenaCompilada::liberar();
+   *
+   * \brief Libera os vetores e as BVHs da cena compilada.
+   */
+  void
+  CenaCompilada::liberar(){
+    libera_alinhado(centro_x);
+    libera_alinhado(centro_y);
+    libera_alinhado(centro_z);
+    libera_alinhado(raio2);
+    libera_alinhado(material_esferas);
+    libera_alinhado(vetor_planos);
+    libera_alinhado(material_planos);
+    for (int c = 0; c < 9; c++){
+      if (!triangulos_mapeados){
+	libera_alinhado(triangulo_soa[c]);
+      }
+      triangulo_soa[c] = NULL;
+    }
+    triangulos_mapeados = false;
+    nuvem = NULL;
+    libera_alinhado(material_triangulos);
+    libera_alinhado(materiais);
+    hierarquia.construir(NULL, 0);
+    hierarquia_triangulos.construir(NULL, 0);
+    centro_x = centro_y = centro_z = raio2 = NULL;
+    material_esferas = NULL;
+    vetor_planos = NULL;
+    material_planos = NULL;
+    material_triangulos = NULL;
+    materiais = NULL;
+    n_esferas = 0;
+    n_planos = 0;
+    n_triangulos = 0;
+    n_materiais = 0;
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn CenaCompilada::CenaCompilada();
+   *
+   * \brief Construtor da classe. A cena compilada inicial nao possui objetos.
+   */
+  CenaCompilada::CenaCompilada(){
+    centro_x = centro_y = centro_z = raio2 = NULL;
+    material_esferas = NULL;
+    vetor_planos = NULL;
+    material_planos = NULL;
+    for (int c = 0; c < 9; c++){
+      triangulo_soa[c] = NULL;
+    }
+    triangulos_mapeados = false;
+    nuvem = NULL;
+    material_triangulos = NULL;
+    materiais = NULL;
+    n_esferas = 0;
+    n_planos = 0;
+    n_triangulos = 0;
+    n_materiais = 0;
+    ka = 0.0;
+    n = 0;
+    m = 0;
+  }
+
+  /**
+   * \fn CenaCompilada::~CenaCompilada();
+   *
+   * \brief Destrutor da classe.
+   */
+  CenaCompilada::~CenaCompilada(){
+    liberar();
+  }
+
+  /**
+   * \fn bool CenaCompilada::compilar(Cena* cena, const OpcoesBVH& opcoes);
+   *
+   * \brief Copia as primitivas e as propriedades da cena para os vetores da cena compilada. A tabela de materiais do armazem (cor ja
+   * normalizada, kd, ks e brilho, sem repeticoes) e copiada como esta, e cada esfera guarda apenas o indice da sua entrada, de modo
+   * que o laco de renderizacao nao precise calcular a norma da cor por pixel. Em seguida a BVH e construida e as esferas sao
+   * reordenadas segundo as folhas, de modo que a posicao k da BVH seja a esfera k. Os vetores SoA das
+   * esferas sao preenchidos com zeros apos a ultima esfera, para que os nucleos possam ler um bloco de LARGURA_ESFERAS esferas a partir
+   * de qualquer esfera. Os planos sao copiados na ordem do armazem e ficam fora da BVH. Os triangulos recebem a sua propria BVH e sao
+   * guardados ja na forma usada pelo teste de Moller-Trumbore (v0, e1 e e2 em SoA), de modo que os vertices compartilhados do
+   * armazem nao sejam consultados durante a renderizacao.
+   *
+   * \param cena - cena que sera compilada
+   * \param opcoes - metodo, qualidade e threads da construcao das BVHs
+   *
+   * \return false se faltar memoria; a cena compilada fica vazia.
+   */
+  bool
+  CenaCompilada::compilar(Cena* cena, const OpcoesBVH& opcoes){
+    liberar();
+
+    const ArmazemPrimitivas& armazem = cena->primitivas();
+    const EsferaCompacta* esferas = armazem.esferas();
+    const int* materiais_armazem = armazem.materiais_esferas();
+    n_esferas = armazem.numero_esferas();
+    size_t bytes_soa = arredonda_linha_cache((n_esferas + LARGURA_ESFERAS - 1) * sizeof(double));
+    centro_x = (double*) aloca_alinhado(bytes_soa);
+    centro_y = (double*) aloca_alinhado(bytes_soa);
+    centro_z = (double*) aloca_alinhado(bytes_soa);
+    raio2 = (double*) aloca_alinhado(bytes_soa);
+    material_esferas = (int*) aloca_alinhado(n_esferas * sizeof(int));
+
+    //Caixas das esferas, levemente folgadas para que o arredondamento do teste de interseccao nunca caia fora da caixa
+    Caixa* caixas = new (std::nothrow) Caixa[n_esferas];
+    if (centro_x == NULL || centro_y == NULL || centro_z == NULL || raio2 == NULL || material_esferas == NULL || caixas == NULL){
+      delete[] caixas;
+      liberar();
+      return false;
+    }
+    memset(centro_x, 0, bytes_soa);
+    memset(centro_y, 0, bytes_soa);
+    memset(centro_z, 0, bytes_soa);
+    memset(raio2, 0, bytes_soa);
+    for (int k = 0; k < n_esferas; k++){
+      const EsferaCompacta& esfera = esferas[k];
+      double folga = esfera.raio * (1.0 + 1e-6);
+      caixas[k] = Caixa(Vetor(esfera.centro[0] - folga, esfera.centro[1] - folga, esfera.centro[2] - folga),
+			Vetor(esfera.centro[0] + folga, esfera.centro[1] + folga, esfera.centro[2] + folga));
+    }
+    if (!hierarquia.construir(caixas, n_esferas, opcoes)){
+      delete[] caixas;
+      liberar();
+      return false;
+    }
+
+    const int* ordem = hierarquia.ordem();
+    for (int k = 0; k < n_esferas; k++){
+      const EsferaCompacta& esfera = esferas[ordem[k]];
+      centro_x[k] = esfera.centro[0];
+      centro_y[k] = esfera.centro[1];
+      centro_z[k] = esfera.centro[2];
+      raio2[k] = esfera.raio * esfera.raio;
+      material_esferas[k] = materiais_armazem[ordem[k]];
+    }
+    delete[] caixas;
+
+    n_planos = armazem.numero_planos();
+    vetor_planos = (PlanoCompacto*) aloca_alinhado(n_planos * sizeof(PlanoCompacto));
+    material_planos = (int*) aloca_alinhado(n_planos * sizeof(int));
+    if (vetor_planos == NULL || material_planos == NULL){
+      liberar();
+      return false;
+    }
+    for (int k = 0; k < n_planos; k++){
+      vetor_planos[k] = armazem.planos()[k];
+      material_planos[k] = armazem.materiais_planos()[k];
+    }
+
+    n_triangulos = armazem.numero_triangulos();
+    const double* vertices = armazem.vertices();
+    const int* indices = armazem.triangulos();
+    size_t bytes_triangulos = arredonda_linha_cache((n_triangulos + LARGURA_ESFERAS - 1) * sizeof(double));
+    bool alocados = true;
+    for (int c = 0; c < 9; c++){
+      triangulo_soa[c] = (double*) aloca_alinhado(bytes_triangulos);
+      alocados = alocados && triangulo_soa[c] != NULL;
+    }
+    material_triangulos = (int*) aloca_alinhado(n_triangulos * sizeof(int));
+
+    //Caixas dos triangulos, com a mesma folga relativa das esferas
+    caixas = new (std::nothrow) Caixa[n_triangulos];
+    if (!alocados || material_triangulos == NULL || caixas == NULL){
+      delete[] caixas;
+      liberar();
+      return false;
+    }
+    for (int c = 0; c < 9; c++){
+      memset(triangulo_soa[c], 0, bytes_triangulos);
+    }
+    for (int k = 0; k < n_triangulos; k++){
+      for (int v = 0; v < 3; v++){
+	const double* p = vertices + 3 * indices[3 * k + v];
+	caixas[k].expandir(Vetor(p[0], p[1], p[2]));
+      }
+      for (int e = 0; e < 3; e++){
+	double folga = (caixas[k].max[e] - caixas[k].min[e]) * 1e-6 + 1e-9;
+	caixas[k].min[e] -= folga;
+	caixas[k].max[e] += folga;
+      }
+    }
+    if (!hierarquia_triangulos.construir(caixas, n_triangulos, opcoes)){
+      delete[] caixas;
+      liberar();
+      return false;
+    }
+
+    ordem = hierarquia_triangulos.ordem();
+    for (int k = 0; k < n_triangulos; k++){
+      const int* triangulo = indices + 3 * ordem[k];
+      const double* v0 = vertices + 3 * triangulo[0];
+      const double* v1 = vertices + 3 * triangulo[1];
+      const double* v2 = vertices + 3 * triangulo[2];
+      for (int e = 0; e < 3; e++){
+	triangulo_soa[e][k] = v0[e];
+	triangulo_soa[3 + e][k] = v1[e] - v0[e];
+	triangulo_soa[6 + e][k] = v2[e] - v0[e];
+      }
+      material_triangulos[k] = armazem.materiais_triangulos()[ordem[k]];
+    }
+    delete[] caixas;
+
+    n_materiais = armazem.numero_materiais();
+    materiais = (Material*) aloca_alinhado(n_materiais * sizeof(Material));
+    if (materiais == NULL){
+      liberar();
+      return false;
+    }
+    for (int k = 0; k < n_materiais; k++){
+      materiais[k] = armazem.materiais()[k];
+    }
+
+    background = Vetor(cena->cor_background_r(), cena->cor_background_g(), cena->cor_background_b());
+    ka = cena->ka_ambiente();
+    n = cena->lado();
+    m = cena->altura();
+    return true;
+  }
+
+  /**
+   * \fn bool CenaCompilada::anexar_malha(const MalhaMapeada& malha, int material, const OpcoesBVH& opcoes);
+   *
+   * \brief Usa os triangulos de uma malha mapeada de um cache, sem copiar os vetores SoA nem a BVH. Apenas uma malha mapeada anterior
+   * pode ser substituida: os triangulos compilados da cena nao sao descartados.
+   */
+  bool
+  CenaCompilada::anexar_malha(const MalhaMapeada& malha, int material, const OpcoesBVH& opcoes){
+    if (n_triangulos > 0 && !triangulos_mapeados){
+      return false;
+    }
+    int* materiais = (int*) aloca_alinhado(malha.numero_triangulos() * sizeof(int));
+    if (materiais == NULL){
+      return false;
+    }
+    for (int c = 0; c < 9; c++){
+      if (!triangulos_mapeados){
+	libera_alinhado(triangulo_soa[c]);
+      }
+    }
+    libera_alinhado(material_triangulos);
+
+    TriangulosSoA tri = malha.triangulos_soa();
+    const double* soa[9] = { tri.v0x, tri.v0y, tri.v0z, tri.e1x, tri.e1y, tri.e1z, tri.e2x, tri.e2y, tri.e2z };
+    for (int c = 0; c < 9; c++){
+      triangulo_soa[c] = const_cast<double*>(soa[c]);
+    }
+    triangulos_mapeados = true;
+    n_triangulos = malha.numero_triangulos();
+    material_triangulos = materiais;
+    for (int k = 0; k < n_triangulos; k++){
+      material_triangulos[k] = material;
+    }
+    hierarquia_triangulos.usar_nos(malha.nos(), malha.numero_nos(), n_triangulos, opcoes.largura);
+    return true;
+  }
+
+  /**
+   * \fn void CenaCompilada::anexar_particulas(const NuvemParticulas& particulas);
+   *
+   * \brief Anexa uma nuvem de particulas, consultada pela sua propria BVH sem ser copiada.
+   */
+  void
+  CenaCompilada::anexar_particulas(const NuvemParticulas& particulas){
+    nuvem = &particulas;
+  }
+
+  /**
+   * \fn bool CenaCompilada::intercepta_planos(const double origem[3], const double direcao[3], double t_minimo, double* t,
+   * IdPrimitiva* primitiva) const;
+   *
+   * \brief Testa o raio contra todos os planos. Se algum plano estiver mais proximo que *t (e alem de t_minimo), *t e *primitiva
+   * passam a ser os desse plano.
+   *
+   * \return true se algum plano substituiu a interseccao.
+   */
+  bool
+  CenaCompilada::intercepta_planos(const double origem[3], const double direcao[3], double t_minimo, double* t,
+				   IdPrimitiva* primitiva) const{
+    bool atingiu = false;
+    for (int k = 0; k < n_planos; k++){
+      double t_plano = intercepta_plano(vetor_planos[k], origem, direcao, t_minimo, *t);
+      if (t_plano >= 0.0){
+	*t = t_plano;
+	*primitiva = id_primitiva(PRIMITIVA_PLANO, k);
+	atingiu = true;
+      }
+    }
+    return atingiu;
+  }
+
+  /**
+   * \fn bool CenaCompilada::algum_plano(const double origem[3], const double direcao[3], double t_minimo, double t_max) const;
+   *
+   * \brief Consulta de qualquer interseccao (raios de sombra): retorna true assim que um plano for atingido em (t_minimo, t_max).
+   */
+  bool
+  CenaCompilada::algum_plano(const double origem[3], const double direcao[3], double t_minimo, double t_max) const{
+    for (int k = 0; k < n_planos; k++){
+      if (intercepta_plano(vetor_planos[k], origem, direcao, t_minimo, t_max) >= 0.0){
+	return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * \fn const Vetor& CenaCompilada::cor_background() const;
+   *
+   * \brief Retorna a cor de background.
+   */
+  const Vetor&
+  CenaCompilada::cor_background() const{
+    return background;
+  }
+
+  /**
+   * \fn double CenaCompilada::ka_ambiente() const;
+   *
+   * \brief Retorna a constante do ambiente.
+   */
+  double
+  CenaCompilada::ka_ambiente() const{
+    return ka;
+  }
+
+  /**
+   * \fn int CenaCompilada::lado() const;
+   *
+   * \brief Retorna o lado da imagem.
+   */
+  int
+  CenaCompilada::lado() const{
+    return n;
+  }
+
+  /**
+   * \fn int CenaCompilada::altura() const;
+   *
+   * \brief Retorna a altura da imagem.
+   */
+  int
+  CenaCompilada::altura() const{
+    return m;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
@@ -0,0 +1,470 @@
+/**
+ * \file cena_compilada.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo cena_compilada.cpp, sendo
+ * este responsavel pela versao somente leitura da cena utilizada durante a renderizacao. A Cena continua sendo a estrutura de montagem
+ * (lista de objetos); antes de renderizar ela e "compilada" em vetores contiguos e alinhados a linha de cache, que podem ser lidos por
+ * varias threads ao mesmo tempo sem qualquer alteracao.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _CENA_COMPILADA_HPP
+#define _CENA_COMPILADA_HPP
+
+#include "vetor.hpp"	//rayTracing::Vetor
+#include "cena.hpp"	//rayTracing::Cena
+#include "bvh.hpp"	//rayTracing::BVH
+#include "material.hpp"	//rayTracing::Material
+#include "primitivas.hpp"	//rayTracing::IdPrimitiva
+#include "nucleos.hpp"	//rayTracing::TriangulosSoA
+#include "particulas.hpp"	//rayTracing::NuvemParticulas
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  class MalhaMapeada;
+
+  /**
+   * \class CenaCompilada
+   *
+   * \brief Copia somente leitura da cena, em vetores contiguos, utilizada pelo laco de renderizacao. Os dados de interseccao das esferas
+   * ficam em forma de estrutura de vetores (SoA), um vetor por coordenada, para que os nucleos testem varias esferas por instrucao.
+   */
+  class CenaCompilada{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    double* centro_x;			///< Coordenada x do centro de cada esfera (alinhada a linha de cache)
+    double* centro_y;			///< Coordenada y do centro de cada esfera
+    double* centro_z;			///< Coordenada z do centro de cada esfera
+    double* raio2;			///< Quadrado do raio de cada esfera
+    int* material_esferas;		///< Indice do material de cada esfera
+    int n_esferas;			///< Numero de esferas
+
+    PlanoCompacto* vetor_planos;	///< Planos infinitos (fora da BVH)
+    int* material_planos;		///< Indice do material de cada plano
+    int n_planos;			///< Numero de planos
+
+    double* triangulo_soa[9];		///< Vertice v0 e arestas e1 = v1 - v0 e e2 = v2 - v0 de cada triangulo, um vetor por coordenada
+    int* material_triangulos;		///< Indice do material de cada triangulo
+    int n_triangulos;			///< Numero de triangulos
+    bool triangulos_mapeados;		///< Indica que os vetores SoA dos triangulos pertencem a uma MalhaMapeada
+
+    const NuvemParticulas* nuvem;	///< Nuvem de particulas anexada (NULL se nenhuma)
+
+    Material* materiais;		///< Tabela de materiais distintos da cena
+    int n_materiais;			///< Numero de materiais
+
+    BVH hierarquia;			///< Hierarquia de volumes envolventes das esferas
+    BVH hierarquia_triangulos;		///< Hierarquia de volumes envolventes dos triangulos
+
+    Vetor background;			///< Cor do background
+    double ka;				///< Constante do ambiente
+    int n;				///< Numero de linhas da imagem
+    int m;				///< Numero de colunas da imagem
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    /**
+     * \fn void liberar();
+     *
+     * \brief Libera os vetores e as BVHs da cena compilada.
+     */
+    void liberar();
+
+    //Copia nao permitida
+    CenaCompilada(const CenaCompilada&);
+    CenaCompilada& operator=(const CenaCompilada&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn CenaCompilada();
+     *
+     * \brief Construtor da classe. A cena compilada inicial nao possui objetos.
+     */
+    CenaCompilada();
+
+    /**
+     * \fn ~CenaCompilada();
+     *
+     * \brief Destrutor da classe.
+     */
+    ~CenaCompilada();
+
+    /**
+     * \fn bool compilar(Cena* cena, const OpcoesBVH& opcoes = OpcoesBVH());
+     *
+     * \brief Copia os objetos e as propriedades da cena para os vetores da cena compilada e constroi a BVH das esferas e a dos
+     * triangulos. Os planos, ilimitados, ficam fora das BVHs e sao testados um a um. A cena original nao e alterada. As esferas ficam na ordem das folhas da BVH, e nao na ordem de inclusao no armazem de primitivas.
+     *
+     * \param cena - cena que sera compilada
+     * \param opcoes - metodo, qualidade e threads da construcao das BVHs
+     *
+     * \return false se faltar memoria; a cena compilada fica vazia.
+     */
+    bool compilar(Cena* cena, const OpcoesBVH& opcoes = OpcoesBVH());
+
+    /**
+     * \fn bool anexar_malha(const MalhaMapeada& malha, int material, const OpcoesBVH& opcoes = OpcoesBVH());
+     *
+     * \brief Usa como triangulos da cena compilada os de uma malha mapeada de um cache. Os vetores SoA e a BVH dos triangulos passam a
+     * apontar para o mapeamento, sem copia; apenas o indice do material, o mesmo para toda a malha, e gravado por triangulo. A malha
+     * deve continuar aberta enquanto a cena compilada for usada, e compilar() desfaz a substituicao.
+     *
+     * \param malha - malha aberta
+     * \param material - indice do material na tabela da cena (incluido no armazem antes de compilar)
+     * \param opcoes - apenas a largura e usada: a BVH binaria do cache e colapsada em nos largos proprios se largura > 2
+     *
+     * \return false, sem alterar a cena, se a cena compilada ja tiver triangulos proprios (que seriam descartados) ou se nao houver
+     * memoria para os materiais.
+     */
+    bool anexar_malha(const MalhaMapeada& malha, int material, const OpcoesBVH& opcoes = OpcoesBVH());
+
+    /**
+     * \fn void anexar_particulas(const NuvemParticulas& particulas);
+     *
+     * \brief Anexa uma nuvem de particulas, que e consultada pela sua propria BVH sem ser copiada. A nuvem deve continuar carregada
+     * enquanto a cena compilada for usada, e compilar() desfaz a anexacao. Os materiais das particulas devem ter sido incluidos no
+     * armazem antes de compilar.
+     *
+     * \param particulas - nuvem carregada
+     */
+    void anexar_particulas(const NuvemParticulas& particulas);
+
+    /**
+     * \fn const NuvemParticulas* particulas() const;
+     *
+     * \brief Retorna a nuvem de particulas anexada, ou NULL.
+     */
+    const NuvemParticulas* particulas() const;
+
+    /**
+     * \fn int numero_esferas() const;
+     *
+     * \brief Retorna o numero de esferas.
+     */
+    int numero_esferas() const;
+
+    /**
+     * \fn const double* centros_x() const;
+     *
+     * \brief Retorna a coordenada x dos centros das esferas. Os quatro vetores SoA tem LARGURA_ESFERAS - 1 posicoes preenchidas
+     * com zero apos a ultima esfera.
+     */
+    const double* centros_x() const;
+
+    /**
+     * \fn const double* centros_y() const;
+     *
+     * \brief Retorna a coordenada y dos centros das esferas.
+     */
+    const double* centros_y() const;
+
+    /**
+     * \fn const double* centros_z() const;
+     *
+     * \brief Retorna a coordenada z dos centros das esferas.
+     */
+    const double* centros_z() const;
+
+    /**
+     * \fn const double* raios2() const;
+     *
+     * \brief Retorna o quadrado dos raios das esferas.
+     */
+    const double* raios2() const;
+
+    /**
+     * \fn Vetor centro_esfera(int k) const;
+     *
+     * \brief Retorna o centro da esfera k.
+     */
+    Vetor centro_esfera(int k) const;
+
+    /**
+     * \fn int numero_planos() const;
+     *
+     * \brief Retorna o numero de planos.
+     */
+    int numero_planos() const;
+
+    /**
+     * \fn const PlanoCompacto& plano(int k) const;
+     *
+     * \brief Retorna o plano k.
+     */
+    const PlanoCompacto& plano(int k) const;
+
+    /**
+     * \fn bool intercepta_planos(const double origem[3], const double direcao[3], double t_minimo, double* t, IdPrimitiva* primitiva) const;
+     *
+     * \brief Testa o raio contra todos os planos. Se algum plano estiver mais proximo que *t (e alem de t_minimo), *t e *primitiva
+     * passam a ser os desse plano; assim a consulta completa a interseccao mais proxima ja encontrada na BVH.
+     *
+     * \return true se algum plano substituiu a interseccao.
+     */
+    bool intercepta_planos(const double origem[3], const double direcao[3], double t_minimo, double* t, IdPrimitiva* primitiva) const;
+
+    /**
+     * \fn bool algum_plano(const double origem[3], const double direcao[3], double t_minimo, double t_max) const;
+     *
+     * \brief Consulta de qualquer interseccao (raios de sombra): retorna true assim que um plano for atingido em (t_minimo, t_max).
+     */
+    bool algum_plano(const double origem[3], const double direcao[3], double t_minimo, double t_max) const;
+
+    /**
+     * \fn int numero_triangulos() const;
+     *
+     * \brief Retorna o numero de triangulos.
+     */
+    int numero_triangulos() const;
+
+    /**
+     * \fn TriangulosSoA triangulos() const;
+     *
+     * \brief Retorna os vetores SoA dos triangulos, na ordem das folhas de bvh_triangulos(). Como os das esferas, os nove vetores tem
+     * LARGURA_ESFERAS - 1 posicoes preenchidas com zero apos o ultimo triangulo (triangulos degenerados, que nunca sao atingidos).
+     */
+    TriangulosSoA triangulos() const;
+
+    /**
+     * \fn int numero_materiais() const;
+     *
+     * \brief Retorna o numero de materiais distintos da cena.
+     */
+    int numero_materiais() const;
+
+    /**
+     * \fn const Material& material(int id) const;
+     *
+     * \brief Retorna a entrada id da tabela de materiais.
+     */
+    const Material& material(int id) const;
+
+    /**
+     * \fn int id_material_esfera(int k) const;
+     *
+     * \brief Retorna o indice do material da esfera k na tabela de materiais.
+     */
+    int id_material_esfera(int k) const;
+
+    /**
+     * \fn const Material& material_esfera(int k) const;
+     *
+     * \brief Retorna o material da esfera k.
+     */
+    const Material& material_esfera(int k) const;
+
+    /**
+     * \fn const Material& material_primitiva(IdPrimitiva id) const;
+     *
+     * \brief Retorna o material da primitiva id, despachando pela etiqueta de tipo.
+     */
+    const Material& material_primitiva(IdPrimitiva id) const;
+
+    /**
+     * \fn Vetor normal_primitiva(IdPrimitiva id, const Vetor& ponto) const;
+     *
+     * \brief Retorna a normal unitaria da primitiva id no ponto, despachando pela etiqueta de tipo.
+     */
+    Vetor normal_primitiva(IdPrimitiva id, const Vetor& ponto) const;
+
+    /**
+     * \fn const BVH& bvh() const;
+     *
+     * \brief Retorna a hierarquia de volumes envolventes das esferas. As posicoes informadas pelas consultas sao os indices k das
+     * esferas da cena compilada.
+     */
+    const BVH& bvh() const;
+
+    /**
+     * \fn const BVH& bvh_triangulos() const;
+     *
+     * \brief Retorna a hierarquia de volumes envolventes dos triangulos. As posicoes informadas pelas consultas sao os indices k dos
+     * triangulos da cena compilada.
+     */
+    const BVH& bvh_triangulos() const;
+
+    /**
+     * \fn const Vetor& cor_background() const;
+     *
+     * \brief Retorna a cor de background.
+     */
+    const Vetor& cor_background() const;
+
+    /**
+     * \fn double ka_ambiente() const;
+     *
+     * \brief Retorna a constante do ambiente.
+     */
+    double ka_ambiente() const;
+
+    /**
+     * \fn int lado() const;
+     *
+     * \brief Retorna o lado da imagem.
+     */
+    int lado() const;
+
+    /**
+     * \fn int altura() const;
+     *
+     * \brief Retorna a altura da imagem.
+     */
+    int altura() const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline int
+  CenaCompilada::numero_esferas() const{
+    return n_esferas;
+  }
+
+  inline const double*
+  CenaCompilada::centros_x() const{
+    return centro_x;
+  }
+
+  inline const double*
+  CenaCompilada::centros_y() const{
+    return centro_y;
+  }
+
+  inline const double*
+  CenaCompilada::centros_z() const{
+    return centro_z;
+  }
+
+  inline const double*
+  CenaCompilada::raios2() const{
+    return raio2;
+  }
+
+  inline Vetor
+  CenaCompilada::centro_esfera(int k) const{
+    return Vetor(centro_x[k], centro_y[k], centro_z[k]);
+  }
+
+  inline int
+  CenaCompilada::numero_planos() const{
+    return n_planos;
+  }
+
+  inline const PlanoCompacto&
+  CenaCompilada::plano(int k) const{
+    return vetor_planos[k];
+  }
+
+  inline int
+  CenaCompilada::numero_triangulos() const{
+    return n_triangulos;
+  }
+
+  inline TriangulosSoA
+  CenaCompilada::triangulos() const{
+    TriangulosSoA tri;
+    tri.v0x = triangulo_soa[0]; tri.v0y = triangulo_soa[1]; tri.v0z = triangulo_soa[2];
+    tri.e1x = triangulo_soa[3]; tri.e1y = triangulo_soa[4]; tri.e1z = triangulo_soa[5];
+    tri.e2x = triangulo_soa[6]; tri.e2y = triangulo_soa[7]; tri.e2z = triangulo_soa[8];
+    return tri;
+  }
+
+  inline int
+  CenaCompilada::numero_materiais() const{
+    return n_materiais;
+  }
+
+  inline const Material&
+  CenaCompilada::material(int id) const{
+    return materiais[id];
+  }
+
+  inline int
+  CenaCompilada::id_material_esfera(int k) const{
+    return material_esferas[k];
+  }
+
+  inline const Material&
+  CenaCompilada::material_esfera(int k) const{
+    return materiais[material_esferas[k]];
+  }
+
+  inline const Material&
+  CenaCompilada::material_primitiva(IdPrimitiva id) const{
+    switch (tipo_primitiva(id)){
+    case PRIMITIVA_PLANO:
+      return materiais[material_planos[indice_primitiva(id)]];
+    case PRIMITIVA_TRIANGULO:
+      return materiais[material_triangulos[indice_primitiva(id)]];
+    case PRIMITIVA_PARTICULA:
+      return materiais[nuvem->id_material(indice_primitiva(id))];
+    case PRIMITIVA_ESFERA:
+    default:
+      return material_esfera(indice_primitiva(id));
+    }
+  }
+
+  inline Vetor
+  CenaCompilada::normal_primitiva(IdPrimitiva id, const Vetor& ponto) const{
+    switch (tipo_primitiva(id)){
+    case PRIMITIVA_PLANO:{
+      const PlanoCompacto& p = vetor_planos[indice_primitiva(id)];
+      return Vetor(p.normal[0], p.normal[1], p.normal[2]);
+    }
+    case PRIMITIVA_TRIANGULO:{
+      int k = indice_primitiva(id);
+      Vetor e1(triangulo_soa[3][k], triangulo_soa[4][k], triangulo_soa[5][k]);
+      Vetor e2(triangulo_soa[6][k], triangulo_soa[7][k], triangulo_soa[8][k]);
+      return e1.produto_vetorial(e2).normalizado();
+    }
+    case PRIMITIVA_PARTICULA:
+      return (ponto - nuvem->centro(indice_primitiva(id))).normalizado();
+    case PRIMITIVA_ESFERA:
+    default:
+      return (ponto - centro_esfera(indice_primitiva(id))).normalizado();
+    }
+  }
+
+  inline const BVH&
+  CenaCompilada::bvh() const{
+    return hierarquia;
+  }
+
+  inline const BVH&
+  CenaCompilada::bvh_triangulos() const{
+    return hierarquia_triangulos;
+  }
+
+  inline const NuvemParticulas*
+  CenaCompilada::particulas() const{
+    return nuvem;
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
@@ -0,0 +1,94 @@
+/**
+ * \file cena_exemplo.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo cena_exemplo.hpp, sendo este responsavel pela cena de
+ * demonstracao do projeto.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "cena_exemplo.hpp"	//rayTracing::CenaExemplo
+#include "textura.hpp"		//rayTracing::Textura
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn CenaExemplo::CenaExemplo(int lado, int altura);
+   *
+   * \brief Monta a cena para uma imagem lado x altura.
+   */
+  CenaExemplo::CenaExemplo(int lado, int altura){
+    double escala = ((lado < altura) ? lado : altura) / 300.0;
+
+    //Primeira esfera
+    Vetor c_esfera1(150.0 * escala, 150.0 * escala, 0.0);
+    //Limites da cor do objeto
+    Vetor range1(0.0, 0.0, 255.0);	//Vetor de limite superior da cor
+    Vetor range2(0.0, 0.0, 254.0);	//Vetor de limite inferior da cor
+    Textura cores1(range1, range2);
+    esferas[0].atualizar_esfera(c_esfera1, 40.0 * escala, 0.3, 0.3, cores1);
+
+    //segunda esfera
+    Vetor c_esfera2(150.0 * escala, 100.0 * escala, 0.0);
+    //Limites da cor do objeto
+    Vetor range3(0.0, 255.0, 0.0);	//Vetor de limite superior da cor
+    Vetor range4(0.0, 254.0, 0.0);	//Vetor de limite inferior da cor
+    Textura cores2(range3, range4);
+    esferas[1].atualizar_esfera(c_esfera2, 60.0 * escala, 0.3, 0.3, cores2);
+
+    //terceira esfera
+    Vetor c_esfera3(150.0 * escala, 200.0 * escala, 0.0);
+    //Limites da cor do objeto
+    Vetor range5(255.0, 0.0, 0.0);	//Vetor de limite superior da cor
+    Vetor range6(254.0, 0.0, 0.0);	//Vetor de limite inferior da cor
+    Textura cores3(range5, range6);
+    esferas[2].atualizar_esfera(c_esfera3, 60.0 * escala, 0.3, 0.3, cores3);
+
+    //quarta esfera
+    Vetor c_esfera4(100.0 * escala, 150.0 * escala, 0.0);
+    //Limites da cor do objeto
+    Vetor range7(255.0, 254.0, 0.0);	//Vetor de limite superior da cor
+    Vetor range8(254.0, 254.0, 0.0);	//Vetor de limite inferior da cor
+    Textura cores4(range7, range8);
+    esferas[3].atualizar_esfera(c_esfera4, 60.0 * escala, 0.3, 0.3, cores4);
+
+    //Criando a cena
+    cena_exemplo.dimensao_imagem(lado, altura);
+    cena_exemplo.atualizar_cor_background(0.0, 0.0, 0.0);
+    cena_exemplo.atualizar_ka(1.2);
+    completa = cena_exemplo.incluir_objetos_pilha(&esferas[0]) &&
+      cena_exemplo.incluir_objetos_pilha(&esferas[1]) &&
+      cena_exemplo.incluir_objetos_pilha(&esferas[2]);
+    //cena_exemplo.incluir_objetos_pilha(&esferas[3]);
+
+    pos_camera = Vetor(155.0 * escala, 150.0 * escala, -150.0 * escala);
+    alvo_camera = Vetor(2.0, 1.0, 0.0);
+
+    //Luz
+    luz_exemplo.posicao_luz(3.0 * escala, 3.0 * escala, 3.0 * escala);
+    //kd, ks e o espalhamento (BRILHO_PADRAO) vem do material de cada esfera
+    luz_exemplo.atualizar_constantes_phong(0.4, 200.0, 192.0, 192.0, 192.0 , 1.0);
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
@@ -0,0 +1,143 @@
+/**
+ * \file cena_exemplo.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo cena_exemplo.cpp, sendo
+ * este responsavel pela cena de demonstracao do projeto (tres esferas e uma luz), compartilhada pelo visualizador GLUT e pelo
+ * renderizador de linha de comando.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _CENA_EXEMPLO_HPP
+#define _CENA_EXEMPLO_HPP
+
+#include "vetor.hpp"	//rayTracing::Vetor
+#include "objeto.hpp"	//rayTracing::Objeto
+#include "cena.hpp"	//rayTracing::Cena
+#include "luz.hpp"	//rayTracing::Luz
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \class CenaExemplo
+   *
+   * \brief Cena de demonstracao. Os objetos pertencem a esta classe, e por isso a cena deve ser usada enquanto ela existir.
+   */
+  class CenaExemplo{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    Objeto esferas[4];	///< Esferas (a quarta nao e incluida na cena)
+    Cena cena_exemplo;	///< Cena com as esferas
+    Luz luz_exemplo;	///< Luz da cena
+    Vetor pos_camera;	///< Posicao da camera (lookfrom)
+    Vetor alvo_camera;	///< Posicao para onde esta apontada a camera (lookat)
+    bool completa;	///< Indica que todas as esferas entraram na cena
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    //Copia nao permitida (a cena guarda ponteiros para as esferas)
+    CenaExemplo(const CenaExemplo&);
+    CenaExemplo& operator=(const CenaExemplo&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn CenaExemplo(int lado, int altura);
+     *
+     * \brief Monta a cena para uma imagem lado x altura. A cena foi desenhada para 300 x 300 pixels; em outras dimensoes as
+     * posicoes e os raios sao escalados pelo menor lado, de modo que a imagem mantem o mesmo enquadramento.
+     *
+     * \param lado, altura - dimensoes da imagem
+     */
+    CenaExemplo(int lado, int altura);
+
+    /**
+     * \fn bool montada() const;
+     *
+     * \brief Indica se a cena foi montada; false se faltou memoria para alguma esfera.
+     */
+    bool montada() const;
+
+    /**
+     * \fn Cena* cena();
+     *
+     * \brief Retorna a cena.
+     */
+    Cena* cena();
+
+    /**
+     * \fn const Luz* luz() const;
+     *
+     * \brief Retorna a luz da cena.
+     */
+    const Luz* luz() const;
+
+    /**
+     * \fn const Vetor& lookfrom() const;
+     *
+     * \brief Retorna a posicao da camera.
+     */
+    const Vetor& lookfrom() const;
+
+    /**
+     * \fn const Vetor& lookat() const;
+     *
+     * \brief Retorna a posicao para onde esta apontada a camera.
+     */
+    const Vetor& lookat() const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline bool
+  CenaExemplo::montada() const{
+    return completa;
+  }
+
+  inline Cena*
+  CenaExemplo::cena(){
+    return &cena_exemplo;
+  }
+
+  inline const Luz*
+  CenaExemplo::luz() const{
+    return &luz_exemplo;
+  }
+
+  inline const Vetor&
+  CenaExemplo::lookfrom() const{
+    return pos_camera;
+  }
+
+  inline const Vetor&
+  CenaExemplo::lookat() const{
+    return alvo_camera;
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * \file escalonador.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo escalonador.hpp, sendo este responsavel pelo conjunto de threads
+ * que executa as tarefas da renderizacao em paralelo com roubo de trabalho entre as filas.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "escalonador.hpp"	//rayTracing::Escalonador
+#include <unistd.h>		//sysconf
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \fn Tarefa::~Tarefa();
+   *
+   * \brief Destrutor da classe.
+   */
+  Tarefa::~Tarefa(){
+  }
+
+  //------------------------------
+  //	Metodos privados
+  //------------------------------
+  /**
+   * \fn void* Escalonador::rotina(void* arg);
+   *
+   * \brief Laco principal das threads auxiliares: aguarda uma nova tarefa, trabalha nela ate esgotar as filas e avisa o termino.
+   */
+  void*
+  Escalonador::rotina(void* arg){
+    Argumento* argumento = (Argumento*) arg;
+    Escalonador* e = argumento->escalonador;
+    int vista = 0;	//Ultima geracao executada por esta thread
+    for (;;){
+      pthread_mutex_lock(&e->trava);
+      while (!e->encerrar && e->geracao == vista){
+	pthread_cond_wait(&e->cond_inicio, &e->trava);
+      }
+      if (e->encerrar){
+	pthread_mutex_unlock(&e->trava);
+	break;
+      }
+      vista = e->geracao;
+      pthread_mutex_unlock(&e->trava);
+
+      e->trabalhar(argumento->indice);
+
+      pthread_mutex_lock(&e->trava);
+      e->ativos--;
+      if (e->ativos == 0){
+	pthread_cond_signal(&e->cond_fim);
+      }
+      pthread_mutex_unlock(&e->trava);
+    }
+    return NULL;
+  }
+
+  /**
+   * \fn bool Escalonador::proximo_item(int trabalhador, int* item);
+   *
+   * \brief Retira o proximo item do inicio da fila da thread ou, se ela estiver vazia, rouba um item do final da fila de outra thread.
+   */
+  bool
+  Escalonador::proximo_item(int trabalhador, int* item){
+    for (int k = 0; k < n_trabalhadores; k++){
+      Fila& fila = filas[(trabalhador + k) % n_trabalhadores];
+      pthread_mutex_lock(&fila.trava);
+      if (!fila.itens.empty()){
+	if (k == 0){	//Fila propria: itens na ordem em que foram distribuidos
+	  *item = fila.itens.front();
+	  fila.itens.pop_front();
+	}
+	else{		//Roubo: itens mais distantes do dono da fila
+	  *item = fila.itens.back();
+	  fila.itens.pop_back();
+	}
+	pthread_mutex_unlock(&fila.trava);
+	return true;
+      }
+      pthread_mutex_unlock(&fila.trava);
+    }
+    return false;
+  }
+
+  /**
+   * \fn void Escalonador::trabalhar(int trabalhador);
+   *
+   * \brief Executa itens ate que todas as filas estejam vazias.
+   */
+  void
+  Escalonador::trabalhar(int trabalhador){
+    int item;
+    while (proximo_item(trabalhador, &item)){
+      tarefa->executar(item, trabalhador);
+    }
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn Escalonador::Escalonador(int _n_trabalhadores);
+   *
+   * \brief Construtor da classe. Cria as threads auxiliares, que ficam aguardando tarefas.
+   */
+  Escalonador::Escalonador(int _n_trabalhadores){
+    n_trabalhadores = (_n_trabalhadores > 0) ? _n_trabalhadores : processadores();
+    tarefa = NULL;
+    geracao = 0;
+    ativos = 0;
+    encerrar = false;
+    pthread_mutex_init(&trava, NULL);
+    pthread_cond_init(&cond_inicio, NULL);
+    pthread_cond_init(&cond_fim, NULL);
+
+    filas = new Fila[n_trabalhadores];
+    for (int i = 0; i < n_trabalhadores; i++){
+      pthread_mutex_init(&filas[i].trava, NULL);
+    }
+
+    //A thread 0 e sempre a thread que chama executar
+    threads = new pthread_t[n_trabalhadores];
+    argumentos = new Argumento[n_trabalhadores];
+    for (int i = 1; i < n_trabalhadores; i++){
+      argumentos[i].escalonador = this;
+      argumentos[i].indice = i;
+      pthread_create(&threads[i], NULL, rotina, &argumentos[i]);
+    }
+  }
+
+  /**
+   * \fn Escalonador::~Escalonador();
+   *
+   * \brief Destrutor da classe. Encerra as threads auxiliares.
+   */
+  Escalonador::~Escalonador(){
+    pthread_mutex_lock(&trava);
+    encerrar = true;
+    pthread_cond_broadcast(&cond_inicio);
+    pthread_mutex_unlock(&trava);
+    for (int i = 1; i < n_trabalhadores; i++){
+      pthread_join(threads[i], NULL);
+    }
+    for (int i = 0; i < n_trabalhadores; i++){
+      pthread_mutex_destroy(&filas[i].trava);
+    }
+    pthread_cond_destroy(&cond_fim);
+    pthread_cond_destroy(&cond_inicio);
+    pthread_mutex_destroy(&trava);
+    delete[] filas;
+    delete[] argumentos;
+    delete[] threads;
+  }
+
+  /**
+   * \fn int Escalonador::trabalhadores() const;
+   *
+   * \brief Retorna o numero de threads do escalonador.
+   */
+  int
+  Escalonador::trabalhadores() const{
+    return n_trabalhadores;
+  }
+
+  /**
+   * \fn void Escalonador::executar(Tarefa* t, int n_itens);
+   *
+   * \brief Executa os itens 0 .. n_itens-1 da tarefa. Os itens sao distribuidos em blocos contiguos entre as filas, de modo que cada
+   * thread comeca por uma regiao propria da imagem; o desequilibrio restante e corrigido pelo roubo de itens.
+   */
+  void
+  Escalonador::executar(Tarefa* t, int n_itens){
+    for (int i = 0; i < n_trabalhadores; i++){
+      int inicio = (int)(((long) n_itens * i) / n_trabalhadores);
+      int fim = (int)(((long) n_itens * (i + 1)) / n_trabalhadores);
+      for (int item = inicio; item < fim; item++){
+	filas[i].itens.push_back(item);
+      }
+    }
+
+    pthread_mutex_lock(&trava);
+    tarefa = t;
+    ativos = n_trabalhadores - 1;
+    geracao++;
+    pthread_cond_broadcast(&cond_inicio);
+    pthread_mutex_unlock(&trava);
+
+    trabalhar(0);
+
+    pthread_mutex_lock(&trava);
+    while (ativos > 0){
+      pthread_cond_wait(&cond_fim, &trava);
+    }
+    tarefa = NULL;
+    pthread_mutex_unlock(&trava);
+  }
+
+  /**
+   * \fn int Escalonador::processadores();
+   *
+   * \brief Retorna o numero de processadores disponiveis na maquina.
+   */
+  int
+  Escalonador::processadores(){
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int) n : 1;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
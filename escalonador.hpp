@@ -0,0 +1,178 @@
+/**
+ * \file escalonador.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo escalonador.cpp, sendo este
+ * responsavel pelo conjunto de threads que executa as tarefas da renderizacao (ladrilhos da imagem) em paralelo. Cada thread possui sua
+ * propria fila de itens e, quando ela se esgota, rouba itens das filas das demais threads (work stealing).
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _ESCALONADOR_HPP
+#define _ESCALONADOR_HPP
+
+#include <pthread.h>	//pthread_t, pthread_mutex_t, pthread_cond_t
+#include <deque>	//std::deque
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \class Tarefa
+   *
+   * \brief Interface de uma tarefa dividida em itens independentes que podem ser executados em qualquer ordem e em qualquer thread.
+   */
+  class Tarefa{
+  public:
+    /**
+     * \fn virtual ~Tarefa();
+     *
+     * \brief Destrutor da classe.
+     */
+    virtual ~Tarefa();
+
+    /**
+     * \fn virtual void executar(int item, int trabalhador) = 0;
+     *
+     * \brief Executa um item da tarefa.
+     *
+     * \param item - indice do item que deve ser executado
+     * \param trabalhador - indice da thread que esta executando o item (0 e a thread que chamou Escalonador::executar)
+     */
+    virtual void executar(int item, int trabalhador) = 0;
+  };
+
+  /**
+   * \class Escalonador
+   *
+   * \brief Conjunto fixo de threads que executa os itens de uma tarefa com roubo de trabalho entre as filas.
+   */
+  class Escalonador{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    //Fila de itens de cada thread
+    struct Fila{
+      pthread_mutex_t trava;	///< Trava da fila
+      std::deque<int> itens;	///< Itens pendentes
+    };
+
+    //Argumento passado para cada thread criada
+    struct Argumento{
+      Escalonador* escalonador;	///< Escalonador dono da thread
+      int indice;		///< Indice da thread
+    };
+
+    int n_trabalhadores;	///< Numero de threads (incluindo a thread que chama executar)
+    pthread_t* threads;		///< Threads auxiliares
+    Argumento* argumentos;	///< Argumentos das threads auxiliares
+    Fila* filas;		///< Uma fila por thread
+
+    Tarefa* tarefa;		///< Tarefa em execucao
+    pthread_mutex_t trava;	///< Trava do estado compartilhado
+    pthread_cond_t cond_inicio;	///< Sinaliza uma nova tarefa as threads
+    pthread_cond_t cond_fim;	///< Sinaliza o fim da tarefa a thread principal
+    int geracao;		///< Contador de tarefas executadas
+    int ativos;			///< Threads auxiliares ainda trabalhando na tarefa atual
+    bool encerrar;		///< Indica que as threads devem terminar
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    /**
+     * \fn static void* rotina(void* arg);
+     *
+     * \brief Laco principal das threads auxiliares.
+     */
+    static void* rotina(void* arg);
+
+    /**
+     * \fn bool proximo_item(int trabalhador, int* item);
+     *
+     * \brief Retira o proximo item da fila da thread ou, se ela estiver vazia, rouba um item do final da fila de outra thread.
+     *
+     * \param trabalhador - indice da thread
+     * \param item - item retirado
+     *
+     * \return false quando nao ha mais itens em nenhuma fila.
+     */
+    bool proximo_item(int trabalhador, int* item);
+
+    /**
+     * \fn void trabalhar(int trabalhador);
+     *
+     * \brief Executa itens ate que todas as filas estejam vazias.
+     */
+    void trabalhar(int trabalhador);
+
+    //Copia nao permitida
+    Escalonador(const Escalonador&);
+    Escalonador& operator=(const Escalonador&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn Escalonador(int _n_trabalhadores);
+     *
+     * \brief Construtor da classe. Cria as threads auxiliares, que ficam aguardando tarefas.
+     *
+     * \param _n_trabalhadores - numero de threads; 0 utiliza o numero de processadores da maquina
+     */
+    Escalonador(int _n_trabalhadores);
+
+    /**
+     * \fn ~Escalonador();
+     *
+     * \brief Destrutor da classe. Encerra as threads auxiliares.
+     */
+    ~Escalonador();
+
+    /**
+     * \fn int trabalhadores() const;
+     *
+     * \brief Retorna o numero de threads do escalonador.
+     */
+    int trabalhadores() const;
+
+    /**
+     * \fn void executar(Tarefa* t, int n_itens);
+     *
+     * \brief Executa os itens 0 .. n_itens-1 da tarefa e retorna apenas quando todos foram executados. A thread que chama o metodo
+     * tambem trabalha como a thread 0.
+     *
+     * \param t - tarefa a ser executada
+     * \param n_itens - numero de itens da tarefa
+     */
+    void executar(Tarefa* t, int n_itens);
+
+    /**
+     * \fn static int processadores();
+     *
+     * \brief Retorna o numero de processadores disponiveis na maquina.
+     */
+    static int processadores();
+  };
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
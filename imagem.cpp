@@ -0,0 +1,190 @@
+/**
+ * \file imagem.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo imagem.hpp, sendo este responsavel pela alocacao da imagem
+ * pintada pelo ray tracing.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "imagem.hpp"	//rayTracing::Imagem
+#include "memoria.hpp"	//rayTracing::aloca_alinhado
+#include <string.h>	//memset
+#include <stdio.h>	//fopen, fprintf, fwrite
+#include <float.h>	//FLT_EPSILON
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn Imagem::Imagem();
+   *
+   * \brief Construtor da classe. A imagem inicial e vazia.
+   */
+  Imagem::Imagem(){
+    pixels = NULL;
+    n_largura = 0;
+    n_altura = 0;
+    n_passo = 0;
+    formato_pixels = FORMATO_RGB8;
+  }
+
+  /**
+   * \fn Imagem::~Imagem();
+   *
+   * \brief Destrutor da classe.
+   */
+  Imagem::~Imagem(){
+    libera_alinhado(pixels);
+  }
+
+  /**
+   * \fn bool Imagem::alocar(int largura, int altura, FormatoPixel formato);
+   *
+   * \brief Aloca a imagem com as dimensoes e o formato dados. A largura de cada linha e arredondada para um multiplo de
+   * PIXELS_ALINHAMENTO pixels: como PIXELS_ALINHAMENTO pixels ocupam um numero inteiro de linhas de cache em todos os formatos, o
+   * passo tambem e um numero inteiro de pixels (o que o glDrawPixels exige em GL_UNPACK_ROW_LENGTH).
+   *
+   * \return false se a memoria nao pode ser alocada (a imagem fica vazia).
+   */
+  bool
+  Imagem::alocar(int largura, int altura, FormatoPixel formato){
+    libera_alinhado(pixels);
+    pixels = NULL;
+    n_largura = n_altura = 0;
+    n_passo = 0;
+    formato_pixels = formato;
+    if (largura <= 0 || altura <= 0){
+      return true;
+    }
+
+    size_t largura_linha = ((size_t) largura + PIXELS_ALINHAMENTO - 1) / PIXELS_ALINHAMENTO * PIXELS_ALINHAMENTO;
+    size_t passo = largura_linha * bytes_por_pixel(formato);
+    pixels = (unsigned char*) aloca_alinhado(passo * altura);
+    if (pixels == NULL){
+      return false;
+    }
+    memset(pixels, 0, passo * altura);
+    n_largura = largura;
+    n_altura = altura;
+    n_passo = passo;
+    return true;
+  }
+
+  /**
+   * \fn void Imagem::trocar(Imagem& outra);
+   *
+   * \brief Troca os pixels, as dimensoes e o formato com outra imagem, sem copiar os pixels.
+   */
+  void
+  Imagem::trocar(Imagem& outra){
+    unsigned char* pixels_aux = pixels;
+    pixels = outra.pixels;
+    outra.pixels = pixels_aux;
+    int aux = n_largura;
+    n_largura = outra.n_largura;
+    outra.n_largura = aux;
+    aux = n_altura;
+    n_altura = outra.n_altura;
+    outra.n_altura = aux;
+    size_t passo_aux = n_passo;
+    n_passo = outra.n_passo;
+    outra.n_passo = passo_aux;
+    FormatoPixel formato_aux = formato_pixels;
+    formato_pixels = outra.formato_pixels;
+    outra.formato_pixels = formato_aux;
+  }
+
+  /**
+   * \fn bool Imagem::copiar(const Imagem& outra);
+   *
+   * \brief Copia os pixels de outra imagem, linha a linha.
+   */
+  bool
+  Imagem::copiar(const Imagem& outra){
+    if (n_largura != outra.n_largura || n_altura != outra.n_altura || formato_pixels != outra.formato_pixels){
+      if (!alocar(outra.n_largura, outra.n_altura, outra.formato_pixels)){
+	return false;
+      }
+    }
+    size_t bytes_linha = n_largura * bytes_por_pixel(formato_pixels);
+    for (int y = 0; y < n_altura; y++){
+      memcpy(linha(y), outra.linha(y), bytes_linha);
+    }
+    return true;
+  }
+
+  /**
+   * \fn VistaImagem Imagem::ladrilho(int x0, int y0, int largura, int altura);
+   *
+   * \brief Retorna a vista do retangulo de canto (x0, y0) e das dimensoes dadas.
+   */
+  VistaImagem
+  Imagem::ladrilho(int x0, int y0, int largura, int altura){
+    VistaImagem vista;
+    vista.dados = linha(y0) + x0 * bytes_por_pixel(formato_pixels);
+    vista.passo = n_passo;
+    vista.largura = largura;
+    vista.altura = altura;
+    vista.formato = formato_pixels;
+    return vista;
+  }
+
+  /**
+   * \fn bool Imagem::salvar_ppm(const char* caminho) const;
+   *
+   * \brief Grava a imagem em um arquivo PPM binario (P6), uma linha por vez, de cima para baixo.
+   */
+  bool
+  Imagem::salvar_ppm(const char* caminho) const{
+    FILE* arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL){
+      return false;
+    }
+    fprintf(arquivo, "P6\n%d %d\n255\n", n_largura, n_altura);
+    unsigned char* saida = new unsigned char[3 * (size_t) n_largura + 1];
+    bool ok = true;
+    for (int y = 0; y < n_altura && ok; y++){
+      const unsigned char* origem = linha(y);
+      for (int x = 0; x < n_largura; x++){
+	if (formato_pixels == FORMATO_RGB_FLOAT){
+	  //meio ulp relativo desfaz o arredondamento para float sem subir os canais logo abaixo de um inteiro
+	  const float* f = (const float*) origem + 3 * x;
+	  saida[3*x + 0] = satura_byte(255.0 * f[0] * (1.0 + 0.5 * FLT_EPSILON));
+	  saida[3*x + 1] = satura_byte(255.0 * f[1] * (1.0 + 0.5 * FLT_EPSILON));
+	  saida[3*x + 2] = satura_byte(255.0 * f[2] * (1.0 + 0.5 * FLT_EPSILON));
+	}
+	else{
+	  const unsigned char* p = origem + x * bytes_por_pixel(formato_pixels);
+	  saida[3*x + 0] = p[0];
+	  saida[3*x + 1] = p[1];
+	  saida[3*x + 2] = p[2];
+	}
+      }
+      ok = (fwrite(saida, 3, n_largura, arquivo) == (size_t) n_largura);
+    }
+    delete[] saida;
+    return (fclose(arquivo) == 0) && ok;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
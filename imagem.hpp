@@ -0,0 +1,337 @@
+/**
+ * \file imagem.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo imagem.cpp, sendo este
+ * responsavel pela imagem pintada pelo ray tracing. A imagem e alocada no heap com largura e altura quaisquer, as linhas comecam em
+ * uma linha de cache e o passo entre linhas e multiplo de PIXELS_ALINHAMENTO pixels, de modo que ladrilhos com largura multipla de
+ * PIXELS_ALINHAMENTO nunca dividam uma linha de cache com os vizinhos, em qualquer formato de pixel.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _IMAGEM_HPP
+#define _IMAGEM_HPP
+
+#include <stddef.h>	//size_t
+#include <string.h>	//memcpy
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \enum FormatoPixel
+   *
+   * \brief Formato dos pixels da imagem. Nos formatos de 8 bits as cores (de 0 a 255) sao saturadas; no formato em ponto flutuante
+   * elas sao divididas por 255 e guardadas sem saturacao.
+   */
+  enum FormatoPixel{
+    FORMATO_RGB8,	///< Tres bytes por pixel
+    FORMATO_RGBA8,	///< Quatro bytes por pixel (alfa 255)
+    FORMATO_RGB_FLOAT	///< Tres floats por pixel
+  };
+
+  /**
+   * \brief O passo entre as linhas da imagem e multiplo deste numero de pixels.
+   */
+  const int PIXELS_ALINHAMENTO = 64;
+
+  /**
+   * \fn size_t bytes_por_pixel(FormatoPixel formato);
+   *
+   * \brief Retorna o tamanho de um pixel no formato.
+   */
+  size_t bytes_por_pixel(FormatoPixel formato);
+
+  /**
+   * \fn void escreve_pixel(FormatoPixel formato, unsigned char* destino, double r, double g, double b);
+   *
+   * \brief Converte a cor (de 0 a 255 em cada canal) para o formato e a escreve em destino.
+   */
+  void escreve_pixel(FormatoPixel formato, unsigned char* destino, double r, double g, double b);
+
+  /**
+   * \fn unsigned char satura_byte(double v);
+   *
+   * \brief Converte um canal para byte, saturando em 0 e 255.
+   */
+  unsigned char satura_byte(double v);
+
+  /**
+   * \struct VistaImagem
+   *
+   * \brief Janela retangular sobre uma imagem (um ladrilho), com coordenadas locais. Cada trabalhador escreve apenas na sua vista.
+   */
+  struct VistaImagem{
+    unsigned char* dados;	///< Primeiro pixel da vista
+    size_t passo;		///< Bytes entre duas linhas
+    int largura;		///< Largura da vista
+    int altura;			///< Altura da vista
+    FormatoPixel formato;	///< Formato dos pixels
+
+    /**
+     * \fn void escrever_pixel(int x, int y, double r, double g, double b);
+     *
+     * \brief Escreve a cor (de 0 a 255 em cada canal) no pixel (x, y) da vista.
+     */
+    void escrever_pixel(int x, int y, double r, double g, double b);
+
+    /**
+     * \fn void replicar_pixel(int x, int y, int lado);
+     *
+     * \brief Copia o pixel (x, y) para o bloco lado x lado de canto (x, y), recortado pela vista (preenchimento pelo vizinho mais
+     * proximo das passadas progressivas).
+     */
+    void replicar_pixel(int x, int y, int lado);
+  };
+
+  /**
+   * \class Imagem
+   *
+   * \brief Imagem pintada, com as linhas de cima para baixo e os pixels de cada linha da esquerda para a direita.
+   */
+  class Imagem{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    unsigned char* pixels;	///< Pixels (alinhados a linha de cache)
+    int n_largura;		///< Largura em pixels
+    int n_altura;		///< Altura em pixels
+    size_t n_passo;		///< Bytes entre duas linhas
+    FormatoPixel formato_pixels;	///< Formato dos pixels
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    //Copia nao permitida
+    Imagem(const Imagem&);
+    Imagem& operator=(const Imagem&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn Imagem();
+     *
+     * \brief Construtor da classe. A imagem inicial e vazia.
+     */
+    Imagem();
+
+    /**
+     * \fn ~Imagem();
+     *
+     * \brief Destrutor da classe.
+     */
+    ~Imagem();
+
+    /**
+     * \fn bool alocar(int largura, int altura, FormatoPixel formato);
+     *
+     * \brief Aloca a imagem com as dimensoes e o formato dados, descartando os pixels anteriores. Os pixels novos sao zerados.
+     *
+     * \return false se a memoria nao pode ser alocada (a imagem fica vazia).
+     */
+    bool alocar(int largura, int altura, FormatoPixel formato);
+
+    /**
+     * \fn void trocar(Imagem& outra);
+     *
+     * \brief Troca os pixels, as dimensoes e o formato com outra imagem, sem copiar os pixels.
+     */
+    void trocar(Imagem& outra);
+
+    /**
+     * \fn bool copiar(const Imagem& outra);
+     *
+     * \brief Copia os pixels de outra imagem, realocando esta se as dimensoes ou o formato forem diferentes.
+     *
+     * \return false se a memoria nao pode ser alocada.
+     */
+    bool copiar(const Imagem& outra);
+
+    /**
+     * \fn int largura() const;
+     *
+     * \brief Retorna a largura em pixels.
+     */
+    int largura() const;
+
+    /**
+     * \fn int altura() const;
+     *
+     * \brief Retorna a altura em pixels.
+     */
+    int altura() const;
+
+    /**
+     * \fn size_t passo() const;
+     *
+     * \brief Retorna o numero de bytes entre duas linhas (multiplo da linha de cache e de PIXELS_ALINHAMENTO pixels).
+     */
+    size_t passo() const;
+
+    /**
+     * \fn FormatoPixel formato() const;
+     *
+     * \brief Retorna o formato dos pixels.
+     */
+    FormatoPixel formato() const;
+
+    /**
+     * \fn const unsigned char* dados() const;
+     *
+     * \brief Retorna os pixels, para exibicao ou gravacao.
+     */
+    const unsigned char* dados() const;
+
+    /**
+     * \fn unsigned char* linha(int y);
+     *
+     * \brief Retorna o primeiro pixel da linha y.
+     */
+    unsigned char* linha(int y);
+
+    /**
+     * \fn const unsigned char* linha(int y) const;
+     *
+     * \brief Retorna o primeiro pixel da linha y.
+     */
+    const unsigned char* linha(int y) const;
+
+    /**
+     * \fn VistaImagem ladrilho(int x0, int y0, int largura, int altura);
+     *
+     * \brief Retorna a vista do retangulo de canto (x0, y0) e das dimensoes dadas.
+     */
+    VistaImagem ladrilho(int x0, int y0, int largura, int altura);
+
+    /**
+     * \fn void escrever_pixel(int x, int y, double r, double g, double b);
+     *
+     * \brief Escreve a cor (de 0 a 255 em cada canal) no pixel (x, y).
+     */
+    void escrever_pixel(int x, int y, double r, double g, double b);
+
+    /**
+     * \fn bool salvar_ppm(const char* caminho) const;
+     *
+     * \brief Grava a imagem em um arquivo PPM binario (P6) de 8 bits por canal. O canal alfa e descartado e os pixels em ponto
+     * flutuante sao truncados como nos formatos de 8 bits e saturados em [0, 255]; antes do truncamento o valor e
+     * aumentado de meio ulp do float, o erro relativo maximo do arredondamento para float, para que um canal inteiro nao caia
+     * no byte de baixo.
+     *
+     * \return false se o arquivo nao puder ser escrito.
+     */
+    bool salvar_ppm(const char* caminho) const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline size_t
+  bytes_por_pixel(FormatoPixel formato){
+    return (formato == FORMATO_RGB8) ? 3 : ((formato == FORMATO_RGBA8) ? 4 : 3 * sizeof(float));
+  }
+
+  inline unsigned char
+  satura_byte(double v){
+    return (v <= 0.0) ? 0 : ((v >= 255.0) ? 255 : (unsigned char) v);
+  }
+
+  inline void
+  escreve_pixel(FormatoPixel formato, unsigned char* destino, double r, double g, double b){
+    if (formato == FORMATO_RGB_FLOAT){
+      float* f = (float*) destino;
+      f[0] = (float)(r / 255.0);
+      f[1] = (float)(g / 255.0);
+      f[2] = (float)(b / 255.0);
+      return;
+    }
+    destino[0] = satura_byte(r);
+    destino[1] = satura_byte(g);
+    destino[2] = satura_byte(b);
+    if (formato == FORMATO_RGBA8){
+      destino[3] = 255;
+    }
+  }
+
+  inline void
+  VistaImagem::escrever_pixel(int x, int y, double r, double g, double b){
+    escreve_pixel(formato, dados + y * passo + x * bytes_por_pixel(formato), r, g, b);
+  }
+
+  inline void
+  VistaImagem::replicar_pixel(int x, int y, int lado){
+    size_t bpp = bytes_por_pixel(formato);
+    const unsigned char* origem = dados + y * passo + x * bpp;
+    int x1 = (x + lado < largura) ? x + lado : largura;
+    int y1 = (y + lado < altura) ? y + lado : altura;
+    for (int j = y; j < y1; j++){
+      unsigned char* destino = dados + j * passo;
+      for (int i = (j == y) ? x + 1 : x; i < x1; i++){
+	memcpy(destino + i * bpp, origem, bpp);
+      }
+    }
+  }
+
+  inline int
+  Imagem::largura() const{
+    return n_largura;
+  }
+
+  inline int
+  Imagem::altura() const{
+    return n_altura;
+  }
+
+  inline size_t
+  Imagem::passo() const{
+    return n_passo;
+  }
+
+  inline FormatoPixel
+  Imagem::formato() const{
+    return formato_pixels;
+  }
+
+  inline const unsigned char*
+  Imagem::dados() const{
+    return pixels;
+  }
+
+  inline unsigned char*
+  Imagem::linha(int y){
+    return pixels + y * n_passo;
+  }
+
+  inline const unsigned char*
+  Imagem::linha(int y) const{
+    return pixels + y * n_passo;
+  }
+
+  inline void
+  Imagem::escrever_pixel(int x, int y, double r, double g, double b){
+    escreve_pixel(formato_pixels, linha(y) + x * bytes_por_pixel(formato_pixels), r, g, b);
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
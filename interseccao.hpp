@@ -0,0 +1,52 @@
+/**
+ * \file interseccao.hpp
+ *
+ * \brief Este arquivo e um pacote que contem a definicao do registro de interseccao, isto e, tudo o que o sombreamento precisa saber
+ * sobre o ponto em que um raio atingiu uma primitiva. O registro e preenchido por quem traca o raio e apenas lido pela luz, de modo que
+ * a mesma luz pode ser utilizada por varias threads ao mesmo tempo.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _INTERSECCAO_HPP
+#define _INTERSECCAO_HPP
+
+#include "vetor.hpp"	//rayTracing::Vetor
+#include "primitivas.hpp"	//rayTracing::IdPrimitiva
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \struct Interseccao
+   *
+   * \brief Registro de uma interseccao entre um raio e uma primitiva.
+   */
+  struct Interseccao{
+    Vetor ponto;	///< Ponto de interseccao
+    Vetor normal;	///< Normal (unitaria) da primitiva no ponto
+    Vetor observador;	///< Origem do raio (posicao da camera para os raios primarios)
+    double t;		///< Parametro do raio no ponto de interseccao
+    IdPrimitiva primitiva;	///< Primitiva interceptada (tipo e indice na cena compilada)
+  };
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
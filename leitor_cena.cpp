@@ -0,0 +1,411 @@
+/**
+ * \file leitor_cena.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo leitor_cena.hpp, sendo este responsavel pela leitura das
+ * cenas descritas em arquivos texto.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "leitor_cena.hpp"	//rayTracing::DescricaoCena
+#include "leitor_obj.hpp"	//rayTracing::carregar_obj
+#include <stdio.h>		//fopen, fread, sprintf
+#include <stdlib.h>		//strtod, strtol
+#include <string.h>		//strcmp, strchr
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \fn static char* proxima_palavra(char** c);
+   *
+   * \brief Retorna a proxima palavra da linha, terminada em '\\0' no proprio buffer, e avanca o cursor; NULL no fim da linha.
+   */
+  static char*
+  proxima_palavra(char** c){
+    char* p = *c;
+    while (*p == ' ' || *p == '\t' || *p == '\r'){
+      p++;
+    }
+    if (*p == '\0'){
+      *c = p;
+      return NULL;
+    }
+    char* inicio = p;
+    while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '\r'){
+      p++;
+    }
+    if (*p != '\0'){
+      *p++ = '\0';
+    }
+    *c = p;
+    return inicio;
+  }
+
+  /**
+   * \fn static bool fim_linha(const char* c);
+   *
+   * \brief Indica se resta apenas espaco em branco na linha.
+   */
+  static bool
+  fim_linha(const char* c){
+    while (*c == ' ' || *c == '\t' || *c == '\r'){
+      c++;
+    }
+    return *c == '\0';
+  }
+
+  /**
+   * \fn static bool le_numeros(char** c, double* valores, int n);
+   *
+   * \brief Le n numeros reais da linha.
+   *
+   * \return false se faltar algum numero ou se uma palavra nao for um numero.
+   */
+  static bool
+  le_numeros(char** c, double* valores, int n){
+    for (int k = 0; k < n; k++){
+      char* palavra = proxima_palavra(c);
+      if (palavra == NULL){
+	return false;
+      }
+      char* fim;
+      valores[k] = strtod(palavra, &fim);
+      if (fim == palavra || *fim != '\0'){
+	return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * \fn static bool le_inteiro(char** c, int* valor);
+   *
+   * \brief Le um numero inteiro da linha.
+   */
+  static bool
+  le_inteiro(char** c, int* valor){
+    char* palavra = proxima_palavra(c);
+    if (palavra == NULL){
+      return false;
+    }
+    char* fim;
+    *valor = (int) strtol(palavra, &fim, 10);
+    return fim != palavra && *fim == '\0';
+  }
+
+  //------------------------------
+  //	Metodos privados
+  //------------------------------
+  /**
+   * \fn bool DescricaoCena::erro(const std::string& descricao);
+   *
+   * \brief Guarda a mensagem do erro da linha atual e retorna false.
+   */
+  bool
+  DescricaoCena::erro(const std::string& descricao){
+    mensagem = descricao;
+    return false;
+  }
+
+  /**
+   * \fn bool DescricaoCena::comando(char* c);
+   *
+   * \brief Interpreta uma linha terminada em '\\0', ja sem o comentario. Cada comando le exatamente os seus argumentos; texto
+   * sobrando no fim da linha e um erro.
+   *
+   * \return false em caso de erro, com a mensagem preenchida.
+   */
+  bool
+  DescricaoCena::comando(char* c){
+    char* nome = proxima_palavra(&c);
+    if (nome == NULL){
+      return true;	//Linha vazia
+    }
+    ArmazemPrimitivas& armazem = cena_descrita.primitivas();
+    double v[10];
+
+    if (strcmp(nome, "imagem") == 0){
+      if (!le_inteiro(&c, &lado_imagem) || !le_inteiro(&c, &altura_imagem)){
+	return erro("imagem espera LADO ALTURA inteiros");
+      }
+      if (lado_imagem <= 0 || altura_imagem <= 0){
+	return erro("dimensoes da imagem devem ser positivas");
+      }
+      cena_descrita.dimensao_imagem(lado_imagem, altura_imagem);
+    }
+    else if (strcmp(nome, "fundo") == 0){
+      if (!le_numeros(&c, v, 3)){
+	return erro("fundo espera R G B");
+      }
+      cena_descrita.atualizar_cor_background(v[0], v[1], v[2]);
+    }
+    else if (strcmp(nome, "ambiente") == 0){
+      if (!le_numeros(&c, v, 1)){
+	return erro("ambiente espera KA");
+      }
+      cena_descrita.atualizar_ka(v[0]);
+    }
+    else if (strcmp(nome, "camera") == 0){
+      char* tipo = proxima_palavra(&c);
+      if (tipo != NULL && strcmp(tipo, "janela") == 0){
+	if (!le_numeros(&c, v, 3)){
+	  return erro("camera janela espera X Y Z");
+	}
+	tipo_camera = CAMERA_JANELA;
+	pos_camera = Vetor(v[0], v[1], v[2]);
+      }
+      else if (tipo != NULL && strcmp(tipo, "perspectiva") == 0){
+	if (!le_numeros(&c, v, 10)){
+	  return erro("camera perspectiva espera X Y Z AX AY AZ UX UY UZ FOV");
+	}
+	if (v[9] <= 0.0 || v[9] >= 180.0){
+	  return erro("abertura da camera deve estar entre 0 e 180 graus");
+	}
+	Camera teste;
+	if (!teste.de_lookat(Vetor(v[0], v[1], v[2]), Vetor(v[3], v[4], v[5]), Vetor(v[6], v[7], v[8]), v[9], 1, 1)){
+	  return erro("camera degenerada: o alvo coincide com a posicao ou up e nulo ou paralelo a direcao de visao");
+	}
+	tipo_camera = CAMERA_PERSPECTIVA;
+	pos_camera = Vetor(v[0], v[1], v[2]);
+	alvo_camera = Vetor(v[3], v[4], v[5]);
+	cima_camera = Vetor(v[6], v[7], v[8]);
+	abertura = v[9];
+      }
+      else{
+	return erro("camera espera janela ou perspectiva");
+      }
+    }
+    else if (strcmp(nome, "luz") == 0){
+      if (n_luzes > 0){
+	return erro("o renderizador suporta uma unica luz por cena");
+      }
+      if (!le_numeros(&c, v, 9)){
+	return erro("luz espera X Y Z KA IA IR IG IB FAT");
+      }
+      luz_descrita.posicao_luz(v[0], v[1], v[2]);
+      luz_descrita.atualizar_constantes_phong(v[3], v[4], v[5], v[6], v[7], v[8]);
+      n_luzes++;
+    }
+    else if (strcmp(nome, "material") == 0){
+      char* nome_material = proxima_palavra(&c);
+      if (nome_material == NULL || !le_numeros(&c, v, 5)){
+	return erro("material espera NOME R G B KD KS [BRILHO]");
+      }
+      v[5] = BRILHO_PADRAO;
+      if (!fim_linha(c) && !le_numeros(&c, v + 5, 1)){
+	return erro("brilho do material invalido");
+      }
+      if (v[0] == 0.0 && v[1] == 0.0 && v[2] == 0.0){
+	return erro("cor do material nao pode ser nula");
+      }
+      if (materiais.count(nome_material) > 0){
+	return erro(std::string("material ja definido: ") + nome_material);
+      }
+      int indice_material = armazem.incluir_material(Vetor(v[0], v[1], v[2]), v[3], v[4], v[5]);
+      if (indice_material < 0){
+	return erro("sem memoria para o material");
+      }
+      materiais[nome_material] = indice_material;
+    }
+    else if (strcmp(nome, "esfera") == 0 || strcmp(nome, "plano") == 0){
+      bool esfera = (nome[0] == 'e');
+      if (!le_numeros(&c, v, esfera ? 4 : 6)){
+	return erro(esfera ? "esfera espera X Y Z RAIO MATERIAL" : "plano espera X Y Z NX NY NZ MATERIAL");
+      }
+      char* nome_material = proxima_palavra(&c);
+      if (nome_material == NULL){
+	return erro("falta o material");
+      }
+      std::map<std::string, int>::const_iterator material = materiais.find(nome_material);
+      if (material == materiais.end()){
+	return erro(std::string("material nao definido: ") + nome_material);
+      }
+      if (esfera){
+	if (v[3] <= 0.0){
+	  return erro("raio da esfera deve ser positivo");
+	}
+	if (armazem.incluir_esfera(Vetor(v[0], v[1], v[2]), v[3], material->second) == PRIMITIVA_NENHUMA){
+	  return erro("sem memoria para a esfera");
+	}
+      }
+      else{
+	if (v[3] == 0.0 && v[4] == 0.0 && v[5] == 0.0){
+	  return erro("normal do plano nao pode ser nula");
+	}
+	if (armazem.incluir_plano(Vetor(v[0], v[1], v[2]), Vetor(v[3], v[4], v[5]), material->second) == PRIMITIVA_NENHUMA){
+	  return erro("sem memoria para o plano");
+	}
+      }
+    }
+    else if (strcmp(nome, "malha") == 0){
+      char* arquivo = proxima_palavra(&c);
+      char* nome_material = proxima_palavra(&c);
+      if (arquivo == NULL || nome_material == NULL){
+	return erro("malha espera ARQUIVO MATERIAL [escala S] [posicao X Y Z]");
+      }
+      std::map<std::string, int>::const_iterator material = materiais.find(nome_material);
+      if (material == materiais.end()){
+	return erro(std::string("material nao definido: ") + nome_material);
+      }
+      double escala = 1.0;
+      Vetor posicao;
+      for (char* opcao = proxima_palavra(&c); opcao != NULL; opcao = proxima_palavra(&c)){
+	if (strcmp(opcao, "escala") == 0 && le_numeros(&c, v, 1)){
+	  escala = v[0];
+	}
+	else if (strcmp(opcao, "posicao") == 0 && le_numeros(&c, v, 3)){
+	  posicao = Vetor(v[0], v[1], v[2]);
+	}
+	else{
+	  return erro(std::string("opcao de malha invalida: ") + opcao);
+	}
+      }
+      std::string caminho = (arquivo[0] == '/') ? std::string(arquivo) : diretorio + arquivo;
+      int linha_obj = 0;
+      const char* mensagem_obj = NULL;
+      if (!carregar_obj(caminho.c_str(), armazem, material->second, escala, posicao, &linha_obj, &mensagem_obj)){
+	char numero[32];
+	sprintf(numero, "%d", linha_obj);
+	return erro(caminho + ":" + numero + ": " + mensagem_obj);
+      }
+      return true;
+    }
+    else if (strcmp(nome, "sombras") == 0){
+      char* valor = proxima_palavra(&c);
+      if (valor != NULL && strcmp(valor, "sim") == 0){
+	tracar_sombras = true;
+      }
+      else if (valor != NULL && strcmp(valor, "nao") == 0){
+	tracar_sombras = false;
+      }
+      else{
+	return erro("sombras espera sim ou nao");
+      }
+    }
+    else if (strcmp(nome, "threads") == 0){
+      if (!le_inteiro(&c, &numero_threads) || numero_threads < 0){
+	return erro("threads espera um inteiro nao negativo");
+      }
+    }
+    else{
+      return erro(std::string("comando desconhecido: ") + nome);
+    }
+
+    if (!fim_linha(c)){
+      return erro(std::string("argumentos a mais para ") + nome);
+    }
+    return true;
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn DescricaoCena::DescricaoCena();
+   *
+   * \brief Construtor da classe. A cena inicial e vazia, com imagem de 300 x 300 pixels e camera de janela na origem.
+   */
+  DescricaoCena::DescricaoCena(){
+    n_luzes = 0;
+    tipo_camera = CAMERA_JANELA;
+    cima_camera = Vetor(0.0, 1.0, 0.0);
+    abertura = 60.0;
+    lado_imagem = 300;
+    altura_imagem = 300;
+    cena_descrita.dimensao_imagem(lado_imagem, altura_imagem);
+    tracar_sombras = false;
+    numero_threads = 0;
+    linha = 0;
+  }
+
+  /**
+   * \fn bool DescricaoCena::carregar(const char* nome_arquivo);
+   *
+   * \brief Le o arquivo da cena inteiro para a memoria e o percorre uma unica vez: cada linha e terminada em '\\0' no proprio buffer,
+   * o comentario e cortado e o comando e interpretado, incluindo as primitivas no armazem a medida que sao lidas.
+   *
+   * \return false em caso de erro; linha_erro() e mensagem_erro() descrevem o primeiro erro encontrado.
+   */
+  bool
+  DescricaoCena::carregar(const char* nome_arquivo){
+    linha = 0;
+    mensagem.clear();
+    FILE* arquivo = fopen(nome_arquivo, "rb");
+    if (arquivo == NULL){
+      return erro("nao foi possivel abrir o arquivo");
+    }
+    fseek(arquivo, 0, SEEK_END);
+    long tamanho = ftell(arquivo);
+    fseek(arquivo, 0, SEEK_SET);
+    if (tamanho < 0){
+      fclose(arquivo);
+      return erro("nao foi possivel ler o arquivo");
+    }
+    char* texto = new char[tamanho + 1];
+    size_t lidos = fread(texto, 1, (size_t) tamanho, arquivo);
+    fclose(arquivo);
+    texto[lidos] = '\0';
+
+    const char* barra = strrchr(nome_arquivo, '/');
+    diretorio = (barra != NULL) ? std::string(nome_arquivo, barra + 1) : std::string();
+
+    bool ok = true;
+    char* inicio = texto;
+    while (ok && *inicio != '\0'){
+      linha++;
+      char* fim = strchr(inicio, '\n');
+      char* proxima = (fim != NULL) ? fim + 1 : inicio + strlen(inicio);
+      if (fim != NULL){
+	*fim = '\0';
+      }
+      char* comentario = strchr(inicio, '#');
+      if (comentario != NULL){
+	*comentario = '\0';
+      }
+      ok = comando(inicio);
+      inicio = proxima;
+    }
+    delete[] texto;
+    if (ok){
+      linha = 0;
+    }
+    return ok;
+  }
+
+  /**
+   * \fn bool DescricaoCena::montar_camera(Camera& camera, const Vetor& lookfrom, int lado, int altura) const;
+   *
+   * \brief Monta a camera descrita para uma imagem lado x altura, com a posicao dada.
+   *
+   * \return false se as dimensoes nao forem validas ou se a base da camera perspectiva for degenerada na posicao dada.
+   */
+  bool
+  DescricaoCena::montar_camera(Camera& camera, const Vetor& lookfrom, int lado, int altura) const{
+    if (tipo_camera == CAMERA_PERSPECTIVA){
+      if (lado <= 0 || altura <= 0){
+	return false;
+      }
+      return camera.de_lookat(lookfrom, alvo_camera, cima_camera, abertura, lado, altura);
+    }
+    return camera.de_janela_ortografica(lookfrom, lado, altura);
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
@@ -0,0 +1,259 @@
+/**
+ * \file leitor_cena.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo leitor_cena.cpp, sendo
+ * este responsavel pela leitura das cenas descritas em arquivos texto (.cena). Cada linha e um comando seguido dos seus argumentos,
+ * separados por espacos; '#' inicia um comentario ate o fim da linha:
+ *
+ *   imagem LADO ALTURA				dimensoes da imagem (padrao 300 300)
+ *   fundo R G B				cor do background
+ *   ambiente KA				constante do ambiente da cena
+ *   camera janela X Y Z			camera do visualizador (projecao na janela) na posicao dada
+ *   camera perspectiva X Y Z AX AY AZ UX UY UZ FOV	camera perspectiva: posicao, alvo, "para cima" e abertura em graus
+ *   luz X Y Z KA IA IR IG IB FAT		luz pontual: posicao e constantes de phong (uma luz por cena)
+ *   material NOME R G B KD KS [BRILHO]		material nomeado, usado pelas primitivas seguintes
+ *   esfera X Y Z RAIO MATERIAL			esfera
+ *   plano X Y Z NX NY NZ MATERIAL		plano infinito por um ponto, com a normal dada
+ *   malha ARQUIVO.obj MATERIAL [escala S] [posicao X Y Z]	malha de triangulos (caminho relativo ao arquivo da cena)
+ *   sombras sim|nao				tracado dos raios de sombra
+ *   threads N					numero de threads (0 utiliza todos os processadores)
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _LEITOR_CENA_HPP
+#define _LEITOR_CENA_HPP
+
+#include "vetor.hpp"	//rayTracing::Vetor
+#include "cena.hpp"	//rayTracing::Cena
+#include "luz.hpp"	//rayTracing::Luz
+#include "camera.hpp"	//rayTracing::Camera
+#include <map>		//map
+#include <string>	//string
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \enum TipoCamera
+   *
+   * \brief Forma de montar a camera de uma cena descrita.
+   */
+  enum TipoCamera{
+    CAMERA_JANELA = 0,		///< Camera::de_janela_ortografica (a do visualizador)
+    CAMERA_PERSPECTIVA = 1	///< Camera::de_lookat
+  };
+
+  /**
+   * \class DescricaoCena
+   *
+   * \brief Cena lida de um arquivo .cena: as primitivas vao direto para o armazem da Cena, sem objetos intermediarios, e a luz, a
+   * camera e as opcoes de renderizacao ficam guardadas para quem vai renderizar.
+   */
+  class DescricaoCena{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    Cena cena_descrita;			///< Cena com as primitivas lidas
+    Luz luz_descrita;			///< Luz da cena
+    int n_luzes;			///< Numero de comandos luz lidos
+    TipoCamera tipo_camera;		///< Forma de montar a camera
+    Vetor pos_camera;			///< Posicao da camera (lookfrom)
+    Vetor alvo_camera;			///< Alvo da camera perspectiva (lookat)
+    Vetor cima_camera;			///< Direcao "para cima" da camera perspectiva
+    double abertura;			///< Abertura vertical da camera perspectiva, em graus
+    int lado_imagem;			///< Lado da imagem
+    int altura_imagem;			///< Altura da imagem
+    bool tracar_sombras;		///< Tracado dos raios de sombra
+    int numero_threads;			///< Numero de threads
+    std::map<std::string, int> materiais;	///< Indice no armazem de cada material nomeado
+    std::string diretorio;		///< Diretorio do arquivo da cena, base dos caminhos relativos
+    int linha;				///< Linha do ultimo erro
+    std::string mensagem;		///< Descricao do ultimo erro
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    /**
+     * \fn bool comando(char* c);
+     *
+     * \brief Interpreta uma linha terminada em '\\0', ja sem o comentario.
+     *
+     * \return false em caso de erro, com a mensagem preenchida.
+     */
+    bool comando(char* c);
+
+    /**
+     * \fn bool erro(const std::string& descricao);
+     *
+     * \brief Guarda a mensagem do erro da linha atual e retorna false.
+     */
+    bool erro(const std::string& descricao);
+
+    //Copia nao permitida
+    DescricaoCena(const DescricaoCena&);
+    DescricaoCena& operator=(const DescricaoCena&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn DescricaoCena();
+     *
+     * \brief Construtor da classe. A cena inicial e vazia, com imagem de 300 x 300 pixels e camera de janela na origem.
+     */
+    DescricaoCena();
+
+    /**
+     * \fn bool carregar(const char* nome_arquivo);
+     *
+     * \brief Le o arquivo da cena em uma unica passada, incluindo as primitivas no armazem a medida que sao lidas. As dimensoes da
+     * imagem lidas sao aplicadas a cena com Cena::dimensao_imagem.
+     *
+     * \return false em caso de erro; linha_erro() e mensagem_erro() descrevem o primeiro erro encontrado.
+     */
+    bool carregar(const char* nome_arquivo);
+
+    /**
+     * \fn int linha_erro() const;
+     *
+     * \brief Retorna a linha do erro da ultima leitura (0 se o arquivo nao pode ser lido).
+     */
+    int linha_erro() const;
+
+    /**
+     * \fn const char* mensagem_erro() const;
+     *
+     * \brief Retorna a descricao do erro da ultima leitura.
+     */
+    const char* mensagem_erro() const;
+
+    /**
+     * \fn Cena* cena();
+     *
+     * \brief Retorna a cena montada.
+     */
+    Cena* cena();
+
+    /**
+     * \fn const Luz* luz() const;
+     *
+     * \brief Retorna a luz da cena.
+     */
+    const Luz* luz() const;
+
+    /**
+     * \fn const Vetor& lookfrom() const;
+     *
+     * \brief Retorna a posicao da camera.
+     */
+    const Vetor& lookfrom() const;
+
+    /**
+     * \fn bool montar_camera(Camera& camera, const Vetor& lookfrom, int lado, int altura) const;
+     *
+     * \brief Monta a camera descrita para uma imagem lado x altura, com a posicao dada (normalmente lookfrom()).
+     *
+     * \return false se as dimensoes nao forem validas ou se a base da camera perspectiva for degenerada na posicao dada (Camera::de_lookat).
+     */
+    bool montar_camera(Camera& camera, const Vetor& lookfrom, int lado, int altura) const;
+
+    /**
+     * \fn int lado() const;
+     *
+     * \brief Retorna o lado da imagem descrita.
+     */
+    int lado() const;
+
+    /**
+     * \fn int altura() const;
+     *
+     * \brief Retorna a altura da imagem descrita.
+     */
+    int altura() const;
+
+    /**
+     * \fn bool sombras() const;
+     *
+     * \brief Indica se a cena pede o tracado dos raios de sombra.
+     */
+    bool sombras() const;
+
+    /**
+     * \fn int threads() const;
+     *
+     * \brief Retorna o numero de threads pedido pela cena (0 utiliza todos os processadores).
+     */
+    int threads() const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline int
+  DescricaoCena::linha_erro() const{
+    return linha;
+  }
+
+  inline const char*
+  DescricaoCena::mensagem_erro() const{
+    return mensagem.c_str();
+  }
+
+  inline Cena*
+  DescricaoCena::cena(){
+    return &cena_descrita;
+  }
+
+  inline const Luz*
+  DescricaoCena::luz() const{
+    return &luz_descrita;
+  }
+
+  inline const Vetor&
+  DescricaoCena::lookfrom() const{
+    return pos_camera;
+  }
+
+  inline int
+  DescricaoCena::lado() const{
+    return lado_imagem;
+  }
+
+  inline int
+  DescricaoCena::altura() const{
+    return altura_imagem;
+  }
+
+  inline bool
+  DescricaoCena::sombras() const{
+    return tracar_sombras;
+  }
+
+  inline int
+  DescricaoCena::threads() const{
+    return numero_threads;
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
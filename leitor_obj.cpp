@@ -0,0 +1,268 @@
+/**
+ * \file leitor_obj.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo leitor_obj.hpp, sendo este responsavel pela leitura de malhas
+ * de triangulos no formato Wavefront OBJ.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "leitor_obj.hpp"	//rayTracing::carregar_obj
+#include <stdio.h>		//fopen, fread
+#include <stdlib.h>		//strtod, strtol
+#include <string.h>		//memmove, memcpy
+#include <vector>		//vector
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //Tamanho do bloco lido do arquivo a cada fread
+  static const size_t TAMANHO_BLOCO_OBJ = 1 << 20;
+
+  /**
+   * \fn static const char* pula_espacos(const char* c);
+   *
+   * \brief Avanca sobre espacos e tabulacoes (e o '\\r' de arquivos gravados no Windows).
+   */
+  static const char*
+  pula_espacos(const char* c){
+    while (*c == ' ' || *c == '\t' || *c == '\r'){
+      c++;
+    }
+    return c;
+  }
+
+  /**
+   * \fn static bool le_indice(const char** c, long* indice);
+   *
+   * \brief Le um indice inteiro em *c e avanca o cursor.
+   *
+   * \return false se nao houver um numero no cursor.
+   */
+  static bool
+  le_indice(const char** c, long* indice){
+    char* fim;
+    *indice = strtol(*c, &fim, 10);
+    if (fim == *c){
+      return false;
+    }
+    *c = fim;
+    return true;
+  }
+
+  /**
+   * \class LeitorObj
+   *
+   * \brief Estado da leitura de um arquivo: o armazem, a transformacao dos vertices e os vertices ja lidos do arquivo.
+   */
+  class LeitorObj{
+  public:
+    ArmazemPrimitivas* armazem;	///< Armazem que recebe a malha
+    int material;		///< Material dos triangulos
+    double escala;		///< Escala dos vertices
+    Vetor deslocamento;		///< Translacao dos vertices
+    int primeiro_vertice;	///< Indice no armazem do primeiro vertice do arquivo
+    int n_vertices;		///< Numero de vertices lidos do arquivo
+    int n_triangulos;		///< Numero de triangulos incluidos
+    std::vector<int> face;	///< Vertices (no armazem) da face em leitura
+    const char* erro;		///< Descricao do erro, se houver
+
+    /**
+     * \fn bool vertice(const char* c);
+     *
+     * \brief Le as coordenadas de uma linha "v".
+     */
+    bool vertice(const char* c){
+      double p[3];
+      for (int e = 0; e < 3; e++){
+	char* fim;
+	c = pula_espacos(c);
+	p[e] = strtod(c, &fim);
+	if (fim == c){
+	  erro = "vertice com menos de tres coordenadas";
+	  return false;
+	}
+	c = fim;
+      }
+      if (armazem->incluir_vertice(Vetor(p[0], p[1], p[2]) * escala + deslocamento) < 0){
+	erro = "sem memoria para os vertices";
+	return false;
+      }
+      n_vertices++;
+      return true;
+    }
+
+    /**
+     * \fn bool face_obj(const char* c);
+     *
+     * \brief Le uma linha "f" e inclui os seus triangulos, dividindo a face em leque a partir do primeiro vertice.
+     */
+    bool face_obj(const char* c){
+      face.clear();
+      for (c = pula_espacos(c); *c != '\0'; c = pula_espacos(c)){
+	long indice, ignorado;
+	if (!le_indice(&c, &indice)){
+	  erro = "indice de vertice invalido";
+	  return false;
+	}
+	//Coordenada de textura e normal sao lidas apenas para validar a sintaxe
+	if (*c == '/'){
+	  c++;
+	  if (*c != '/' && !le_indice(&c, &ignorado)){
+	    erro = "indice de textura invalido";
+	    return false;
+	  }
+	  if (*c == '/'){
+	    c++;
+	    if (!le_indice(&c, &ignorado)){
+	      erro = "indice de normal invalido";
+	      return false;
+	    }
+	  }
+	}
+	if (*c != '\0' && *c != ' ' && *c != '\t' && *c != '\r'){
+	  erro = "caractere inesperado na face";
+	  return false;
+	}
+	//Indices positivos contam a partir de 1; negativos, a partir do ultimo vertice lido
+	long v = (indice > 0) ? indice - 1 : n_vertices + indice;
+	if (indice == 0 || v < 0 || v >= n_vertices){
+	  erro = "indice de vertice fora do intervalo";
+	  return false;
+	}
+	face.push_back(primeiro_vertice + (int) v);
+      }
+      if (face.size() < 3){
+	erro = "face com menos de tres vertices";
+	return false;
+      }
+      for (size_t k = 1; k + 1 < face.size(); k++){
+	if (armazem->incluir_triangulo(face[0], face[k], face[k + 1], material) == PRIMITIVA_NENHUMA){
+	  erro = "sem memoria para os triangulos";
+	  return false;
+	}
+	n_triangulos++;
+      }
+      return true;
+    }
+
+    /**
+     * \fn bool linha(const char* c);
+     *
+     * \brief Interpreta uma linha terminada em '\\0'.
+     */
+    bool linha(const char* c){
+      c = pula_espacos(c);
+      if (c[0] == 'v' && (c[1] == ' ' || c[1] == '\t')){
+	return vertice(c + 2);
+      }
+      if (c[0] == 'f' && (c[1] == ' ' || c[1] == '\t')){
+	return face_obj(c + 2);
+      }
+      return true;
+    }
+  };
+
+  /**
+   * \fn bool carregar_obj(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, double escala,
+   * const Vetor& deslocamento, int* linha_erro, const char** mensagem_erro);
+   *
+   * \brief Le um arquivo OBJ e inclui os seus vertices e triangulos no armazem. O arquivo e lido em blocos de TAMANHO_BLOCO_OBJ bytes;
+   * as linhas completas de cada bloco sao terminadas em '\\0' no proprio bloco e a linha incompleta do fim e levada para o inicio do
+   * proximo. Uma linha maior que o bloco dobra o bloco.
+   *
+   * \return false em caso de erro; os triangulos ja incluidos do arquivo sao entao excluidos do armazem.
+   */
+  bool
+  carregar_obj(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, double escala,
+	       const Vetor& deslocamento, int* linha_erro, const char** mensagem_erro){
+    FILE* arquivo = fopen(nome_arquivo, "rb");
+    if (arquivo == NULL){
+      if (linha_erro != NULL) *linha_erro = 0;
+      if (mensagem_erro != NULL) *mensagem_erro = "nao foi possivel abrir o arquivo";
+      return false;
+    }
+
+    LeitorObj leitor;
+    leitor.armazem = &armazem;
+    leitor.material = material;
+    leitor.escala = escala;
+    leitor.deslocamento = deslocamento;
+    leitor.primeiro_vertice = armazem.numero_vertices();
+    leitor.n_vertices = 0;
+    leitor.n_triangulos = 0;
+    leitor.erro = NULL;
+
+    size_t capacidade = TAMANHO_BLOCO_OBJ;
+    char* bloco = new char[capacidade + 1];
+    size_t usados = 0;		//Bytes da linha incompleta trazida do bloco anterior
+    int numero_linha = 0;
+    bool fim_arquivo = false;
+    while (!fim_arquivo && leitor.erro == NULL){
+      if (usados == capacidade){
+	char* maior = new char[2 * capacidade + 1];
+	memcpy(maior, bloco, usados);
+	delete[] bloco;
+	bloco = maior;
+	capacidade *= 2;
+      }
+      size_t lidos = fread(bloco + usados, 1, capacidade - usados, arquivo);
+      fim_arquivo = (lidos < capacidade - usados);
+      size_t total = usados + lidos;
+      bloco[total] = '\0';
+
+      //Interpretando as linhas completas (e, no fim do arquivo, a ultima linha sem '\n')
+      size_t inicio = 0;
+      for (size_t k = 0; k < total && leitor.erro == NULL; k++){
+	if (bloco[k] == '\n'){
+	  bloco[k] = '\0';
+	  numero_linha++;
+	  leitor.linha(bloco + inicio);
+	  inicio = k + 1;
+	}
+      }
+      if (leitor.erro == NULL && fim_arquivo && inicio < total){
+	numero_linha++;
+	leitor.linha(bloco + inicio);
+	inicio = total;
+      }
+      usados = total - inicio;
+      memmove(bloco, bloco + inicio, usados);
+    }
+    delete[] bloco;
+    bool falha_leitura = ferror(arquivo) != 0;
+    fclose(arquivo);
+
+    if (leitor.erro == NULL && falha_leitura){
+      leitor.erro = "erro de leitura do arquivo";
+      numero_linha = 0;
+    }
+    if (leitor.erro != NULL){
+      for (int k = 0; k < leitor.n_triangulos; k++){
+	armazem.excluir_ultima();
+      }
+      if (linha_erro != NULL) *linha_erro = numero_linha;
+      if (mensagem_erro != NULL) *mensagem_erro = leitor.erro;
+      return false;
+    }
+    return true;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
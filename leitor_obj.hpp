@@ -0,0 +1,61 @@
+/**
+ * \file leitor_obj.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo leitor_obj.cpp, sendo este
+ * responsavel pela leitura de malhas de triangulos no formato Wavefront OBJ. Os vertices e as faces vao direto para o armazem de
+ * primitivas, sem objetos intermediarios.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _LEITOR_OBJ_HPP
+#define _LEITOR_OBJ_HPP
+
+#include "vetor.hpp"		//rayTracing::Vetor
+#include "primitivas.hpp"	//rayTracing::ArmazemPrimitivas
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \fn bool carregar_obj(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, double escala = 1.0,
+   * const Vetor& deslocamento = Vetor(), int* linha_erro = NULL, const char** mensagem_erro = NULL);
+   *
+   * \brief Le um arquivo OBJ e inclui os seus vertices e triangulos no armazem, todos com o mesmo material. Sao lidas as linhas "v"
+   * (vertices) e "f" (faces, nas formas v, v/vt, v/vt/vn e v//vn, com indices positivos ou negativos); faces com mais de tres
+   * vertices sao divididas em leque. As demais linhas (normais, coordenadas de textura, grupos, materiais) sao ignoradas. O arquivo e
+   * lido em blocos e os numeros sao convertidos direto no bloco, sem copias por linha.
+   *
+   * \param nome_arquivo - caminho do arquivo OBJ
+   * \param armazem - armazem que recebe a malha
+   * \param material - indice retornado por incluir_material
+   * \param escala - fator aplicado as coordenadas dos vertices
+   * \param deslocamento - translacao aplicada apos a escala
+   * \param linha_erro - recebe a linha do erro (0 se o arquivo nao pode ser lido)
+   * \param mensagem_erro - recebe a descricao do erro
+   *
+   * \return false em caso de erro; os triangulos ja incluidos do arquivo sao entao excluidos do armazem.
+   */
+  bool carregar_obj(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, double escala = 1.0,
+		    const Vetor& deslocamento = Vetor(), int* linha_erro = NULL, const char** mensagem_erro = NULL);
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
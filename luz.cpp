@@ -38,13 +38,10 @@ namespace rayTracing{
    * \brief Construtor da classe.
    */
   Luz::Luz(){
-    //Instanciando a posicao da luz
-    pos_luz = new Vetor();
-    //Instanciando vetores n, l, o e r
-    n = new Vetor();
-    l = new Vetor();
-    o = new Vetor();
-    r = new Vetor();
+    //A posicao da luz e iniciada zerada
+    ka = 0.0;
+    Ia = Ilight_red = Ilight_green = Ilight_blue = 0.0;
+    fat = 1.0;
   }
 	
   /**
@@ -58,127 +55,24 @@ namespace rayTracing{
    */
   void 
   Luz::posicao_luz(double pos_luz_x, double pos_luz_y, double pos_luz_z){
-    pos_luz->valores_vetor(pos_luz_x, pos_luz_y, pos_luz_z);
+    pos_luz.valores_vetor(pos_luz_x, pos_luz_y, pos_luz_z);
   }
 	
   /**
-   * \fn void Luz::atualizar_vetores_auxiliares(Vetor* interseccao_esfera, Vetor* centro_esfera, Vetor* lookfrom);
+   * \fn void Luz::atualizar_constantes_phong(double _ka, double _Ia, double _Ilight_red, double _Ilight_green, double _Ilight_blue, double _fat);
    *
-   * \brief Pega todos os vetores necessarios para quantificacao da luz em um determinado ponto.
-   *
-   * \param interseccao_esfera - ponteiro para o vetor de interseccao da esfera
-   * \param centro_esfera - ponteiro para o vetor de centro da esfera
-   * \param lookfrom - ponteiro para o vetor de posicao da camera
-   */
-  void Luz::atualizar_vetores_auxiliares(Vetor* interseccao_esfera, Vetor* centro_esfera, Vetor* lookfrom){
-    //Pegando valores da interseccao_esfera
-    int_esf_x = interseccao_esfera->vx();
-    int_esf_y = interseccao_esfera->vy();
-    int_esf_z = interseccao_esfera->vz();
-	  
-    //Pegando valores do centro da esfera
-    c_esf_x = centro_esfera->vx();
-    c_esf_y = centro_esfera->vy();
-    c_esf_z = centro_esfera->vz();
-		
-    //Pegando valores da posicao da camera
-    lkf_x = lookfrom->vx();
-    lkf_y = lookfrom->vy();
-    lkf_z = lookfrom->vz();
-  }
-	
-  /**
-   * \fn void Luz::vetor_normal();
-   *
-   * \brief Encontra o vetor normal do ponto da interseccao.
-   */
-  void 
-  Luz::vetor_normal(){
-    n->valores_vetor( int_esf_x - c_esf_x, int_esf_y - c_esf_y, int_esf_z - c_esf_z );
-		
-    //Normalizando o vetor
-    double n_norma = n->norma();
-    n->valores_vetor( (int_esf_x - c_esf_x)/n_norma, (int_esf_y - c_esf_y)/n_norma, (int_esf_z - c_esf_z)/n_norma );
-  }
-	
-  /**
-   * \fn void Luz::vetor_luz();
-   *
-   * \brief Encontra o vetor da luz partindo do ponto de interseccao.
-   */
-  void 
-  Luz::vetor_luz(){
-    double x, y, z;
-    x = pos_luz->vx();
-    y = pos_luz->vy();
-    z = pos_luz->vz();
-		
-    l->valores_vetor( x - int_esf_x, y - int_esf_y, z - int_esf_z );
-		
-    //Normalizando o vetor
-    double l_norma = l->norma();
-    l->valores_vetor( (x - int_esf_x)/l_norma, (y - int_esf_y)/l_norma , (z - int_esf_z)/l_norma );
-  }
-	
-  /**
-   * \fn void Luz::vetor_observador();
-   *
-   * \brief Encontra o vetor do ponto de interseccao da esfera ate o observador
-   */
-  void 
-  Luz::vetor_observador(){
-    o->valores_vetor( lkf_x - int_esf_x, lkf_y - int_esf_y, lkf_z - int_esf_z );
-		
-    //Normalizando o vetor
-    double o_norma = o->norma();
-    o->valores_vetor( (lkf_x - int_esf_x)/o_norma, (lkf_y - int_esf_y)/o_norma, (lkf_z - int_esf_z)/o_norma );
-  }
-	
-  /**
-   * \fn void Luz::vetor_reflexao();
-   *
-   * \brief Encontra o vetor de reflexao atraves da fórmula R = 2*N*(N.L) - L
-   */
-  void 
-  Luz::vetor_reflexao(){
-    double produto_escalar_N_L = n->produto_escalar(l);
-		
-    double n_x = n->vx();
-    double n_y = n->vy();
-    double n_z = n->vz();
-		
-    double l_x = l->vx();
-    double l_y = l->vy();
-    double l_z = l->vz();
-		
-    r->valores_vetor( (2*n_x*produto_escalar_N_L) - l_x, (2*n_y*produto_escalar_N_L) - l_y, (2*n_z*produto_escalar_N_L) - l_z );
-		
-    //Normalizando o vetor
-    double r_norma = r->norma();
-    r->valores_vetor( ((2*n_x*produto_escalar_N_L) - l_x)/r_norma, ((2*n_y*produto_escalar_N_L) - l_y)/r_norma, ((2*n_z*produto_escalar_N_L) - l_z)/r_norma );
-  }
-	
-  /**
-   * \fn void Luz::atualizar_constantes_phong(double _ka, double _ks, double _kd, double _Ia, double _Ilight_red, double _Ilight_green, double _Ilight_blue, double _fat, double _nshin);
-   *
-   * \brief Atualiza as variaveis referentes as constantes de phong
+   * \brief Atualiza as variaveis referentes as constantes de phong da luz
    * 
    * \param _ka - constante ambiente
-   * \param _ks - constante especular
-   * \param _kd - constante difusa
    * \param _Ia - intensidade do ambiente
    * \param _Ilight_red - intensidade vermelha da luz
    * \param _Ilight_green - intensidade verde da luz
    * \param _Ilight_blue - intensidade azul da luz
    * \param _fat - fator de atenuacao
-   * \param _nshin - espalhamento da luz
    */
-  void Luz::atualizar_constantes_phong(double _ka, double _ks, double _kd, 
-				       double _Ia, double _Ilight_red, double _Ilight_green, double _Ilight_blue,
-				       double _fat, double _nshin){
+  void Luz::atualizar_constantes_phong(double _ka, double _Ia, double _Ilight_red, double _Ilight_green, double _Ilight_blue,
+				       double _fat){
     ka = _ka;
-    ks = _ks;
-    kd = _kd;
 		
     Ia = _Ia;
     Ilight_red = _Ilight_red;
@@ -186,85 +80,77 @@ namespace rayTracing{
     Ilight_blue = _Ilight_blue;
 		
     fat = _fat;
-    nshin = _nshin;
   }
 	
   /**
-   * \fn double Luz::calcula_luz_red();
+   * \fn Vetor Luz::calcula_luz(const Interseccao& interseccao, const Material& material) const;
    *
-   * \brief Calcula o valor da luz de intensidade vermelha para o ponto de interseccao atraves da fórmula de phong.
+   * \brief Calcula as intensidades vermelha, verde e azul da luz no ponto de interseccao atraves da fórmula de phong. Os vetores da luz
+   * (L), do observador (O) e de reflexao (R = 2*N*(N.L) - L) e a potencia especular sao calculados uma unica vez e apenas a intensidade
+   * da luz muda entre os canais. As constantes difusa e especular e o espalhamento vem do material da primitiva.
    * 
-   * \return O valor da luz no ponto de interseccao.
+   * \param interseccao - registro da interseccao (ponto, normal unitaria e observador)
+   * \param material - material da primitiva interceptada
+   *
+   * \return As intensidades vermelha, verde e azul (componentes x, y e z).
    */
-  double 
-  Luz::calcula_luz_red(){
-    //Calculando os vetores: normal, luz, observador e reflexao
-    vetor_normal();
-    vetor_luz();
-    vetor_observador();
-    vetor_reflexao();
-		
-    double produto_escalar_N_L = n->produto_escalar(l);
-    double produto_escalar_O_R = o->produto_escalar(r);
-		
-    double potencia = pow(produto_escalar_O_R, nshin);
-		
+  Vetor
+  Luz::calcula_luz(const Interseccao& interseccao, const Material& material) const{
+    //Calculando os vetores: luz, observador e reflexao (a normal ja vem normalizada)
+    const Vetor& n = interseccao.normal;
+    Vetor l = (pos_luz - interseccao.ponto).normalizado();
+    Vetor o = (interseccao.observador - interseccao.ponto).normalizado();
+    double produto_escalar_N_L = n.produto_escalar(l);
+    Vetor r = ((n * (2*produto_escalar_N_L)) - l).normalizado();
+    double produto_escalar_O_R = o.produto_escalar(r);
+    double potencia = pow(produto_escalar_O_R, material.brilho);
     //equacao de iluminacao
-    double value = (ka * Ia) + fat * Ilight_red * ( (kd * produto_escalar_N_L) + (ks * potencia) );
-		
-    return value;
+    double ambiente = ka * Ia;
+    double difusa_especular = (material.kd * produto_escalar_N_L) + (material.ks * potencia);
+    return Vetor(ambiente + fat * Ilight_red * difusa_especular,
+		 ambiente + fat * Ilight_green * difusa_especular,
+		 ambiente + fat * Ilight_blue * difusa_especular);
   }
 	
   /**
-   * \fn double Luz::calcula_luz_green();
+   * \fn ParametrosPhong Luz::parametros_phong() const;
    *
-   * \brief Calcula o valor da luz de intensidade verde para o ponto de interseccao atraves da fórmula de phong.
-   * 
-   * \return O valor da luz no ponto de interseccao.
+   * \brief Retorna as constantes da luz na forma usada pelo sombreamento dos pacotes. As intensidades ja sao multiplicadas pelo fator
+   * de atenuacao, como no inicio do produto fat * Ilight * difusa_especular de calcula_luz.
    */
-  double 
-  Luz::calcula_luz_green(){
-    //Calculando os vetores: normal, luz, observador e reflexao
-    vetor_normal();
-    vetor_luz();
-    vetor_observador();
-    vetor_reflexao();
-		
-    double produto_escalar_N_L = n->produto_escalar(l);
-    double produto_escalar_O_R = o->produto_escalar(r);
-		
-    double potencia = pow(produto_escalar_O_R, nshin);
-		
-    //equacao de iluminacao
-    double value = (ka * Ia) + fat * Ilight_green * ( (kd * produto_escalar_N_L) + (ks * potencia) );
-		
-    return value;
+  ParametrosPhong
+  Luz::parametros_phong() const{
+    ParametrosPhong p;
+    p.posicao[0] = pos_luz.vx();
+    p.posicao[1] = pos_luz.vy();
+    p.posicao[2] = pos_luz.vz();
+    p.ambiente = ka * Ia;
+    p.intensidade[0] = fat * Ilight_red;
+    p.intensidade[1] = fat * Ilight_green;
+    p.intensidade[2] = fat * Ilight_blue;
+    return p;
   }
 	
   /**
-   * \fn double Luz::calcula_luz_blue();
+   * \fn const Vetor& Luz::posicao() const;
    *
-   * \brief Calcula o valor da luz de intensidade azul para o ponto de interseccao atraves da fórmula de phong.
+   * \brief Retorna a posicao da luz.
+   */
+  const Vetor&
+  Luz::posicao() const{
+    return pos_luz;
+  }
+	
+  /**
+   * \fn double Luz::calcula_luz_ambiente() const;
+   *
+   * \brief Calcula apenas a parcela ambiente da lei de phong, utilizada nos pontos em sombra.
    * 
-   * \return O valor da luz no ponto de interseccao.
+   * \return O valor da luz ambiente.
    */
-  double 
-  Luz::calcula_luz_blue(){
-    //Calculando os vetores: normal, luz, observador e reflexao
-    vetor_normal();
-    vetor_luz();
-    vetor_observador();
-    vetor_reflexao();
-		
-    double produto_escalar_N_L = n->produto_escalar(l);
-    double produto_escalar_O_R = o->produto_escalar(r);
-		
-    double potencia = pow(produto_escalar_O_R, nshin);
-		
-    //equacao de iluminacao
-    double value = (ka * Ia) + fat * Ilight_blue * ( (kd * produto_escalar_N_L) + (ks * potencia) );
-		
-    return value;
+  double
+  Luz::calcula_luz_ambiente() const{
+    return ka * Ia;
   }
 	
 } //Fim do namespace rayTracing
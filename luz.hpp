@@ -20,6 +20,9 @@
 #define _LUZ_HPP
 
 #include "vetor.hpp"	//rayTracing::Vetor
+#include "interseccao.hpp"	//rayTracing::Interseccao
+#include "material.hpp"	//rayTracing::Material
+#include "nucleos.hpp"	//rayTracing::ParametrosPhong
 
 /** 
  * \defgroup RayTracingNameSpace Namespace rayTracing.
@@ -35,36 +38,19 @@ namespace rayTracing{
   /**
    * \class Luz
    * 
-   * \brief Define as caracteristicas como posicao e vetores para as luzes do ambiente.
+   * \brief Define as caracteristicas como posicao e intensidades das luzes do ambiente. As constantes difusa e especular e o
+   * espalhamento pertencem ao material de cada objeto. A luz nao guarda resultados intermediarios, portanto uma unica luz pode ser
+   * compartilhada pelas threads de renderizacao.
    */
   class Luz{
     //------------------------------
     //	Atributos privados
     //------------------------------
   private:
-    Vetor* pos_luz;	///< Vetor da posicao da luz
-		
-    //Coordenadas dos vetores de interseccao com a esfera, centro da esfera e posicao da camera.
-    double int_esf_x;	///< Coordenada x do vetor de interseccao com a esfera
-    double int_esf_y;	///< Coordenada y do vetor de interseccao com a esfera
-    double int_esf_z;	///< Coordenada z do vetor de interseccao com a esfera
-    double c_esf_x;		///< Coordenada x do vetor do centro da esfera
-    double c_esf_y;		///< Coordenada y do vetor do centro da esfera
-    double c_esf_z;		///< Coordenada z do vetor do centro da esfera
-    double lkf_x;		///< Coordenada x do vetor da posicao da camera
-    double lkf_y;		///< Coordenada y do vetor da posicao da camera
-    double lkf_z;		///< Coordenada z do vetor da posicao da camera
-		
-    //Vetores para o calculo da lei de phong
-    Vetor* n;	///< Vetor da normal
-    Vetor* l; ///< Vetor do ponto de luz
-    Vetor* o; ///< Vetor do observador
-    Vetor* r; ///< Vetor da reflexao da luz
+    Vetor pos_luz;	///< Vetor da posicao da luz
 		
     //Constantes para o calculo da lei de phong
     double ka; ///< Constante ambiente
-    double ks; ///< Constante especular
-    double kd; ///< Constante difusa
 		
     double Ia; ///< Intensidade do ambiente
     double Ilight_red; ///< Intensidade vermelha da luz
@@ -72,7 +58,6 @@ namespace rayTracing{
     double Ilight_blue; ///< Intensidade azul da luz
 		
     double fat; ///< Fator de atenuacao
-    double nshin; ///< Espalhamento da luz no objeto
 		
     //------------------------------
     //	Metodos publicos
@@ -97,89 +82,57 @@ namespace rayTracing{
     void posicao_luz(double pos_luz_x, double pos_luz_y, double pos_luz_z);
 		
     /**
-     * \fn void atualizar_vetores_auxiliares(Vetor* interseccao_esfera, Vetor* centro_esfera, Vetor* lookfrom);
-     *
-     * \brief Pega todos os vetores necessarios para quantificacao da luz em um determinado ponto.
+     * \fn void atualizar_constantes_phong(double _ka, double _Ia, double _Ilight_red, double _Ilight_green, double _Ilight_blue, double _fat);
      *
-     * \param interseccao_esfera - ponteiro para o vetor de interseccao da esfera
-     * \param centro_esfera - ponteiro para o vetor de centro da esfera
-     * \param lookfrom - ponteiro para o vetor de posicao da camera
-     */
-    void atualizar_vetores_auxiliares(Vetor* interseccao_esfera, Vetor* centro_esfera, Vetor* lookfrom);
-		
-    /**
-     * \fn void vetor_normal();
-     *
-     * \brief Encontra o vetor normal do ponto da interseccao.
-     */
-    void vetor_normal();
-		
-    /**
-     * \fn void vetor_luz();
-     *
-     * \brief Encontra o vetor da luz partindo do ponto de interseccao.
-     */
-    void vetor_luz();
-		
-    /**
-     * \fn void vetor_observador();
-     *
-     * \brief Encontra o vetor do ponto de interseccao da esfera ate o observador
-     */
-    void vetor_observador();
-		
-    /**
-     * \fn void vetor_reflexao();
-     *
-     * \brief Encontra o vetor de reflexao.
-     */
-    void vetor_reflexao();
-		
-    /**
-     * \fn void atualizar_constantes_phong(double _ka, double _ks, double _kd, double _Ia, double _Ilight_red, double _Ilight_green, double _Ilight_blue, double _fat, double _nshin);
-     *
-     * \brief Atualiza as variaveis referentes as constantes de phong
+     * \brief Atualiza as variaveis referentes as constantes de phong da luz
      * 
      * \param _ka - constante ambiente
-     * \param _ks - constante especular
-     * \param _kd - constante difusa
      * \param _Ia - intensidade do ambiente
      * \param _Ilight_red - intensidade vermelha da luz
      * \param _Ilight_green - intensidade verde da luz
      * \param _Ilight_blue - intensidade azul da luz
      * \param _fat - fator de atenuacao
-     * \param _nshin - espalhamento da luz (Utilize 2.0)
      */
-    void atualizar_constantes_phong(double _ka, double _ks, double _kd, 
-				    double _Ia, double _Ilight_red, double _Ilight_green, double _Ilight_blue,
-				    double _fat, double _nshin);
+    void atualizar_constantes_phong(double _ka, double _Ia, double _Ilight_red, double _Ilight_green, double _Ilight_blue,
+				    double _fat);
 		
     /**
-     * \fn double calcula_luz_red();
+     * \fn Vetor calcula_luz(const Interseccao& interseccao, const Material& material) const;
      *
-     * \brief Calcula o valor da luz de intensidade vermelha para o ponto de interseccao.
-     * 
-     * \return O valor da luz no ponto de interseccao.
+     * \brief Calcula, atraves da formula de phong, as intensidades vermelha, verde e azul da luz no ponto de interseccao. Os vetores
+     * normal, da luz, do observador e de reflexao sao calculados uma unica vez para os tres canais. O metodo nao altera a luz e pode
+     * ser chamado por varias threads ao mesmo tempo.
+     *
+     * \param interseccao - registro da interseccao
+     * \param material - material da primitiva interceptada (kd, ks e brilho)
+     *
+     * \return As intensidades vermelha, verde e azul (componentes x, y e z).
+     */
+    Vetor calcula_luz(const Interseccao& interseccao, const Material& material) const;
+		
+    /**
+     * \fn ParametrosPhong parametros_phong() const;
+     *
+     * \brief Retorna as constantes da luz na forma usada pelo sombreamento dos pacotes (sombrear_pacote), que repete as contas de
+     * calcula_luz.
      */
-    double calcula_luz_red();
+    ParametrosPhong parametros_phong() const;
 
     /**
-     * \fn double calcula_luz_green();
+     * \fn const Vetor& posicao() const;
      *
-     * \brief Calcula o valor da luz de intensidade verde para o ponto de interseccao.
-     * 
-     * \return O valor da luz no ponto de interseccao.
+     * \brief Retorna a posicao da luz.
      */
-    double calcula_luz_green();
+    const Vetor& posicao() const;
 		
     /**
-     * \fn double calcula_luz_blue();
+     * \fn double calcula_luz_ambiente() const;
      *
-     * \brief Calcula o valor da luz de intensidade azul para o ponto de interseccao.
-     * 
-     * \return O valor da luz no ponto de interseccao.
+     * \brief Calcula apenas a parcela ambiente da lei de phong, utilizada nos pontos em sombra.
+     *
+     * \return O valor da luz ambiente.
      */
-    double calcula_luz_blue();
+    double calcula_luz_ambiente() const;
 				
   };
 
@@ -33,6 +33,9 @@
 
 #include <iostream> //std::endl, std::cin e std::cout
 #include <ctime> //clock		
+#include <cstdlib> //atoi, exit
+#include <cstring> //strcmp
+#include <pthread.h> //pthread_create, pthread_mutex_t
 #include "cena.hpp" //rayTracing::Cena
 #include "objeto.hpp" //rayTracing::Objeto
 #include "vetor.hpp" //rayTracing::Vetor
@@ -40,6 +43,13 @@
 #include "luz.hpp" //rayTracing::Luz
 #include "textura.hpp" //rayTracing::Textura
 #include "ray_tracing.hpp" //rayTracing::Ray_tracing
+#include "nucleos.hpp" //rayTracing::selecionar_nucleos
+#include "imagem.hpp" //rayTracing::Imagem
+#include "cena_exemplo.hpp" //rayTracing::CenaExemplo
+#include "leitor_cena.hpp" //rayTracing::DescricaoCena
+#include "cena_compilada.hpp" //rayTracing::CenaCompilada
+#include "camera.hpp" //rayTracing::Camera
+#include "quadros.hpp" //rayTracing::TrocaQuadros
 
 using rayTracing::Vetor;
 using rayTracing::Raio;
@@ -48,8 +58,29 @@ using rayTracing::Cena;
 using rayTracing::Objeto;
 using rayTracing::Textura;
 using rayTracing::Ray_tracing;
+using rayTracing::selecionar_nucleos;
+using rayTracing::nucleos_ativos;
+using rayTracing::Imagem;
+using rayTracing::CenaExemplo;
+using rayTracing::DescricaoCena;
+using rayTracing::CenaCompilada;
+using rayTracing::Camera;
+using rayTracing::TrocaQuadros;
 
-GLubyte imagem[300][300][3];
+TrocaQuadros quadros; //Imagens pintada, pronta e desenhada, trocadas sem travas entre a renderizacao e a janela
+int numero_threads = -1; //Numero de threads da renderizacao (0 utiliza todos os processadores, -1 usa o da cena)
+bool tracar_sombras = false; //Indica se os raios de sombra sao tracados
+const char* nome_nucleos = NULL; //Variante dos nucleos vetoriais pedida (NULL escolhe pelo processador)
+CenaExemplo* exemplo = NULL; //Cena de demonstracao, montada uma unica vez
+DescricaoCena* descricao = NULL; //Cena lida do arquivo passado em --cena (NULL mostra a cena de demonstracao)
+Cena* cena_montada = NULL; //Cena mostrada (a de demonstracao ou a do arquivo)
+const Luz* luz_cena = NULL; //Luz da cena mostrada
+Vetor posicao_camera; //Posicao da camera (alterada pelas setas do teclado)
+pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER; //Protege os pedidos de renderizacao
+pthread_cond_t novo_pedido = PTHREAD_COND_INITIALIZER; //Acorda a thread de renderizacao
+int versao_pedida = 0; //Incrementada a cada mudanca na camera, na luz ou na cena
+const int INTERVALO_QUADROS = 16; //Intervalo (ms) entre as apresentacoes de quadros
+const double PASSO_CAMERA = 10.0; //Deslocamento da camera a cada tecla
 /**
  * \fn void print_pixel(int x, int y, double red, double green, double blue);
  *
@@ -74,124 +105,157 @@ void init(void){
   glClearColor(0.0, 0.0, 0.0, 0.0);
 }
 
+/**
+ * \fn void pedir_renderizacao(void);
+ *
+ * \brief Agenda uma nova renderizacao. Deve ser chamada sempre que a camera, a luz ou a cena mudarem; pedidos feitos durante uma
+ * renderizacao sao atendidos por uma unica renderizacao seguinte.
+ */
+void pedir_renderizacao(void){
+  pthread_mutex_lock(&trava);
+  versao_pedida++;
+  pthread_cond_signal(&novo_pedido);
+  pthread_mutex_unlock(&trava);
+}
+
+/**
+ * \fn void* renderizar(void* argumento);
+ *
+ * \brief Laco da thread de renderizacao. A cena e compilada uma unica vez, com as BVHs construidas pelas threads da renderizacao; a
+ * cada pedido a imagem de trabalho e pintada pelas passadas progressivas (1 pixel em 16, 1 em 4 e todos), e cada passada e
+ * publicada para a janela assim que termina. Se um novo pedido chegar entre duas passadas, as restantes sao abandonadas.
+ */
+void* renderizar(void* argumento){
+  Ray_tracing obj_ray_tracing;
+  obj_ray_tracing.atualizar_threads(numero_threads);
+  CenaCompilada cena;
+  rayTracing::OpcoesBVH opcoes_bvh;
+  opcoes_bvh.escalonador = obj_ray_tracing.conjunto_threads();
+  if (!cena.compilar(cena_montada, opcoes_bvh)){
+    std::cerr << "sem memoria para compilar a cena" << std::endl;
+    exit(1);
+  }
+  const rayTracing::EstatisticasBVH& bvh = cena.bvh().estatisticas();
+  std::cout << "bvh: " << bvh.nos << " nos, " << bvh.folhas << " folhas, profundidade " << bvh.profundidade << ", "
+	    << bvh.segundos << " segundos" << std::endl;
+  int versao_renderizada = 0;
+  for (;;){
+    pthread_mutex_lock(&trava);
+    while (versao_pedida == versao_renderizada){
+      pthread_cond_wait(&novo_pedido, &trava);
+    }
+    versao_renderizada = versao_pedida;
+    Vetor lookfrom = posicao_camera;
+    bool sombras = tracar_sombras;
+    pthread_mutex_unlock(&trava);
+
+    double start_clock = clock();
+    Camera camera;
+    if (descricao == NULL){
+      camera.de_janela_ortografica(lookfrom, cena.lado(), cena.altura());
+    }
+    else if (!descricao->montar_camera(camera, lookfrom, cena.lado(), cena.altura())){
+      //A camera foi movida para o alvo: o quadro anterior continua na janela
+      std::cerr << "camera degenerada nesta posicao; o quadro nao foi pintado" << std::endl;
+      continue;
+    }
+    obj_ray_tracing.atualizar_sombras(sombras);
+    int passo_anterior = 0;
+    bool completa = true;
+    for (int k = 0; k < rayTracing::N_PASSOS_PROGRESSIVOS; k++){
+      int passo = rayTracing::PASSOS_PROGRESSIVOS[k];
+      if (!obj_ray_tracing.print_imagem_passada(cena, luz_cena, camera, quadros.imagem_trabalho(), passo, passo_anterior)){
+	std::cerr << "sem memoria para pintar a imagem" << std::endl;
+	exit(1);
+      }
+      passo_anterior = passo;
+      //As passadas seguintes continuam a partir da imagem publicada
+      quadros.publicar(passo != 1);
+
+      pthread_mutex_lock(&trava);
+      completa = (versao_pedida == versao_renderizada);
+      pthread_mutex_unlock(&trava);
+      if (!completa){
+	break;
+      }
+    }
+    double stop_clock = clock();
+    if (completa){
+      std::cout << "time: " << (stop_clock-start_clock)/(CLOCKS_PER_SEC) << " segundos (cpu), "
+		<< obj_ray_tracing.threads() << " threads, nucleos " << nucleos_ativos->nome << std::endl;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * \fn void apresentar_quadro(int valor);
+ *
+ * \brief Temporizador do GLUT, a cada INTERVALO_QUADROS ms: adquire o quadro mais recente publicado pela renderizacao, se houver, e
+ * pede o redesenho da janela. Nao espera pela renderizacao.
+ */
+void apresentar_quadro(int valor){
+  if (quadros.adquirir()){
+    glutPostRedisplay();
+  }
+  glutTimerFunc(INTERVALO_QUADROS, apresentar_quadro, 0);
+}
+
 /**
  * \fn void display(void);
  *
- * \brief Pinta toda a tela.
+ * \brief Pinta toda a tela com o quadro adquirido. Nao renderiza: exposicoes da janela apenas redesenham a imagem, que a
+ * renderizacao nunca escreve.
  */
 void display(void){
   glClear(GL_COLOR_BUFFER_BIT);
-  glRasterPos2i(0, 0);
-
-  double start_clock = clock();
-  //Primeira esfera
-  Vetor* c_esfera1 = new Vetor();
-  c_esfera1->valores_vetor(150.0, 150.0, 0.0);
-  //Limites da cor do objeto
-  Vetor* range1 = new Vetor();	//Vetor de limite superior da cor
-  range1->valores_vetor(0.0, 0.0, 255.0);
-  Vetor* range2 = new Vetor();	//Vetor de limite inferior da cor
-  range2->valores_vetor(0.0, 0.0, 254.0);
-  Textura* cores1 = new Textura(range1, range2);
-  Objeto* esfera1 = new Objeto();
-  esfera1->atualizar_esfera(c_esfera1, 40.0, 0.3, 0.3, cores1);
-	
-  //segunda esfera
-  Vetor* c_esfera2 = new Vetor();
-  c_esfera2->valores_vetor(150.0, 100.0, 0.0);
-  //Limites da cor do objeto
-  Vetor* range3 = new Vetor();	//Vetor de limite superior da cor
-  range3->valores_vetor(0.0, 255.0, 0.0);
-  Vetor* range4 = new Vetor();	//Vetor de limite inferior da cor
-  range4->valores_vetor(0.0, 254.0, 0.0);
-  Textura* cores2 = new Textura(range3, range4);
-  Objeto* esfera2 = new Objeto();
-  esfera2->atualizar_esfera(c_esfera2, 60.0, 0.3, 0.3, cores2);
-	
-  //terceira esfera
-  Vetor* c_esfera3 = new Vetor();
-  c_esfera3->valores_vetor(150.0, 200.0, 0.0);
-  //Limites da cor do objeto
-  Vetor* range5 = new Vetor();	//Vetor de limite superior da cor
-  range5->valores_vetor(255.0, 0.0, 0.0);
-  Vetor* range6 = new Vetor();	//Vetor de limite inferior da cor
-  range6->valores_vetor(254.0, 0.0, 0.0);
-  Textura* cores3 = new Textura(range5, range6);
-  Objeto* esfera3 = new Objeto();
-  esfera3->atualizar_esfera(c_esfera3, 60.0, 0.3, 0.3, cores3);
+  const Imagem& imagem = quadros.imagem_exibida();
+  if (imagem.largura() > 0){
+    //As linhas da imagem vao de cima para baixo: o desenho comeca no canto superior com a escala vertical invertida
+    GLenum formato_gl = (imagem.formato() == rayTracing::FORMATO_RGBA8) ? GL_RGBA : GL_RGB;
+    GLenum tipo_gl = (imagem.formato() == rayTracing::FORMATO_RGB_FLOAT) ? GL_FLOAT : GL_UNSIGNED_BYTE;
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint)(imagem.passo() / rayTracing::bytes_por_pixel(imagem.formato())));
+    glRasterPos2i(0, imagem.altura());
+    glPixelZoom(1.0, -1.0);
+    glDrawPixels(imagem.largura(), imagem.altura(), formato_gl, tipo_gl, imagem.dados());
+    glPixelZoom(1.0, 1.0);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+  }
+  glFlush();
+}
 
-  //quarta esfera
-  Vetor* c_esfera4 = new Vetor();
-  c_esfera4->valores_vetor(100.0, 150.0, 0.0);
-  //Limites da cor do objeto
-  Vetor* range7 = new Vetor();	//Vetor de limite superior da cor
-  range7->valores_vetor(255.0, 254.0, 0.0);
-  Vetor* range8 = new Vetor();	//Vetor de limite inferior da cor
-  range8->valores_vetor(254.0, 254.0, 0.0);
-  Textura* cores4 = new Textura(range7, range8);
-  Objeto* esfera4 = new Objeto();
-  esfera4->atualizar_esfera(c_esfera4, 60.0, 0.3, 0.3, cores4);
-	
-  //Criando a cena
-  Cena* cena = new Cena();
-  cena->atualizar_cor_background(0.0, 0.0, 0.0);
-  cena->atualizar_ka(1.2);
-  //incluindo primeira esfera
-  cena->incluir_objetos_pilha(esfera1);
-  //incluindo segunda esfera
-  cena->incluir_objetos_pilha(esfera2);
-  //incluindo terceira esfera
-  cena->incluir_objetos_pilha(esfera3);
-  //incluindo terceira esfera
-  //cena->incluir_objetos_pilha(esfera4);
-	
-  //std::cout << ("cena: ")<< cena->size_objetos_pilha() << std::endl;
-	
-	
-  //Lookfrom
-  Vetor* lookfrom = new Vetor();
-  lookfrom->valores_vetor(155.0, 150.0, -150.0);
-  //Lookat
-  Vetor* lookat = new Vetor();
-  lookat->valores_vetor(2.0, 1.0, 0.0);
-	
-  //Luz
-  Luz* luz = new Luz();
-  luz->posicao_luz(3.0, 3.0, 3.0);
-  //O valor de _nshin (espalhamento da luz) estabelecido como 2.0
-  luz->atualizar_constantes_phong(0.4, esfera1->ks_esfera(), esfera1->kd_esfera(), 200.0, 192.0, 192.0, 192.0 , 1.0, 2.0);
-	
-  //Matrizes de visualizacao
-  GLint viewport[4];
-  GLdouble modelview[16], projection[16];
+/**
+ * \fn void teclado(unsigned char tecla, int x, int y);
+ *
+ * \brief Tecla s: liga ou desliga as sombras.
+ */
+void teclado(unsigned char tecla, int x, int y){
+  if (tecla == 's' || tecla == 'S'){
+    pthread_mutex_lock(&trava);
+    tracar_sombras = !tracar_sombras;
+    pthread_mutex_unlock(&trava);
+    pedir_renderizacao();
+  }
+}
 
-  //Parte do cdigo que provoca um erro segmentation fault talvez por eu nao ter especificado a viewport
-  //------------------------------------------------------------------------------------------------------
-  glGetDoublev( GL_MODELVIEW_MATRIX, modelview );
-  glGetDoublev( GL_PROJECTION_MATRIX, projection );
-  glGetIntegerv( GL_VIEWPORT, viewport );
-  //------------------------------------------------------------------------------------------------------
-	
-  //Aplicacao do ray tracing
-  Ray_tracing* obj_ray_tracing = new Ray_tracing();
-  //imagem = obj_ray_tracing -> print_imagem(cena, luz, lookfrom, lookat, modelview, projection, viewport);
-  obj_ray_tracing -> print_imagem(cena, luz, lookfrom, lookat, modelview, projection, viewport, *&imagem);
-	
-  std::cout << "passei pela pintura da imagem" << std::endl;
-  /* //pintando a imagem
-     for (int i = 0; i < 300; i++){
-     for (int j = 0; j < 300; j++){
-     print_pixel(i, j, 255.0, 255.0, 0.0);
-     }
-     } */
-	
-  unsigned int n = 300;
-  unsigned int m = 300;
-  glDrawPixels(n, m, GL_RGB, GL_UNSIGNED_BYTE, imagem);
-   
-  double stop_clock = clock();
-  std::cout << "time: " << (stop_clock-start_clock)/(CLOCKS_PER_SEC) << " segundos" << std::endl;
-  glFlush();
+/**
+ * \fn void teclas_especiais(int tecla, int x, int y);
+ *
+ * \brief Setas: deslocam a camera no plano xy.
+ */
+void teclas_especiais(int tecla, int x, int y){
+  double dx = 0.0, dy = 0.0;
+  switch (tecla){
+  case GLUT_KEY_LEFT: dx = -PASSO_CAMERA; break;
+  case GLUT_KEY_RIGHT: dx = PASSO_CAMERA; break;
+  case GLUT_KEY_UP: dy = PASSO_CAMERA; break;
+  case GLUT_KEY_DOWN: dy = -PASSO_CAMERA; break;
+  default: return;
+  }
+  pthread_mutex_lock(&trava);
+  posicao_camera = Vetor(posicao_camera.vx() + dx, posicao_camera.vy() + dy, posicao_camera.vz());
+  pthread_mutex_unlock(&trava);
+  pedir_renderizacao();
 }
 
 /**
@@ -213,6 +277,52 @@ void reshape(int w, int h){
 int main(int argc, char** argv)
 {
   glutInit(&argc, argv);
+  const char* arquivo_cena = NULL; //Arquivo .cena pedido na linha de comando
+  //Opcoes da linha de comando (as opcoes do GLUT ja foram removidas por glutInit)
+  for (int i = 1; i < argc; i++){
+    if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc){
+      numero_threads = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--sombras") == 0){
+      tracar_sombras = true;
+    }
+    else if (strcmp(argv[i], "--nucleos") == 0 && i + 1 < argc){
+      nome_nucleos = argv[++i];
+    }
+    else if (strcmp(argv[i], "--cena") == 0 && i + 1 < argc){
+      arquivo_cena = argv[++i];
+    }
+  }
+  selecionar_nucleos(nome_nucleos);
+  //A cena e montada uma unica vez; a thread de renderizacao pinta a primeira imagem enquanto a janela e criada
+  if (arquivo_cena != NULL){
+    descricao = new DescricaoCena;
+    if (!descricao->carregar(arquivo_cena)){
+      std::cerr << arquivo_cena << ":" << descricao->linha_erro() << ": " << descricao->mensagem_erro() << std::endl;
+      return 1;
+    }
+    //A janela tem 300 x 300 pixels; as sombras e as threads da cena valem se nao foram pedidas na linha de comando
+    cena_montada = descricao->cena();
+    cena_montada->dimensao_imagem(300, 300);
+    luz_cena = descricao->luz();
+    posicao_camera = descricao->lookfrom();
+    tracar_sombras = tracar_sombras || descricao->sombras();
+    if (numero_threads < 0) numero_threads = descricao->threads();
+  }
+  else{
+    exemplo = new CenaExemplo(300, 300);
+    if (!exemplo->montada()){
+      std::cerr << "sem memoria para montar a cena de demonstracao" << std::endl;
+      return 1;
+    }
+    cena_montada = exemplo->cena();
+    luz_cena = exemplo->luz();
+    posicao_camera = exemplo->lookfrom();
+  }
+  if (numero_threads < 0) numero_threads = 0;
+  pthread_t thread_renderizacao;
+  pthread_create(&thread_renderizacao, NULL, renderizar, NULL);
+  pedir_renderizacao();
   glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
   glutInitWindowSize(300, 300);
   glutInitWindowPosition(100, 100);
@@ -256,6 +366,9 @@ int main(int argc, char** argv)
   imagem = obj_ray_tracing -> print_imagem(cena, luz, lookfrom, lookat, GL_MODELVIEW, GL_PROJECTION, GL_VIEWPORT);
   */
   glutDisplayFunc(display);
+  glutKeyboardFunc(teclado);
+  glutSpecialFunc(teclas_especiais);
+  glutTimerFunc(INTERVALO_QUADROS, apresentar_quadro, 0);
   glutMainLoop();
   return 0;
 }
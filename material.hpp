@@ -0,0 +1,75 @@
+/**
+ * \file material.hpp
+ *
+ * \brief Este arquivo e um pacote que contem a definicao dos materiais da cena compilada. Cada primitiva guarda apenas o indice do seu
+ * material na tabela de materiais da cena; primitivas com o mesmo material compartilham a mesma entrada, e todo o sombreamento le os
+ * coeficientes dessa tabela.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _MATERIAL_HPP
+#define _MATERIAL_HPP
+
+#include "vetor.hpp"	//rayTracing::Vetor
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \brief Espalhamento especular (expoente de phong) padrao dos objetos.
+   */
+  const double BRILHO_PADRAO = 2.0;
+
+  /**
+   * \struct Material
+   *
+   * \brief Coeficientes de sombreamento de um material.
+   */
+  struct Material{
+    Vetor albedo;		///< Cor do objeto dividida pela sua norma
+    double kd;			///< Constante difusa
+    double ks;			///< Constante especular
+    double brilho;		///< Espalhamento da luz (expoente de phong)
+    double reflexao;		///< Fracao refletida (reservado para os raios refletidos; 0 por enquanto)
+    double indice_refracao;	///< Indice de refracao (reservado para os raios refratados; 1 por enquanto)
+  };
+
+  /**
+   * \struct MenorMaterial
+   *
+   * \brief Ordem lexicografica dos coeficientes de dois materiais, utilizada para encontrar materiais repetidos.
+   */
+  struct MenorMaterial{
+    bool operator()(const Material& a, const Material& b) const{
+      if (a.albedo.vx() != b.albedo.vx()) return a.albedo.vx() < b.albedo.vx();
+      if (a.albedo.vy() != b.albedo.vy()) return a.albedo.vy() < b.albedo.vy();
+      if (a.albedo.vz() != b.albedo.vz()) return a.albedo.vz() < b.albedo.vz();
+      if (a.kd != b.kd) return a.kd < b.kd;
+      if (a.ks != b.ks) return a.ks < b.ks;
+      if (a.brilho != b.brilho) return a.brilho < b.brilho;
+      if (a.reflexao != b.reflexao) return a.reflexao < b.reflexao;
+      return a.indice_refracao < b.indice_refracao;
+    }
+  };
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
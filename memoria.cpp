@@ -0,0 +1,67 @@
+/**
+ * \file memoria.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo memoria.hpp, sendo este responsavel pela alocacao de blocos de
+ * memoria alinhados a linha de cache.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "memoria.hpp"	//rayTracing::aloca_alinhado
+#include <stdlib.h>	//posix_memalign, free
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \fn void* aloca_alinhado(size_t bytes);
+   *
+   * \brief Aloca um bloco de memoria alinhado a linha de cache.
+   */
+  void*
+  aloca_alinhado(size_t bytes){
+    void* bloco = NULL;
+    if (posix_memalign(&bloco, LINHA_CACHE, arredonda_linha_cache(bytes > 0 ? bytes : 1)) != 0){
+      return NULL;
+    }
+    return bloco;
+  }
+
+  /**
+   * \fn void libera_alinhado(void* bloco);
+   *
+   * \brief Libera um bloco alocado por aloca_alinhado.
+   */
+  void
+  libera_alinhado(void* bloco){
+    free(bloco);
+  }
+
+  /**
+   * \fn size_t arredonda_linha_cache(size_t bytes);
+   *
+   * \brief Arredonda um tamanho para o proximo multiplo da linha de cache.
+   */
+  size_t
+  arredonda_linha_cache(size_t bytes){
+    return ((bytes + LINHA_CACHE - 1) / LINHA_CACHE) * LINHA_CACHE;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
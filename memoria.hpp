@@ -0,0 +1,69 @@
+/**
+ * \file memoria.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo memoria.cpp, sendo este
+ * responsavel pela alocacao de blocos de memoria alinhados a linha de cache, utilizados pelas estruturas lidas por varias threads.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _MEMORIA_HPP
+#define _MEMORIA_HPP
+
+#include <stddef.h>	//size_t
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \brief Tamanho (em bytes) de uma linha de cache.
+   */
+  const size_t LINHA_CACHE = 64;
+
+  /**
+   * \fn void* aloca_alinhado(size_t bytes);
+   *
+   * \brief Aloca um bloco de memoria alinhado a linha de cache.
+   *
+   * \param bytes - tamanho do bloco
+   *
+   * \return O bloco alocado ou NULL se nao houver memoria.
+   */
+  void* aloca_alinhado(size_t bytes);
+
+  /**
+   * \fn void libera_alinhado(void* bloco);
+   *
+   * \brief Libera um bloco alocado por aloca_alinhado.
+   *
+   * \param bloco - bloco a ser liberado (pode ser NULL)
+   */
+  void libera_alinhado(void* bloco);
+
+  /**
+   * \fn size_t arredonda_linha_cache(size_t bytes);
+   *
+   * \brief Arredonda um tamanho para o proximo multiplo da linha de cache.
+   */
+  size_t arredonda_linha_cache(size_t bytes);
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
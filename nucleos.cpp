@@ -0,0 +1,100 @@
+/**
+ * \file nucleos.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo nucleos.hpp, sendo este responsavel pela escolha da variante
+ * dos nucleos. As variantes ficam nos arquivos nucleos_<nome>.cpp; este arquivo e compilado sem opcoes de conjunto de instrucoes e
+ * consulta o processador (cpuid) antes de entregar uma variante vetorial.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.2
+ * \date Outubro 2013
+ */
+
+#include "nucleos.hpp"	//rayTracing::ConjuntoNucleos
+#include <iostream>	//std::cerr e std::endl
+#include <stdlib.h>	//getenv
+#include <string.h>	//strcmp
+#include <stddef.h>	//NULL
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  const ConjuntoNucleos* nucleos_ativos = &NUCLEOS_ESCALAR;
+
+  //Variantes em ordem de preferencia (da mais larga para a escalar)
+  static const ConjuntoNucleos* const VARIANTES[] = { &NUCLEOS_AVX512, &NUCLEOS_AVX2, &NUCLEOS_SSE4, &NUCLEOS_ESCALAR };
+  static const int N_VARIANTES = 4;
+
+  /**
+   * \fn static bool suportada(const ConjuntoNucleos* variante);
+   *
+   * \brief Verifica se a variante foi compilada e se o processador possui as suas instrucoes.
+   */
+  static bool
+  suportada(const ConjuntoNucleos* variante){
+    if (variante->intercepta_esferas == NULL){
+      return false;
+    }
+    if (variante == &NUCLEOS_ESCALAR){
+      return true;
+    }
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (variante == &NUCLEOS_AVX512) return __builtin_cpu_supports("avx512f");
+    if (variante == &NUCLEOS_AVX2) return __builtin_cpu_supports("avx2");
+    if (variante == &NUCLEOS_SSE4) return __builtin_cpu_supports("sse4.2");
+#endif
+    return false;
+  }
+
+  /**
+   * \fn const char* selecionar_nucleos(const char* nome);
+   *
+   * \brief Escolhe a variante dos nucleos: a pedida, se o processador a suportar, ou a mais larga suportada.
+   *
+   * \param nome - "escalar", "sse4", "avx2", "avx512" ou NULL (usa RAYTRACING_NUCLEOS ou a escolha automatica)
+   *
+   * \return O nome da variante escolhida.
+   */
+  const char*
+  selecionar_nucleos(const char* nome){
+    if (nome == NULL || nome[0] == '\0'){
+      nome = getenv("RAYTRACING_NUCLEOS");
+    }
+    if (nome != NULL && nome[0] != '\0'){
+      for (int k = 0; k < N_VARIANTES; k++){
+	if (strcmp(VARIANTES[k]->nome, nome) == 0){
+	  if (suportada(VARIANTES[k])){
+	    nucleos_ativos = VARIANTES[k];
+	    return nucleos_ativos->nome;
+	  }
+	  break;
+	}
+      }
+      std::cerr << "nucleos " << nome << " indisponiveis, usando a escolha automatica" << std::endl;
+    }
+    for (int k = 0; k < N_VARIANTES; k++){
+      if (suportada(VARIANTES[k])){
+	nucleos_ativos = VARIANTES[k];
+	break;
+      }
+    }
+    return nucleos_ativos->nome;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
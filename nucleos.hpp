@@ -0,0 +1,253 @@
+/**
+ * \file nucleos.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo nucleos.cpp, sendo este
+ * responsavel pelos nucleos vetoriais de interseccao e pela escolha, ao iniciar o programa, da variante adequada ao processador. Cada
+ * variante (escalar, SSE4, AVX2 e AVX-512) e compilada em seu proprio arquivo com as opcoes do seu conjunto de instrucoes, de modo
+ * que um unico executavel use toda a largura vetorial de cada maquina. Os nucleos trabalham apenas sobre vetores de doubles.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.2
+ * \date Outubro 2013
+ */
+
+#ifndef _NUCLEOS_HPP
+#define _NUCLEOS_HPP
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  struct PacoteRaios;
+  struct AcertosPacote;
+
+  /**
+   * \brief Numero maximo de esferas lidas a cada iteracao de um nucleo (a largura do AVX-512). Os vetores de esferas devem ter pelo
+   * menos LARGURA_ESFERAS - 1 posicoes preenchidas apos a ultima esfera, para que a ultima iteracao possa ler um bloco inteiro. Os
+   * vetores de triangulos seguem a mesma regra.
+   */
+  const int LARGURA_ESFERAS = 8;
+
+  /**
+   * \brief Maior numero de filhos de um no da BVH larga.
+   */
+  const int LARGURA_BVH_MAXIMA = 8;
+
+  /**
+   * \struct CaixasQuantizadas
+   *
+   * \brief Caixas dos filhos de um no da BVH larga, quantizadas em 8 bits por coordenada em relacao ao no: no eixo e, a coordenada
+   * q de um filho vale origem[e] + q * 2^expoente[e], calculado em double. Os cantos sao arredondados para fora, de modo que a caixa
+   * quantizada sempre contem a caixa original. Cada eixo guarda os LARGURA_BVH_MAXIMA filhos em sequencia, para que um nucleo os
+   * leia de uma vez, e o no inteiro ocupa uma linha de cache de 64 bytes.
+   */
+  struct CaixasQuantizadas{
+    float origem[3];					///< Canto minimo do no, arredondado para baixo
+    signed char expoente[3];				///< Expoente do passo da quantizacao de cada eixo
+    unsigned char n_filhos;				///< Numero de filhos (as demais posicoes sao ignoradas)
+    unsigned char minimo[3][LARGURA_BVH_MAXIMA];	///< Canto minimo de cada filho, em passos a partir da origem
+    unsigned char maximo[3][LARGURA_BVH_MAXIMA];	///< Canto maximo de cada filho, em passos a partir da origem
+  };
+
+  /**
+   * \struct TriangulosSoA
+   *
+   * \brief Triangulos em forma de estrutura de vetores, ja preparados para o teste de Moller-Trumbore: o vertice v0 e as arestas
+   * e1 = v1 - v0 e e2 = v2 - v0 de cada triangulo.
+   */
+  struct TriangulosSoA{
+    const double* v0x;	///< Coordenada x do vertice v0
+    const double* v0y;	///< Coordenada y do vertice v0
+    const double* v0z;	///< Coordenada z do vertice v0
+    const double* e1x;	///< Componente x da aresta e1
+    const double* e1y;	///< Componente y da aresta e1
+    const double* e1z;	///< Componente z da aresta e1
+    const double* e2x;	///< Componente x da aresta e2
+    const double* e2y;	///< Componente y da aresta e2
+    const double* e2z;	///< Componente z da aresta e2
+  };
+
+  /**
+   * \struct ParametrosPhong
+   *
+   * \brief Constantes de uma luz usadas pelo sombreamento dos pacotes (ver Luz::parametros_phong).
+   */
+  struct ParametrosPhong{
+    double posicao[3];		///< Posicao da luz
+    double ambiente;		///< Parcela ambiente, ka * Ia
+    double intensidade[3];	///< Intensidades vermelha, verde e azul ja multiplicadas pelo fator de atenuacao
+  };
+
+  /**
+   * \struct ConjuntoNucleos
+   *
+   * \brief Tabela com os nucleos de uma variante. As funcoes sao nulas se a variante nao foi compilada (por exemplo, fora da
+   * arquitetura x86).
+   */
+  struct ConjuntoNucleos{
+    const char* nome;	///< Nome da variante ("escalar", "sse4", "avx2" ou "avx512")
+
+    /**
+     * \brief Testa um raio contra as esferas [inicio, inicio + n) e retorna a mais proxima (ver intercepta_esferas).
+     */
+    int (*intercepta_esferas)(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+			      const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t);
+
+    /**
+     * \brief Testa um pacote de raios contra a esfera k (ver PacoteRaios).
+     */
+    void (*intercepta_esfera_pacote)(PacoteRaios& p, const double oc[3], double c, int k);
+
+    /**
+     * \brief Testa um pacote de raios contra uma caixa (ver PacoteRaios).
+     */
+    bool (*intercepta_caixa_pacote)(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada);
+
+    /**
+     * \brief Testa um raio contra os triangulos [inicio, inicio + n) e retorna o mais proximo (ver intercepta_triangulos).
+     */
+    int (*intercepta_triangulos)(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+				 double t_minimo, double t_max, double* t);
+
+    /**
+     * \brief Testa um pacote de raios contra o triangulo k (ver PacoteRaios).
+     */
+    void (*intercepta_triangulo_pacote)(PacoteRaios& p, const TriangulosSoA& tri, int k);
+
+    /**
+     * \brief Testa um raio contra as caixas dos filhos de um no da BVH larga (ver intercepta_caixas_quantizadas).
+     */
+    int (*intercepta_caixas_quantizadas)(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max,
+					 double* t_entrada);
+
+    /**
+     * \brief Sombreia pela formula de phong os raios ativos de um pacote (ver AcertosPacote).
+     */
+    void (*sombrear_pacote)(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz);
+  };
+
+  /**
+   * \brief Variantes dos nucleos, cada uma definida no seu arquivo nucleos_<nome>.cpp.
+   */
+  extern const ConjuntoNucleos NUCLEOS_ESCALAR;
+  extern const ConjuntoNucleos NUCLEOS_SSE4;
+  extern const ConjuntoNucleos NUCLEOS_AVX2;
+  extern const ConjuntoNucleos NUCLEOS_AVX512;
+
+  /**
+   * \brief Variante em uso. Comeca com a escalar e e trocada por selecionar_nucleos antes da renderizacao.
+   */
+  extern const ConjuntoNucleos* nucleos_ativos;
+
+  /**
+   * \fn const char* selecionar_nucleos(const char* nome);
+   *
+   * \brief Escolhe a variante dos nucleos. Sem nome, e usada a variavel de ambiente RAYTRACING_NUCLEOS e, sem ela, a variante mais
+   * larga suportada pelo processador. Uma variante pedida que nao foi compilada ou que o processador nao suporta e informada na saida
+   * de erro e substituida pela escolha automatica. Deve ser chamada antes de qualquer renderizacao.
+   *
+   * \param nome - "escalar", "sse4", "avx2", "avx512" ou NULL
+   *
+   * \return O nome da variante escolhida.
+   */
+  const char* selecionar_nucleos(const char* nome);
+
+  /**
+   * \fn int intercepta_esferas(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+   * const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t);
+   *
+   * \brief Testa um raio contra as esferas [inicio, inicio + n) e retorna a mais proxima. Cada esfera e testada como em
+   * intercepta_esfera; a menor interseccao de cada posicao do registrador e mantida durante o laco e, ao final, uma reducao horizontal
+   * escolhe a menor entre as posicoes (em caso de empate, a esfera de menor indice, como no laco escalar).
+   *
+   * \param cx, cy, cz - coordenadas dos centros das esferas
+   * \param r2 - quadrado dos raios das esferas
+   * \param inicio, n - intervalo de esferas testadas
+   * \param origem - origem do raio
+   * \param direcao - direcao normalizada do raio
+   * \param t_minimo, t_max - apenas interseccoes com t_minimo < t < t_max sao consideradas
+   * \param t - t da interseccao encontrada
+   *
+   * \return O indice da esfera interceptada ou -1.
+   */
+  int intercepta_esferas(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+			 const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t);
+
+  /**
+   * \fn int intercepta_triangulos(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+   * double t_minimo, double t_max, double* t);
+   *
+   * \brief Testa um raio contra os triangulos [inicio, inicio + n) pelo metodo de Moller-Trumbore e retorna o mais proximo. Com
+   * \f$ P = D \times e_2 \f$, \f$ det = e_1 \cdot P \f$, \f$ T = O - v_0 \f$ e \f$ Q = T \times e_1 \f$, as coordenadas
+   * baricentricas sao \f$ u = (T \cdot P) / det \f$ e \f$ v = (D \cdot Q) / det \f$, e \f$ t = (e_2 \cdot Q) / det \f$. O raio atinge o
+   * triangulo se \f$ det \neq 0 \f$, \f$ u, v \geq 0 \f$ e \f$ u + v \leq 1 \f$. Os dois lados do triangulo sao aceitos. Como em
+   * intercepta_esferas, varios triangulos sao testados por instrucao e o empate fica com o de menor indice.
+   *
+   * \param tri - triangulos da cena
+   * \param inicio, n - intervalo de triangulos testados
+   * \param origem - origem do raio
+   * \param direcao - direcao normalizada do raio
+   * \param t_minimo, t_max - apenas interseccoes com t_minimo < t < t_max sao consideradas
+   * \param t - t da interseccao encontrada
+   *
+   * \return O indice do triangulo interceptado ou -1.
+   */
+  int intercepta_triangulos(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+			    double t_minimo, double t_max, double* t);
+
+  /**
+   * \fn int intercepta_caixas_quantizadas(const CaixasQuantizadas& c, const double origem[3], const double inverso[3],
+   * double t_max, double* t_entrada);
+   *
+   * \brief Teste das placas (slabs) de um raio contra as caixas de todos os filhos de um no da BVH larga, no intervalo [0, t_max]. As
+   * caixas sao decodificadas e testadas juntas, varios filhos por instrucao, com o mesmo resultado do teste escalar de cada caixa.
+   *
+   * \param c - caixas quantizadas dos filhos
+   * \param origem - origem do raio
+   * \param inverso - inverso de cada componente da direcao do raio
+   * \param t_max - fim do intervalo testado
+   * \param t_entrada - vetor de LARGURA_BVH_MAXIMA posicoes que recebe o t em que o raio entra na caixa de cada filho
+   *
+   * \return Mascara com o bit i ligado se o raio atinge o filho i.
+   */
+  int intercepta_caixas_quantizadas(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max,
+				    double* t_entrada);
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline int
+  intercepta_triangulos(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+			double t_minimo, double t_max, double* t){
+    return nucleos_ativos->intercepta_triangulos(tri, inicio, n, origem, direcao, t_minimo, t_max, t);
+  }
+
+  inline int
+  intercepta_caixas_quantizadas(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max,
+				double* t_entrada){
+    return nucleos_ativos->intercepta_caixas_quantizadas(c, origem, inverso, t_max, t_entrada);
+  }
+
+  inline int
+  intercepta_esferas(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+		     const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t){
+    return nucleos_ativos->intercepta_esferas(cx, cy, cz, r2, inicio, n, origem, direcao, t_minimo, t_max, t);
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
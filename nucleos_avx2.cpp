@@ -0,0 +1,335 @@
+/**
+ * \file nucleos_avx2.cpp
+ *
+ * \brief Este arquivo contem a variante AVX2 dos nucleos definidos no arquivo nucleos.hpp: quatro doubles por instrucao. O arquivo e
+ * compilado com -mavx2 e so e executado se o processador suportar essas instrucoes; por isso ele nao chama funcoes inline de outros
+ * cabecalhos, cujas copias poderiam ser escolhidas pelo ligador para o programa inteiro.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "nucleos.hpp"		//rayTracing::ConjuntoNucleos
+#include "nucleos_comum.hpp"	//rayTracing::menor_posicao
+#include "pacote.hpp"		//rayTracing::PacoteRaios
+#include <stddef.h>		//NULL
+
+#if defined(__AVX2__)
+#include <immintrin.h>		//_mm256_*
+#endif
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+#if defined(__AVX2__)
+  /**
+   * \fn static int esferas_avx2(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+   * const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t);
+   *
+   * \brief Versao AVX2 de intercepta_esferas: quatro esferas por instrucao.
+   */
+  static int
+  esferas_avx2(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+	       const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t){
+    const __m256d ox = _mm256_set1_pd(origem[0]), oy = _mm256_set1_pd(origem[1]), oz = _mm256_set1_pd(origem[2]);
+    const __m256d dx = _mm256_set1_pd(direcao[0]), dy = _mm256_set1_pd(direcao[1]), dz = _mm256_set1_pd(direcao[2]);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sinal = _mm256_set1_pd(-0.0);
+    const __m256d minimo = _mm256_set1_pd(t_minimo);
+    __m256d t_melhor = _mm256_set1_pd(t_max);
+    __m256d melhor = _mm256_set1_pd(-1.0);
+    int fim = inicio + n;
+    for (int j = inicio; j < fim; j += 4){
+      __m256d ocx = _mm256_sub_pd(ox, _mm256_loadu_pd(cx + j));
+      __m256d ocy = _mm256_sub_pd(oy, _mm256_loadu_pd(cy + j));
+      __m256d ocz = _mm256_sub_pd(oz, _mm256_loadu_pd(cz + j));
+      __m256d c = _mm256_sub_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ocx, ocx), _mm256_mul_pd(ocy, ocy)), _mm256_mul_pd(ocz, ocz)),
+				_mm256_loadu_pd(r2 + j));
+      __m256d b = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ocx, dx), _mm256_mul_pd(ocy, dy)), _mm256_mul_pd(ocz, dz));
+      __m256d discriminante = _mm256_sub_pd(_mm256_mul_pd(b, b), c);
+      __m256d tj = _mm256_sub_pd(_mm256_xor_pd(b, sinal), _mm256_sqrt_pd(_mm256_max_pd(discriminante, zero)));
+      __m256d acerto = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(c, zero, _CMP_GE_OQ), _mm256_cmp_pd(b, zero, _CMP_LE_OQ)),
+				     _mm256_and_pd(_mm256_cmp_pd(discriminante, zero, _CMP_GE_OQ),
+						   _mm256_and_pd(_mm256_cmp_pd(tj, minimo, _CMP_GT_OQ), _mm256_cmp_pd(tj, t_melhor, _CMP_LT_OQ))));
+      //Posicoes alem da ultima esfera sao descartadas
+      __m256d indices = _mm256_set_pd(j + 3, j + 2, j + 1, j);
+      acerto = _mm256_and_pd(acerto, _mm256_cmp_pd(indices, _mm256_set1_pd(fim), _CMP_LT_OQ));
+      t_melhor = _mm256_blendv_pd(t_melhor, tj, acerto);
+      melhor = _mm256_blendv_pd(melhor, indices, acerto);
+    }
+    double t_posicoes[4], indices[4];
+    _mm256_storeu_pd(t_posicoes, t_melhor);
+    _mm256_storeu_pd(indices, melhor);
+    return menor_posicao(t_posicoes, indices, 4, t);
+  }
+
+  /**
+   * \fn static void esfera_pacote_avx2(PacoteRaios& p, const double oc[3], double c, int k);
+   *
+   * \brief Versao AVX2 de intercepta_esfera_pacote: quatro raios por instrucao.
+   */
+  static void
+  esfera_pacote_avx2(PacoteRaios& p, const double oc[3], double c, int k){
+    if (c < 0.0){	//Origem dentro da esfera: apenas a menor raiz e considerada, e ela e negativa
+      return;
+    }
+    const __m256d ocx = _mm256_set1_pd(oc[0]), ocy = _mm256_set1_pd(oc[1]), ocz = _mm256_set1_pd(oc[2]);
+    const __m256d vc = _mm256_set1_pd(c);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d sinal = _mm256_set1_pd(-0.0);
+    for (int i = 0; i < LARGURA_PACOTE; i += 4){
+      __m256d b = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ocx, _mm256_loadu_pd(p.dx + i)),
+					      _mm256_mul_pd(ocy, _mm256_loadu_pd(p.dy + i))),
+				_mm256_mul_pd(ocz, _mm256_loadu_pd(p.dz + i)));
+      __m256d discriminante = _mm256_sub_pd(_mm256_mul_pd(b, b), vc);
+      __m256d t = _mm256_sub_pd(_mm256_xor_pd(b, sinal), _mm256_sqrt_pd(_mm256_max_pd(discriminante, zero)));
+      __m256d t_atual = _mm256_loadu_pd(p.t + i);
+      __m256d acerto = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(b, zero, _CMP_LE_OQ), _mm256_cmp_pd(discriminante, zero, _CMP_GE_OQ)),
+				     _mm256_and_pd(_mm256_cmp_pd(t, zero, _CMP_GT_OQ), _mm256_cmp_pd(t, t_atual, _CMP_LT_OQ)));
+      int mascara = _mm256_movemask_pd(acerto);
+      if (mascara != 0){
+	_mm256_storeu_pd(p.t + i, _mm256_blendv_pd(t_atual, t, acerto));
+	for (int l = 0; l < 4; l++){
+	  if (mascara & (1 << l)){
+	    p.indice[i + l] = k;
+	  }
+	}
+      }
+    }
+  }
+
+  /**
+   * \fn static bool caixa_pacote_avx2(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada);
+   *
+   * \brief Versao AVX2 de intercepta_caixa_pacote: quatro raios por instrucao.
+   */
+  static bool
+  caixa_pacote_avx2(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada){
+    const __m256d ox = _mm256_set1_pd(p.origem[0]), oy = _mm256_set1_pd(p.origem[1]), oz = _mm256_set1_pd(p.origem[2]);
+    const __m256d minx = _mm256_sub_pd(_mm256_set1_pd(min[0]), ox), maxx = _mm256_sub_pd(_mm256_set1_pd(max[0]), ox);
+    const __m256d miny = _mm256_sub_pd(_mm256_set1_pd(min[1]), oy), maxy = _mm256_sub_pd(_mm256_set1_pd(max[1]), oy);
+    const __m256d minz = _mm256_sub_pd(_mm256_set1_pd(min[2]), oz), maxz = _mm256_sub_pd(_mm256_set1_pd(max[2]), oz);
+    const __m256d infinito = _mm256_set1_pd(1e300);
+    __m256d menor = infinito;
+    int mascara = 0;
+    for (int i = 0; i < LARGURA_PACOTE; i += 4){
+      __m256d inv = _mm256_loadu_pd(p.inv_dx + i);
+      __m256d a = _mm256_mul_pd(minx, inv), b = _mm256_mul_pd(maxx, inv);
+      __m256d t0 = _mm256_max_pd(_mm256_setzero_pd(), _mm256_min_pd(a, b));
+      __m256d t1 = _mm256_min_pd(_mm256_loadu_pd(p.t + i), _mm256_max_pd(a, b));
+      inv = _mm256_loadu_pd(p.inv_dy + i);
+      a = _mm256_mul_pd(miny, inv); b = _mm256_mul_pd(maxy, inv);
+      t0 = _mm256_max_pd(t0, _mm256_min_pd(a, b));
+      t1 = _mm256_min_pd(t1, _mm256_max_pd(a, b));
+      inv = _mm256_loadu_pd(p.inv_dz + i);
+      a = _mm256_mul_pd(minz, inv); b = _mm256_mul_pd(maxz, inv);
+      t0 = _mm256_max_pd(t0, _mm256_min_pd(a, b));
+      t1 = _mm256_min_pd(t1, _mm256_max_pd(a, b));
+      __m256d acerto = _mm256_cmp_pd(t0, t1, _CMP_LE_OQ);
+      mascara |= _mm256_movemask_pd(acerto);
+      menor = _mm256_min_pd(menor, _mm256_blendv_pd(infinito, t0, acerto));
+    }
+    double m[4];
+    _mm256_storeu_pd(m, menor);
+    double t_menor = m[0];
+    for (int l = 1; l < 4; l++){
+      if (m[l] < t_menor) t_menor = m[l];
+    }
+    *t_entrada = t_menor;
+    return mascara != 0;
+  }
+
+  /**
+   * \fn static int triangulos_avx2(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+   * double t_minimo, double t_max, double* t);
+   *
+   * \brief Versao AVX2 de intercepta_triangulos: quatro triangulos por instrucao.
+   */
+  static int
+  triangulos_avx2(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+		  double t_minimo, double t_max, double* t){
+    const __m256d ox = _mm256_set1_pd(origem[0]), oy = _mm256_set1_pd(origem[1]), oz = _mm256_set1_pd(origem[2]);
+    const __m256d dx = _mm256_set1_pd(direcao[0]), dy = _mm256_set1_pd(direcao[1]), dz = _mm256_set1_pd(direcao[2]);
+    const __m256d zero = _mm256_setzero_pd(), um = _mm256_set1_pd(1.0);
+    const __m256d minimo = _mm256_set1_pd(t_minimo);
+    __m256d t_melhor = _mm256_set1_pd(t_max);
+    __m256d melhor = _mm256_set1_pd(-1.0);
+    int fim = inicio + n;
+    for (int j = inicio; j < fim; j += 4){
+      __m256d e1x = _mm256_loadu_pd(tri.e1x + j), e1y = _mm256_loadu_pd(tri.e1y + j), e1z = _mm256_loadu_pd(tri.e1z + j);
+      __m256d e2x = _mm256_loadu_pd(tri.e2x + j), e2y = _mm256_loadu_pd(tri.e2y + j), e2z = _mm256_loadu_pd(tri.e2z + j);
+      __m256d px = _mm256_sub_pd(_mm256_mul_pd(dy, e2z), _mm256_mul_pd(dz, e2y));
+      __m256d py = _mm256_sub_pd(_mm256_mul_pd(dz, e2x), _mm256_mul_pd(dx, e2z));
+      __m256d pz = _mm256_sub_pd(_mm256_mul_pd(dx, e2y), _mm256_mul_pd(dy, e2x));
+      __m256d det = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(e1x, px), _mm256_mul_pd(e1y, py)), _mm256_mul_pd(e1z, pz));
+      __m256d inv = _mm256_div_pd(um, det);
+      __m256d tx = _mm256_sub_pd(ox, _mm256_loadu_pd(tri.v0x + j)), ty = _mm256_sub_pd(oy, _mm256_loadu_pd(tri.v0y + j)), tz = _mm256_sub_pd(oz, _mm256_loadu_pd(tri.v0z + j));
+      __m256d u = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(tx, px), _mm256_mul_pd(ty, py)), _mm256_mul_pd(tz, pz)), inv);
+      __m256d qx = _mm256_sub_pd(_mm256_mul_pd(ty, e1z), _mm256_mul_pd(tz, e1y));
+      __m256d qy = _mm256_sub_pd(_mm256_mul_pd(tz, e1x), _mm256_mul_pd(tx, e1z));
+      __m256d qz = _mm256_sub_pd(_mm256_mul_pd(tx, e1y), _mm256_mul_pd(ty, e1x));
+      __m256d v = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, qx), _mm256_mul_pd(dy, qy)), _mm256_mul_pd(dz, qz)), inv);
+      __m256d tj = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(e2x, qx), _mm256_mul_pd(e2y, qy)), _mm256_mul_pd(e2z, qz)), inv);
+      //Posicoes alem do ultimo triangulo sao descartadas
+      __m256d indices = _mm256_set_pd(j + 3, j + 2, j + 1, j);
+      __m256d acerto = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(det, zero, _CMP_NEQ_OQ), _mm256_cmp_pd(u, zero, _CMP_GE_OQ)), _mm256_cmp_pd(v, zero, _CMP_GE_OQ));
+      acerto = _mm256_and_pd(_mm256_and_pd(_mm256_and_pd(_mm256_and_pd(acerto, _mm256_cmp_pd(_mm256_add_pd(u, v), um, _CMP_LE_OQ)), _mm256_cmp_pd(tj, minimo, _CMP_GT_OQ)), _mm256_cmp_pd(tj, t_melhor, _CMP_LT_OQ)), _mm256_cmp_pd(indices, _mm256_set1_pd(fim), _CMP_LT_OQ));
+      t_melhor = _mm256_blendv_pd(t_melhor, tj, acerto);
+      melhor = _mm256_blendv_pd(melhor, indices, acerto);
+    }
+    double t_posicoes[4], indices[4];
+    _mm256_storeu_pd(t_posicoes, t_melhor);
+    _mm256_storeu_pd(indices, melhor);
+    return menor_posicao(t_posicoes, indices, 4, t);
+  }
+
+  /**
+   * \fn static void triangulo_pacote_avx2(PacoteRaios& p, const TriangulosSoA& tri, int k);
+   *
+   * \brief Versao AVX2 de intercepta_triangulo_pacote: quatro raios por instrucao.
+   */
+  static void
+  triangulo_pacote_avx2(PacoteRaios& p, const TriangulosSoA& tri, int k){
+    double tx = p.origem[0] - tri.v0x[k], ty = p.origem[1] - tri.v0y[k], tz = p.origem[2] - tri.v0z[k];
+    double qx = ty * tri.e1z[k] - tz * tri.e1y[k];
+    double qy = tz * tri.e1x[k] - tx * tri.e1z[k];
+    double qz = tx * tri.e1y[k] - ty * tri.e1x[k];
+    double e2q = tri.e2x[k] * qx + tri.e2y[k] * qy + tri.e2z[k] * qz;
+    const __m256d e1x = _mm256_set1_pd(tri.e1x[k]), e1y = _mm256_set1_pd(tri.e1y[k]), e1z = _mm256_set1_pd(tri.e1z[k]);
+    const __m256d e2x = _mm256_set1_pd(tri.e2x[k]), e2y = _mm256_set1_pd(tri.e2y[k]), e2z = _mm256_set1_pd(tri.e2z[k]);
+    const __m256d vtx = _mm256_set1_pd(tx), vty = _mm256_set1_pd(ty), vtz = _mm256_set1_pd(tz);
+    const __m256d vqx = _mm256_set1_pd(qx), vqy = _mm256_set1_pd(qy), vqz = _mm256_set1_pd(qz);
+    const __m256d ve2q = _mm256_set1_pd(e2q);
+    const __m256d zero = _mm256_setzero_pd(), um = _mm256_set1_pd(1.0);
+    for (int i = 0; i < LARGURA_PACOTE; i += 4){
+      __m256d dx = _mm256_loadu_pd(p.dx + i), dy = _mm256_loadu_pd(p.dy + i), dz = _mm256_loadu_pd(p.dz + i);
+      __m256d px = _mm256_sub_pd(_mm256_mul_pd(dy, e2z), _mm256_mul_pd(dz, e2y));
+      __m256d py = _mm256_sub_pd(_mm256_mul_pd(dz, e2x), _mm256_mul_pd(dx, e2z));
+      __m256d pz = _mm256_sub_pd(_mm256_mul_pd(dx, e2y), _mm256_mul_pd(dy, e2x));
+      __m256d det = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(e1x, px), _mm256_mul_pd(e1y, py)), _mm256_mul_pd(e1z, pz));
+      __m256d inv = _mm256_div_pd(um, det);
+      __m256d u = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(vtx, px), _mm256_mul_pd(vty, py)), _mm256_mul_pd(vtz, pz)), inv);
+      __m256d v = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dx, vqx), _mm256_mul_pd(dy, vqy)), _mm256_mul_pd(dz, vqz)), inv);
+      __m256d t = _mm256_mul_pd(ve2q, inv);
+      __m256d t_atual = _mm256_loadu_pd(p.t + i);
+      __m256d acerto = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(det, zero, _CMP_NEQ_OQ), _mm256_cmp_pd(u, zero, _CMP_GE_OQ)), _mm256_cmp_pd(v, zero, _CMP_GE_OQ));
+      acerto = _mm256_and_pd(_mm256_and_pd(_mm256_and_pd(acerto, _mm256_cmp_pd(_mm256_add_pd(u, v), um, _CMP_LE_OQ)), _mm256_cmp_pd(t, zero, _CMP_GT_OQ)), _mm256_cmp_pd(t, t_atual, _CMP_LT_OQ));
+      int mascara = _mm256_movemask_pd(acerto);
+      if (mascara != 0){
+	_mm256_storeu_pd(p.t + i, _mm256_blendv_pd(t_atual, t, acerto));
+	for (int l = 0; l < 4; l++){
+	  if (mascara & (1 << l)){
+	    p.indice[i + l] = k;
+	  }
+	}
+      }
+    }
+  }
+
+  /**
+   * \fn static int caixas_quantizadas_avx2(const CaixasQuantizadas& c, const double origem[3], const double inverso[3],
+   * double t_max, double* t_entrada);
+   *
+   * \brief Versao AVX2 de intercepta_caixas_quantizadas: quatro filhos por instrucao.
+   */
+  static int
+  caixas_quantizadas_avx2(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max,
+			  double* t_entrada){
+    double escala[3], deslocamento[3], margem;
+    if (!preparar_caixas(c, origem, inverso, escala, deslocamento, &margem)){
+      return caixas_exatas(c, origem, inverso, t_max, t_entrada);
+    }
+    __m256d t0[2], t1[2];
+    for (int j = 0; j < 2; j++){
+      t0[j] = _mm256_setzero_pd();
+      t1[j] = _mm256_set1_pd(t_max);
+    }
+    for (int e = 0; e < 3; e++){
+      const __m256d s = _mm256_set1_pd(escala[e]), d = _mm256_set1_pd(deslocamento[e]);
+      __m128i entrada = _mm_loadl_epi64((const __m128i*) ((inverso[e] >= 0.0) ? c.minimo[e] : c.maximo[e]));
+      __m128i saida = _mm_loadl_epi64((const __m128i*) ((inverso[e] >= 0.0) ? c.maximo[e] : c.minimo[e]));
+      for (int j = 0; j < 2; j++){
+	__m256d a = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm_cvtepu8_epi32(entrada)), s), d);
+	__m256d b = _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm_cvtepu8_epi32(saida)), s), d);
+	t0[j] = _mm256_max_pd(a, t0[j]);
+	t1[j] = _mm256_min_pd(b, t1[j]);
+	//Os quatro filhos seguintes
+	entrada = _mm_srli_si128(entrada, 4);
+	saida = _mm_srli_si128(saida, 4);
+      }
+    }
+    const __m256d m = _mm256_set1_pd(margem);
+    int mascara = 0;
+    for (int j = 0; j < 2; j++){
+      __m256d entrada = _mm256_sub_pd(t0[j], m);
+      _mm256_storeu_pd(t_entrada + 4 * j, entrada);
+      mascara |= _mm256_movemask_pd(_mm256_cmp_pd(entrada, _mm256_add_pd(t1[j], m), _CMP_LE_OQ)) << (4 * j);
+    }
+    return mascara & ((1 << c.n_filhos) - 1);
+  }
+
+  /**
+   * \fn static void sombrear_pacote_avx2(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz);
+   *
+   * \brief Versao AVX2 de sombrear_pacote: quatro raios por instrucao.
+   */
+  static void
+  sombrear_pacote_avx2(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz){
+    double produto_n_l[LARGURA_PACOTE], potencia[LARGURA_PACOTE];
+    const __m256d luz_x = _mm256_set1_pd(luz.posicao[0]), luz_y = _mm256_set1_pd(luz.posicao[1]), luz_z = _mm256_set1_pd(luz.posicao[2]);
+    const __m256d obs_x = _mm256_set1_pd(observador[0]), obs_y = _mm256_set1_pd(observador[1]), obs_z = _mm256_set1_pd(observador[2]);
+    const __m256d dois = _mm256_set1_pd(2.0);
+    for (int i = 0; i < LARGURA_PACOTE; i += 4){
+      __m256d px = _mm256_loadu_pd(a.px + i), py = _mm256_loadu_pd(a.py + i), pz = _mm256_loadu_pd(a.pz + i);
+      __m256d nx = _mm256_loadu_pd(a.nx + i), ny = _mm256_loadu_pd(a.ny + i), nz = _mm256_loadu_pd(a.nz + i);
+      __m256d lx = _mm256_sub_pd(luz_x, px), ly = _mm256_sub_pd(luz_y, py), lz = _mm256_sub_pd(luz_z, pz);
+      __m256d norma = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(lx, lx), _mm256_mul_pd(ly, ly)), _mm256_mul_pd(lz, lz)));
+      lx = _mm256_div_pd(lx, norma); ly = _mm256_div_pd(ly, norma); lz = _mm256_div_pd(lz, norma);
+      __m256d ox = _mm256_sub_pd(obs_x, px), oy = _mm256_sub_pd(obs_y, py), oz = _mm256_sub_pd(obs_z, pz);
+      norma = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ox, ox), _mm256_mul_pd(oy, oy)), _mm256_mul_pd(oz, oz)));
+      ox = _mm256_div_pd(ox, norma); oy = _mm256_div_pd(oy, norma); oz = _mm256_div_pd(oz, norma);
+      __m256d n_l = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(nx, lx), _mm256_mul_pd(ny, ly)), _mm256_mul_pd(nz, lz));
+      __m256d dobro = _mm256_mul_pd(dois, n_l);
+      __m256d rx = _mm256_sub_pd(_mm256_mul_pd(nx, dobro), lx), ry = _mm256_sub_pd(_mm256_mul_pd(ny, dobro), ly);
+      __m256d rz = _mm256_sub_pd(_mm256_mul_pd(nz, dobro), lz);
+      norma = _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(rx, rx), _mm256_mul_pd(ry, ry)), _mm256_mul_pd(rz, rz)));
+      rx = _mm256_div_pd(rx, norma); ry = _mm256_div_pd(ry, norma); rz = _mm256_div_pd(rz, norma);
+      _mm256_storeu_pd(produto_n_l + i, n_l);
+      _mm256_storeu_pd(potencia + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ox, rx), _mm256_mul_pd(oy, ry)), _mm256_mul_pd(oz, rz)));
+    }
+    potencias_ativas(potencia, a.brilho, LARGURA_PACOTE, a.ativos);
+    const __m256d ambiente = _mm256_set1_pd(luz.ambiente);
+    const __m256d ir = _mm256_set1_pd(luz.intensidade[0]), ig = _mm256_set1_pd(luz.intensidade[1]), ib = _mm256_set1_pd(luz.intensidade[2]);
+    for (int i = 0; i < LARGURA_PACOTE; i += 4){
+      __m256d difusa_especular = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(a.kd + i), _mm256_loadu_pd(produto_n_l + i)),
+					       _mm256_mul_pd(_mm256_loadu_pd(a.ks + i), _mm256_loadu_pd(potencia + i)));
+      _mm256_storeu_pd(a.r + i, _mm256_mul_pd(_mm256_add_pd(ambiente, _mm256_mul_pd(ir, difusa_especular)), _mm256_loadu_pd(a.albedo_r + i)));
+      _mm256_storeu_pd(a.g + i, _mm256_mul_pd(_mm256_add_pd(ambiente, _mm256_mul_pd(ig, difusa_especular)), _mm256_loadu_pd(a.albedo_g + i)));
+      _mm256_storeu_pd(a.b + i, _mm256_mul_pd(_mm256_add_pd(ambiente, _mm256_mul_pd(ib, difusa_especular)), _mm256_loadu_pd(a.albedo_b + i)));
+    }
+  }
+
+  const ConjuntoNucleos NUCLEOS_AVX2 = { "avx2", esferas_avx2, esfera_pacote_avx2, caixa_pacote_avx2,
+					   triangulos_avx2, triangulo_pacote_avx2, caixas_quantizadas_avx2, sombrear_pacote_avx2 };
+#else
+  //Variante nao compilada (arquitetura sem AVX2)
+  const ConjuntoNucleos NUCLEOS_AVX2 = { "avx2", NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+#endif
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
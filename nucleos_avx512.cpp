@@ -0,0 +1,349 @@
+/**
+ * \file nucleos_avx512.cpp
+ *
+ * \brief Este arquivo contem a variante AVX-512 dos nucleos definidos no arquivo nucleos.hpp: oito doubles por instrucao, o pacote
+ * inteiro de uma vez. O arquivo e compilado com -mavx512f e so e executado se o processador suportar essas instrucoes; por isso ele
+ * nao chama funcoes inline de outros cabecalhos, cujas copias poderiam ser escolhidas pelo ligador para o programa inteiro.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "nucleos.hpp"		//rayTracing::ConjuntoNucleos
+#include "nucleos_comum.hpp"	//rayTracing::menor_posicao
+#include "pacote.hpp"		//rayTracing::PacoteRaios
+#include <stddef.h>		//NULL
+
+#if defined(__AVX512F__)
+#include <immintrin.h>		//_mm512_*
+#if defined(__GNUC__) && !defined(__clang__)
+//Alguns GCC acusam como nao iniciado o _mm512_undefined_pd usado dentro dos proprios intrinsecos
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+#if defined(__AVX512F__)
+  /**
+   * \fn static __m512d oposto(__m512d v);
+   *
+   * \brief Troca o sinal de v (o AVX-512F nao possui xor de doubles).
+   */
+  static inline __m512d
+  oposto(__m512d v){
+    return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(v), _mm512_castpd_si512(_mm512_set1_pd(-0.0))));
+  }
+
+  /**
+   * \fn static int esferas_avx512(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+   * const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t);
+   *
+   * \brief Versao AVX-512 de intercepta_esferas: oito esferas por instrucao.
+   */
+  static int
+  esferas_avx512(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+		 const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t){
+    const __m512d ox = _mm512_set1_pd(origem[0]), oy = _mm512_set1_pd(origem[1]), oz = _mm512_set1_pd(origem[2]);
+    const __m512d dx = _mm512_set1_pd(direcao[0]), dy = _mm512_set1_pd(direcao[1]), dz = _mm512_set1_pd(direcao[2]);
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d minimo = _mm512_set1_pd(t_minimo);
+    __m512d t_melhor = _mm512_set1_pd(t_max);
+    __m512d melhor = _mm512_set1_pd(-1.0);
+    int fim = inicio + n;
+    for (int j = inicio; j < fim; j += 8){
+      __m512d ocx = _mm512_sub_pd(ox, _mm512_loadu_pd(cx + j));
+      __m512d ocy = _mm512_sub_pd(oy, _mm512_loadu_pd(cy + j));
+      __m512d ocz = _mm512_sub_pd(oz, _mm512_loadu_pd(cz + j));
+      __m512d c = _mm512_sub_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(ocx, ocx), _mm512_mul_pd(ocy, ocy)), _mm512_mul_pd(ocz, ocz)),
+				_mm512_loadu_pd(r2 + j));
+      __m512d b = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(ocx, dx), _mm512_mul_pd(ocy, dy)), _mm512_mul_pd(ocz, dz));
+      __m512d discriminante = _mm512_sub_pd(_mm512_mul_pd(b, b), c);
+      __m512d tj = _mm512_sub_pd(oposto(b), _mm512_sqrt_pd(_mm512_max_pd(discriminante, zero)));
+      //Posicoes alem da ultima esfera sao descartadas
+      __m512d indices = _mm512_set_pd(j + 7, j + 6, j + 5, j + 4, j + 3, j + 2, j + 1, j);
+      __mmask8 acerto = _mm512_cmp_pd_mask(c, zero, _CMP_GE_OQ) & _mm512_cmp_pd_mask(b, zero, _CMP_LE_OQ)
+	& _mm512_cmp_pd_mask(discriminante, zero, _CMP_GE_OQ) & _mm512_cmp_pd_mask(tj, minimo, _CMP_GT_OQ)
+	& _mm512_cmp_pd_mask(tj, t_melhor, _CMP_LT_OQ) & _mm512_cmp_pd_mask(indices, _mm512_set1_pd(fim), _CMP_LT_OQ);
+      t_melhor = _mm512_mask_blend_pd(acerto, t_melhor, tj);
+      melhor = _mm512_mask_blend_pd(acerto, melhor, indices);
+    }
+    double t_posicoes[8], indices[8];
+    _mm512_storeu_pd(t_posicoes, t_melhor);
+    _mm512_storeu_pd(indices, melhor);
+    return menor_posicao(t_posicoes, indices, 8, t);
+  }
+
+  /**
+   * \fn static inline __mmask8 posicoes_pacote(int i);
+   *
+   * \brief Mascara das posicoes do pacote a partir de i que cabem em um registrador: todas as oito, exceto nos pacotes de 4 raios.
+   */
+  static inline __mmask8
+  posicoes_pacote(int i){
+    return (LARGURA_PACOTE - i >= 8) ? (__mmask8) 0xFF : (__mmask8) ((1 << (LARGURA_PACOTE - i)) - 1);
+  }
+
+  /**
+   * \fn static void esfera_pacote_avx512(PacoteRaios& p, const double oc[3], double c, int k);
+   *
+   * \brief Versao AVX-512 de intercepta_esfera_pacote: oito raios por instrucao.
+   */
+  static void
+  esfera_pacote_avx512(PacoteRaios& p, const double oc[3], double c, int k){
+    if (c < 0.0){	//Origem dentro da esfera: apenas a menor raiz e considerada, e ela e negativa
+      return;
+    }
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d ocx = _mm512_set1_pd(oc[0]), ocy = _mm512_set1_pd(oc[1]), ocz = _mm512_set1_pd(oc[2]);
+    for (int i = 0; i < LARGURA_PACOTE; i += 8){
+      __mmask8 posicoes = posicoes_pacote(i);
+      __m512d b = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(ocx, _mm512_maskz_loadu_pd(posicoes, p.dx + i)),
+					      _mm512_mul_pd(ocy, _mm512_maskz_loadu_pd(posicoes, p.dy + i))),
+				_mm512_mul_pd(ocz, _mm512_maskz_loadu_pd(posicoes, p.dz + i)));
+      __m512d discriminante = _mm512_sub_pd(_mm512_mul_pd(b, b), _mm512_set1_pd(c));
+      __m512d t = _mm512_sub_pd(oposto(b), _mm512_sqrt_pd(_mm512_max_pd(discriminante, zero)));
+      __m512d t_atual = _mm512_maskz_loadu_pd(posicoes, p.t + i);
+      __mmask8 acerto = posicoes & _mm512_cmp_pd_mask(b, zero, _CMP_LE_OQ) & _mm512_cmp_pd_mask(discriminante, zero, _CMP_GE_OQ)
+	& _mm512_cmp_pd_mask(t, zero, _CMP_GT_OQ) & _mm512_cmp_pd_mask(t, t_atual, _CMP_LT_OQ);
+      if (acerto != 0){
+	_mm512_mask_storeu_pd(p.t + i, acerto, t);
+	for (int l = 0; l < 8; l++){
+	  if (acerto & (1 << l)){
+	    p.indice[i + l] = k;
+	  }
+	}
+      }
+    }
+  }
+
+  /**
+   * \fn static bool caixa_pacote_avx512(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada);
+   *
+   * \brief Versao AVX-512 de intercepta_caixa_pacote: oito raios por instrucao.
+   */
+  static bool
+  caixa_pacote_avx512(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada){
+    const __m512d ox = _mm512_set1_pd(p.origem[0]), oy = _mm512_set1_pd(p.origem[1]), oz = _mm512_set1_pd(p.origem[2]);
+    const __m512d minx = _mm512_sub_pd(_mm512_set1_pd(min[0]), ox), maxx = _mm512_sub_pd(_mm512_set1_pd(max[0]), ox);
+    const __m512d miny = _mm512_sub_pd(_mm512_set1_pd(min[1]), oy), maxy = _mm512_sub_pd(_mm512_set1_pd(max[1]), oy);
+    const __m512d minz = _mm512_sub_pd(_mm512_set1_pd(min[2]), oz), maxz = _mm512_sub_pd(_mm512_set1_pd(max[2]), oz);
+    const __m512d infinito = _mm512_set1_pd(1e300);
+    __m512d menor = infinito;
+    bool algum = false;
+    for (int i = 0; i < LARGURA_PACOTE; i += 8){
+      __mmask8 posicoes = posicoes_pacote(i);
+      __m512d inv = _mm512_maskz_loadu_pd(posicoes, p.inv_dx + i);
+      __m512d a = _mm512_mul_pd(minx, inv), b = _mm512_mul_pd(maxx, inv);
+      __m512d t0 = _mm512_max_pd(_mm512_setzero_pd(), _mm512_min_pd(a, b));
+      __m512d t1 = _mm512_min_pd(_mm512_maskz_loadu_pd(posicoes, p.t + i), _mm512_max_pd(a, b));
+      inv = _mm512_maskz_loadu_pd(posicoes, p.inv_dy + i);
+      a = _mm512_mul_pd(miny, inv); b = _mm512_mul_pd(maxy, inv);
+      t0 = _mm512_max_pd(t0, _mm512_min_pd(a, b));
+      t1 = _mm512_min_pd(t1, _mm512_max_pd(a, b));
+      inv = _mm512_maskz_loadu_pd(posicoes, p.inv_dz + i);
+      a = _mm512_mul_pd(minz, inv); b = _mm512_mul_pd(maxz, inv);
+      t0 = _mm512_max_pd(t0, _mm512_min_pd(a, b));
+      t1 = _mm512_min_pd(t1, _mm512_max_pd(a, b));
+      __mmask8 acerto = posicoes & _mm512_cmp_pd_mask(t0, t1, _CMP_LE_OQ);
+      menor = _mm512_min_pd(menor, _mm512_mask_blend_pd(acerto, infinito, t0));
+      algum = algum || acerto != 0;
+    }
+    *t_entrada = _mm512_reduce_min_pd(menor);
+    return algum;
+  }
+
+  /**
+   * \fn static int triangulos_avx512(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+   * double t_minimo, double t_max, double* t);
+   *
+   * \brief Versao AVX-512 de intercepta_triangulos: oito triangulos por instrucao.
+   */
+  static int
+  triangulos_avx512(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+      	    double t_minimo, double t_max, double* t){
+    const __m512d ox = _mm512_set1_pd(origem[0]), oy = _mm512_set1_pd(origem[1]), oz = _mm512_set1_pd(origem[2]);
+    const __m512d dx = _mm512_set1_pd(direcao[0]), dy = _mm512_set1_pd(direcao[1]), dz = _mm512_set1_pd(direcao[2]);
+    const __m512d zero = _mm512_setzero_pd(), um = _mm512_set1_pd(1.0);
+    const __m512d minimo = _mm512_set1_pd(t_minimo);
+    __m512d t_melhor = _mm512_set1_pd(t_max);
+    __m512d melhor = _mm512_set1_pd(-1.0);
+    int fim = inicio + n;
+    for (int j = inicio; j < fim; j += 8){
+    __m512d e1x = _mm512_loadu_pd(tri.e1x + j), e1y = _mm512_loadu_pd(tri.e1y + j), e1z = _mm512_loadu_pd(tri.e1z + j);
+    __m512d e2x = _mm512_loadu_pd(tri.e2x + j), e2y = _mm512_loadu_pd(tri.e2y + j), e2z = _mm512_loadu_pd(tri.e2z + j);
+    __m512d px = _mm512_sub_pd(_mm512_mul_pd(dy, e2z), _mm512_mul_pd(dz, e2y));
+    __m512d py = _mm512_sub_pd(_mm512_mul_pd(dz, e2x), _mm512_mul_pd(dx, e2z));
+    __m512d pz = _mm512_sub_pd(_mm512_mul_pd(dx, e2y), _mm512_mul_pd(dy, e2x));
+    __m512d det = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(e1x, px), _mm512_mul_pd(e1y, py)), _mm512_mul_pd(e1z, pz));
+    __m512d inv = _mm512_div_pd(um, det);
+    __m512d tx = _mm512_sub_pd(ox, _mm512_loadu_pd(tri.v0x + j)), ty = _mm512_sub_pd(oy, _mm512_loadu_pd(tri.v0y + j)), tz = _mm512_sub_pd(oz, _mm512_loadu_pd(tri.v0z + j));
+    __m512d u = _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(tx, px), _mm512_mul_pd(ty, py)), _mm512_mul_pd(tz, pz)), inv);
+    __m512d qx = _mm512_sub_pd(_mm512_mul_pd(ty, e1z), _mm512_mul_pd(tz, e1y));
+    __m512d qy = _mm512_sub_pd(_mm512_mul_pd(tz, e1x), _mm512_mul_pd(tx, e1z));
+    __m512d qz = _mm512_sub_pd(_mm512_mul_pd(tx, e1y), _mm512_mul_pd(ty, e1x));
+    __m512d v = _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, qx), _mm512_mul_pd(dy, qy)), _mm512_mul_pd(dz, qz)), inv);
+    __m512d tj = _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(e2x, qx), _mm512_mul_pd(e2y, qy)), _mm512_mul_pd(e2z, qz)), inv);
+    //Posicoes alem do ultimo triangulo sao descartadas
+    __m512d indices = _mm512_set_pd(j + 7, j + 6, j + 5, j + 4, j + 3, j + 2, j + 1, j);
+    __mmask8 acerto = _mm512_cmp_pd_mask(det, zero, _CMP_NEQ_OQ) & _mm512_cmp_pd_mask(u, zero, _CMP_GE_OQ) & _mm512_cmp_pd_mask(v, zero, _CMP_GE_OQ);
+    acerto = acerto & _mm512_cmp_pd_mask(_mm512_add_pd(u, v), um, _CMP_LE_OQ) & _mm512_cmp_pd_mask(tj, minimo, _CMP_GT_OQ) & _mm512_cmp_pd_mask(tj, t_melhor, _CMP_LT_OQ) & _mm512_cmp_pd_mask(indices, _mm512_set1_pd(fim), _CMP_LT_OQ);
+    t_melhor = _mm512_mask_blend_pd(acerto, t_melhor, tj);
+    melhor = _mm512_mask_blend_pd(acerto, melhor, indices);
+    }
+    double t_posicoes[8], indices[8];
+    _mm512_storeu_pd(t_posicoes, t_melhor);
+    _mm512_storeu_pd(indices, melhor);
+    return menor_posicao(t_posicoes, indices, 8, t);
+  }
+
+  /**
+   * \fn static void triangulo_pacote_avx512(PacoteRaios& p, const TriangulosSoA& tri, int k);
+   *
+   * \brief Versao AVX-512 de intercepta_triangulo_pacote: oito raios por instrucao.
+   */
+  static void
+  triangulo_pacote_avx512(PacoteRaios& p, const TriangulosSoA& tri, int k){
+    double tx = p.origem[0] - tri.v0x[k], ty = p.origem[1] - tri.v0y[k], tz = p.origem[2] - tri.v0z[k];
+    double qx = ty * tri.e1z[k] - tz * tri.e1y[k];
+    double qy = tz * tri.e1x[k] - tx * tri.e1z[k];
+    double qz = tx * tri.e1y[k] - ty * tri.e1x[k];
+    double e2q = tri.e2x[k] * qx + tri.e2y[k] * qy + tri.e2z[k] * qz;
+    const __m512d e1x = _mm512_set1_pd(tri.e1x[k]), e1y = _mm512_set1_pd(tri.e1y[k]), e1z = _mm512_set1_pd(tri.e1z[k]);
+    const __m512d e2x = _mm512_set1_pd(tri.e2x[k]), e2y = _mm512_set1_pd(tri.e2y[k]), e2z = _mm512_set1_pd(tri.e2z[k]);
+    const __m512d vtx = _mm512_set1_pd(tx), vty = _mm512_set1_pd(ty), vtz = _mm512_set1_pd(tz);
+    const __m512d vqx = _mm512_set1_pd(qx), vqy = _mm512_set1_pd(qy), vqz = _mm512_set1_pd(qz);
+    const __m512d ve2q = _mm512_set1_pd(e2q);
+    const __m512d zero = _mm512_setzero_pd(), um = _mm512_set1_pd(1.0);
+    for (int i = 0; i < LARGURA_PACOTE; i += 8){
+      __mmask8 posicoes = posicoes_pacote(i);
+      __m512d dx = _mm512_maskz_loadu_pd(posicoes, p.dx + i), dy = _mm512_maskz_loadu_pd(posicoes, p.dy + i);
+      __m512d dz = _mm512_maskz_loadu_pd(posicoes, p.dz + i);
+      __m512d px = _mm512_sub_pd(_mm512_mul_pd(dy, e2z), _mm512_mul_pd(dz, e2y));
+      __m512d py = _mm512_sub_pd(_mm512_mul_pd(dz, e2x), _mm512_mul_pd(dx, e2z));
+      __m512d pz = _mm512_sub_pd(_mm512_mul_pd(dx, e2y), _mm512_mul_pd(dy, e2x));
+      __m512d det = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(e1x, px), _mm512_mul_pd(e1y, py)), _mm512_mul_pd(e1z, pz));
+      __m512d inv = _mm512_div_pd(um, det);
+      __m512d u = _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(vtx, px), _mm512_mul_pd(vty, py)), _mm512_mul_pd(vtz, pz)), inv);
+      __m512d v = _mm512_mul_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(dx, vqx), _mm512_mul_pd(dy, vqy)), _mm512_mul_pd(dz, vqz)), inv);
+      __m512d t = _mm512_mul_pd(ve2q, inv);
+      __m512d t_atual = _mm512_maskz_loadu_pd(posicoes, p.t + i);
+      __mmask8 acerto = posicoes & _mm512_cmp_pd_mask(det, zero, _CMP_NEQ_OQ) & _mm512_cmp_pd_mask(u, zero, _CMP_GE_OQ)
+	& _mm512_cmp_pd_mask(v, zero, _CMP_GE_OQ);
+      acerto = acerto & _mm512_cmp_pd_mask(_mm512_add_pd(u, v), um, _CMP_LE_OQ) & _mm512_cmp_pd_mask(t, zero, _CMP_GT_OQ) & _mm512_cmp_pd_mask(t, t_atual, _CMP_LT_OQ);
+      if (acerto != 0){
+	_mm512_mask_storeu_pd(p.t + i, acerto, t);
+	for (int l = 0; l < 8; l++){
+	  if (acerto & (1 << l)){
+	    p.indice[i + l] = k;
+	  }
+	}
+      }
+    }
+  }
+
+  /**
+   * \fn static int caixas_quantizadas_avx512(const CaixasQuantizadas& c, const double origem[3], const double inverso[3],
+   * double t_max, double* t_entrada);
+   *
+   * \brief Versao AVX-512 de intercepta_caixas_quantizadas: os oito filhos em uma instrucao.
+   */
+  static int
+  caixas_quantizadas_avx512(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max,
+			    double* t_entrada){
+    double escala[3], deslocamento[3], margem;
+    if (!preparar_caixas(c, origem, inverso, escala, deslocamento, &margem)){
+      return caixas_exatas(c, origem, inverso, t_max, t_entrada);
+    }
+    __m512d t0 = _mm512_setzero_pd(), t1 = _mm512_set1_pd(t_max);
+    for (int e = 0; e < 3; e++){
+      const __m512d s = _mm512_set1_pd(escala[e]), d = _mm512_set1_pd(deslocamento[e]);
+      const unsigned char* entrada = (inverso[e] >= 0.0) ? c.minimo[e] : c.maximo[e];
+      const unsigned char* saida = (inverso[e] >= 0.0) ? c.maximo[e] : c.minimo[e];
+      __m512d a = _mm512_cvtepi32_pd(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) entrada)));
+      __m512d b = _mm512_cvtepi32_pd(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*) saida)));
+      t0 = _mm512_max_pd(_mm512_add_pd(_mm512_mul_pd(a, s), d), t0);
+      t1 = _mm512_min_pd(_mm512_add_pd(_mm512_mul_pd(b, s), d), t1);
+    }
+    const __m512d m = _mm512_set1_pd(margem);
+    t0 = _mm512_sub_pd(t0, m);
+    _mm512_storeu_pd(t_entrada, t0);
+    return _mm512_cmp_pd_mask(t0, _mm512_add_pd(t1, m), _CMP_LE_OQ) & ((1 << c.n_filhos) - 1);
+  }
+
+  /**
+   * \fn static void sombrear_pacote_avx512(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz);
+   *
+   * \brief Versao AVX-512 de sombrear_pacote: oito raios por instrucao.
+   */
+  static void
+  sombrear_pacote_avx512(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz){
+    double produto_n_l[LARGURA_PACOTE], potencia[LARGURA_PACOTE];
+    const __m512d luz_x = _mm512_set1_pd(luz.posicao[0]), luz_y = _mm512_set1_pd(luz.posicao[1]), luz_z = _mm512_set1_pd(luz.posicao[2]);
+    const __m512d obs_x = _mm512_set1_pd(observador[0]), obs_y = _mm512_set1_pd(observador[1]), obs_z = _mm512_set1_pd(observador[2]);
+    const __m512d dois = _mm512_set1_pd(2.0);
+    for (int i = 0; i < LARGURA_PACOTE; i += 8){
+      __mmask8 posicoes = posicoes_pacote(i);
+      __m512d px = _mm512_maskz_loadu_pd(posicoes, a.px + i), py = _mm512_maskz_loadu_pd(posicoes, a.py + i);
+      __m512d pz = _mm512_maskz_loadu_pd(posicoes, a.pz + i);
+      __m512d nx = _mm512_maskz_loadu_pd(posicoes, a.nx + i), ny = _mm512_maskz_loadu_pd(posicoes, a.ny + i);
+      __m512d nz = _mm512_maskz_loadu_pd(posicoes, a.nz + i);
+      __m512d lx = _mm512_sub_pd(luz_x, px), ly = _mm512_sub_pd(luz_y, py), lz = _mm512_sub_pd(luz_z, pz);
+      __m512d norma = _mm512_sqrt_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(lx, lx), _mm512_mul_pd(ly, ly)), _mm512_mul_pd(lz, lz)));
+      lx = _mm512_div_pd(lx, norma); ly = _mm512_div_pd(ly, norma); lz = _mm512_div_pd(lz, norma);
+      __m512d ox = _mm512_sub_pd(obs_x, px), oy = _mm512_sub_pd(obs_y, py), oz = _mm512_sub_pd(obs_z, pz);
+      norma = _mm512_sqrt_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(ox, ox), _mm512_mul_pd(oy, oy)), _mm512_mul_pd(oz, oz)));
+      ox = _mm512_div_pd(ox, norma); oy = _mm512_div_pd(oy, norma); oz = _mm512_div_pd(oz, norma);
+      __m512d n_l = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(nx, lx), _mm512_mul_pd(ny, ly)), _mm512_mul_pd(nz, lz));
+      __m512d dobro = _mm512_mul_pd(dois, n_l);
+      __m512d rx = _mm512_sub_pd(_mm512_mul_pd(nx, dobro), lx), ry = _mm512_sub_pd(_mm512_mul_pd(ny, dobro), ly);
+      __m512d rz = _mm512_sub_pd(_mm512_mul_pd(nz, dobro), lz);
+      norma = _mm512_sqrt_pd(_mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(rx, rx), _mm512_mul_pd(ry, ry)), _mm512_mul_pd(rz, rz)));
+      rx = _mm512_div_pd(rx, norma); ry = _mm512_div_pd(ry, norma); rz = _mm512_div_pd(rz, norma);
+      _mm512_mask_storeu_pd(produto_n_l + i, posicoes, n_l);
+      _mm512_mask_storeu_pd(potencia + i, posicoes,
+			    _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(ox, rx), _mm512_mul_pd(oy, ry)), _mm512_mul_pd(oz, rz)));
+    }
+    potencias_ativas(potencia, a.brilho, LARGURA_PACOTE, a.ativos);
+    const __m512d ambiente = _mm512_set1_pd(luz.ambiente);
+    const __m512d ir = _mm512_set1_pd(luz.intensidade[0]), ig = _mm512_set1_pd(luz.intensidade[1]), ib = _mm512_set1_pd(luz.intensidade[2]);
+    for (int i = 0; i < LARGURA_PACOTE; i += 8){
+      __mmask8 posicoes = posicoes_pacote(i);
+      __m512d kd = _mm512_maskz_loadu_pd(posicoes, a.kd + i), ks = _mm512_maskz_loadu_pd(posicoes, a.ks + i);
+      __m512d difusa_especular = _mm512_add_pd(_mm512_mul_pd(kd, _mm512_maskz_loadu_pd(posicoes, produto_n_l + i)),
+					       _mm512_mul_pd(ks, _mm512_maskz_loadu_pd(posicoes, potencia + i)));
+      __m512d ar = _mm512_maskz_loadu_pd(posicoes, a.albedo_r + i), ag = _mm512_maskz_loadu_pd(posicoes, a.albedo_g + i);
+      __m512d ab = _mm512_maskz_loadu_pd(posicoes, a.albedo_b + i);
+      _mm512_mask_storeu_pd(a.r + i, posicoes, _mm512_mul_pd(_mm512_add_pd(ambiente, _mm512_mul_pd(ir, difusa_especular)), ar));
+      _mm512_mask_storeu_pd(a.g + i, posicoes, _mm512_mul_pd(_mm512_add_pd(ambiente, _mm512_mul_pd(ig, difusa_especular)), ag));
+      _mm512_mask_storeu_pd(a.b + i, posicoes, _mm512_mul_pd(_mm512_add_pd(ambiente, _mm512_mul_pd(ib, difusa_especular)), ab));
+    }
+  }
+
+  const ConjuntoNucleos NUCLEOS_AVX512 = { "avx512", esferas_avx512, esfera_pacote_avx512, caixa_pacote_avx512,
+					   triangulos_avx512, triangulo_pacote_avx512, caixas_quantizadas_avx512,
+					   sombrear_pacote_avx512 };
+#else
+  //Variante nao compilada (arquitetura sem AVX-512)
+  const ConjuntoNucleos NUCLEOS_AVX512 = { "avx512", NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+#endif
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
@@ -0,0 +1,146 @@
+/**
+ * \file nucleos_comum.hpp
+ *
+ * \brief Este arquivo contem as funcoes auxiliares compartilhadas pelas variantes dos nucleos (nucleos_<nome>.cpp). As funcoes sao
+ * static para que cada variante tenha a sua propria copia, compilada com o seu conjunto de instrucoes: uma funcao inline comum
+ * poderia ter a copia de uma variante larga escolhida pelo ligador para o programa inteiro.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _NUCLEOS_COMUM_HPP
+#define _NUCLEOS_COMUM_HPP
+
+#include <math.h>	//fabs, pow
+#include <stdint.h>	//uint64_t
+#include <string.h>	//memcpy
+#include "nucleos.hpp"	//rayTracing::CaixasQuantizadas
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \fn static int menor_posicao(const double* t_posicoes, const double* indices, int largura, double* t);
+   *
+   * \brief Reducao horizontal: retorna o indice da menor interseccao entre as posicoes do registrador (o menor indice em caso de
+   * empate) ou -1 se nenhuma posicao encontrou interseccao.
+   */
+  static inline int
+  menor_posicao(const double* t_posicoes, const double* indices, int largura, double* t){
+    int melhor = -1;
+    double t_melhor = 0.0;
+    for (int l = 0; l < largura; l++){
+      if (indices[l] < 0.0){
+	continue;
+      }
+      if (melhor < 0 || t_posicoes[l] < t_melhor || (t_posicoes[l] == t_melhor && (int) indices[l] < melhor)){
+	melhor = (int) indices[l];
+	t_melhor = t_posicoes[l];
+      }
+    }
+    if (melhor >= 0){
+      *t = t_melhor;
+    }
+    return melhor;
+  }
+
+  /**
+   * \fn static void potencias_ativas(double* base, const double* expoente, int n, int ativos);
+   *
+   * \brief Troca base[k] por pow(base[k], expoente[k]) nas posicoes com o bit k de ativos ligado, e por zero nas demais. Nao ha pow
+   * vetorial portavel, entao todas as variantes do sombreamento chamam a mesma funcao da biblioteca, raio a raio.
+   */
+  static inline void
+  potencias_ativas(double* base, const double* expoente, int n, int ativos){
+    for (int k = 0; k < n; k++){
+      base[k] = (ativos & (1 << k)) ? pow(base[k], expoente[k]) : 0.0;
+    }
+  }
+
+  /**
+   * \fn static double potencia_dois(int expoente);
+   *
+   * \brief Retorna 2^expoente (expoente entre -1022 e 1023), montando os bits do double sem chamar a biblioteca matematica.
+   */
+  static inline double
+  potencia_dois(int expoente){
+    uint64_t bits = (uint64_t) (expoente + 1023) << 52;
+    double potencia;
+    memcpy(&potencia, &bits, sizeof(potencia));
+    return potencia;
+  }
+
+  /**
+   * \fn static bool preparar_caixas(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double escala[3],
+   * double deslocamento[3], double* margem);
+   *
+   * \brief Prepara o teste das placas de intercepta_caixas_quantizadas: no eixo e, o t da coordenada q de um filho e
+   * q * escala[e] + deslocamento[e], com escala[e] = 2^expoente[e] * inverso[e] (exata) e deslocamento[e] = (origem do no - origem do
+   * raio) * inverso[e]. Cada t fica a menos de margem do t da coordenada decodificada, e os nucleos afastam as placas dessa margem
+   * para que o teste continue conservador.
+   *
+   * \return false se alguma componente da direcao e nula (inverso infinito): os nucleos usam entao caixas_exatas.
+   */
+  static inline bool
+  preparar_caixas(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double escala[3],
+		  double deslocamento[3], double* margem){
+    double maior = 0.0;
+    for (int e = 0; e < 3; e++){
+      escala[e] = potencia_dois(c.expoente[e]) * inverso[e];
+      deslocamento[e] = ((double) c.origem[e] - origem[e]) * inverso[e];
+      double m = fabs(deslocamento[e]) + 255.0 * fabs(escala[e]);
+      if (m > maior) maior = m;
+    }
+    //Quatro arredondamentos de no maximo 2^-53 cada, com folga: 2^-50
+    *margem = maior * 8.8817841970012523e-16;
+    return maior <= 1e300;
+  }
+
+  /**
+   * \fn static int caixas_exatas(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max,
+   * double* t_entrada);
+   *
+   * \brief intercepta_caixas_quantizadas com as caixas decodificadas e o teste das placas de BVH::intercepta_caixa, um filho por vez.
+   * Trata os inversos infinitos como a BVH binaria.
+   */
+  static inline int
+  caixas_exatas(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max, double* t_entrada){
+    int mascara = 0;
+    for (int i = 0; i < c.n_filhos; i++){
+      double t0 = 0.0, t1 = t_max;
+      for (int e = 0; e < 3; e++){
+	double passo = potencia_dois(c.expoente[e]);
+	double a = ((double) c.origem[e] + c.minimo[e][i] * passo - origem[e]) * inverso[e];
+	double b = ((double) c.origem[e] + c.maximo[e][i] * passo - origem[e]) * inverso[e];
+	if (a > b){ double aux = a; a = b; b = aux; }
+	if (a > t0) t0 = a;
+	if (b < t1) t1 = b;
+      }
+      t_entrada[i] = t0;
+      if (t0 <= t1){
+	mascara |= 1 << i;
+      }
+    }
+    return mascara;
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
@@ -0,0 +1,257 @@
+/**
+ * \file nucleos_escalar.cpp
+ *
+ * \brief Este arquivo contem a variante escalar dos nucleos definidos no arquivo nucleos.hpp: um raio (ou uma esfera) por vez, com as
+ * mesmas operacoes, na mesma ordem, das variantes vetoriais. E a variante usada em processadores sem as extensoes vetoriais e a
+ * referencia das demais.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "nucleos.hpp"		//rayTracing::ConjuntoNucleos
+#include "nucleos_comum.hpp"	//rayTracing::menor_posicao
+#include "pacote.hpp"		//rayTracing::PacoteRaios
+#include <math.h>		//sqrt
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \fn static int esferas_escalar(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+   * const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t);
+   *
+   * \brief Versao escalar de intercepta_esferas: uma esfera por vez.
+   */
+  static int
+  esferas_escalar(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+		  const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t){
+    double t_melhor = t_max;
+    double melhor = -1.0;
+    for (int j = inicio; j < inicio + n; j++){
+      double ocx = origem[0] - cx[j], ocy = origem[1] - cy[j], ocz = origem[2] - cz[j];
+      double c = ocx * ocx + ocy * ocy + ocz * ocz - r2[j];
+      double b = ocx * direcao[0] + ocy * direcao[1] + ocz * direcao[2];
+      double discriminante = b * b - c;
+      if (c < 0.0 || b > 0.0 || discriminante < 0.0){
+	continue;
+      }
+      double tj = -b - sqrt(discriminante);
+      if (tj > t_minimo && tj < t_melhor){
+	t_melhor = tj;
+	melhor = (double) j;
+      }
+    }
+    return menor_posicao(&t_melhor, &melhor, 1, t);
+  }
+
+  /**
+   * \fn static void esfera_pacote_escalar(PacoteRaios& p, const double oc[3], double c, int k);
+   *
+   * \brief Versao escalar de intercepta_esfera_pacote: um raio por vez.
+   */
+  static void
+  esfera_pacote_escalar(PacoteRaios& p, const double oc[3], double c, int k){
+    if (c < 0.0){	//Origem dentro da esfera: apenas a menor raiz e considerada, e ela e negativa
+      return;
+    }
+    for (int i = 0; i < LARGURA_PACOTE; i++){
+      double b = oc[0] * p.dx[i] + oc[1] * p.dy[i] + oc[2] * p.dz[i];
+      double discriminante = b * b - c;
+      if (b > 0.0 || discriminante < 0.0){
+	continue;
+      }
+      double t = -b - sqrt(discriminante);
+      if (t > 0.0 && t < p.t[i]){
+	p.t[i] = t;
+	p.indice[i] = k;
+      }
+    }
+  }
+
+  /**
+   * \fn static bool caixa_pacote_escalar(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada);
+   *
+   * \brief Versao escalar de intercepta_caixa_pacote: um raio por vez.
+   */
+  static bool
+  caixa_pacote_escalar(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada){
+    const double* inv[3] = { p.inv_dx, p.inv_dy, p.inv_dz };
+    bool algum = false;
+    double menor = 1e300;
+    for (int i = 0; i < LARGURA_PACOTE; i++){
+      double t0 = 0.0, t1 = p.t[i];
+      for (int e = 0; e < 3; e++){
+	double a = (min[e] - p.origem[e]) * inv[e][i];
+	double b = (max[e] - p.origem[e]) * inv[e][i];
+	if (a > b){ double aux = a; a = b; b = aux; }
+	if (a > t0) t0 = a;
+	if (b < t1) t1 = b;
+      }
+      if (t0 <= t1){
+	algum = true;
+	if (t0 < menor) menor = t0;
+      }
+    }
+    *t_entrada = menor;
+    return algum;
+  }
+
+  /**
+   * \fn static int triangulos_escalar(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+   * double t_minimo, double t_max, double* t);
+   *
+   * \brief Versao escalar de intercepta_triangulos: um triangulo por vez.
+   */
+  static int
+  triangulos_escalar(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+		     double t_minimo, double t_max, double* t){
+    double t_melhor = t_max;
+    double melhor = -1.0;
+    for (int j = inicio; j < inicio + n; j++){
+      double px = direcao[1] * tri.e2z[j] - direcao[2] * tri.e2y[j];
+      double py = direcao[2] * tri.e2x[j] - direcao[0] * tri.e2z[j];
+      double pz = direcao[0] * tri.e2y[j] - direcao[1] * tri.e2x[j];
+      double det = tri.e1x[j] * px + tri.e1y[j] * py + tri.e1z[j] * pz;
+      if (det == 0.0){
+	continue;
+      }
+      double inv = 1.0 / det;
+      double tx = origem[0] - tri.v0x[j], ty = origem[1] - tri.v0y[j], tz = origem[2] - tri.v0z[j];
+      double u = (tx * px + ty * py + tz * pz) * inv;
+      double qx = ty * tri.e1z[j] - tz * tri.e1y[j];
+      double qy = tz * tri.e1x[j] - tx * tri.e1z[j];
+      double qz = tx * tri.e1y[j] - ty * tri.e1x[j];
+      double v = (direcao[0] * qx + direcao[1] * qy + direcao[2] * qz) * inv;
+      double tj = (tri.e2x[j] * qx + tri.e2y[j] * qy + tri.e2z[j] * qz) * inv;
+      if (u >= 0.0 && v >= 0.0 && u + v <= 1.0 && tj > t_minimo && tj < t_melhor){
+	t_melhor = tj;
+	melhor = (double) j;
+      }
+    }
+    return menor_posicao(&t_melhor, &melhor, 1, t);
+  }
+
+  /**
+   * \fn static void triangulo_pacote_escalar(PacoteRaios& p, const TriangulosSoA& tri, int k);
+   *
+   * \brief Versao escalar de intercepta_triangulo_pacote: um raio por vez.
+   */
+  static void
+  triangulo_pacote_escalar(PacoteRaios& p, const TriangulosSoA& tri, int k){
+    double tx = p.origem[0] - tri.v0x[k], ty = p.origem[1] - tri.v0y[k], tz = p.origem[2] - tri.v0z[k];
+    double qx = ty * tri.e1z[k] - tz * tri.e1y[k];
+    double qy = tz * tri.e1x[k] - tx * tri.e1z[k];
+    double qz = tx * tri.e1y[k] - ty * tri.e1x[k];
+    double e2q = tri.e2x[k] * qx + tri.e2y[k] * qy + tri.e2z[k] * qz;
+    for (int i = 0; i < LARGURA_PACOTE; i++){
+      double px = p.dy[i] * tri.e2z[k] - p.dz[i] * tri.e2y[k];
+      double py = p.dz[i] * tri.e2x[k] - p.dx[i] * tri.e2z[k];
+      double pz = p.dx[i] * tri.e2y[k] - p.dy[i] * tri.e2x[k];
+      double det = tri.e1x[k] * px + tri.e1y[k] * py + tri.e1z[k] * pz;
+      if (det == 0.0){
+	continue;
+      }
+      double inv = 1.0 / det;
+      double u = (tx * px + ty * py + tz * pz) * inv;
+      double v = (p.dx[i] * qx + p.dy[i] * qy + p.dz[i] * qz) * inv;
+      double t = e2q * inv;
+      if (u >= 0.0 && v >= 0.0 && u + v <= 1.0 && t > 0.0 && t < p.t[i]){
+	p.t[i] = t;
+	p.indice[i] = k;
+      }
+    }
+  }
+
+  /**
+   * \fn static int caixas_quantizadas_escalar(const CaixasQuantizadas& c, const double origem[3], const double inverso[3],
+   * double t_max, double* t_entrada);
+   *
+   * \brief Versao escalar de intercepta_caixas_quantizadas: um filho por vez, com as mesmas operacoes das versoes vetoriais. O sinal
+   * do inverso escolhe a placa de entrada de cada eixo.
+   */
+  static int
+  caixas_quantizadas_escalar(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max,
+			     double* t_entrada){
+    double escala[3], deslocamento[3], margem;
+    if (!preparar_caixas(c, origem, inverso, escala, deslocamento, &margem)){
+      return caixas_exatas(c, origem, inverso, t_max, t_entrada);
+    }
+    const unsigned char* entrada[3];
+    const unsigned char* saida[3];
+    for (int e = 0; e < 3; e++){
+      entrada[e] = (inverso[e] >= 0.0) ? c.minimo[e] : c.maximo[e];
+      saida[e] = (inverso[e] >= 0.0) ? c.maximo[e] : c.minimo[e];
+    }
+    int mascara = 0;
+    for (int i = 0; i < c.n_filhos; i++){
+      double t0 = 0.0, t1 = t_max;
+      for (int e = 0; e < 3; e++){
+	double a = entrada[e][i] * escala[e] + deslocamento[e];
+	double b = saida[e][i] * escala[e] + deslocamento[e];
+	if (a > t0) t0 = a;
+	if (b < t1) t1 = b;
+      }
+      t0 = t0 - margem;
+      t1 = t1 + margem;
+      t_entrada[i] = t0;
+      if (t0 <= t1){
+	mascara |= 1 << i;
+      }
+    }
+    return mascara;
+  }
+
+  /**
+   * \fn static void sombrear_pacote_escalar(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz);
+   *
+   * \brief Versao escalar de sombrear_pacote: um raio por vez, com as operacoes de Luz::calcula_luz.
+   */
+  static void
+  sombrear_pacote_escalar(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz){
+    double produto_n_l[LARGURA_PACOTE], potencia[LARGURA_PACOTE];
+    for (int i = 0; i < LARGURA_PACOTE; i++){
+      double lx = luz.posicao[0] - a.px[i], ly = luz.posicao[1] - a.py[i], lz = luz.posicao[2] - a.pz[i];
+      double norma = sqrt((lx * lx) + (ly * ly) + (lz * lz));
+      lx = lx / norma; ly = ly / norma; lz = lz / norma;
+      double ox = observador[0] - a.px[i], oy = observador[1] - a.py[i], oz = observador[2] - a.pz[i];
+      norma = sqrt((ox * ox) + (oy * oy) + (oz * oz));
+      ox = ox / norma; oy = oy / norma; oz = oz / norma;
+      double n_l = (a.nx[i] * lx) + (a.ny[i] * ly) + (a.nz[i] * lz);
+      double dobro = 2 * n_l;
+      double rx = a.nx[i] * dobro - lx, ry = a.ny[i] * dobro - ly, rz = a.nz[i] * dobro - lz;
+      norma = sqrt((rx * rx) + (ry * ry) + (rz * rz));
+      rx = rx / norma; ry = ry / norma; rz = rz / norma;
+      produto_n_l[i] = n_l;
+      potencia[i] = (ox * rx) + (oy * ry) + (oz * rz);
+    }
+    potencias_ativas(potencia, a.brilho, LARGURA_PACOTE, a.ativos);
+    for (int i = 0; i < LARGURA_PACOTE; i++){
+      double difusa_especular = (a.kd[i] * produto_n_l[i]) + (a.ks[i] * potencia[i]);
+      a.r[i] = (luz.ambiente + luz.intensidade[0] * difusa_especular) * a.albedo_r[i];
+      a.g[i] = (luz.ambiente + luz.intensidade[1] * difusa_especular) * a.albedo_g[i];
+      a.b[i] = (luz.ambiente + luz.intensidade[2] * difusa_especular) * a.albedo_b[i];
+    }
+  }
+
+  const ConjuntoNucleos NUCLEOS_ESCALAR = { "escalar", esferas_escalar, esfera_pacote_escalar, caixa_pacote_escalar,
+					     triangulos_escalar, triangulo_pacote_escalar, caixas_quantizadas_escalar,
+					     sombrear_pacote_escalar };
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
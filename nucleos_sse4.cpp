@@ -0,0 +1,325 @@
+/**
+ * \file nucleos_sse4.cpp
+ *
+ * \brief Este arquivo contem a variante SSE4 dos nucleos definidos no arquivo nucleos.hpp: dois doubles por instrucao. O arquivo e
+ * compilado com -msse4.2 e so e executado se o processador suportar essas instrucoes; por isso ele nao chama funcoes inline de outros
+ * cabecalhos, cujas copias poderiam ser escolhidas pelo ligador para o programa inteiro.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "nucleos.hpp"		//rayTracing::ConjuntoNucleos
+#include "nucleos_comum.hpp"	//rayTracing::menor_posicao
+#include "pacote.hpp"		//rayTracing::PacoteRaios
+#include <stddef.h>		//NULL
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>		//_mm_*
+#endif
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+#if defined(__SSE4_1__)
+  /**
+   * \fn static int esferas_sse4(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+   * const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t);
+   *
+   * \brief Versao SSE4 de intercepta_esferas: duas esferas por instrucao.
+   */
+  static int
+  esferas_sse4(const double* cx, const double* cy, const double* cz, const double* r2, int inicio, int n,
+	       const double origem[3], const double direcao[3], double t_minimo, double t_max, double* t){
+    const __m128d ox = _mm_set1_pd(origem[0]), oy = _mm_set1_pd(origem[1]), oz = _mm_set1_pd(origem[2]);
+    const __m128d dx = _mm_set1_pd(direcao[0]), dy = _mm_set1_pd(direcao[1]), dz = _mm_set1_pd(direcao[2]);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d sinal = _mm_set1_pd(-0.0);
+    const __m128d minimo = _mm_set1_pd(t_minimo);
+    __m128d t_melhor = _mm_set1_pd(t_max);
+    __m128d melhor = _mm_set1_pd(-1.0);
+    int fim = inicio + n;
+    for (int j = inicio; j < fim; j += 2){
+      __m128d ocx = _mm_sub_pd(ox, _mm_loadu_pd(cx + j));
+      __m128d ocy = _mm_sub_pd(oy, _mm_loadu_pd(cy + j));
+      __m128d ocz = _mm_sub_pd(oz, _mm_loadu_pd(cz + j));
+      __m128d c = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(ocx, ocx), _mm_mul_pd(ocy, ocy)), _mm_mul_pd(ocz, ocz)), _mm_loadu_pd(r2 + j));
+      __m128d b = _mm_add_pd(_mm_add_pd(_mm_mul_pd(ocx, dx), _mm_mul_pd(ocy, dy)), _mm_mul_pd(ocz, dz));
+      __m128d discriminante = _mm_sub_pd(_mm_mul_pd(b, b), c);
+      __m128d tj = _mm_sub_pd(_mm_xor_pd(b, sinal), _mm_sqrt_pd(_mm_max_pd(discriminante, zero)));
+      __m128d acerto = _mm_and_pd(_mm_and_pd(_mm_cmpge_pd(c, zero), _mm_cmple_pd(b, zero)),
+				  _mm_and_pd(_mm_cmpge_pd(discriminante, zero), _mm_and_pd(_mm_cmpgt_pd(tj, minimo), _mm_cmplt_pd(tj, t_melhor))));
+      //Posicoes alem da ultima esfera sao descartadas
+      __m128d indices = _mm_set_pd(j + 1, j);
+      acerto = _mm_and_pd(acerto, _mm_cmplt_pd(indices, _mm_set1_pd(fim)));
+      t_melhor = _mm_blendv_pd(t_melhor, tj, acerto);
+      melhor = _mm_blendv_pd(melhor, indices, acerto);
+    }
+    double t_posicoes[2], indices[2];
+    _mm_storeu_pd(t_posicoes, t_melhor);
+    _mm_storeu_pd(indices, melhor);
+    return menor_posicao(t_posicoes, indices, 2, t);
+  }
+
+  /**
+   * \fn static void esfera_pacote_sse4(PacoteRaios& p, const double oc[3], double c, int k);
+   *
+   * \brief Versao SSE4 de intercepta_esfera_pacote: dois raios por instrucao.
+   */
+  static void
+  esfera_pacote_sse4(PacoteRaios& p, const double oc[3], double c, int k){
+    if (c < 0.0){	//Origem dentro da esfera: apenas a menor raiz e considerada, e ela e negativa
+      return;
+    }
+    const __m128d ocx = _mm_set1_pd(oc[0]), ocy = _mm_set1_pd(oc[1]), ocz = _mm_set1_pd(oc[2]);
+    const __m128d vc = _mm_set1_pd(c);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d sinal = _mm_set1_pd(-0.0);
+    for (int i = 0; i < LARGURA_PACOTE; i += 2){
+      __m128d b = _mm_add_pd(_mm_add_pd(_mm_mul_pd(ocx, _mm_loadu_pd(p.dx + i)), _mm_mul_pd(ocy, _mm_loadu_pd(p.dy + i))),
+			     _mm_mul_pd(ocz, _mm_loadu_pd(p.dz + i)));
+      __m128d discriminante = _mm_sub_pd(_mm_mul_pd(b, b), vc);
+      __m128d t = _mm_sub_pd(_mm_xor_pd(b, sinal), _mm_sqrt_pd(_mm_max_pd(discriminante, zero)));
+      __m128d t_atual = _mm_loadu_pd(p.t + i);
+      __m128d acerto = _mm_and_pd(_mm_and_pd(_mm_cmple_pd(b, zero), _mm_cmpge_pd(discriminante, zero)),
+				  _mm_and_pd(_mm_cmpgt_pd(t, zero), _mm_cmplt_pd(t, t_atual)));
+      int mascara = _mm_movemask_pd(acerto);
+      if (mascara != 0){
+	_mm_storeu_pd(p.t + i, _mm_blendv_pd(t_atual, t, acerto));
+	if (mascara & 1) p.indice[i] = k;
+	if (mascara & 2) p.indice[i + 1] = k;
+      }
+    }
+  }
+
+  /**
+   * \fn static bool caixa_pacote_sse4(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada);
+   *
+   * \brief Versao SSE4 de intercepta_caixa_pacote: dois raios por instrucao.
+   */
+  static bool
+  caixa_pacote_sse4(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada){
+    const __m128d ox = _mm_set1_pd(p.origem[0]), oy = _mm_set1_pd(p.origem[1]), oz = _mm_set1_pd(p.origem[2]);
+    const __m128d minx = _mm_sub_pd(_mm_set1_pd(min[0]), ox), maxx = _mm_sub_pd(_mm_set1_pd(max[0]), ox);
+    const __m128d miny = _mm_sub_pd(_mm_set1_pd(min[1]), oy), maxy = _mm_sub_pd(_mm_set1_pd(max[1]), oy);
+    const __m128d minz = _mm_sub_pd(_mm_set1_pd(min[2]), oz), maxz = _mm_sub_pd(_mm_set1_pd(max[2]), oz);
+    const __m128d infinito = _mm_set1_pd(1e300);
+    __m128d menor = infinito;
+    int mascara = 0;
+    for (int i = 0; i < LARGURA_PACOTE; i += 2){
+      __m128d inv = _mm_loadu_pd(p.inv_dx + i);
+      __m128d a = _mm_mul_pd(minx, inv), b = _mm_mul_pd(maxx, inv);
+      __m128d t0 = _mm_max_pd(_mm_setzero_pd(), _mm_min_pd(a, b));
+      __m128d t1 = _mm_min_pd(_mm_loadu_pd(p.t + i), _mm_max_pd(a, b));
+      inv = _mm_loadu_pd(p.inv_dy + i);
+      a = _mm_mul_pd(miny, inv); b = _mm_mul_pd(maxy, inv);
+      t0 = _mm_max_pd(t0, _mm_min_pd(a, b));
+      t1 = _mm_min_pd(t1, _mm_max_pd(a, b));
+      inv = _mm_loadu_pd(p.inv_dz + i);
+      a = _mm_mul_pd(minz, inv); b = _mm_mul_pd(maxz, inv);
+      t0 = _mm_max_pd(t0, _mm_min_pd(a, b));
+      t1 = _mm_min_pd(t1, _mm_max_pd(a, b));
+      __m128d acerto = _mm_cmple_pd(t0, t1);
+      mascara |= _mm_movemask_pd(acerto);
+      menor = _mm_min_pd(menor, _mm_blendv_pd(infinito, t0, acerto));
+    }
+    double m[2];
+    _mm_storeu_pd(m, menor);
+    *t_entrada = (m[0] < m[1]) ? m[0] : m[1];
+    return mascara != 0;
+  }
+
+  /**
+   * \fn static int triangulos_sse4(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+   * double t_minimo, double t_max, double* t);
+   *
+   * \brief Versao SSE4 de intercepta_triangulos: dois triangulos por instrucao.
+   */
+  static int
+  triangulos_sse4(const TriangulosSoA& tri, int inicio, int n, const double origem[3], const double direcao[3],
+		  double t_minimo, double t_max, double* t){
+    const __m128d ox = _mm_set1_pd(origem[0]), oy = _mm_set1_pd(origem[1]), oz = _mm_set1_pd(origem[2]);
+    const __m128d dx = _mm_set1_pd(direcao[0]), dy = _mm_set1_pd(direcao[1]), dz = _mm_set1_pd(direcao[2]);
+    const __m128d zero = _mm_setzero_pd(), um = _mm_set1_pd(1.0);
+    const __m128d minimo = _mm_set1_pd(t_minimo);
+    __m128d t_melhor = _mm_set1_pd(t_max);
+    __m128d melhor = _mm_set1_pd(-1.0);
+    int fim = inicio + n;
+    for (int j = inicio; j < fim; j += 2){
+      __m128d e1x = _mm_loadu_pd(tri.e1x + j), e1y = _mm_loadu_pd(tri.e1y + j), e1z = _mm_loadu_pd(tri.e1z + j);
+      __m128d e2x = _mm_loadu_pd(tri.e2x + j), e2y = _mm_loadu_pd(tri.e2y + j), e2z = _mm_loadu_pd(tri.e2z + j);
+      __m128d px = _mm_sub_pd(_mm_mul_pd(dy, e2z), _mm_mul_pd(dz, e2y));
+      __m128d py = _mm_sub_pd(_mm_mul_pd(dz, e2x), _mm_mul_pd(dx, e2z));
+      __m128d pz = _mm_sub_pd(_mm_mul_pd(dx, e2y), _mm_mul_pd(dy, e2x));
+      __m128d det = _mm_add_pd(_mm_add_pd(_mm_mul_pd(e1x, px), _mm_mul_pd(e1y, py)), _mm_mul_pd(e1z, pz));
+      __m128d inv = _mm_div_pd(um, det);
+      __m128d tx = _mm_sub_pd(ox, _mm_loadu_pd(tri.v0x + j)), ty = _mm_sub_pd(oy, _mm_loadu_pd(tri.v0y + j)), tz = _mm_sub_pd(oz, _mm_loadu_pd(tri.v0z + j));
+      __m128d u = _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(tx, px), _mm_mul_pd(ty, py)), _mm_mul_pd(tz, pz)), inv);
+      __m128d qx = _mm_sub_pd(_mm_mul_pd(ty, e1z), _mm_mul_pd(tz, e1y));
+      __m128d qy = _mm_sub_pd(_mm_mul_pd(tz, e1x), _mm_mul_pd(tx, e1z));
+      __m128d qz = _mm_sub_pd(_mm_mul_pd(tx, e1y), _mm_mul_pd(ty, e1x));
+      __m128d v = _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, qx), _mm_mul_pd(dy, qy)), _mm_mul_pd(dz, qz)), inv);
+      __m128d tj = _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(e2x, qx), _mm_mul_pd(e2y, qy)), _mm_mul_pd(e2z, qz)), inv);
+      //Posicoes alem do ultimo triangulo sao descartadas
+      __m128d indices = _mm_set_pd(j + 1, j);
+      __m128d acerto = _mm_and_pd(_mm_and_pd(_mm_cmpneq_pd(det, zero), _mm_cmpge_pd(u, zero)), _mm_cmpge_pd(v, zero));
+      acerto = _mm_and_pd(_mm_and_pd(_mm_and_pd(_mm_and_pd(acerto, _mm_cmple_pd(_mm_add_pd(u, v), um)), _mm_cmpgt_pd(tj, minimo)), _mm_cmplt_pd(tj, t_melhor)), _mm_cmplt_pd(indices, _mm_set1_pd(fim)));
+      t_melhor = _mm_blendv_pd(t_melhor, tj, acerto);
+      melhor = _mm_blendv_pd(melhor, indices, acerto);
+    }
+    double t_posicoes[2], indices[2];
+    _mm_storeu_pd(t_posicoes, t_melhor);
+    _mm_storeu_pd(indices, melhor);
+    return menor_posicao(t_posicoes, indices, 2, t);
+  }
+
+  /**
+   * \fn static void triangulo_pacote_sse4(PacoteRaios& p, const TriangulosSoA& tri, int k);
+   *
+   * \brief Versao SSE4 de intercepta_triangulo_pacote: dois raios por instrucao.
+   */
+  static void
+  triangulo_pacote_sse4(PacoteRaios& p, const TriangulosSoA& tri, int k){
+    double tx = p.origem[0] - tri.v0x[k], ty = p.origem[1] - tri.v0y[k], tz = p.origem[2] - tri.v0z[k];
+    double qx = ty * tri.e1z[k] - tz * tri.e1y[k];
+    double qy = tz * tri.e1x[k] - tx * tri.e1z[k];
+    double qz = tx * tri.e1y[k] - ty * tri.e1x[k];
+    double e2q = tri.e2x[k] * qx + tri.e2y[k] * qy + tri.e2z[k] * qz;
+    const __m128d e1x = _mm_set1_pd(tri.e1x[k]), e1y = _mm_set1_pd(tri.e1y[k]), e1z = _mm_set1_pd(tri.e1z[k]);
+    const __m128d e2x = _mm_set1_pd(tri.e2x[k]), e2y = _mm_set1_pd(tri.e2y[k]), e2z = _mm_set1_pd(tri.e2z[k]);
+    const __m128d vtx = _mm_set1_pd(tx), vty = _mm_set1_pd(ty), vtz = _mm_set1_pd(tz);
+    const __m128d vqx = _mm_set1_pd(qx), vqy = _mm_set1_pd(qy), vqz = _mm_set1_pd(qz);
+    const __m128d ve2q = _mm_set1_pd(e2q);
+    const __m128d zero = _mm_setzero_pd(), um = _mm_set1_pd(1.0);
+    for (int i = 0; i < LARGURA_PACOTE; i += 2){
+      __m128d dx = _mm_loadu_pd(p.dx + i), dy = _mm_loadu_pd(p.dy + i), dz = _mm_loadu_pd(p.dz + i);
+      __m128d px = _mm_sub_pd(_mm_mul_pd(dy, e2z), _mm_mul_pd(dz, e2y));
+      __m128d py = _mm_sub_pd(_mm_mul_pd(dz, e2x), _mm_mul_pd(dx, e2z));
+      __m128d pz = _mm_sub_pd(_mm_mul_pd(dx, e2y), _mm_mul_pd(dy, e2x));
+      __m128d det = _mm_add_pd(_mm_add_pd(_mm_mul_pd(e1x, px), _mm_mul_pd(e1y, py)), _mm_mul_pd(e1z, pz));
+      __m128d inv = _mm_div_pd(um, det);
+      __m128d u = _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(vtx, px), _mm_mul_pd(vty, py)), _mm_mul_pd(vtz, pz)), inv);
+      __m128d v = _mm_mul_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(dx, vqx), _mm_mul_pd(dy, vqy)), _mm_mul_pd(dz, vqz)), inv);
+      __m128d t = _mm_mul_pd(ve2q, inv);
+      __m128d t_atual = _mm_loadu_pd(p.t + i);
+      __m128d acerto = _mm_and_pd(_mm_and_pd(_mm_cmpneq_pd(det, zero), _mm_cmpge_pd(u, zero)), _mm_cmpge_pd(v, zero));
+      acerto = _mm_and_pd(_mm_and_pd(_mm_and_pd(acerto, _mm_cmple_pd(_mm_add_pd(u, v), um)), _mm_cmpgt_pd(t, zero)), _mm_cmplt_pd(t, t_atual));
+      int mascara = _mm_movemask_pd(acerto);
+      if (mascara != 0){
+	_mm_storeu_pd(p.t + i, _mm_blendv_pd(t_atual, t, acerto));
+	for (int l = 0; l < 2; l++){
+	  if (mascara & (1 << l)){
+	    p.indice[i + l] = k;
+	  }
+	}
+      }
+    }
+  }
+
+  /**
+   * \fn static int caixas_quantizadas_sse4(const CaixasQuantizadas& c, const double origem[3], const double inverso[3],
+   * double t_max, double* t_entrada);
+   *
+   * \brief Versao SSE4 de intercepta_caixas_quantizadas: dois filhos por instrucao.
+   */
+  static int
+  caixas_quantizadas_sse4(const CaixasQuantizadas& c, const double origem[3], const double inverso[3], double t_max,
+			  double* t_entrada){
+    double escala[3], deslocamento[3], margem;
+    if (!preparar_caixas(c, origem, inverso, escala, deslocamento, &margem)){
+      return caixas_exatas(c, origem, inverso, t_max, t_entrada);
+    }
+    __m128d t0[4], t1[4];
+    for (int j = 0; j < 4; j++){
+      t0[j] = _mm_setzero_pd();
+      t1[j] = _mm_set1_pd(t_max);
+    }
+    for (int e = 0; e < 3; e++){
+      const __m128d s = _mm_set1_pd(escala[e]), d = _mm_set1_pd(deslocamento[e]);
+      __m128i entrada = _mm_loadl_epi64((const __m128i*) ((inverso[e] >= 0.0) ? c.minimo[e] : c.maximo[e]));
+      __m128i saida = _mm_loadl_epi64((const __m128i*) ((inverso[e] >= 0.0) ? c.maximo[e] : c.minimo[e]));
+      for (int j = 0; j < 4; j++){
+	__m128d a = _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_cvtepu8_epi32(entrada)), s), d);
+	__m128d b = _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_cvtepu8_epi32(saida)), s), d);
+	t0[j] = _mm_max_pd(a, t0[j]);
+	t1[j] = _mm_min_pd(b, t1[j]);
+	//Os dois filhos seguintes
+	entrada = _mm_srli_si128(entrada, 2);
+	saida = _mm_srli_si128(saida, 2);
+      }
+    }
+    const __m128d m = _mm_set1_pd(margem);
+    int mascara = 0;
+    for (int j = 0; j < 4; j++){
+      __m128d entrada = _mm_sub_pd(t0[j], m);
+      _mm_storeu_pd(t_entrada + 2 * j, entrada);
+      mascara |= _mm_movemask_pd(_mm_cmple_pd(entrada, _mm_add_pd(t1[j], m))) << (2 * j);
+    }
+    return mascara & ((1 << c.n_filhos) - 1);
+  }
+
+  /**
+   * \fn static void sombrear_pacote_sse4(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz);
+   *
+   * \brief Versao SSE4 de sombrear_pacote: dois raios por instrucao.
+   */
+  static void
+  sombrear_pacote_sse4(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz){
+    double produto_n_l[LARGURA_PACOTE], potencia[LARGURA_PACOTE];
+    const __m128d luz_x = _mm_set1_pd(luz.posicao[0]), luz_y = _mm_set1_pd(luz.posicao[1]), luz_z = _mm_set1_pd(luz.posicao[2]);
+    const __m128d obs_x = _mm_set1_pd(observador[0]), obs_y = _mm_set1_pd(observador[1]), obs_z = _mm_set1_pd(observador[2]);
+    const __m128d dois = _mm_set1_pd(2.0);
+    for (int i = 0; i < LARGURA_PACOTE; i += 2){
+      __m128d px = _mm_loadu_pd(a.px + i), py = _mm_loadu_pd(a.py + i), pz = _mm_loadu_pd(a.pz + i);
+      __m128d nx = _mm_loadu_pd(a.nx + i), ny = _mm_loadu_pd(a.ny + i), nz = _mm_loadu_pd(a.nz + i);
+      __m128d lx = _mm_sub_pd(luz_x, px), ly = _mm_sub_pd(luz_y, py), lz = _mm_sub_pd(luz_z, pz);
+      __m128d norma = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(lx, lx), _mm_mul_pd(ly, ly)), _mm_mul_pd(lz, lz)));
+      lx = _mm_div_pd(lx, norma); ly = _mm_div_pd(ly, norma); lz = _mm_div_pd(lz, norma);
+      __m128d ox = _mm_sub_pd(obs_x, px), oy = _mm_sub_pd(obs_y, py), oz = _mm_sub_pd(obs_z, pz);
+      norma = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(ox, ox), _mm_mul_pd(oy, oy)), _mm_mul_pd(oz, oz)));
+      ox = _mm_div_pd(ox, norma); oy = _mm_div_pd(oy, norma); oz = _mm_div_pd(oz, norma);
+      __m128d n_l = _mm_add_pd(_mm_add_pd(_mm_mul_pd(nx, lx), _mm_mul_pd(ny, ly)), _mm_mul_pd(nz, lz));
+      __m128d dobro = _mm_mul_pd(dois, n_l);
+      __m128d rx = _mm_sub_pd(_mm_mul_pd(nx, dobro), lx), ry = _mm_sub_pd(_mm_mul_pd(ny, dobro), ly);
+      __m128d rz = _mm_sub_pd(_mm_mul_pd(nz, dobro), lz);
+      norma = _mm_sqrt_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(rx, rx), _mm_mul_pd(ry, ry)), _mm_mul_pd(rz, rz)));
+      rx = _mm_div_pd(rx, norma); ry = _mm_div_pd(ry, norma); rz = _mm_div_pd(rz, norma);
+      _mm_storeu_pd(produto_n_l + i, n_l);
+      _mm_storeu_pd(potencia + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(ox, rx), _mm_mul_pd(oy, ry)), _mm_mul_pd(oz, rz)));
+    }
+    potencias_ativas(potencia, a.brilho, LARGURA_PACOTE, a.ativos);
+    const __m128d ambiente = _mm_set1_pd(luz.ambiente);
+    const __m128d ir = _mm_set1_pd(luz.intensidade[0]), ig = _mm_set1_pd(luz.intensidade[1]), ib = _mm_set1_pd(luz.intensidade[2]);
+    for (int i = 0; i < LARGURA_PACOTE; i += 2){
+      __m128d difusa_especular = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(a.kd + i), _mm_loadu_pd(produto_n_l + i)),
+					    _mm_mul_pd(_mm_loadu_pd(a.ks + i), _mm_loadu_pd(potencia + i)));
+      _mm_storeu_pd(a.r + i, _mm_mul_pd(_mm_add_pd(ambiente, _mm_mul_pd(ir, difusa_especular)), _mm_loadu_pd(a.albedo_r + i)));
+      _mm_storeu_pd(a.g + i, _mm_mul_pd(_mm_add_pd(ambiente, _mm_mul_pd(ig, difusa_especular)), _mm_loadu_pd(a.albedo_g + i)));
+      _mm_storeu_pd(a.b + i, _mm_mul_pd(_mm_add_pd(ambiente, _mm_mul_pd(ib, difusa_especular)), _mm_loadu_pd(a.albedo_b + i)));
+    }
+  }
+
+  const ConjuntoNucleos NUCLEOS_SSE4 = { "sse4", esferas_sse4, esfera_pacote_sse4, caixa_pacote_sse4,
+					   triangulos_sse4, triangulo_pacote_sse4, caixas_quantizadas_sse4, sombrear_pacote_sse4 };
+#else
+  //Variante nao compilada (arquitetura sem SSE4)
+  const ConjuntoNucleos NUCLEOS_SSE4 = { "sse4", NULL, NULL, NULL, NULL, NULL, NULL, NULL };
+#endif
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
@@ -31,9 +31,34 @@ namespace rayTracing{
   //------------------------------
   //	Metodos publicos
   //------------------------------
+  /**
+   * \fn Objeto::Objeto();
+   *
+   * \brief Construtor da classe. O objeto inicial e uma esfera de raio zero.
+   */
+  Objeto::Objeto(){
+    tipo = PRIMITIVA_ESFERA;
+    esfera.pos_x = esfera.pos_y = esfera.pos_z = 0.0;
+    esfera.raio = 0.0;
+    kd = ks = 0.0;
+    brilho = BRILHO_PADRAO;
+    cor_r = cor_g = cor_b = 0.0;
+  }
+
+  /**
+   * \fn TipoPrimitiva Objeto::tipo_primitiva() const;
+   *
+   * \brief Retorna o tipo da primitiva descrita pelo objeto.
+   */
+  TipoPrimitiva
+  Objeto::tipo_primitiva() const{
+    return tipo;
+  }
+
   //Esfera
   /**
-   * \fn void Objeto::atualizar_esfera(Vetor* pos_esfera, double _raio, double _kd, double _ks, Vetor* cor);
+   * \fn void Objeto::atualizar_esfera(const Vetor& pos_esfera, double _raio, double _kd, double _ks, Textura& cor,
+   * double _brilho);
    *
    * \brief Atualiza os valores da esfera
    *
@@ -41,106 +66,113 @@ namespace rayTracing{
    * \param _raio - raio da esfera
    * \param _kd - constante difusa
    * \param _ks - constante especular
-   * \param cor - Vetor com contribuicao r, g e b da cor.
+   * \param cor - Textura que fornece a contribuicao r, g e b da cor.
+   * \param _brilho - espalhamento da luz (expoente de phong)
    */
   void
-  Objeto::atualizar_esfera(Vetor* pos_esfera, double _raio, double _kd, double _ks, Textura* cor){
+  Objeto::atualizar_esfera(const Vetor& pos_esfera, double _raio, double _kd, double _ks, Textura& cor, double _brilho){
+    tipo = PRIMITIVA_ESFERA;
     //Posicao da esfera
-    esfera.pos_x = pos_esfera->vx();
-    esfera.pos_y = pos_esfera->vy();
-    esfera.pos_z = pos_esfera->vz();
+    esfera.pos_x = pos_esfera.vx();
+    esfera.pos_y = pos_esfera.vy();
+    esfera.pos_z = pos_esfera.vz();
 
     //Raio da esfera
     esfera.raio = _raio;
 		
     //Material da esfera
-    esfera.kd = _kd;
-    esfera.ks = _ks;
+    kd = _kd;
+    ks = _ks;
+    brilho = _brilho;
 		
-    Vetor* contribuicoes_rgb = new Vetor();
-    contribuicoes_rgb = cor->map_textura_solida();
+    Vetor contribuicoes_rgb = cor.map_textura_solida();
 		
     //Cor da esfera
-    esfera.cor_r = contribuicoes_rgb->vx();
-    esfera.cor_g = contribuicoes_rgb->vy();
-    esfera.cor_b = contribuicoes_rgb->vz();
+    cor_r = contribuicoes_rgb.vx();
+    cor_g = contribuicoes_rgb.vy();
+    cor_b = contribuicoes_rgb.vz();
   }
 	
   /**
-   * \fn void	Objeto::modificar_cor_pixel(Textura* cor);
+   * \fn void	Objeto::modificar_cor_pixel(Textura& cor);
    *
    * \brief Pinta pixels de cores definida pelo range da textura
    *
-   * \param cor - Vetor com contribuicao r, g e b da cor.
+   * \param cor - Textura que fornece a contribuicao r, g e b da cor.
    */
   void
-  Objeto::modificar_cor_pixel(Textura* cor){
-    Vetor* contribuicoes_rgb = new Vetor();
-    contribuicoes_rgb = cor->map_textura_solida();
+  Objeto::modificar_cor_pixel(Textura& cor){
+    Vetor contribuicoes_rgb = cor.map_textura_solida();
 		
     //Cor da esfera
-    esfera.cor_r = contribuicoes_rgb->vx();
-    esfera.cor_g = contribuicoes_rgb->vy();
-    esfera.cor_b = contribuicoes_rgb->vz();
+    cor_r = contribuicoes_rgb.vx();
+    cor_g = contribuicoes_rgb.vy();
+    cor_b = contribuicoes_rgb.vz();
   }
 	
   /**
-   * \fn Vetor* Objeto::posicao_esfera();
+   * \fn Vetor Objeto::posicao_esfera() const;
    *
    * \brief Retorna a posicao central da esfera.
    */
-  Vetor* 
-  Objeto::posicao_esfera(){
-    Vetor* aux = new Vetor();
-    aux->valores_vetor(esfera.pos_x, esfera.pos_y, esfera.pos_z);
-    return aux;
+  Vetor 
+  Objeto::posicao_esfera() const{
+    return Vetor(esfera.pos_x, esfera.pos_y, esfera.pos_z);
   }
 	
   /**
-   * \fn double Objeto::raio();
+   * \fn double Objeto::raio() const;
    *
    * \brief Retorna o raio.
    */
   double
-  Objeto::raio(){
+  Objeto::raio() const{
     return esfera.raio;
   }
 	
   /**
-   * \fn double Objeto::kd_esfera();
+   * \fn double Objeto::kd_esfera() const;
    *
    * \brief Retorna a constante difusa do material
    */
   double 
-  Objeto::kd_esfera(){
-    return esfera.kd;
+  Objeto::kd_esfera() const{
+    return kd;
   }
 	
   /**
-   * \fn double Objeto::posicao_esfera();
+   * \fn double Objeto::ks_esfera() const;
    *
    * \brief Retorna a constante especular do material
    */
   double 
-  Objeto::ks_esfera(){
-    return esfera.ks;
+  Objeto::ks_esfera() const{
+    return ks;
   }
 	
   /**
-   * \fn Vetor* Objeto::cor_esfera();
+   * \fn double Objeto::brilho_esfera() const;
+   *
+   * \brief Retorna o espalhamento da luz (expoente de phong) do material
+   */
+  double 
+  Objeto::brilho_esfera() const{
+    return brilho;
+  }
+	
+  /**
+   * \fn Vetor Objeto::cor_esfera() const;
    *
    * \brief Retorna a cor da esfera.
    */
-  Vetor* 
-  Objeto::cor_esfera(){
-    Vetor* aux = new Vetor();
-    aux->valores_vetor(esfera.cor_r, esfera.cor_g, esfera.cor_b);
-    return aux;
+  Vetor 
+  Objeto::cor_esfera() const{
+    return Vetor(cor_r, cor_g, cor_b);
   }	
 
   //Plano
   /**
-   * \fn void Objeto::atualizar_plano(Vetor* pos_plano, double _kd, double _ks, Vetor* cor);
+   * \fn void Objeto::atualizar_plano(const Vetor& pos_plano, double _kd, double _ks, const Vetor& cor, const Vetor& _normal);
    *
    * \brief Atualiza os valores do plano
    *
@@ -148,66 +180,90 @@ namespace rayTracing{
    * \param _kd - constante difusa
    * \param _ks - constante especular
    * \param cor - Vetor com contribuicao r, g e b da cor.
+   * \param _normal - normal do plano
    */
   void 
-  Objeto::atualizar_plano(Vetor* pos_plano, double _kd, double _ks, Vetor* cor){
+  Objeto::atualizar_plano(const Vetor& pos_plano, double _kd, double _ks, const Vetor& cor, const Vetor& _normal){
+    tipo = PRIMITIVA_PLANO;
+
     //Posicao do plano
-    plano.pos_x = pos_plano->vx();
-    plano.pos_y = pos_plano->vy();
-    plano.pos_z = pos_plano->vz();
+    plano.pos_x = pos_plano.vx();
+    plano.pos_y = pos_plano.vy();
+    plano.pos_z = pos_plano.vz();
+
+    //Normal do plano
+    plano.normal_x = _normal.vx();
+    plano.normal_y = _normal.vy();
+    plano.normal_z = _normal.vz();
 		
     //Material da plano
-    plano.kd = _kd;
-    plano.ks = _ks;
+    kd = _kd;
+    ks = _ks;
 		
     //Cor do plano
-    plano.cor_r = cor->vx();
-    plano.cor_g = cor->vy();
-    plano.cor_b = cor->vz();
+    cor_r = cor.vx();
+    cor_g = cor.vy();
+    cor_b = cor.vz();
   }
 	
   /**
-   * \fn Vetor* Objeto::posicao_plano();
+   * \fn Vetor Objeto::posicao_plano() const;
    *
    * \brief Retorna a posicao central do plano.
    */
-  Vetor* 
-  Objeto::posicao_plano(){
-    Vetor* aux = new Vetor();
-    aux->valores_vetor(plano.pos_x, plano.pos_y, plano.pos_z);
-    return aux;
+  Vetor 
+  Objeto::posicao_plano() const{
+    return Vetor(plano.pos_x, plano.pos_y, plano.pos_z);
+  }
+
+  /**
+   * \fn Vetor Objeto::normal_plano() const;
+   *
+   * \brief Retorna a normal do plano.
+   */
+  Vetor
+  Objeto::normal_plano() const{
+    return Vetor(plano.normal_x, plano.normal_y, plano.normal_z);
   }
 	
   /**
-   * \fn double Objeto::kd_plano();
+   * \fn double Objeto::kd_plano() const;
    *
    * \brief Retorna a constante difusa do material
    */
   double 
-  Objeto::kd_plano(){
-    return plano.kd;
+  Objeto::kd_plano() const{
+    return kd;
   }
 	
   /**
-   * \fn double Objeto::posicao_plano();
+   * \fn double Objeto::ks_plano() const;
    *
    * \brief Retorna a constante especular do material
    */
   double 
-  Objeto::ks_plano(){
-    return plano.ks;
+  Objeto::ks_plano() const{
+    return ks;
+  }
+	
+  /**
+   * \fn double Objeto::brilho_plano() const;
+   *
+   * \brief Retorna o espalhamento da luz (expoente de phong) do material
+   */
+  double 
+  Objeto::brilho_plano() const{
+    return brilho;
   }
 	
   /**
-   * \fn Vetor* Objeto::cor_plano();
+   * \fn Vetor Objeto::cor_plano() const;
    *
    * \brief Retorna a cor do plano.
    */
-  Vetor* 
-  Objeto::cor_plano(){
-    Vetor* aux = new Vetor();
-    aux->valores_vetor(plano.cor_r, plano.cor_g, plano.cor_b);
-    return aux;
+  Vetor 
+  Objeto::cor_plano() const{
+    return Vetor(cor_r, cor_g, cor_b);
   }
 
 } //Fim do namespace rayTracing
@@ -21,6 +21,8 @@
 
 #include "vetor.hpp"	//rayTracing::Vetor
 #include "textura.hpp"	//rayTracing::Textura  
+#include "material.hpp"	//rayTracing::BRILHO_PADRAO
+#include "primitivas.hpp"	//rayTracing::TipoPrimitiva
 
 /** 
  * \defgroup RayTracingNameSpace Namespace rayTracing.
@@ -36,7 +38,9 @@ namespace rayTracing{
   /**
    * \class Objeto
    * 
-   * \brief Define as caracteristicas dos objetos.
+   * \brief Define as caracteristicas dos objetos. Um objeto descreve uma unica primitiva: a etiqueta indica qual das geometrias da
+   * uniao e valida, e o material e comum a todos os tipos. O objeto serve apenas para montar a cena; Cena::incluir_objetos_pilha copia
+   * os seus dados para o armazem compacto de primitivas.
    */
   class Objeto{
     //------------------------------
@@ -52,16 +56,7 @@ namespace rayTracing{
 
       //raio da esfera
       double raio;	///< raio
-				
-      //Material da esfera
-      double kd;		///< constante difusa
-      double ks;		///< constante especular
-
-				//cor da esfera
-      double cor_r;	///< contribuicao red da cor
-      double cor_g;	///< contribuicao green da cor
-      double cor_b;	///< contribuicao blue da cor
-    }esfera;
+    };
 			
     //Criando uma estrutura Plano
     struct Plano{
@@ -69,25 +64,52 @@ namespace rayTracing{
       double pos_x;	///< coordenada x
       double pos_y;	///< coordenada y
       double pos_z;	///< coordenada z
-				
-      //Constantes
-      double kd;		///< constante difusa
-      double ks;		///< constante especular
 
-				//cor do plano
-      double cor_r;	///< contribuicao red da cor
-      double cor_g;	///< contribuicao green da cor
-      double cor_b;	///< contribuicao blue da cor
-    }plano;
+      //normal do plano
+      double normal_x;	///< componente x
+      double normal_y;	///< componente y
+      double normal_z;	///< componente z
+    };
+
+    TipoPrimitiva tipo;	///< Etiqueta da geometria valida
+    union{
+      Esfera esfera;	///< Geometria da esfera
+      Plano plano;	///< Geometria do plano
+    };
+
+    //Material do objeto
+    double kd;		///< constante difusa
+    double ks;		///< constante especular
+    double brilho;	///< espalhamento da luz
+
+    //cor do objeto
+    double cor_r;	///< contribuicao red da cor
+    double cor_g;	///< contribuicao green da cor
+    double cor_b;	///< contribuicao blue da cor
 			
     ///Estruturas a adicionar: Cubo, Cilindro e Toroide alem da Textura dos objetos
     //------------------------------
     //	Metodos publicos
     //------------------------------
   public:
+    /**
+     * \fn Objeto();
+     *
+     * \brief Construtor da classe. O objeto inicial e uma esfera de raio zero.
+     */
+    Objeto();
+
+    /**
+     * \fn TipoPrimitiva tipo_primitiva() const;
+     *
+     * \brief Retorna o tipo da primitiva descrita pelo objeto.
+     */
+    TipoPrimitiva tipo_primitiva() const;
+
     //Esfera
     /**
-     * \fn void atualizar_esfera(Vetor* pos_esfera, double _raio, double _kd, double _ks, Vetor* cor);
+     * \fn void atualizar_esfera(const Vetor& pos_esfera, double _raio, double _kd, double _ks, Textura& cor,
+     * double _brilho = BRILHO_PADRAO);
      *
      * \brief Atualiza os valores da esfera
      *
@@ -95,57 +117,66 @@ namespace rayTracing{
      * \param _raio - raio da esfera
      * \param _kd - constante difusa
      * \param _ks - constante especular
-     * \param cor - Vetor com contribuicao r, g e b da cor.
+     * \param cor - Textura que fornece a contribuicao r, g e b da cor.
+     * \param _brilho - espalhamento da luz (expoente de phong)
      */
-    void atualizar_esfera(Vetor* pos_esfera, double _raio, double _kd, double _ks, Textura* cor);
+    void atualizar_esfera(const Vetor& pos_esfera, double _raio, double _kd, double _ks, Textura& cor,
+			  double _brilho = BRILHO_PADRAO);
 		
     /**
-     * \fn void	Objeto::modificar_cor_pixel(Textura* cor);
+     * \fn void modificar_cor_pixel(Textura& cor);
      *
      * \brief Pinta pixels de cores definida pelo range da textura
      *
-     * \param cor - Vetor com contribuicao r, g e b da cor.
+     * \param cor - Textura que fornece a contribuicao r, g e b da cor.
      */
-    void modificar_cor_pixel(Textura* cor);
+    void modificar_cor_pixel(Textura& cor);
 		
     /**
-     * \fn Vetor* posicao_esfera();
+     * \fn Vetor posicao_esfera() const;
      *
      * \brief Retorna a posicao central da esfera.
      */
-    Vetor* posicao_esfera();
+    Vetor posicao_esfera() const;
 		
     /**
-     * \fn double raio();
+     * \fn double raio() const;
      *
      * \brief Retorna o raio.
      */
-    double raio();
+    double raio() const;
 		
     /**
-     * \fn double kd_esfera();
+     * \fn double kd_esfera() const;
      *
      * \brief Retorna a constante difusa do material
      */
-    double kd_esfera();
+    double kd_esfera() const;
 		
     /**
-     * \fn double posicao_esfera();
+     * \fn double ks_esfera() const;
      *
      * \brief Retorna a constante especular do material
      */
-    double ks_esfera();
+    double ks_esfera() const;
+    /**
+     * \fn double brilho_esfera() const;
+     *
+     * \brief Retorna o espalhamento da luz (expoente de phong) do material
+     */
+    double brilho_esfera() const;
 		
     /**
-     * \fn Vetor* cor_esfera();
+     * \fn Vetor cor_esfera() const;
      *
      * \brief Retorna a cor da esfera.
      */
-    Vetor* cor_esfera();
+    Vetor cor_esfera() const;
 		
     //Plano
     /**
-     * \fn void atualizar_plano(Vetor* pos_plano, double _kd, double _ks, Vetor* cor);
+     * \fn void atualizar_plano(const Vetor& pos_plano, double _kd, double _ks, const Vetor& cor,
+     * const Vetor& _normal = Vetor(0.0, 1.0, 0.0));
      *
      * \brief Atualiza os valores do plano
      *
@@ -153,36 +184,52 @@ namespace rayTracing{
      * \param _kd - constante difusa
      * \param _ks - constante especular
      * \param cor - Vetor com contribuicao r, g e b da cor.
+     * \param _normal - normal do plano
      */
-    void atualizar_plano(Vetor* pos_plano, double _kd, double _ks, Vetor* cor);
+    void atualizar_plano(const Vetor& pos_plano, double _kd, double _ks, const Vetor& cor,
+			 const Vetor& _normal = Vetor(0.0, 1.0, 0.0));
 		
     /**
-     * \fn Vetor* posicao_plano();
+     * \fn Vetor posicao_plano() const;
      *
      * \brief Retorna a posicao central do plano.
      */
-    Vetor* posicao_plano();
+    Vetor posicao_plano() const;
+
+    /**
+     * \fn Vetor normal_plano() const;
+     *
+     * \brief Retorna a normal do plano.
+     */
+    Vetor normal_plano() const;
 		
     /**
-     * \fn double kd_plano();
+     * \fn double kd_plano() const;
      *
      * \brief Retorna a constante difusa do material
      */
-    double kd_plano();
+    double kd_plano() const;
 		
     /**
-     * \fn double posicao_plano();
+     * \fn double ks_plano() const;
      *
      * \brief Retorna a constante especular do material
      */
-    double ks_plano();
+    double ks_plano() const;
+		
+    /**
+     * \fn double brilho_plano() const;
+     *
+     * \brief Retorna o espalhamento da luz (expoente de phong) do material
+     */
+    double brilho_plano() const;
 		
     /**
-     * \fn Vetor* cor_plano();
+     * \fn Vetor cor_plano() const;
      *
      * \brief Retorna a cor do plano.
      */
-    Vetor* cor_plano();
+    Vetor cor_plano() const;
   };
 
 } ////Fim do namespace rayTracing
@@ -0,0 +1,173 @@
+/**
+ * \file pacote.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo pacote.cpp, sendo este
+ * responsavel pelos pacotes de raios. Um pacote guarda LARGURA_PACOTE raios coerentes com origem comum (os raios primarios de pixels
+ * vizinhos) em forma de estrutura de vetores (SoA), de modo que o teste de um pacote contra uma esfera ou uma caixa seja feito com
+ * instrucoes vetoriais em vez de um raio por vez. Os testes sao encaminhados a variante dos nucleos escolhida para o processador.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _PACOTE_HPP
+#define _PACOTE_HPP
+
+#include "nucleos.hpp"	//rayTracing::nucleos_ativos
+
+//Largura dos pacotes, definida pelo Makefile (PACOTE)
+#ifndef LARGURA_PACOTE_RAIOS
+#define LARGURA_PACOTE_RAIOS 8
+#endif
+#if LARGURA_PACOTE_RAIOS != 4 && LARGURA_PACOTE_RAIOS != 8 && LARGURA_PACOTE_RAIOS != 16
+#error "LARGURA_PACOTE_RAIOS deve ser 4, 8 ou 16"
+#endif
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \brief Numero de raios de um pacote, escolhido na compilacao (make PACOTE=4, 8 ou 16). O padrao, 8, e a largura de um
+   * registrador AVX-512 em doubles; os nucleos percorrem o pacote de registrador em registrador.
+   */
+  const int LARGURA_PACOTE = LARGURA_PACOTE_RAIOS;
+
+  /**
+   * \struct PacoteRaios
+   *
+   * \brief Pacote de raios com origem comum. Cada raio k tem direcao normalizada (dx[k], dy[k], dz[k]), a menor interseccao t[k]
+   * encontrada ate o momento e o indice[k] da primitiva correspondente (-1 se ainda nao houve interseccao). Raios inativos (pacotes
+   * incompletos no fim de uma linha) tem t[k] = -1, e por isso nunca sao atualizados.
+   */
+  struct PacoteRaios{
+    double origem[3];			///< Origem comum dos raios
+    double dx[LARGURA_PACOTE];		///< Componente x das direcoes
+    double dy[LARGURA_PACOTE];		///< Componente y das direcoes
+    double dz[LARGURA_PACOTE];		///< Componente z das direcoes
+    double inv_dx[LARGURA_PACOTE];	///< Inverso de dx (teste das caixas)
+    double inv_dy[LARGURA_PACOTE];	///< Inverso de dy
+    double inv_dz[LARGURA_PACOTE];	///< Inverso de dz
+    double t[LARGURA_PACOTE];		///< Menor interseccao encontrada (ou t maximo)
+    int indice[LARGURA_PACOTE];		///< Primitiva da menor interseccao
+  };
+
+  /**
+   * \struct AcertosPacote
+   *
+   * \brief Interseccoes dos raios de um pacote prontas para o sombreamento, em forma de estrutura de vetores: o ponto, a normal
+   * unitaria voltada para o observador, as constantes do material e o albedo de cada raio. Apenas os raios com o bit k de ativos
+   * sao sombreados; as posicoes dos demais devem guardar valores finitos (por exemplo, os de um pacote anterior), que sao calculados
+   * e descartados.
+   */
+  struct AcertosPacote{
+    double px[LARGURA_PACOTE];		///< Coordenada x do ponto de interseccao
+    double py[LARGURA_PACOTE];		///< Coordenada y do ponto de interseccao
+    double pz[LARGURA_PACOTE];		///< Coordenada z do ponto de interseccao
+    double nx[LARGURA_PACOTE];		///< Componente x da normal
+    double ny[LARGURA_PACOTE];		///< Componente y da normal
+    double nz[LARGURA_PACOTE];		///< Componente z da normal
+    double kd[LARGURA_PACOTE];		///< Constante difusa do material
+    double ks[LARGURA_PACOTE];		///< Constante especular do material
+    double brilho[LARGURA_PACOTE];	///< Espalhamento especular do material
+    double albedo_r[LARGURA_PACOTE];	///< Componente vermelha normalizada da cor do material
+    double albedo_g[LARGURA_PACOTE];	///< Componente verde normalizada da cor do material
+    double albedo_b[LARGURA_PACOTE];	///< Componente azul normalizada da cor do material
+    double r[LARGURA_PACOTE];		///< Cor vermelha calculada
+    double g[LARGURA_PACOTE];		///< Cor verde calculada
+    double b[LARGURA_PACOTE];		///< Cor azul calculada
+    int ativos;				///< Bit k ligado se o raio k deve ser sombreado
+  };
+
+  /**
+   * \fn void intercepta_esfera_pacote(PacoteRaios& p, const double oc[3], double c, int k);
+   *
+   * \brief Versao em pacote de intercepta_esfera: testa todos os raios do pacote contra a esfera k e atualiza t e indice dos raios
+   * para os quais ela e a interseccao mais proxima ate agora. Como a origem e comum, OC e c sao os mesmos para todo o pacote e
+   * apenas \f$ b = OC \cdot D \f$ muda entre os raios.
+   *
+   * \param p - pacote de raios
+   * \param oc - origem do pacote menos o centro da esfera
+   * \param c - \f$ |OC|^2 - r^2 \f$
+   * \param k - indice da esfera
+   */
+  void intercepta_esfera_pacote(PacoteRaios& p, const double oc[3], double c, int k);
+
+  /**
+   * \fn bool intercepta_caixa_pacote(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada);
+   *
+   * \brief Teste das placas (slabs) de todos os raios do pacote contra uma caixa, cada raio no intervalo [0, t[k]].
+   *
+   * \param t_entrada - menor t de entrada entre os raios que atingem a caixa
+   *
+   * \return true se algum raio do pacote atinge a caixa.
+   */
+  bool intercepta_caixa_pacote(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada);
+
+  /**
+   * \fn void intercepta_triangulo_pacote(PacoteRaios& p, const TriangulosSoA& tri, int k);
+   *
+   * \brief Versao em pacote de intercepta_triangulos: testa todos os raios do pacote contra o triangulo k e atualiza t e indice dos
+   * raios para os quais ele e a interseccao mais proxima ate agora. Como a origem e comum, \f$ T = O - v_0 \f$, \f$ Q = T \times e_1 \f$
+   * e \f$ e_2 \cdot Q \f$ sao calculados uma unica vez para o pacote.
+   *
+   * \param p - pacote de raios
+   * \param tri - triangulos da cena
+   * \param k - indice do triangulo
+   */
+  void intercepta_triangulo_pacote(PacoteRaios& p, const TriangulosSoA& tri, int k);
+
+  /**
+   * \fn void sombrear_pacote(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz);
+   *
+   * \brief Versao em pacote de Luz::calcula_luz: calcula a cor (r, g, b) de cada raio ativo como a intensidade de phong vezes o
+   * albedo, com as mesmas operacoes e na mesma ordem, de modo que a imagem seja a mesma do calculo raio a raio. Os vetores da luz,
+   * do observador e de reflexao sao normalizados com instrucoes vetoriais; a potencia especular e calculada raio a raio.
+   *
+   * \param a - interseccoes do pacote
+   * \param observador - origem comum dos raios
+   * \param luz - constantes da luz
+   */
+  void sombrear_pacote(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz);
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline void
+  intercepta_esfera_pacote(PacoteRaios& p, const double oc[3], double c, int k){
+    nucleos_ativos->intercepta_esfera_pacote(p, oc, c, k);
+  }
+
+  inline bool
+  intercepta_caixa_pacote(const PacoteRaios& p, const double min[3], const double max[3], double* t_entrada){
+    return nucleos_ativos->intercepta_caixa_pacote(p, min, max, t_entrada);
+  }
+
+  inline void
+  intercepta_triangulo_pacote(PacoteRaios& p, const TriangulosSoA& tri, int k){
+    nucleos_ativos->intercepta_triangulo_pacote(p, tri, k);
+  }
+
+  inline void
+  sombrear_pacote(AcertosPacote& a, const double observador[3], const ParametrosPhong& luz){
+    nucleos_ativos->sombrear_pacote(a, observador, luz);
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
@@ -0,0 +1,546 @@
+/**
+ * \file particulas.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo particulas.hpp, sendo este responsavel pelas nuvens de
+ * particulas.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "particulas.hpp"	//rayTracing::NuvemParticulas
+#include "memoria.hpp"		//rayTracing::aloca_alinhado
+#include <stdio.h>		//fopen, fread
+#include <stdlib.h>		//strtod
+#include <string.h>		//strlen, strcmp, memmove, memcpy
+#include <math.h>		//fabs, floor
+#include <float.h>		//FLT_MAX
+#include <fcntl.h>		//open
+#include <unistd.h>		//close
+#include <sys/mman.h>		//mmap, munmap, madvise
+#include <sys/stat.h>		//fstat
+#include <algorithm>		//std::min, std::max
+#include <sstream>		//ostringstream
+#include <vector>		//vector
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //Tamanho do bloco lido do arquivo CSV a cada fread
+  static const size_t TAMANHO_BLOCO_CSV = 1 << 20;
+  //Maior valor de uma coordenada quantizada
+  static const double MAXIMO_QUANTIZADO = 65535.0;
+  //Numero de particulas que ainda cabem no identificador de primitiva
+  static const int MAXIMO_PARTICULAS = (int) (PRIMITIVA_NENHUMA >> BITS_TIPO_PRIMITIVA);
+
+  /**
+   * \fn static bool maquina_little_endian();
+   *
+   * \brief Indica se a maquina guarda os inteiros com o byte menos significativo primeiro, como os arquivos binarios.
+   */
+  static bool
+  maquina_little_endian(){
+    uint32_t marca = 1;
+    return *((const unsigned char*) &marca) == 1;
+  }
+
+  /**
+   * \fn static const char* registro_invalido(const float* r, int campos);
+   *
+   * \brief Valida um registro: coordenadas finitas, raio positivo e cores de 0 a 255.
+   *
+   * \return A descricao do problema, ou NULL se o registro e valido.
+   */
+  static const char*
+  registro_invalido(const float* r, int campos){
+    for (int e = 0; e < 3; e++){
+      if (!(fabs(r[e]) <= FLT_MAX)){
+	return "coordenada invalida";
+      }
+    }
+    if (!(r[3] > 0.0f && r[3] <= FLT_MAX)){
+      return "raio deve ser positivo";
+    }
+    for (int e = 4; e < campos; e++){
+      if (!(r[e] >= 0.0f && r[e] <= 255.0f)){
+	return "cor fora do intervalo 0 a 255";
+      }
+    }
+    return NULL;
+  }
+
+  /**
+   * \fn static uint16_t quantiza(double valor, double minimo, double passo);
+   *
+   * \brief Arredonda (valor - minimo) / passo para o inteiro de 16 bits mais proximo.
+   */
+  static uint16_t
+  quantiza(double valor, double minimo, double passo){
+    if (passo <= 0.0){
+      return 0;
+    }
+    double q = floor((valor - minimo) / passo + 0.5);
+    if (q < 0.0) q = 0.0;
+    if (q > MAXIMO_QUANTIZADO) q = MAXIMO_QUANTIZADO;
+    return (uint16_t) q;
+  }
+
+  //------------------------------
+  //	Metodos privados
+  //------------------------------
+  /**
+   * \fn bool NuvemParticulas::erro(int posicao, const std::string& descricao);
+   *
+   * \brief Guarda a posicao e a mensagem do erro, libera a nuvem e retorna false.
+   */
+  bool
+  NuvemParticulas::erro(int posicao, const std::string& descricao){
+    limpar();
+    linha = posicao;
+    mensagem = descricao;
+    return false;
+  }
+
+  /**
+   * \fn bool NuvemParticulas::carregar_binario(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar,
+   * bool com_cor, const OpcoesBVH& opcoes);
+   *
+   * \brief Mapeia um arquivo binario de registros float e monta a nuvem diretamente do mapeamento: o arquivo nunca e copiado para
+   * um vetor intermediario, e as paginas ja lidas podem ser devolvidas pelo sistema enquanto a nuvem e montada.
+   */
+  bool
+  NuvemParticulas::carregar_binario(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar, bool com_cor,
+				    const OpcoesBVH& opcoes){
+    if (!maquina_little_endian()){
+      return erro(0, "arquivos binarios de particulas sao little-endian");
+    }
+    int campos = com_cor ? 7 : 4;
+    size_t tamanho_registro = campos * sizeof(float);
+    int descritor = open(nome_arquivo, O_RDONLY);
+    if (descritor < 0){
+      return erro(0, "nao foi possivel abrir o arquivo");
+    }
+    struct stat estado;
+    if (fstat(descritor, &estado) != 0){
+      close(descritor);
+      return erro(0, "nao foi possivel ler o tamanho do arquivo");
+    }
+    size_t tamanho = (size_t) estado.st_size;
+    if (tamanho % tamanho_registro != 0){
+      close(descritor);
+      std::ostringstream descricao;
+      descricao << "tamanho do arquivo nao e multiplo do registro de " << tamanho_registro << " bytes";
+      return erro(0, descricao.str());
+    }
+    if (tamanho == 0){
+      close(descritor);
+      return erro(0, "nenhuma particula no arquivo");
+    }
+    if (tamanho / tamanho_registro > (size_t) MAXIMO_PARTICULAS){
+      close(descritor);
+      return erro(0, "particulas demais para o identificador de primitiva");
+    }
+    void* mapa = mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor);
+    if (mapa == MAP_FAILED){
+      return erro(0, "nao foi possivel mapear o arquivo");
+    }
+    madvise(mapa, tamanho, MADV_WILLNEED);
+    bool montada = montar((const float*) mapa, (int) (tamanho / tamanho_registro), campos, armazem, material, quantizar, opcoes);
+    munmap(mapa, tamanho);
+    return montada;
+  }
+
+  /**
+   * \fn bool NuvemParticulas::carregar_csv(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar,
+   * const OpcoesBVH& opcoes);
+   *
+   * \brief Le um arquivo CSV em blocos de TAMANHO_BLOCO_CSV bytes, como carregar_obj, para um vetor de registros float e monta a
+   * nuvem a partir dele. A primeira linha com dados define se as particulas tem cor.
+   */
+  bool
+  NuvemParticulas::carregar_csv(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar,
+				const OpcoesBVH& opcoes){
+    FILE* arquivo = fopen(nome_arquivo, "rb");
+    if (arquivo == NULL){
+      return erro(0, "nao foi possivel abrir o arquivo");
+    }
+    std::vector<float> lidos;
+    int campos = 0;		//Campos por linha (0 ate a primeira linha com dados)
+    bool primeira_linha = true;	//A primeira linha nao vazia pode ser um titulo
+    const char* problema = NULL;
+
+    size_t capacidade = TAMANHO_BLOCO_CSV;
+    char* bloco = new char[capacidade + 1];
+    size_t usados = 0;
+    int numero_linha = 0;
+    bool fim_arquivo = false;
+    while (!fim_arquivo && problema == NULL){
+      if (usados == capacidade){
+	char* maior = new char[2 * capacidade + 1];
+	memcpy(maior, bloco, usados);
+	delete[] bloco;
+	bloco = maior;
+	capacidade *= 2;
+      }
+      size_t n_lidos = fread(bloco + usados, 1, capacidade - usados, arquivo);
+      fim_arquivo = (n_lidos < capacidade - usados);
+      size_t total = usados + n_lidos;
+      bloco[total] = '\0';
+
+      size_t inicio = 0;
+      for (size_t k = 0; k <= total && problema == NULL; k++){
+	if (k == total && !(fim_arquivo && inicio < total)){
+	  break;
+	}
+	if (k < total && bloco[k] != '\n'){
+	  continue;
+	}
+	bloco[k] = '\0';
+	numero_linha++;
+	char* c = bloco + inicio;
+	inicio = k + 1;
+	char* comentario = strchr(c, '#');
+	if (comentario != NULL){
+	  *comentario = '\0';
+	}
+
+	//Lendo os numeros da linha, separados por virgulas e espacos
+	float r[8];
+	int n = 0;
+	while (n < 8){
+	  while (*c == ' ' || *c == '\t' || *c == '\r' || (n > 0 && *c == ',')){
+	    c++;
+	  }
+	  if (*c == '\0'){
+	    break;
+	  }
+	  char* fim;
+	  double valor = strtod(c, &fim);
+	  if (fim == c){
+	    n = -1;
+	    break;
+	  }
+	  r[n++] = (float) valor;
+	  c = fim;
+	}
+	if (n == 0){
+	  continue;
+	}
+	if (n < 0 && primeira_linha){	//Linha de titulo
+	  primeira_linha = false;
+	  continue;
+	}
+	primeira_linha = false;
+	if (n < 0){
+	  problema = "numero invalido";
+	}
+	else if (n != 4 && n != 7){
+	  problema = "esperados x,y,z,raio ou x,y,z,raio,r,g,b";
+	}
+	else if (campos != 0 && n != campos){
+	  problema = (campos == 4) ? "particula com cor em um arquivo sem cores" : "particula sem cor em um arquivo com cores";
+	}
+	else if ((problema = registro_invalido(r, n)) == NULL){
+	  campos = n;
+	  lidos.insert(lidos.end(), r, r + n);
+	  if (lidos.size() / campos > (size_t) MAXIMO_PARTICULAS){
+	    problema = "particulas demais para o identificador de primitiva";
+	  }
+	}
+      }
+      if (inicio > total){
+	inicio = total;
+      }
+      usados = total - inicio;
+      memmove(bloco, bloco + inicio, usados);
+    }
+    delete[] bloco;
+    bool falha_leitura = ferror(arquivo) != 0;
+    fclose(arquivo);
+
+    if (problema != NULL){
+      return erro(numero_linha, problema);
+    }
+    if (falha_leitura){
+      return erro(0, "erro de leitura do arquivo");
+    }
+    if (lidos.empty()){
+      return erro(0, "nenhuma particula no arquivo");
+    }
+    return montar(&lidos[0], (int) (lidos.size() / campos), campos, armazem, material, quantizar, opcoes);
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn NuvemParticulas::NuvemParticulas();
+   *
+   * \brief Construtor da classe. A nuvem inicial e vazia.
+   */
+  NuvemParticulas::NuvemParticulas(){
+    registros = NULL;
+    quantizados = NULL;
+    cores = NULL;
+    paleta = NULL;
+    inicio_grupos = NULL;
+    limpar();
+    linha = 0;
+  }
+
+  /**
+   * \fn NuvemParticulas::~NuvemParticulas();
+   *
+   * \brief Destrutor da classe.
+   */
+  NuvemParticulas::~NuvemParticulas(){
+    limpar();
+  }
+
+  /**
+   * \fn void NuvemParticulas::limpar();
+   *
+   * \brief Libera os vetores e a BVH da nuvem.
+   */
+  void
+  NuvemParticulas::limpar(){
+    libera_alinhado(registros);
+    libera_alinhado(quantizados);
+    libera_alinhado(cores);
+    libera_alinhado(paleta);
+    libera_alinhado(inicio_grupos);
+    registros = NULL;
+    quantizados = NULL;
+    cores = NULL;
+    paleta = NULL;
+    inicio_grupos = NULL;
+    for (int e = 0; e < 3; e++){
+      base[e] = 0.0;
+      passo[e] = 0.0;
+    }
+    passo_raio = 0.0;
+    n_cores = 0;
+    material_unico = 0;
+    n_grupos = 0;
+    n_particulas = 0;
+    hierarquia.construir(NULL, 0);
+  }
+
+  /**
+   * \fn bool NuvemParticulas::carregar(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar,
+   * bool com_cor, const OpcoesBVH& opcoes);
+   *
+   * \brief Le um arquivo de particulas, CSV se o nome terminar em ".csv" e binario cru nos demais casos.
+   */
+  bool
+  NuvemParticulas::carregar(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar, bool com_cor,
+			   const OpcoesBVH& opcoes){
+    size_t tamanho = strlen(nome_arquivo);
+    if (tamanho >= 4 && (strcmp(nome_arquivo + tamanho - 4, ".csv") == 0 || strcmp(nome_arquivo + tamanho - 4, ".CSV") == 0)){
+      return carregar_csv(nome_arquivo, armazem, material, quantizar, opcoes);
+    }
+    return carregar_binario(nome_arquivo, armazem, material, quantizar, com_cor, opcoes);
+  }
+
+  /**
+   * \fn bool NuvemParticulas::montar(const float* registros_fonte, int n, int campos, ArmazemPrimitivas& armazem, int material,
+   * bool quantizar, const OpcoesBVH& opcoes);
+   *
+   * \brief Monta a nuvem sem copiar os registros para um vetor intermediario:
+   *
+   * 1. os registros sao validados e a caixa dos centros e o maior raio sao calculados;
+   * 2. um codigo de Morton de 30 bits do centro de cada particula, junto com o seu indice, e ordenado (8 bytes por particula, liberados
+   * no fim, e mais 8 durante a ordenacao paralela), de modo que grupos de particulas consecutivas sejam compactos no espaco;
+   * 3. a BVH e construida com as opcoes dadas sobre as caixas dos grupos, folgadas pelo erro da quantizacao, de modo que contenham as
+   * esferas decodificadas;
+   * 4. cada particula e codificada uma unica vez, direto na sua posicao final: grupos na ordem da BVH e, dentro do grupo, na ordem de
+   * Morton.
+   *
+   * As cores sao reduzidas a 5, 6 e 5 bits (r, g, b) e cada cor distinta vira um material do armazem, de modo que a paleta nunca
+   * passe de 65536 entradas. Uma cor que se reduz a preta, e nao pode ser normalizada, usa o material dado.
+   */
+  bool
+  NuvemParticulas::montar(const float* registros_fonte, int n, int campos, ArmazemPrimitivas& armazem, int material, bool quantizar,
+			  const OpcoesBVH& opcoes){
+    limpar();
+    if (campos != 4 && campos != 7){
+      return erro(0, "registros devem ter 4 ou 7 campos");
+    }
+    if (n <= 0){
+      return erro(0, "nenhuma particula no arquivo");
+    }
+    if (n > MAXIMO_PARTICULAS){
+      return erro(0, "particulas demais para o identificador de primitiva");
+    }
+
+    //1. Validacao, caixa dos centros e maior raio
+    Caixa caixa;
+    double raio_maximo = 0.0;
+    for (int k = 0; k < n; k++){
+      const float* r = registros_fonte + (size_t) k * campos;
+      const char* problema = registro_invalido(r, campos);
+      if (problema != NULL){
+	return erro(k + 1, problema);
+      }
+      caixa.expandir(Vetor(r[0], r[1], r[2]));
+      if (r[3] > raio_maximo){
+	raio_maximo = r[3];
+      }
+    }
+    double folga_quantizacao[3] = { 0.0, 0.0, 0.0 };
+    if (quantizar){
+      for (int e = 0; e < 3; e++){
+	base[e] = caixa.min[e];
+	passo[e] = (caixa.max[e] - caixa.min[e]) / MAXIMO_QUANTIZADO;
+	folga_quantizacao[e] = passo[e];
+      }
+      passo_raio = raio_maximo / MAXIMO_QUANTIZADO;
+      for (int e = 0; e < 3; e++){
+	folga_quantizacao[e] += passo_raio;
+      }
+    }
+
+    //2. Ordenacao pela curva de Morton
+    uint64_t* chaves = (uint64_t*) aloca_alinhado((size_t) n * sizeof(uint64_t));
+    if (chaves == NULL){
+      return erro(0, "sem memoria para ordenar as particulas");
+    }
+    double escala_morton[3];
+    for (int e = 0; e < 3; e++){
+      double extensao = caixa.max[e] - caixa.min[e];
+      escala_morton[e] = (extensao > 0.0) ? 1023.0 / extensao : 0.0;
+    }
+    for (int k = 0; k < n; k++){
+      const float* r = registros_fonte + (size_t) k * campos;
+      uint32_t q[3];
+      for (int e = 0; e < 3; e++){
+	q[e] = (uint32_t) ((r[e] - caixa.min[e]) * escala_morton[e]);
+      }
+      chaves[k] = ((uint64_t) codigo_morton(q[0], q[1], q[2]) << 32) | (uint32_t) k;
+    }
+    ordenar_chaves(chaves, n, opcoes.escalonador);
+
+    //3. BVH sobre as caixas dos grupos
+    n_grupos = (n + TAMANHO_GRUPO_PARTICULAS - 1) / TAMANHO_GRUPO_PARTICULAS;
+    Caixa* caixas = new Caixa[n_grupos];
+    for (int k = 0; k < n; k++){
+      const float* r = registros_fonte + (size_t) (uint32_t) chaves[k] * campos;
+      Caixa& c = caixas[k / TAMANHO_GRUPO_PARTICULAS];
+      for (int e = 0; e < 3; e++){
+	double folga = r[3] * (1.0 + 1e-6) + folga_quantizacao[e];
+	if (r[e] - folga < c.min[e]) c.min[e] = r[e] - folga;
+	if (r[e] + folga > c.max[e]) c.max[e] = r[e] + folga;
+      }
+    }
+    bool construida = hierarquia.construir(caixas, n_grupos, opcoes);
+    delete[] caixas;
+    if (!construida){
+      libera_alinhado(chaves);
+      return erro(0, "sem memoria para a BVH das particulas");
+    }
+
+    //4. Codificacao na ordem final
+    n_particulas = n;
+    inicio_grupos = (int*) aloca_alinhado((n_grupos + 1) * sizeof(int));
+    if (quantizar){
+      quantizados = (uint16_t*) aloca_alinhado((size_t) n * 4 * sizeof(uint16_t));
+    }
+    else{
+      registros = (float*) aloca_alinhado((size_t) n * 4 * sizeof(float));
+    }
+    std::vector<int> cor_paleta;	//Entrada da paleta de cada cor de 16 bits (-1 se ainda nao usada)
+    std::vector<int> materiais_paleta;
+    Material base_cores = armazem.materiais()[material];
+    material_unico = material;
+    if (campos == 7){
+      cores = (uint16_t*) aloca_alinhado((size_t) n * sizeof(uint16_t));
+      cor_paleta.assign(65536, -1);
+    }
+    if (inicio_grupos == NULL || (registros == NULL && quantizados == NULL) || (campos == 7 && cores == NULL)){
+      libera_alinhado(chaves);
+      return erro(0, "sem memoria para as particulas");
+    }
+    const int* ordem = hierarquia.ordem();
+    int posicao = 0;
+    for (int c = 0; c < n_grupos; c++){
+      inicio_grupos[c] = posicao;
+      int primeira = ordem[c] * TAMANHO_GRUPO_PARTICULAS;
+      int ultima = std::min(primeira + TAMANHO_GRUPO_PARTICULAS, n);
+      for (int j = primeira; j < ultima; j++, posicao++){
+	const float* r = registros_fonte + (size_t) (uint32_t) chaves[j] * campos;
+	if (quantizar){
+	  uint16_t* q = quantizados + 4 * (size_t) posicao;
+	  for (int e = 0; e < 3; e++){
+	    q[e] = quantiza(r[e], base[e], passo[e]);
+	  }
+	  q[3] = std::max(quantiza(r[3], 0.0, passo_raio), (uint16_t) 1);
+	}
+	else{
+	  memcpy(registros + 4 * (size_t) posicao, r, 4 * sizeof(float));
+	}
+	if (campos == 7){
+	  int cor = (((int) r[4] >> 3) << 11) | (((int) r[5] >> 2) << 5) | ((int) r[6] >> 3);
+	  if (cor_paleta[cor] < 0){
+	    int id = material;
+	    if (cor != 0){
+	      Vetor rgb(((cor >> 11) & 31) * 255.0 / 31.0, ((cor >> 5) & 63) * 255.0 / 63.0, (cor & 31) * 255.0 / 31.0);
+	      id = armazem.incluir_material(rgb, base_cores.kd, base_cores.ks, base_cores.brilho);
+	      if (id < 0){
+		libera_alinhado(chaves);
+		return erro(0, "sem memoria para os materiais das particulas");
+	      }
+	    }
+	    cor_paleta[cor] = (int) materiais_paleta.size();
+	    materiais_paleta.push_back(id);
+	  }
+	  cores[posicao] = (uint16_t) cor_paleta[cor];
+	}
+      }
+    }
+    inicio_grupos[n_grupos] = n;
+    libera_alinhado(chaves);
+
+    if (campos == 7){
+      n_cores = (int) materiais_paleta.size();
+      paleta = (int*) aloca_alinhado(n_cores * sizeof(int));
+      for (int k = 0; k < n_cores; k++){
+	paleta[k] = materiais_paleta[k];
+      }
+    }
+    return true;
+  }
+
+  /**
+   * \fn size_t NuvemParticulas::bytes() const;
+   *
+   * \brief Retorna a memoria ocupada pela nuvem: registros, cores, paleta, inicio dos grupos e os nos e a ordem da BVH.
+   */
+  size_t
+  NuvemParticulas::bytes() const{
+    size_t total = (size_t) n_particulas * 4 * ((quantizados != NULL) ? sizeof(uint16_t) : sizeof(float));
+    if (cores != NULL){
+      total += (size_t) n_particulas * sizeof(uint16_t) + n_cores * sizeof(int);
+    }
+    total += (n_grupos + 1) * sizeof(int);
+    total += hierarquia.bytes_nos() + n_grupos * sizeof(int);
+    return total;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
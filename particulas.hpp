@@ -0,0 +1,323 @@
+/**
+ * \file particulas.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo particulas.cpp, sendo
+ * este responsavel pelas nuvens de particulas: conjuntos de milhoes de esferas vindos de simulacoes, lidos em bloco de arquivos
+ * binarios (mapeados em memoria) ou CSV diretamente para vetores compactos, sem um Objeto nem uma entrada no armazem de primitivas
+ * por particula. Cada particula ocupa 16 bytes (x, y, z e raio em float) ou, quantizada, 8 bytes (quatro inteiros de 16 bits
+ * relativos a caixa da nuvem), mais 2 bytes com o indice da sua cor quando o arquivo traz cores. As particulas sao ordenadas pela
+ * curva de Morton e agrupadas de TAMANHO_GRUPO_PARTICULAS em TAMANHO_GRUPO_PARTICULAS; a BVH e construida sobre os grupos, de modo
+ * que os seus nos custem menos de 8 bytes por particula.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _PARTICULAS_HPP
+#define _PARTICULAS_HPP
+
+#include <stddef.h>		//size_t
+#include <stdint.h>		//uint16_t
+#include <string>		//string
+#include "vetor.hpp"		//rayTracing::Vetor
+#include "bvh.hpp"		//rayTracing::BVH
+#include "nucleos.hpp"		//rayTracing::LARGURA_ESFERAS
+#include "primitivas.hpp"	//rayTracing::ArmazemPrimitivas
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \brief Numero de particulas de cada grupo (primitiva da BVH). Apenas o ultimo grupo pode ter menos.
+   */
+  const int TAMANHO_GRUPO_PARTICULAS = 16;
+
+  /**
+   * \brief Tamanho dos vetores usados para decodificar um grupo: o grupo e as LARGURA_ESFERAS - 1 posicoes zeradas que os nucleos
+   * podem ler apos a ultima esfera.
+   */
+  const int TAMANHO_DECODIFICADO = TAMANHO_GRUPO_PARTICULAS + LARGURA_ESFERAS - 1;
+
+  /**
+   * \class NuvemParticulas
+   *
+   * \brief Nuvem de particulas esfericas em vetores compactos, ja na ordem da sua BVH. As consultas decodificam um grupo por vez para
+   * os vetores SoA em double usados pelos nucleos das esferas.
+   */
+  class NuvemParticulas{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    float* registros;			///< x, y, z e raio de cada particula (NULL se quantizada)
+    uint16_t* quantizados;		///< x, y, z e raio de cada particula em 16 bits (NULL se nao quantizada)
+    double base[3];			///< Canto minimo da caixa dos centros (quantizacao)
+    double passo[3];			///< Passo da quantizacao de cada eixo
+    double passo_raio;			///< Passo da quantizacao do raio
+    uint16_t* cores;			///< Indice na paleta da cor de cada particula (NULL se todas usam material_unico)
+    int* paleta;			///< Indice no armazem do material de cada cor
+    int n_cores;			///< Numero de cores da paleta
+    int material_unico;			///< Material das particulas sem cor
+    int* inicio_grupos;			///< Primeira particula de cada grupo, na ordem da BVH, e o total no fim
+    int n_grupos;			///< Numero de grupos
+    int n_particulas;			///< Numero de particulas
+    BVH hierarquia;			///< Hierarquia de volumes envolventes dos grupos
+    int linha;				///< Linha (CSV) ou registro (binario) do ultimo erro
+    std::string mensagem;		///< Descricao do ultimo erro
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    /**
+     * \fn bool erro(int posicao, const std::string& descricao);
+     *
+     * \brief Guarda a posicao e a mensagem do erro, libera a nuvem e retorna false.
+     */
+    bool erro(int posicao, const std::string& descricao);
+
+    /**
+     * \fn bool carregar_binario(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar, bool com_cor,
+     * const OpcoesBVH& opcoes);
+     *
+     * \brief Mapeia um arquivo binario de registros float e monta a nuvem diretamente do mapeamento.
+     */
+    bool carregar_binario(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar, bool com_cor,
+			  const OpcoesBVH& opcoes);
+
+    /**
+     * \fn bool carregar_csv(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar,
+     * const OpcoesBVH& opcoes);
+     *
+     * \brief Le um arquivo CSV para um vetor de registros float e monta a nuvem a partir dele.
+     */
+    bool carregar_csv(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar, const OpcoesBVH& opcoes);
+
+    //Copia nao permitida
+    NuvemParticulas(const NuvemParticulas&);
+    NuvemParticulas& operator=(const NuvemParticulas&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn NuvemParticulas();
+     *
+     * \brief Construtor da classe. A nuvem inicial e vazia.
+     */
+    NuvemParticulas();
+
+    /**
+     * \fn ~NuvemParticulas();
+     *
+     * \brief Destrutor da classe.
+     */
+    ~NuvemParticulas();
+
+    /**
+     * \fn void limpar();
+     *
+     * \brief Libera os vetores e a BVH da nuvem.
+     */
+    void limpar();
+
+    /**
+     * \fn bool carregar(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar = false,
+     * bool com_cor = false, const OpcoesBVH& opcoes = OpcoesBVH());
+     *
+     * \brief Le um arquivo de particulas. Arquivos terminados em ".csv" tem uma particula por linha, "x,y,z,raio" ou
+     * "x,y,z,raio,r,g,b" (virgulas ou espacos; linhas vazias, comentarios '#' e uma linha de titulo sao ignorados). Os demais sao
+     * binarios crus: registros de float32 little-endian x, y, z, raio e, com com_cor, r, g, b. As cores vao de 0 a 255.
+     *
+     * \param armazem - armazem que recebe os materiais das cores (antes de compilar a cena)
+     * \param material - material das particulas sem cor; as cores copiam dele kd, ks e brilho
+     * \param quantizar - guarda as particulas em 16 bits
+     * \param com_cor - registros binarios com cor
+     * \param opcoes - construcao da BVH dos grupos; o escalonador tambem ordena as particulas
+     *
+     * \return false em caso de erro; linha_erro() e mensagem_erro() o descrevem e a nuvem fica vazia.
+     */
+    bool carregar(const char* nome_arquivo, ArmazemPrimitivas& armazem, int material, bool quantizar = false, bool com_cor = false,
+		  const OpcoesBVH& opcoes = OpcoesBVH());
+
+    /**
+     * \fn bool montar(const float* registros_fonte, int n, int campos, ArmazemPrimitivas& armazem, int material, bool quantizar,
+     * const OpcoesBVH& opcoes = OpcoesBVH());
+     *
+     * \brief Monta a nuvem a partir de n registros float de campos (4 ou 7) valores cada, no formato dos arquivos binarios.
+     *
+     * \return false se algum registro for invalido.
+     */
+    bool montar(const float* registros_fonte, int n, int campos, ArmazemPrimitivas& armazem, int material, bool quantizar,
+		const OpcoesBVH& opcoes = OpcoesBVH());
+
+    /**
+     * \fn int linha_erro() const;
+     *
+     * \brief Retorna a linha (CSV) ou o registro (binario) do ultimo erro, ou 0 se o arquivo nao pode ser lido.
+     */
+    int linha_erro() const;
+
+    /**
+     * \fn const char* mensagem_erro() const;
+     *
+     * \brief Retorna a descricao do ultimo erro.
+     */
+    const char* mensagem_erro() const;
+
+    /**
+     * \fn int numero_particulas() const;
+     *
+     * \brief Retorna o numero de particulas.
+     */
+    int numero_particulas() const;
+
+    /**
+     * \fn bool quantizada() const;
+     *
+     * \brief Indica se as particulas estao guardadas em 16 bits.
+     */
+    bool quantizada() const;
+
+    /**
+     * \fn size_t bytes() const;
+     *
+     * \brief Retorna a memoria ocupada pela nuvem, incluindo os nos da BVH.
+     */
+    size_t bytes() const;
+
+    /**
+     * \fn const BVH& bvh() const;
+     *
+     * \brief Retorna a hierarquia dos grupos. As posicoes informadas pelas consultas sao os grupos.
+     */
+    const BVH& bvh() const;
+
+    /**
+     * \fn int decodificar_grupo(int g, double* cx, double* cy, double* cz, double* r2) const;
+     *
+     * \brief Escreve os centros e o quadrado dos raios das particulas do grupo g em vetores de TAMANHO_DECODIFICADO posicoes,
+     * zerando as posicoes apos a ultima particula.
+     *
+     * \return O numero de particulas do grupo; a primeira e primeira_particula(g).
+     */
+    int decodificar_grupo(int g, double* cx, double* cy, double* cz, double* r2) const;
+
+    /**
+     * \fn int primeira_particula(int g) const;
+     *
+     * \brief Retorna a primeira particula do grupo g.
+     */
+    int primeira_particula(int g) const;
+
+    /**
+     * \fn Vetor centro(int k) const;
+     *
+     * \brief Retorna o centro da particula k, decodificado como nas consultas.
+     */
+    Vetor centro(int k) const;
+
+    /**
+     * \fn int id_material(int k) const;
+     *
+     * \brief Retorna o indice no armazem do material da particula k.
+     */
+    int id_material(int k) const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline int
+  NuvemParticulas::linha_erro() const{
+    return linha;
+  }
+
+  inline const char*
+  NuvemParticulas::mensagem_erro() const{
+    return mensagem.c_str();
+  }
+
+  inline int
+  NuvemParticulas::numero_particulas() const{
+    return n_particulas;
+  }
+
+  inline bool
+  NuvemParticulas::quantizada() const{
+    return quantizados != NULL;
+  }
+
+  inline const BVH&
+  NuvemParticulas::bvh() const{
+    return hierarquia;
+  }
+
+  inline int
+  NuvemParticulas::decodificar_grupo(int g, double* cx, double* cy, double* cz, double* r2) const{
+    int inicio = inicio_grupos[g];
+    int n = inicio_grupos[g + 1] - inicio;
+    if (quantizados != NULL){
+      const uint16_t* q = quantizados + 4 * inicio;
+      for (int j = 0; j < n; j++, q += 4){
+	cx[j] = base[0] + q[0] * passo[0];
+	cy[j] = base[1] + q[1] * passo[1];
+	cz[j] = base[2] + q[2] * passo[2];
+	double r = q[3] * passo_raio;
+	r2[j] = r * r;
+      }
+    }
+    else{
+      const float* f = registros + 4 * inicio;
+      for (int j = 0; j < n; j++, f += 4){
+	cx[j] = f[0];
+	cy[j] = f[1];
+	cz[j] = f[2];
+	r2[j] = (double) f[3] * f[3];
+      }
+    }
+    for (int j = n; j < TAMANHO_DECODIFICADO; j++){
+      cx[j] = cy[j] = cz[j] = r2[j] = 0.0;
+    }
+    return n;
+  }
+
+  inline int
+  NuvemParticulas::primeira_particula(int g) const{
+    return inicio_grupos[g];
+  }
+
+  inline Vetor
+  NuvemParticulas::centro(int k) const{
+    if (quantizados != NULL){
+      const uint16_t* q = quantizados + 4 * k;
+      return Vetor(base[0] + q[0] * passo[0], base[1] + q[1] * passo[1], base[2] + q[2] * passo[2]);
+    }
+    const float* f = registros + 4 * k;
+    return Vetor(f[0], f[1], f[2]);
+  }
+
+  inline int
+  NuvemParticulas::id_material(int k) const{
+    return (cores != NULL) ? paleta[cores[k]] : material_unico;
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
@@ -0,0 +1,412 @@
+/**
+ * \file primitivas.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo primitivas.hpp, sendo este responsavel pelo armazem de
+ * primitivas da cena.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "primitivas.hpp"	//rayTracing::ArmazemPrimitivas
+#include "memoria.hpp"		//rayTracing::aloca_alinhado
+#include <string.h>		//memcpy
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //Capacidade inicial de cada vetor do armazem
+  static const int CAPACIDADE_INICIAL = 16;
+
+  /**
+   * \fn static void* crescer(void* bloco, size_t bytes_usados, size_t bytes_novos);
+   *
+   * \brief Troca um bloco alinhado por outro de bytes_novos, copiando os bytes_usados iniciais.
+   *
+   * \return O novo bloco ou NULL se nao houver memoria; nesse caso o bloco antigo nao e liberado.
+   */
+  static void*
+  crescer(void* bloco, size_t bytes_usados, size_t bytes_novos){
+    void* novo = aloca_alinhado(bytes_novos);
+    if (novo == NULL){
+      return NULL;
+    }
+    if (bytes_usados > 0){
+      memcpy(novo, bloco, bytes_usados);
+    }
+    libera_alinhado(bloco);
+    return novo;
+  }
+
+  /**
+   * \fn static int proxima_capacidade(int capacidade, int n);
+   *
+   * \brief Dobra a capacidade ate que caibam n elementos.
+   */
+  static int
+  proxima_capacidade(int capacidade, int n){
+    if (capacidade < CAPACIDADE_INICIAL){
+      capacidade = CAPACIDADE_INICIAL;
+    }
+    while (capacidade < n){
+      capacidade *= 2;
+    }
+    return capacidade;
+  }
+
+  //------------------------------
+  //	Metodos privados
+  //------------------------------
+  /**
+   * \fn bool ArmazemPrimitivas::reservar_tipos(int n);
+   *
+   * \brief Garante espaco para n etiquetas.
+   */
+  bool
+  ArmazemPrimitivas::reservar_tipos(int n){
+    if (n > capacidade_tipos){
+      int capacidade = proxima_capacidade(capacidade_tipos, n);
+      unsigned char* novos = (unsigned char*) crescer(tipos, n_primitivas, capacidade);
+      if (novos == NULL){
+	return false;
+      }
+      tipos = novos;
+      capacidade_tipos = capacidade;
+    }
+    return true;
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn ArmazemPrimitivas::ArmazemPrimitivas();
+   *
+   * \brief Construtor da classe. O armazem inicial e vazio.
+   */
+  ArmazemPrimitivas::ArmazemPrimitivas(){
+    tipos = NULL;
+    vetor_esferas = NULL;
+    material_esferas = NULL;
+    vetor_planos = NULL;
+    material_planos = NULL;
+    vetor_vertices = NULL;
+    vetor_triangulos = NULL;
+    material_triangulos = NULL;
+    vetor_materiais = NULL;
+    n_primitivas = capacidade_tipos = 0;
+    n_esferas = capacidade_esferas = 0;
+    n_planos = capacidade_planos = 0;
+    n_vertices = capacidade_vertices = 0;
+    n_triangulos = capacidade_triangulos = 0;
+    n_materiais = capacidade_materiais = 0;
+  }
+
+  /**
+   * \fn ArmazemPrimitivas::~ArmazemPrimitivas();
+   *
+   * \brief Destrutor da classe.
+   */
+  ArmazemPrimitivas::~ArmazemPrimitivas(){
+    limpar();
+  }
+
+  /**
+   * \fn void ArmazemPrimitivas::limpar();
+   *
+   * \brief Remove todas as primitivas e materiais e libera os vetores.
+   */
+  void
+  ArmazemPrimitivas::limpar(){
+    libera_alinhado(tipos);
+    libera_alinhado(vetor_esferas);
+    libera_alinhado(material_esferas);
+    libera_alinhado(vetor_planos);
+    libera_alinhado(material_planos);
+    libera_alinhado(vetor_vertices);
+    libera_alinhado(vetor_triangulos);
+    libera_alinhado(material_triangulos);
+    libera_alinhado(vetor_materiais);
+    tipos = NULL;
+    vetor_esferas = NULL;
+    material_esferas = NULL;
+    vetor_planos = NULL;
+    material_planos = NULL;
+    vetor_vertices = NULL;
+    vetor_triangulos = NULL;
+    material_triangulos = NULL;
+    vetor_materiais = NULL;
+    n_primitivas = capacidade_tipos = 0;
+    n_esferas = capacidade_esferas = 0;
+    n_planos = capacidade_planos = 0;
+    n_vertices = capacidade_vertices = 0;
+    n_triangulos = capacidade_triangulos = 0;
+    n_materiais = capacidade_materiais = 0;
+    ids_materiais.clear();
+  }
+
+  /**
+   * \fn bool ArmazemPrimitivas::reservar_esferas(int n);
+   *
+   * \brief Garante espaco para n esferas, evitando realocacoes quando o numero de esferas e conhecido de antemao. Se apenas um dos
+   * vetores crescer, a capacidade continua a antiga e o crescimento e refeito na proxima reserva.
+   */
+  bool
+  ArmazemPrimitivas::reservar_esferas(int n){
+    if (n > capacidade_esferas){
+      int capacidade = proxima_capacidade(capacidade_esferas, n);
+      EsferaCompacta* esferas = (EsferaCompacta*) crescer(vetor_esferas, n_esferas * sizeof(EsferaCompacta),
+							   capacidade * sizeof(EsferaCompacta));
+      if (esferas == NULL){
+	return false;
+      }
+      vetor_esferas = esferas;
+      int* materiais = (int*) crescer(material_esferas, n_esferas * sizeof(int), capacidade * sizeof(int));
+      if (materiais == NULL){
+	return false;
+      }
+      material_esferas = materiais;
+      capacidade_esferas = capacidade;
+    }
+    return reservar_tipos(n_primitivas - n_esferas + n);
+  }
+
+  /**
+   * \fn int ArmazemPrimitivas::incluir_material(const Vetor& cor, double kd, double ks, double brilho);
+   *
+   * \brief Inclui um material, com a cor ja normalizada, e retorna o seu indice. Um material igual a outro ja incluido nao e
+   * repetido: o indice do existente e retornado.
+   *
+   * \param cor - contribuicao r, g e b da cor
+   * \param kd - constante difusa
+   * \param ks - constante especular
+   * \param brilho - espalhamento da luz (expoente de phong)
+   *
+   * \return O indice do material ou -1 se nao houver memoria.
+   */
+  int
+  ArmazemPrimitivas::incluir_material(const Vetor& cor, double kd, double ks, double brilho){
+    double norma = cor.norma();
+    Material material;
+    material.albedo = Vetor(cor.vx()/norma, cor.vy()/norma, cor.vz()/norma);
+    material.kd = kd;
+    material.ks = ks;
+    material.brilho = brilho;
+    material.reflexao = 0.0;
+    material.indice_refracao = 1.0;
+
+    std::map<Material, int, MenorMaterial>::iterator id = ids_materiais.find(material);
+    if (id != ids_materiais.end()){
+      return id->second;
+    }
+    if (n_materiais == capacidade_materiais){
+      int capacidade = proxima_capacidade(capacidade_materiais, n_materiais + 1);
+      Material* materiais = (Material*) crescer(vetor_materiais, n_materiais * sizeof(Material), capacidade * sizeof(Material));
+      if (materiais == NULL){
+	return -1;
+      }
+      vetor_materiais = materiais;
+      capacidade_materiais = capacidade;
+    }
+    vetor_materiais[n_materiais] = material;
+    ids_materiais.insert(std::make_pair(material, n_materiais));
+    return n_materiais++;
+  }
+
+  /**
+   * \fn IdPrimitiva ArmazemPrimitivas::incluir_esfera(const Vetor& centro, double raio, int material);
+   *
+   * \brief Inclui uma esfera e retorna o seu identificador.
+   *
+   * \param centro - centro da esfera
+   * \param raio - raio da esfera
+   * \param material - indice retornado por incluir_material
+   *
+   * \return O identificador da esfera ou PRIMITIVA_NENHUMA se nao houver memoria.
+   */
+  IdPrimitiva
+  ArmazemPrimitivas::incluir_esfera(const Vetor& centro, double raio, int material){
+    if (!reservar_esferas(n_esferas + 1)){
+      return PRIMITIVA_NENHUMA;
+    }
+    EsferaCompacta& esfera = vetor_esferas[n_esferas];
+    esfera.centro[0] = centro.vx();
+    esfera.centro[1] = centro.vy();
+    esfera.centro[2] = centro.vz();
+    esfera.raio = raio;
+    material_esferas[n_esferas] = material;
+    tipos[n_primitivas++] = PRIMITIVA_ESFERA;
+    return id_primitiva(PRIMITIVA_ESFERA, n_esferas++);
+  }
+
+  /**
+   * \fn IdPrimitiva ArmazemPrimitivas::incluir_plano(const Vetor& ponto, const Vetor& normal, int material);
+   *
+   * \brief Inclui um plano infinito e retorna o seu identificador. A normal e normalizada e d e calculado de modo que o ponto
+   * pertenca ao plano.
+   *
+   * \param ponto - um ponto do plano
+   * \param normal - normal do plano (nao precisa ser unitaria)
+   * \param material - indice retornado por incluir_material
+   *
+   * \return O identificador do plano ou PRIMITIVA_NENHUMA se nao houver memoria.
+   */
+  IdPrimitiva
+  ArmazemPrimitivas::incluir_plano(const Vetor& ponto, const Vetor& normal, int material){
+    if (n_planos == capacidade_planos){
+      int capacidade = proxima_capacidade(capacidade_planos, n_planos + 1);
+      PlanoCompacto* planos = (PlanoCompacto*) crescer(vetor_planos, n_planos * sizeof(PlanoCompacto),
+						       capacidade * sizeof(PlanoCompacto));
+      if (planos == NULL){
+	return PRIMITIVA_NENHUMA;
+      }
+      vetor_planos = planos;
+      int* materiais = (int*) crescer(material_planos, n_planos * sizeof(int), capacidade * sizeof(int));
+      if (materiais == NULL){
+	return PRIMITIVA_NENHUMA;
+      }
+      material_planos = materiais;
+      capacidade_planos = capacidade;
+    }
+    if (!reservar_tipos(n_primitivas + 1)){
+      return PRIMITIVA_NENHUMA;
+    }
+    Vetor n = normal.normalizado();
+    PlanoCompacto& plano = vetor_planos[n_planos];
+    plano.normal[0] = n.vx();
+    plano.normal[1] = n.vy();
+    plano.normal[2] = n.vz();
+    plano.d = -n.produto_escalar(ponto);
+    material_planos[n_planos] = material;
+    tipos[n_primitivas++] = PRIMITIVA_PLANO;
+    return id_primitiva(PRIMITIVA_PLANO, n_planos++);
+  }
+
+  /**
+   * \fn bool ArmazemPrimitivas::reservar_vertices(int n);
+   *
+   * \brief Garante espaco para n vertices.
+   */
+  bool
+  ArmazemPrimitivas::reservar_vertices(int n){
+    if (n > capacidade_vertices){
+      int capacidade = proxima_capacidade(capacidade_vertices, n);
+      double* vertices = (double*) crescer(vetor_vertices, 3 * n_vertices * sizeof(double), 3 * capacidade * sizeof(double));
+      if (vertices == NULL){
+	return false;
+      }
+      vetor_vertices = vertices;
+      capacidade_vertices = capacidade;
+    }
+    return true;
+  }
+
+  /**
+   * \fn bool ArmazemPrimitivas::reservar_triangulos(int n);
+   *
+   * \brief Garante espaco para n triangulos. Como em reservar_esferas, a capacidade so muda quando os dois vetores crescem.
+   */
+  bool
+  ArmazemPrimitivas::reservar_triangulos(int n){
+    if (n > capacidade_triangulos){
+      int capacidade = proxima_capacidade(capacidade_triangulos, n);
+      int* triangulos = (int*) crescer(vetor_triangulos, 3 * n_triangulos * sizeof(int), 3 * capacidade * sizeof(int));
+      if (triangulos == NULL){
+	return false;
+      }
+      vetor_triangulos = triangulos;
+      int* materiais = (int*) crescer(material_triangulos, n_triangulos * sizeof(int), capacidade * sizeof(int));
+      if (materiais == NULL){
+	return false;
+      }
+      material_triangulos = materiais;
+      capacidade_triangulos = capacidade;
+    }
+    return reservar_tipos(n_primitivas - n_triangulos + n);
+  }
+
+  /**
+   * \fn int ArmazemPrimitivas::incluir_vertice(const Vetor& posicao);
+   *
+   * \brief Inclui um vertice de malha e retorna o seu indice, ou -1 se nao houver memoria.
+   */
+  int
+  ArmazemPrimitivas::incluir_vertice(const Vetor& posicao){
+    if (!reservar_vertices(n_vertices + 1)){
+      return -1;
+    }
+    double* v = vetor_vertices + 3 * n_vertices;
+    v[0] = posicao.vx();
+    v[1] = posicao.vy();
+    v[2] = posicao.vz();
+    return n_vertices++;
+  }
+
+  /**
+   * \fn IdPrimitiva ArmazemPrimitivas::incluir_triangulo(int a, int b, int c, int material);
+   *
+   * \brief Inclui um triangulo e retorna o seu identificador. A normal segue a regra da mao direita na ordem a, b, c.
+   *
+   * \param a, b, c - indices retornados por incluir_vertice
+   * \param material - indice retornado por incluir_material
+   *
+   * \return O identificador do triangulo ou PRIMITIVA_NENHUMA se nao houver memoria.
+   */
+  IdPrimitiva
+  ArmazemPrimitivas::incluir_triangulo(int a, int b, int c, int material){
+    if (!reservar_triangulos(n_triangulos + 1)){
+      return PRIMITIVA_NENHUMA;
+    }
+    int* triangulo = vetor_triangulos + 3 * n_triangulos;
+    triangulo[0] = a;
+    triangulo[1] = b;
+    triangulo[2] = c;
+    material_triangulos[n_triangulos] = material;
+    tipos[n_primitivas++] = PRIMITIVA_TRIANGULO;
+    return id_primitiva(PRIMITIVA_TRIANGULO, n_triangulos++);
+  }
+
+  /**
+   * \fn bool ArmazemPrimitivas::excluir_ultima();
+   *
+   * \brief Exclui a ultima primitiva incluida. A etiqueta da ultima primitiva indica de qual vetor ela sai; os materiais e os vertices nao sao
+   * excluidos.
+   *
+   * \return false se o armazem estava vazio.
+   */
+  bool
+  ArmazemPrimitivas::excluir_ultima(){
+    if (n_primitivas == 0){
+      return false;
+    }
+    switch (tipos[--n_primitivas]){
+    case PRIMITIVA_ESFERA:
+      n_esferas--;
+      break;
+    case PRIMITIVA_PLANO:
+      n_planos--;
+      break;
+    case PRIMITIVA_TRIANGULO:
+      n_triangulos--;
+      break;
+    }
+    return true;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
@@ -0,0 +1,475 @@
+/**
+ * \file primitivas.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo primitivas.cpp, sendo este
+ * responsavel pelo armazem de primitivas da cena. Cada tipo de primitiva (esferas, planos e, no futuro, triangulos e quadricas) tem o
+ * seu proprio vetor contiguo de registros compactos, e cada primitiva e identificada por um inteiro que carrega o tipo (etiqueta) e a
+ * posicao no vetor do tipo. Os triangulos das malhas guardam apenas os indices dos seus vertices, que ficam em um vetor compartilhado. Quem percorre a cena despacha pelo tipo com um switch, sem chamadas virtuais.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _PRIMITIVAS_HPP
+#define _PRIMITIVAS_HPP
+
+#include "vetor.hpp"	//rayTracing::Vetor
+#include "material.hpp"	//rayTracing::Material
+#include <map>		//map
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \enum TipoPrimitiva
+   *
+   * \brief Etiqueta do tipo de uma primitiva.
+   */
+  enum TipoPrimitiva{
+    PRIMITIVA_ESFERA = 0,	///< Esfera (EsferaCompacta)
+    PRIMITIVA_PLANO = 1,	///< Plano infinito (PlanoCompacto)
+    PRIMITIVA_TRIANGULO = 2,	///< Triangulo de uma malha (tres indices de vertices)
+    PRIMITIVA_PARTICULA = 3	///< Particula de uma NuvemParticulas, guardada fora do armazem
+  };
+
+  /**
+   * \brief Identificador de uma primitiva: a posicao no vetor do seu tipo deslocada de BITS_TIPO_PRIMITIVA bits, com o tipo nos bits
+   * baixos.
+   */
+  typedef unsigned int IdPrimitiva;
+
+  /**
+   * \brief Numero de bits da etiqueta de tipo no identificador (ate oito tipos de primitivas).
+   */
+  const int BITS_TIPO_PRIMITIVA = 3;
+
+  /**
+   * \brief Identificador reservado para "nenhuma primitiva" (raio que nao atingiu nada).
+   */
+  const IdPrimitiva PRIMITIVA_NENHUMA = ~0u;
+
+  /**
+   * \struct EsferaCompacta
+   *
+   * \brief Registro de 32 bytes de uma esfera: apenas o que o teste de interseccao le. O material fica em um vetor paralelo.
+   */
+  struct EsferaCompacta{
+    double centro[3];	///< Centro da esfera
+    double raio;	///< Raio da esfera
+  };
+
+  /**
+   * \struct PlanoCompacto
+   *
+   * \brief Registro de 32 bytes de um plano infinito: os pontos X do plano satisfazem \f$ N \cdot X + d = 0 \f$, com N unitaria.
+   */
+  struct PlanoCompacto{
+    double normal[3];	///< Normal unitaria do plano
+    double d;		///< Termo independente da equacao do plano
+  };
+
+  /**
+   * \fn IdPrimitiva id_primitiva(TipoPrimitiva tipo, int indice);
+   *
+   * \brief Monta o identificador da primitiva indice do tipo dado.
+   */
+  IdPrimitiva id_primitiva(TipoPrimitiva tipo, int indice);
+
+  /**
+   * \fn TipoPrimitiva tipo_primitiva(IdPrimitiva id);
+   *
+   * \brief Retorna a etiqueta de tipo do identificador.
+   */
+  TipoPrimitiva tipo_primitiva(IdPrimitiva id);
+
+  /**
+   * \fn int indice_primitiva(IdPrimitiva id);
+   *
+   * \brief Retorna a posicao da primitiva no vetor do seu tipo.
+   */
+  int indice_primitiva(IdPrimitiva id);
+
+  /**
+   * \class ArmazemPrimitivas
+   *
+   * \brief Armazem das primitivas e dos materiais da cena em vetores contiguos, um por tipo de primitiva. Uma esfera ocupa 32 bytes mais
+   * os 4 bytes do indice do seu material e 1 byte de etiqueta. Os materiais repetidos sao incluidos uma unica vez.
+   */
+  class ArmazemPrimitivas{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    unsigned char* tipos;		///< Etiqueta de cada primitiva, na ordem de inclusao
+    int n_primitivas;			///< Numero de primitivas
+    int capacidade_tipos;		///< Capacidade do vetor de etiquetas
+
+    EsferaCompacta* vetor_esferas;	///< Esferas
+    int* material_esferas;		///< Indice do material de cada esfera
+    int n_esferas;			///< Numero de esferas
+    int capacidade_esferas;		///< Capacidade dos vetores das esferas
+
+    PlanoCompacto* vetor_planos;	///< Planos
+    int* material_planos;		///< Indice do material de cada plano
+    int n_planos;			///< Numero de planos
+    int capacidade_planos;		///< Capacidade dos vetores dos planos
+
+    double* vetor_vertices;		///< Coordenadas x, y e z de cada vertice das malhas
+    int n_vertices;			///< Numero de vertices
+    int capacidade_vertices;		///< Capacidade do vetor de vertices
+
+    int* vetor_triangulos;		///< Indices dos tres vertices de cada triangulo
+    int* material_triangulos;		///< Indice do material de cada triangulo
+    int n_triangulos;			///< Numero de triangulos
+    int capacidade_triangulos;		///< Capacidade dos vetores dos triangulos
+
+    Material* vetor_materiais;		///< Materiais distintos
+    int n_materiais;			///< Numero de materiais
+    int capacidade_materiais;		///< Capacidade do vetor de materiais
+    std::map<Material, int, MenorMaterial> ids_materiais; ///< Indice de cada material ja incluido
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    /**
+     * \fn bool reservar_tipos(int n);
+     *
+     * \brief Garante espaco para n etiquetas.
+     *
+     * \return false se nao houver memoria; as primitivas ja incluidas sao mantidas.
+     */
+    bool reservar_tipos(int n);
+
+    //Copia nao permitida
+    ArmazemPrimitivas(const ArmazemPrimitivas&);
+    ArmazemPrimitivas& operator=(const ArmazemPrimitivas&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn ArmazemPrimitivas();
+     *
+     * \brief Construtor da classe. O armazem inicial e vazio.
+     */
+    ArmazemPrimitivas();
+
+    /**
+     * \fn ~ArmazemPrimitivas();
+     *
+     * \brief Destrutor da classe.
+     */
+    ~ArmazemPrimitivas();
+
+    /**
+     * \fn void limpar();
+     *
+     * \brief Remove todas as primitivas e materiais e libera os vetores.
+     */
+    void limpar();
+
+    /**
+     * \fn bool reservar_esferas(int n);
+     *
+     * \brief Garante espaco para n esferas, evitando realocacoes quando o numero de esferas e conhecido de antemao.
+     *
+     * \return false se nao houver memoria; as primitivas ja incluidas sao mantidas.
+     */
+    bool reservar_esferas(int n);
+
+    /**
+     * \fn int incluir_material(const Vetor& cor, double kd, double ks, double brilho = BRILHO_PADRAO);
+     *
+     * \brief Inclui um material, com a cor ja normalizada, e retorna o seu indice. Um material igual a outro ja incluido nao e
+     * repetido: o indice do existente e retornado.
+     *
+     * \param cor - contribuicao r, g e b da cor
+     * \param kd - constante difusa
+     * \param ks - constante especular
+     * \param brilho - espalhamento da luz (expoente de phong)
+     *
+     * \return O indice do material ou -1 se nao houver memoria.
+     */
+    int incluir_material(const Vetor& cor, double kd, double ks, double brilho = BRILHO_PADRAO);
+
+    /**
+     * \fn IdPrimitiva incluir_esfera(const Vetor& centro, double raio, int material);
+     *
+     * \brief Inclui uma esfera e retorna o seu identificador.
+     *
+     * \param centro - centro da esfera
+     * \param raio - raio da esfera
+     * \param material - indice retornado por incluir_material
+     *
+     * \return O identificador da esfera ou PRIMITIVA_NENHUMA se nao houver memoria.
+     */
+    IdPrimitiva incluir_esfera(const Vetor& centro, double raio, int material);
+
+    /**
+     * \fn IdPrimitiva incluir_plano(const Vetor& ponto, const Vetor& normal, int material);
+     *
+     * \brief Inclui um plano infinito e retorna o seu identificador.
+     *
+     * \param ponto - um ponto do plano
+     * \param normal - normal do plano (nao precisa ser unitaria)
+     * \param material - indice retornado por incluir_material
+     *
+     * \return O identificador do plano ou PRIMITIVA_NENHUMA se nao houver memoria.
+     */
+    IdPrimitiva incluir_plano(const Vetor& ponto, const Vetor& normal, int material);
+
+    /**
+     * \fn bool reservar_vertices(int n);
+     *
+     * \brief Garante espaco para n vertices.
+     *
+     * \return false se nao houver memoria; as primitivas ja incluidas sao mantidas.
+     */
+    bool reservar_vertices(int n);
+
+    /**
+     * \fn bool reservar_triangulos(int n);
+     *
+     * \brief Garante espaco para n triangulos.
+     *
+     * \return false se nao houver memoria; as primitivas ja incluidas sao mantidas.
+     */
+    bool reservar_triangulos(int n);
+
+    /**
+     * \fn int incluir_vertice(const Vetor& posicao);
+     *
+     * \brief Inclui um vertice de malha e retorna o seu indice. Os vertices sao compartilhados entre os triangulos que os citam.
+     *
+     * \return O indice do vertice ou -1 se nao houver memoria.
+     */
+    int incluir_vertice(const Vetor& posicao);
+
+    /**
+     * \fn IdPrimitiva incluir_triangulo(int a, int b, int c, int material);
+     *
+     * \brief Inclui um triangulo e retorna o seu identificador. A normal segue a regra da mao direita na ordem a, b, c.
+     *
+     * \param a, b, c - indices retornados por incluir_vertice
+     * \param material - indice retornado por incluir_material
+     *
+     * \return O identificador do triangulo ou PRIMITIVA_NENHUMA se nao houver memoria.
+     */
+    IdPrimitiva incluir_triangulo(int a, int b, int c, int material);
+
+    /**
+     * \fn bool excluir_ultima();
+     *
+     * \brief Exclui a ultima primitiva incluida. Os materiais nao sao excluidos.
+     *
+     * \return false se o armazem estava vazio.
+     */
+    bool excluir_ultima();
+
+    /**
+     * \fn int numero_primitivas() const;
+     *
+     * \brief Retorna o numero de primitivas de todos os tipos.
+     */
+    int numero_primitivas() const;
+
+    /**
+     * \fn int numero_esferas() const;
+     *
+     * \brief Retorna o numero de esferas.
+     */
+    int numero_esferas() const;
+
+    /**
+     * \fn const EsferaCompacta* esferas() const;
+     *
+     * \brief Retorna o vetor de esferas.
+     */
+    const EsferaCompacta* esferas() const;
+
+    /**
+     * \fn const int* materiais_esferas() const;
+     *
+     * \brief Retorna o indice do material de cada esfera.
+     */
+    const int* materiais_esferas() const;
+
+    /**
+     * \fn int numero_planos() const;
+     *
+     * \brief Retorna o numero de planos.
+     */
+    int numero_planos() const;
+
+    /**
+     * \fn const PlanoCompacto* planos() const;
+     *
+     * \brief Retorna o vetor de planos.
+     */
+    const PlanoCompacto* planos() const;
+
+    /**
+     * \fn const int* materiais_planos() const;
+     *
+     * \brief Retorna o indice do material de cada plano.
+     */
+    const int* materiais_planos() const;
+
+    /**
+     * \fn int numero_vertices() const;
+     *
+     * \brief Retorna o numero de vertices das malhas.
+     */
+    int numero_vertices() const;
+
+    /**
+     * \fn const double* vertices() const;
+     *
+     * \brief Retorna as coordenadas x, y e z de cada vertice, em sequencia.
+     */
+    const double* vertices() const;
+
+    /**
+     * \fn int numero_triangulos() const;
+     *
+     * \brief Retorna o numero de triangulos.
+     */
+    int numero_triangulos() const;
+
+    /**
+     * \fn const int* triangulos() const;
+     *
+     * \brief Retorna os indices dos tres vertices de cada triangulo, em sequencia.
+     */
+    const int* triangulos() const;
+
+    /**
+     * \fn const int* materiais_triangulos() const;
+     *
+     * \brief Retorna o indice do material de cada triangulo.
+     */
+    const int* materiais_triangulos() const;
+
+    /**
+     * \fn int numero_materiais() const;
+     *
+     * \brief Retorna o numero de materiais distintos.
+     */
+    int numero_materiais() const;
+
+    /**
+     * \fn const Material* materiais() const;
+     *
+     * \brief Retorna o vetor de materiais.
+     */
+    const Material* materiais() const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline IdPrimitiva
+  id_primitiva(TipoPrimitiva tipo, int indice){
+    return ((IdPrimitiva) indice << BITS_TIPO_PRIMITIVA) | (IdPrimitiva) tipo;
+  }
+
+  inline TipoPrimitiva
+  tipo_primitiva(IdPrimitiva id){
+    return (TipoPrimitiva) (id & ((1u << BITS_TIPO_PRIMITIVA) - 1));
+  }
+
+  inline int
+  indice_primitiva(IdPrimitiva id){
+    return (int) (id >> BITS_TIPO_PRIMITIVA);
+  }
+
+  inline int
+  ArmazemPrimitivas::numero_primitivas() const{
+    return n_primitivas;
+  }
+
+  inline int
+  ArmazemPrimitivas::numero_esferas() const{
+    return n_esferas;
+  }
+
+  inline const EsferaCompacta*
+  ArmazemPrimitivas::esferas() const{
+    return vetor_esferas;
+  }
+
+  inline const int*
+  ArmazemPrimitivas::materiais_esferas() const{
+    return material_esferas;
+  }
+
+  inline int
+  ArmazemPrimitivas::numero_planos() const{
+    return n_planos;
+  }
+
+  inline const PlanoCompacto*
+  ArmazemPrimitivas::planos() const{
+    return vetor_planos;
+  }
+
+  inline const int*
+  ArmazemPrimitivas::materiais_planos() const{
+    return material_planos;
+  }
+
+  inline int
+  ArmazemPrimitivas::numero_vertices() const{
+    return n_vertices;
+  }
+
+  inline const double*
+  ArmazemPrimitivas::vertices() const{
+    return vetor_vertices;
+  }
+
+  inline int
+  ArmazemPrimitivas::numero_triangulos() const{
+    return n_triangulos;
+  }
+
+  inline const int*
+  ArmazemPrimitivas::triangulos() const{
+    return vetor_triangulos;
+  }
+
+  inline const int*
+  ArmazemPrimitivas::materiais_triangulos() const{
+    return material_triangulos;
+  }
+
+  inline int
+  ArmazemPrimitivas::numero_materiais() const{
+    return n_materiais;
+  }
+
+  inline const Material*
+  ArmazemPrimitivas::materiais() const{
+    return vetor_materiais;
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
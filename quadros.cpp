@@ -0,0 +1,93 @@
+/**
+ * \file quadros.cpp
+ *
+ * \brief Este arquivo contem a implementacao que foi definida no arquivo quadros.hpp, sendo este responsavel pela troca de quadros
+ * entre a renderizacao e a apresentacao.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include "quadros.hpp"	//rayTracing::TrocaQuadros
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  //Bit de pronta que indica um quadro publicado e ainda nao adquirido
+  static const int QUADRO_NOVO = 4;
+
+  /**
+   * \fn static int troca_atomica(volatile int* destino, int valor);
+   *
+   * \brief Escreve valor em destino e retorna o valor anterior, atomicamente. A troca e uma barreira completa: as escritas nos pixels
+   * feitas antes dela sao vistas por quem adquirir a imagem depois.
+   */
+  static int
+  troca_atomica(volatile int* destino, int valor){
+    int anterior;
+    do{
+      anterior = *destino;
+    } while (!__sync_bool_compare_and_swap(destino, anterior, valor));
+    return anterior;
+  }
+
+  //------------------------------
+  //	Metodos publicos
+  //------------------------------
+  /**
+   * \fn TrocaQuadros::TrocaQuadros();
+   *
+   * \brief Construtor da classe.
+   */
+  TrocaQuadros::TrocaQuadros(){
+    trabalho = 0;
+    pronta = 1;
+    exibida = 2;
+  }
+
+  /**
+   * \fn void TrocaQuadros::publicar(bool manter);
+   *
+   * \brief Troca a imagem de trabalho com a imagem pronta. Depois da troca o quadro publicado pode ser adquirido e lido pela
+   * apresentacao, mas nunca escrito, entao a copia pedida por manter pode ser lida dele ao mesmo tempo.
+   */
+  void
+  TrocaQuadros::publicar(bool manter){
+    int publicada = trabalho;
+    trabalho = troca_atomica(&pronta, publicada | QUADRO_NOVO) & ~QUADRO_NOVO;
+    if (manter){
+      imagens[trabalho].copiar(imagens[publicada]);
+    }
+  }
+
+  /**
+   * \fn bool TrocaQuadros::adquirir();
+   *
+   * \brief Troca a imagem exibida com a imagem pronta, se esta for um quadro novo.
+   */
+  bool
+  TrocaQuadros::adquirir(){
+    if ((pronta & QUADRO_NOVO) == 0){
+      return false;
+    }
+    exibida = troca_atomica(&pronta, exibida) & ~QUADRO_NOVO;
+    return true;
+  }
+
+} //Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
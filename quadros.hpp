@@ -0,0 +1,120 @@
+/**
+ * \file quadros.hpp
+ *
+ * \brief Este arquivo e um pacote que contem as definicoes que deverao ser apresentados na integra no arquivo quadros.cpp, sendo este
+ * responsavel pela troca de quadros entre a renderizacao e a apresentacao. Sao usadas tres imagens: a que esta sendo pintada, a ultima
+ * publicada e a que esta sendo apresentada. A renderizacao e a apresentacao trocam imagens apenas por operacoes atomicas sobre um
+ * indice, sem travas, de modo que nenhum dos lados espera pelo outro e nenhuma imagem e lida enquanto e escrita.
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#ifndef _QUADROS_HPP
+#define _QUADROS_HPP
+
+#include "imagem.hpp"	//rayTracing::Imagem
+
+/**
+ * \defgroup RayTracingNameSpace Namespace rayTracing.
+ * @{
+ */
+
+/**
+ * \namespace rayTracing
+ *
+ * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
+ */
+namespace rayTracing{
+  /**
+   * \class TrocaQuadros
+   *
+   * \brief Buffer triplo de imagens. Apenas uma thread pinta (imagem_trabalho e publicar) e apenas uma apresenta (adquirir e
+   * imagem_exibida).
+   */
+  class TrocaQuadros{
+    //------------------------------
+    //	Atributos privados
+    //------------------------------
+  private:
+    Imagem imagens[3];		///< Imagens do buffer
+    int trabalho;		///< Imagem pintada (apenas a renderizacao acessa)
+    int exibida;		///< Imagem apresentada (apenas a apresentacao acessa)
+    volatile int pronta;	///< Ultima imagem publicada, com o bit QUADRO_NOVO se ainda nao foi adquirida
+
+    //------------------------------
+    //	Metodos privados
+    //------------------------------
+    //Copia nao permitida
+    TrocaQuadros(const TrocaQuadros&);
+    TrocaQuadros& operator=(const TrocaQuadros&);
+
+    //------------------------------
+    //	Metodos publicos
+    //------------------------------
+  public:
+    /**
+     * \fn TrocaQuadros();
+     *
+     * \brief Construtor da classe. As tres imagens iniciais sao vazias.
+     */
+    TrocaQuadros();
+
+    /**
+     * \fn Imagem& imagem_trabalho();
+     *
+     * \brief Retorna a imagem em que a renderizacao pinta. Nenhuma outra thread a le.
+     */
+    Imagem& imagem_trabalho();
+
+    /**
+     * \fn void publicar(bool manter);
+     *
+     * \brief Publica a imagem de trabalho como o quadro mais recente e recebe outra imagem para pintar. Um quadro publicado e ainda
+     * nao adquirido e substituido pelo novo.
+     *
+     * \param manter - true para copiar o quadro publicado na nova imagem de trabalho (a proxima passada continua a partir dele)
+     */
+    void publicar(bool manter);
+
+    /**
+     * \fn bool adquirir();
+     *
+     * \brief Se houver um quadro publicado desde a ultima chamada, passa a apresenta-lo.
+     *
+     * \return true se a imagem exibida mudou.
+     */
+    bool adquirir();
+
+    /**
+     * \fn const Imagem& imagem_exibida() const;
+     *
+     * \brief Retorna a imagem apresentada. Ela nao e alterada ate a proxima chamada de adquirir.
+     */
+    const Imagem& imagem_exibida() const;
+  };
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  inline Imagem&
+  TrocaQuadros::imagem_trabalho(){
+    return imagens[trabalho];
+  }
+
+  inline const Imagem&
+  TrocaQuadros::imagem_exibida() const{
+    return imagens[exibida];
+  }
+
+} ////Fim do namespace rayTracing
+
+/** @} */ //Fim do grupo class
+
+#endif
@@ -41,14 +41,11 @@ namespace rayTracing{
    * \brief Construtor da classe.
    */
   Raio::Raio(){
-    lkf = new Vetor(); ///< Lookfrom
-    lkt = new Vetor(); ///< Lookat
-    c_esf = new Vetor(); ///< Centro da esfera
-    drt = new Vetor(); ///< Vetor Diretor
+    raio2 = 0.0;
   }
 		
   /**
-   * \fn void Raio::atualizar_vetores(Vetor* _lkf, Vetor* _lkt, Objeto* esfera)
+   * \fn void Raio::atualizar_vetores(const Vetor& _lkf, const Vetor& _lkt, const Objeto* esfera)
    *
    * \brief Atualiza os valores dos vetores de posicao da camera (lookfrom), posicao do centro da esfera e do lookat
    *
@@ -56,31 +53,41 @@ namespace rayTracing{
    * \param _lkt - vetor de posicao do lookat
    * \param esfera - objeto esfera
    */
-  void Raio::atualizar_vetores( Vetor* _lkf, Vetor* _lkt, Objeto* esfera)
+  void Raio::atualizar_vetores(const Vetor& _lkf, const Vetor& _lkt, const Objeto* esfera)
   {
     //lookfrom
     lkf = _lkf;
-    lkfx = _lkf->vx();
-    lkfy = _lkf->vy();
-    lkfz = _lkf->vz();
 		
     //lookat
     lkt = _lkt;
-    lktx = _lkt->vx();
-    lkty = _lkt->vy();
-    lktz = _lkt->vz();
 		
     //centro da esfera
     c_esf = esfera->posicao_esfera();
-    c_esfx = c_esf->vx();
-    c_esfy = c_esf->vy();
-    c_esfz = c_esf->vz();
 		
     //raio da esfera
-    r = esfera->raio();
+    raio2 = esfera->raio() * esfera->raio();
 		
     //vetor diretor
-    drt->valores_vetor(0.0, 0.0, 0.0);
+    vetor_diretor();
+  }
+		
+  /**
+   * \fn void Raio::atualizar_vetores(const Vetor& _lkf, const Vetor& _lkt, const Vetor& centro, double _raio2)
+   *
+   * \brief Atualiza os valores dos vetores a partir dos dados de uma esfera ja compilada.
+   *
+   * \param _lkf - vetor de posicao da camera
+   * \param _lkt - vetor de posicao do lookat
+   * \param centro - centro da esfera
+   * \param _raio2 - quadrado do raio da esfera
+   */
+  void Raio::atualizar_vetores(const Vetor& _lkf, const Vetor& _lkt, const Vetor& centro, double _raio2)
+  {
+    lkf = _lkf;
+    lkt = _lkt;
+    c_esf = centro;
+    raio2 = _raio2;
+    vetor_diretor();
   }
 
   /**
@@ -89,11 +96,11 @@ namespace rayTracing{
    * \brief Calcula a diferenca entre o vetor lookat e o vetor lookfrom.
    */
   void Raio::vetor_diretor(){
-    drt->vetor_diretor(lkt, lkf);
+    drt.vetor_diretor(lkt, lkf);
   }
 
   /**
-   * \fn double Raio::delta(double a, double b, double c)
+   * \fn double Raio::delta(double a, double b, double c) const
    *
    * \brief calcula o delta para ser utilizado no metodo de interseccao com a esfera
    *
@@ -103,7 +110,7 @@ namespace rayTracing{
    *
    * \return o valor de delta
    */
-  double Raio::delta(double a, double b, double c){
+  double Raio::delta(double a, double b, double c) const{
     return (b*b) - (4*a*c);
   }
 
@@ -129,14 +136,14 @@ namespace rayTracing{
     //Chamando o metodo para atualizar o vetor diretor.
     vetor_diretor();
 		
-    //Pegando valores do vetor diretor, pois e o unico que no processo de atualizacao foi passado para a estrutura de dados
-    drtx = drt->vx();
-    drty = drt->vy();
-    drtz = drt->vz();
+    //Coordenadas do vetor diretor, da camera e do centro da esfera
+    double drtx = drt.vx(), drty = drt.vy(), drtz = drt.vz();
+    double lkfx = lkf.vx(), lkfy = lkf.vy(), lkfz = lkf.vz();
+    double c_esfx = c_esf.vx(), c_esfy = c_esf.vy(), c_esfz = c_esf.vz();
 		
     double a = ((drtx)*(drtx)) + ((drty)*(drty)) + ((drtz)*(drtz));
     double b = 2*(lkfx)*(drtx) - 2*(c_esfx)*(drtx) + 2*(lkfy)*(drty) - 2*(c_esfy)*(drty) + 2*(lkfz)*(drtz) - 2*(c_esfz)*(drtz);
-    double c = ((lkfx)*(lkfx)) + ((lkfy)*(lkfy)) + ((lkfz)*(lkfz)) + ((c_esfx)*(c_esfx)) + ((c_esfy)*(c_esfy)) + ((c_esfz)*(c_esfz)) - (r*r) - 2*(c_esfx)*(lkfx) - 2*(c_esfy)*(lkfy) - 2*(c_esfz)*(lkfz);
+    double c = ((lkfx)*(lkfx)) + ((lkfy)*(lkfy)) + ((lkfz)*(lkfz)) + ((c_esfx)*(c_esfx)) + ((c_esfy)*(c_esfy)) + ((c_esfz)*(c_esfz)) - raio2 - 2*(c_esfx)*(lkfx) - 2*(c_esfy)*(lkfy) - 2*(c_esfz)*(lkfz);
 	
     //Encontrando o delta
     double _delta = delta(a, b, c);
@@ -151,7 +158,7 @@ namespace rayTracing{
   }
 
   /**
-   * \fn Vetor* interseccao_esfera(double t)
+   * \fn Vetor Raio::interseccao_esfera(double t) const
    *
    * \brief Atraves do valor de t pode ser encontrado a posicao de interseccao do raio com a esfera aplicando a equacao parametrizada. Sabemos que
    * o vetor diretor esta na forma \f$(D_x) = (lkt_x - lkf_x) \f$, \f$(D_y) = (lkt_y - lkf_y) \f$ e \f$ (D_z) = (lkt_z - lkf_z) \f$ aplicando a equacao parametrizada a qual
@@ -161,10 +168,8 @@ namespace rayTracing{
    *
    * \return a posicao de interseccao entre o raio e a esfera
    */
-  Vetor* Raio::interseccao_esfera(double t){
-    Vetor* aux = new Vetor();
-    aux-> valores_vetor((lkfx + (t * drtx)), (lkfy + (t * drty)), (lkfz + (t * drtz)));
-    return aux;
+  Vetor Raio::interseccao_esfera(double t) const{
+    return lkf + (drt * t);
   }
 
 } //Fim do namespace rayTracing
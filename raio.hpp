@@ -22,6 +22,8 @@
 
 #include "vetor.hpp"	//rayTracing::Vetor
 #include "objeto.hpp"	//rayTracing::Objeto
+#include "primitivas.hpp"	//rayTracing::PlanoCompacto
+#include <math.h>	//sqrt
 
 /** 
  * \defgroup RayTracingNameSpace Namespace rayTracing.
@@ -44,18 +46,12 @@ namespace rayTracing{
     //	Atributos privados
     //------------------------------
   private:
-    Vetor* lkf; ///< Lookfrom
-    Vetor* lkt; ///< Lookat
-    Vetor* c_esf; ///< Centro da esfera
-    Vetor* drt; ///< Vetor Diretor
-    
-    //Coordenadas globais
-    double lkfx, lkfy, lkfz;
-    double lktx, lkty, lktz;
-    double c_esfx, c_esfy, c_esfz;
-    double drtx, drty, drtz;
+    Vetor lkf; ///< Lookfrom
+    Vetor lkt; ///< Lookat
+    Vetor c_esf; ///< Centro da esfera
+    Vetor drt; ///< Vetor Diretor
 			
-    double r;	//raio da esfera
+    double raio2;	//quadrado do raio da esfera
 		//------------------------------
 		//	Atributos publicos
 		//------------------------------
@@ -68,7 +64,7 @@ namespace rayTracing{
     Raio();
 		
     /**
-     * \fn void atualizar_vetores(Vetor* _lkf, Vetor* _lkt, Objeto* esfera)
+     * \fn void atualizar_vetores(const Vetor& _lkf, const Vetor& _lkt, const Objeto* esfera)
      *
      * \brief Atualiza os valores dos vetores de posicao da camera (lookfrom), posicao do centro da esfera e do lookat
      *
@@ -76,7 +72,19 @@ namespace rayTracing{
      * \param _lkt - vetor de posicao do lookat
      * \param esfera - objeto esfera
      */
-    void atualizar_vetores( Vetor* _lkf, Vetor* _lkt, Objeto* esfera);
+    void atualizar_vetores(const Vetor& _lkf, const Vetor& _lkt, const Objeto* esfera);
+		
+    /**
+     * \fn void atualizar_vetores(const Vetor& _lkf, const Vetor& _lkt, const Vetor& centro, double _raio2)
+     *
+     * \brief Atualiza os valores dos vetores a partir dos dados de uma esfera ja compilada.
+     *
+     * \param _lkf - vetor de posicao da camera
+     * \param _lkt - vetor de posicao do lookat
+     * \param centro - centro da esfera
+     * \param _raio2 - quadrado do raio da esfera
+     */
+    void atualizar_vetores(const Vetor& _lkf, const Vetor& _lkt, const Vetor& centro, double _raio2);
 	
     /**
      * \fn void vetor_diretor()
@@ -86,7 +94,7 @@ namespace rayTracing{
     void vetor_diretor();
 	
     /**
-     * \fn double delta(double a, double b, double c)
+     * \fn double delta(double a, double b, double c) const
      *
      * \brief calcula o delta para ser utilizado no metodo de interseccao com a esfera
      *
@@ -96,7 +104,7 @@ namespace rayTracing{
      *
      * \return o valor de delta
      */
-    double delta(double a, double b, double c);
+    double delta(double a, double b, double c) const;
 	
     /**
      * \fn double calcula_t() 
@@ -119,7 +127,7 @@ namespace rayTracing{
     double calcula_t();
 	 
     /**
-     * \fn vetor interseccao_esfera(double t)
+     * \fn Vetor interseccao_esfera(double t) const
      *
      * \brief Atraves do valor de t pode ser encontrado a posicao de interseccao do raio com a esfera aplicando a equacao parametrizada. Sabemos que
      * o vetor diretor esta na forma \f$(D_x) = (lkt_x - lkf_x) \f$, \f$(D_y) = (lkt_y - lkf_y) \f$ e \f$ (D_z) = (lkt_z - lkf_z) \f$ aplicando a equacao parametrizada a qual
@@ -129,10 +137,64 @@ namespace rayTracing{
      *
      * \return a posicao de interseccao entre o raio e a esfera
      */
-    Vetor* interseccao_esfera(double t);
+    Vetor interseccao_esfera(double t) const;
 	
   };
 
+  /**
+   * \fn inline double intercepta_esfera(double ocx, double ocy, double ocz, double c, double dx, double dy, double dz, double t_max);
+   *
+   * \brief Interseccao de um raio com uma esfera sem qualquer estado. Com a direcao D normalizada (a = 1) e \f$ OC = O - C \f$, a
+   * equacao \f$ t^2 + 2bt + c = 0 \f$ tem \f$ b = OC \cdot D \f$ e \f$ c = |OC|^2 - r^2 \f$, e as raizes sao \f$ -b \pm \sqrt{b^2 - c} \f$.
+   * O termo c depende apenas da origem do raio, e por isso pode ser calculado uma unica vez por quadro para os raios primarios. Como
+   * em Raio::calcula_t, apenas a menor raiz e considerada: se a origem estiver dentro da esfera (c < 0) ou a esfera estiver atras do
+   * raio (b > 0), o raio e rejeitado antes da raiz quadrada.
+   *
+   * \param ocx, ocy, ocz - origem do raio menos o centro da esfera
+   * \param c - \f$ |OC|^2 - r^2 \f$
+   * \param dx, dy, dz - direcao normalizada do raio
+   * \param t_max - interseccoes com t >= t_max sao ignoradas
+   *
+   * \return A distancia t ate a interseccao ou -1.0.
+   */
+  inline double
+  intercepta_esfera(double ocx, double ocy, double ocz, double c, double dx, double dy, double dz, double t_max){
+    double b = ocx * dx + ocy * dy + ocz * dz;
+    if (c < 0.0 || b > 0.0){
+      return -1.0;
+    }
+    double discriminante = b * b - c;
+    if (discriminante < 0.0){
+      return -1.0;
+    }
+    double t = -b - sqrt(discriminante);
+    return (t < t_max) ? t : -1.0;
+  }
+
+  /**
+   * \fn inline double intercepta_plano(const PlanoCompacto& plano, const double origem[3], const double direcao[3], double t_minimo,
+   * double t_max);
+   *
+   * \brief Interseccao de um raio com um plano infinito em tempo constante: substituindo \f$ O + tD \f$ em \f$ N \cdot X + d = 0 \f$,
+   * \f$ t = -(N \cdot O + d) / (N \cdot D) \f$. Um raio paralelo ao plano (\f$ N \cdot D = 0 \f$) nao o atinge.
+   *
+   * \param plano - plano testado
+   * \param origem - origem do raio
+   * \param direcao - direcao normalizada do raio
+   * \param t_minimo, t_max - apenas interseccoes com t_minimo < t < t_max sao consideradas
+   *
+   * \return A distancia t ate a interseccao ou -1.0.
+   */
+  inline double
+  intercepta_plano(const PlanoCompacto& plano, const double origem[3], const double direcao[3], double t_minimo, double t_max){
+    double denominador = plano.normal[0] * direcao[0] + plano.normal[1] * direcao[1] + plano.normal[2] * direcao[2];
+    if (denominador == 0.0){
+      return -1.0;
+    }
+    double t = -(plano.normal[0] * origem[0] + plano.normal[1] * origem[1] + plano.normal[2] * origem[2] + plano.d) / denominador;
+    return (t > t_minimo && t < t_max) ? t : -1.0;
+  }
+
 } ////Fim do namespace rayTracing
  
 /** @} */ //Fim do grupo class
@@ -17,27 +17,22 @@
  * \date Outubro 2013
  */
 #include <iostream>			//std::endl, std::cin e std::cout
+#include <algorithm>			//std::min
+#include <string.h>			//memset
 #include "ray_tracing.hpp"	//rayTracing::Ray_tracing
 #include "vetor.hpp"		//rayTracing::Vetor
 #include "raio.hpp"			//rayTracing::Raio
 #include "luz.hpp"			//rayTracing::Luz
+#include "interseccao.hpp"		//rayTracing::Interseccao
 #include "objeto.hpp"		//rayTracing::Objeto
 #include "cena.hpp"			//rayTracing::Cena
-
-#ifdef __unix__   // Unix
-#include <GL/gl.h>		//GLdouble, Glint, glDrawPixels
-#include <GL/glu.h>
-#include <GL/glut.h>		//gluUnProject
-#else // Apple
-#include <OpenGL/gl.h>
-#include <OpenGL/glu.h>
-#include <GLUT/glut.h>
-#endif
-/*#else  // Windows
-#include <w32api/GL/gl.h>	//GLdouble, Glint, glDrawPixels
-#include <w32api/GL/glu.h>
-#include <w32api/GL/glut.h>	//gluUnProject
-#endif*/
+#include "escalonador.hpp"		//rayTracing::Escalonador, rayTracing::Tarefa
+#include "camera.hpp"			//rayTracing::Camera
+#include "cena_compilada.hpp"		//rayTracing::CenaCompilada
+#include "memoria.hpp"			//rayTracing::aloca_alinhado
+#include "pacote.hpp"			//rayTracing::PacoteRaios
+#include "nucleos.hpp"			//rayTracing::intercepta_esferas
+#include "imagem.hpp"			//rayTracing::Imagem
 
 /** 
  * \defgroup RayTracingNameSpace Namespace rayTracing.
@@ -50,152 +45,675 @@
  * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
  */
 namespace rayTracing{
+  //Dimensao (em pixels) do lado de um ladrilho da imagem; multiplo de PIXELS_ALINHAMENTO, para que ladrilhos vizinhos nunca
+  //escrevam na mesma linha de cache
+  static const int TAMANHO_LADRILHO = 64;
+  //Menor t aceito nos raios de sombra, para que a propria esfera nao sombreie o ponto de onde o raio parte
+  static const double T_MINIMO_SOMBRA = 1e-6;
+	
+  /**
+   * \class TesteEsfera
+   *
+   * \brief Teste de interseccao de um raio qualquer com as esferas de uma folha da BVH, lidas dos vetores SoA da cena compilada.
+   */
+  class TesteEsfera{
+  public:
+    const CenaCompilada* cena;	///< Cena compilada
+    double origem[3];		///< Origem do raio
+    double direcao[3];		///< Direcao normalizada do raio
+    double t_minimo;		///< Interseccoes com t <= t_minimo sao ignoradas
+		
+    /**
+     * \fn int operator()(int inicio, int n, double t_max, double* t) const;
+     *
+     * \brief Retorna a esfera mais proxima entre as esferas [inicio, inicio + n) de uma folha ou -1, testando varias esferas por
+     * instrucao.
+     */
+    int operator()(int inicio, int n, double t_max, double* t) const{
+      return intercepta_esferas(cena->centros_x(), cena->centros_y(), cena->centros_z(), cena->raios2(), inicio, n,
+				origem, direcao, t_minimo, t_max, t);
+    }
+  };
+	
+  /**
+   * \class TesteEsferaCamera
+   *
+   * \brief Teste de interseccao de um pacote de raios primarios com a esfera k. Todos os raios primarios partem da camera, entao o
+   * termo \f$ c = |O - C|^2 - r^2 \f$ de cada esfera e lido do cache calculado uma unica vez por quadro.
+   */
+  class TesteEsferaCamera{
+  public:
+    const CenaCompilada* cena;	///< Cena compilada
+    const double* termos_c;	///< Termo c de cada esfera para a origem na camera
+		
+    /**
+     * \fn void operator()(int k, PacoteRaios& p) const;
+     *
+     * \brief Atualiza o pacote com as interseccoes com a esfera k.
+     */
+    void operator()(int k, PacoteRaios& p) const{
+      double oc[3] = { p.origem[0] - cena->centros_x()[k], p.origem[1] - cena->centros_y()[k], p.origem[2] - cena->centros_z()[k] };
+      intercepta_esfera_pacote(p, oc, termos_c[k], k);
+    }
+  };
+	
+  /**
+   * \class TesteTriangulo
+   *
+   * \brief Teste de interseccao de um raio qualquer com os triangulos de uma folha da BVH dos triangulos.
+   */
+  class TesteTriangulo{
+  public:
+    TriangulosSoA tri;		///< Vetores SoA dos triangulos da cena compilada
+    double origem[3];		///< Origem do raio
+    double direcao[3];		///< Direcao normalizada do raio
+    double t_minimo;		///< Interseccoes com t <= t_minimo sao ignoradas
+		
+    /**
+     * \fn int operator()(int inicio, int n, double t_max, double* t) const;
+     *
+     * \brief Retorna o triangulo mais proximo entre os triangulos [inicio, inicio + n) de uma folha ou -1.
+     */
+    int operator()(int inicio, int n, double t_max, double* t) const{
+      return intercepta_triangulos(tri, inicio, n, origem, direcao, t_minimo, t_max, t);
+    }
+  };
+	
+  /**
+   * \class TesteTrianguloCamera
+   *
+   * \brief Teste de interseccao de um pacote de raios primarios com o triangulo k.
+   */
+  class TesteTrianguloCamera{
+  public:
+    TriangulosSoA tri;		///< Vetores SoA dos triangulos da cena compilada
+		
+    /**
+     * \fn void operator()(int k, PacoteRaios& p) const;
+     *
+     * \brief Atualiza o pacote com as interseccoes com o triangulo k.
+     */
+    void operator()(int k, PacoteRaios& p) const{
+      intercepta_triangulo_pacote(p, tri, k);
+    }
+  };
+	
+  /**
+   * \class TesteParticula
+   *
+   * \brief Teste de interseccao de um raio qualquer com os grupos de particulas de uma folha da BVH da nuvem. Cada grupo e
+   * decodificado para vetores SoA na pilha e testado pelo mesmo nucleo das esferas.
+   */
+  class TesteParticula{
+  public:
+    const NuvemParticulas* nuvem;	///< Nuvem de particulas
+    double origem[3];		///< Origem do raio
+    double direcao[3];		///< Direcao normalizada do raio
+    double t_minimo;		///< Interseccoes com t <= t_minimo sao ignoradas
+		
+    /**
+     * \fn int operator()(int inicio, int n, double t_max, double* t) const;
+     *
+     * \brief Retorna a particula mais proxima dos grupos [inicio, inicio + n) de uma folha ou -1.
+     */
+    int operator()(int inicio, int n, double t_max, double* t) const{
+      double cx[TAMANHO_DECODIFICADO], cy[TAMANHO_DECODIFICADO], cz[TAMANHO_DECODIFICADO], r2[TAMANHO_DECODIFICADO];
+      int melhor = -1;
+      double t_melhor = t_max;
+      for (int g = inicio; g < inicio + n; g++){
+	int m = nuvem->decodificar_grupo(g, cx, cy, cz, r2);
+	double tg;
+	int j = intercepta_esferas(cx, cy, cz, r2, 0, m, origem, direcao, t_minimo, t_melhor, &tg);
+	if (j >= 0){
+	  t_melhor = tg;
+	  melhor = nuvem->primeira_particula(g) + j;
+	}
+      }
+      *t = t_melhor;
+      return melhor;
+    }
+  };
+	
+  /**
+   * \class TesteParticulaCamera
+   *
+   * \brief Teste de interseccao de um pacote de raios primarios com o grupo de particulas g. Ao contrario das esferas, o termo c nao
+   * fica em cache: seriam mais 8 bytes por particula.
+   */
+  class TesteParticulaCamera{
+  public:
+    const NuvemParticulas* nuvem;	///< Nuvem de particulas
+		
+    /**
+     * \fn void operator()(int g, PacoteRaios& p) const;
+     *
+     * \brief Atualiza o pacote com as interseccoes com as particulas do grupo g.
+     */
+    void operator()(int g, PacoteRaios& p) const{
+      double cx[TAMANHO_DECODIFICADO], cy[TAMANHO_DECODIFICADO], cz[TAMANHO_DECODIFICADO], r2[TAMANHO_DECODIFICADO];
+      int m = nuvem->decodificar_grupo(g, cx, cy, cz, r2);
+      int primeira = nuvem->primeira_particula(g);
+      for (int j = 0; j < m; j++){
+	double oc[3] = { p.origem[0] - cx[j], p.origem[1] - cy[j], p.origem[2] - cz[j] };
+	intercepta_esfera_pacote(p, oc, oc[0] * oc[0] + oc[1] * oc[1] + oc[2] * oc[2] - r2[j], primeira + j);
+      }
+    }
+  };
+	
+  /**
+   * \class TarefaLadrilhos
+   *
+   * \brief Tarefa de renderizacao: cada item e um ladrilho quadrado da imagem.
+   */
+  class TarefaLadrilhos : public Tarefa{
+  public:
+    Ray_tracing* ray_tracing;	///< Renderizador
+    const CenaCompilada* cena;	///< Cena compilada (apenas lida)
+    const Luz* luz;		///< Luz (apenas lida)
+    const double* termos_c;	///< Termo c de cada esfera para a origem na camera
+    const Vetor* lookfrom;	///< Posicao da camera
+    const Camera* camera;	///< Camera do quadro
+    int altura_janela;		///< Altura da imagem, para converter j na coordenada y da janela
+    Imagem* imagem;		///< Imagem pintada
+    int ladrilhos_lado;		///< Numero de ladrilhos ao longo do lado da imagem
+    Arena* arenas;		///< Arena de cada trabalhador
+    int* perdidos;		///< Ladrilhos de cada trabalhador nao pintados por falta de memoria na arena
+    int passo;			///< Passo da grade de pixels tracados (1 traca todos)
+    int passo_anterior;		///< Passo da grade ja tracada pela passada anterior (0 se nenhuma)
+		
+    /**
+     * \fn void executar(int item, int trabalhador);
+     *
+     * \brief Pinta os pixels do ladrilho na grade de passo. Os pontos de mundo de cada linha do ladrilho sao gerados de uma vez pela
+     * camera, e os raios de LARGURA_PACOTE pixels da linha sao tracados juntos como um pacote. Como TAMANHO_LADRILHO e multiplo dos
+     * passos, a grade local do ladrilho coincide com a grade da imagem. Se a arena do trabalhador nao tiver memoria para os buffers,
+     * o ladrilho nao e pintado e e contado em perdidos.
+     */
+    void executar(int item, int trabalhador){
+      int i0 = (item % ladrilhos_lado) * TAMANHO_LADRILHO;
+      int j0 = (item / ladrilhos_lado) * TAMANHO_LADRILHO;
+      int i1 = std::min(i0 + TAMANHO_LADRILHO, cena->lado());
+      int j1 = std::min(j0 + TAMANHO_LADRILHO, cena->altura());
+      //Buffers do ladrilho na arena do trabalhador, liberados ao fim do ladrilho
+      Arena& arena = arenas[trabalhador];
+      double* ax = arena.alocar_vetor<double>(TAMANHO_LADRILHO);
+      double* ay = arena.alocar_vetor<double>(TAMANHO_LADRILHO);
+      double* az = arena.alocar_vetor<double>(TAMANHO_LADRILHO);
+      int* colunas = arena.alocar_vetor<int>(TAMANHO_LADRILHO);
+      if (ax == NULL || ay == NULL || az == NULL || colunas == NULL){
+	arena.reiniciar();
+	perdidos[trabalhador]++;
+	return;
+      }
+      VistaImagem vista = imagem->ladrilho(i0, j0, i1 - i0, j1 - j0);
+			
+      TesteEsferaCamera teste;
+      teste.cena = cena;
+      teste.termos_c = termos_c;
+      TesteTrianguloCamera teste_triangulos;
+      teste_triangulos.tri = cena->triangulos();
+      TesteParticulaCamera teste_particulas;
+      teste_particulas.nuvem = cena->particulas();
+      int esferas[LARGURA_PACOTE];
+      int triangulos[LARGURA_PACOTE];
+      Vetor cores[LARGURA_PACOTE];
+      ParametrosPhong phong = luz->parametros_phong();
+      //As posicoes inativas guardam os valores finitos de um pacote anterior (ou zero), calculados e descartados pelo sombreamento
+      AcertosPacote acertos;
+      memset(&acertos, 0, sizeof(acertos));
+      PacoteRaios p;
+      p.origem[0] = lookfrom->vx(); p.origem[1] = lookfrom->vy(); p.origem[2] = lookfrom->vz();
+      for (int j = j0; j < j1; j += passo){
+	//Colunas tracadas nesta linha; nas linhas da grade anterior, as colunas dessa grade ja estao prontas
+	int primeira = 0, intervalo = passo;
+	if (passo_anterior > 0 && (j - j0) % passo_anterior == 0){
+	  primeira = passo;
+	  intervalo = passo_anterior;
+	}
+	int n_colunas = 0;
+	for (int i = primeira; i < i1 - i0; i += intervalo){
+	  colunas[n_colunas++] = i;
+	}
+	if (n_colunas == 0){
+	  continue;
+	}
+				
+	//Encontrando lookat's da linha
+	int realy = altura_janela - j - 1;
+	camera->alvos_linha((double) realy, i0, i1 - i0, ax, ay, az);
+	for (int m = 0; m < n_colunas; m += LARGURA_PACOTE){
+	  //Montando o pacote; os raios alem do fim da linha ficam inativos (t = -1)
+	  int n = std::min(LARGURA_PACOTE, n_colunas - m);
+	  for (int k = 0; k < LARGURA_PACOTE; k++){
+	    Vetor direcao(1.0, 0.0, 0.0);
+	    p.t[k] = -1.0;
+	    if (k < n){
+	      int c = colunas[m + k];
+	      direcao = (Vetor(ax[c], ay[c], az[c]) - *lookfrom).normalizado();
+	      p.t[k] = 1e300;
+	    }
+	    p.dx[k] = direcao.vx(); p.dy[k] = direcao.vy(); p.dz[k] = direcao.vz();
+	    p.inv_dx[k] = 1.0 / p.dx[k]; p.inv_dy[k] = 1.0 / p.dy[k]; p.inv_dz[k] = 1.0 / p.dz[k];
+	    p.indice[k] = -1;
+	  }
+	  cena->bvh().mais_proxima_pacote(p, teste);
+	  //Os triangulos partem do t das esferas e so substituem interseccoes mais proximas; indice passa a marcar os triangulos
+	  for (int k = 0; k < LARGURA_PACOTE; k++){
+	    esferas[k] = p.indice[k];
+	    p.indice[k] = -1;
+	  }
+	  cena->bvh_triangulos().mais_proxima_pacote(p, teste_triangulos);
+	  //Da mesma forma, as particulas partem do t dos triangulos
+	  for (int k = 0; k < LARGURA_PACOTE; k++){
+	    triangulos[k] = p.indice[k];
+	    p.indice[k] = -1;
+	  }
+	  if (teste_particulas.nuvem != NULL){
+	    teste_particulas.nuvem->bvh().mais_proxima_pacote(p, teste_particulas);
+	  }
+	  acertos.ativos = 0;
+	  for (int k = 0; k < n; k++){
+	    //Os planos ficam fora da BVH: completam a interseccao mais proxima encontrada pelo pacote
+	    IdPrimitiva primitiva = PRIMITIVA_NENHUMA;
+	    if (p.indice[k] >= 0){
+	      primitiva = id_primitiva(PRIMITIVA_PARTICULA, p.indice[k]);
+	    }
+	    else if (triangulos[k] >= 0){
+	      primitiva = id_primitiva(PRIMITIVA_TRIANGULO, triangulos[k]);
+	    }
+	    else if (esferas[k] >= 0){
+	      primitiva = id_primitiva(PRIMITIVA_ESFERA, esferas[k]);
+	    }
+	    double t = p.t[k];
+	    double direcao[3] = { p.dx[k], p.dy[k], p.dz[k] };
+	    cena->intercepta_planos(p.origem, direcao, 0.0, &t, &primitiva);
+	    if (ray_tracing->preparar_pixel(cena, luz, *lookfrom, Vetor(p.dx[k], p.dy[k], p.dz[k]), t, primitiva, acertos, k, cores[k])){
+	      acertos.ativos |= 1 << k;
+	    }
+	  }
+	  //Os raios iluminados do pacote sao sombreados juntos
+	  if (acertos.ativos != 0){
+	    sombrear_pacote(acertos, p.origem, phong);
+	  }
+	  for (int k = 0; k < n; k++){
+	    int c = colunas[m + k];
+	    if (acertos.ativos & (1 << k)){
+	      vista.escrever_pixel(c, j - j0, acertos.r[k], acertos.g[k], acertos.b[k]);
+	    }
+	    else{
+	      vista.escrever_pixel(c, j - j0, cores[k].vx(), cores[k].vy(), cores[k].vz());
+	    }
+	    if (passo > 1){
+	      vista.replicar_pixel(c, j - j0, passo);
+	    }
+	  }
+	}
+      }
+      arena.reiniciar();
+    }
+  };
+	
   //------------------------------
   //	Metodos privados
   //------------------------------
   /**
-   * \fn void Ray_tracing::calculo_posicao_mundo(GLdouble winX, GLdouble winY, GLdouble winZ,
-   GLdouble model[16], GLdouble proj[16], GLint view[4],
-   GLdouble* objX, GLdouble* objY, GLdouble* objZ);
+   * \fn bool Ray_tracing::preparar_pixel(const CenaCompilada* cena, const Luz* luz, const Vetor& lookfrom, const Vetor& direcao,
+   double t, IdPrimitiva primitiva, AcertosPacote& acertos, int k, Vetor& cor);
    *
-   * \brief Metodo que calcula as posicoes de mundo atraves da funcao gluUnProject
+   * \brief Prepara o raio k de um pacote para o sombreamento a partir da interseccao do seu raio primario, ja encontrada pelo pacote.
+   * A cena e a luz sao apenas lidas, de modo que varios pixels podem ser preparados ao mesmo tempo. Com as sombras ligadas, um raio
+   * de sombra (consulta de qualquer interseccao) e tracado do ponto ate a luz, contra os planos e as BVHs das esferas, dos
+   * triangulos e das particulas. A normal e virada para o lado do observador, de modo que os planos sejam iluminados dos dois lados.
    *
-   * \param winX, winY, winZ - coordenadas da janela
-   * \param model, proj, view - matrizes modelview, projection e viewport.
-   * \param objX, objY, objZ - coordenadas do objeto
+   * \param cena - Cena compilada que sera aplicado o ray tracing
+   * \param luz - Luz no objeto
+   * \param lookfrom - posicao da camera
+   * \param direcao - direcao normalizada do raio primario
+   * \param t - distancia ate a interseccao
+   * \param primitiva - primitiva interceptada (PRIMITIVA_NENHUMA se o raio nao atingiu nada)
+   * \param acertos - interseccoes do pacote, preenchidas na posicao k se o ponto e iluminado
+   * \param k - posicao do raio no pacote
+   * \param cor - cor final do pixel, se ele nao e sombreado pelo pacote
+   *
+   * \return true se o ponto e iluminado e deve ser sombreado por sombrear_pacote; false se cor ja e a cor do pixel (fundo ou luz
+   * ambiente, em sombra).
    */
-  void 
-  Ray_tracing::calculo_posicao_mundo(GLdouble winX, GLdouble winY, GLdouble winZ,
-				     const GLdouble model[16], const GLdouble proj[16],const GLint view[4],
-				     GLdouble* objX, GLdouble* objY, GLdouble* objZ){
-    gluUnProject(winX, winY, winZ, model, proj, view, objX, objY, objZ);
-    return;
+  bool
+  Ray_tracing::preparar_pixel(const CenaCompilada* cena, const Luz* luz, const Vetor& lookfrom, const Vetor& direcao,
+			      double t_aux, IdPrimitiva objeto_salvo, AcertosPacote& acertos, int k, Vetor& cor){
+    if (objeto_salvo != PRIMITIVA_NENHUMA){	//alguma primitiva foi interceptada
+      //Registro da interseccao; a normal e o material vem da primitiva, despachados pela etiqueta de tipo
+      Interseccao interseccao;
+      interseccao.primitiva = objeto_salvo;
+      interseccao.ponto = lookfrom + (direcao * t_aux);
+      interseccao.normal = cena->normal_primitiva(interseccao.primitiva, interseccao.ponto);
+      if (interseccao.normal.produto_escalar(direcao) > 0.0){
+	interseccao.normal = -interseccao.normal;
+      }
+      interseccao.observador = lookfrom;
+      interseccao.t = t_aux;
+      const Vetor& int_esfera = interseccao.ponto;
+			
+      //
+      //	Textura fixa - definido no main
+      //
+      //Pegando o material do objeto na tabela da cena; a contribuicao red, blue e green ja vem normalizada da compilacao
+      const Material& material = cena->material_primitiva(interseccao.primitiva);
+      const Vetor& cores_objeto = material.albedo;
+			
+      //
+      //	Textura variavel com o pixel - Aplicando textura em cada pixel da esfera
+      //
+      //Limites da cor do objeto
+      //Vetor range_areia_superior(223.0, 246.0, 143.0);	//Vetor de limite superior da cor
+      //Vetor range_areia_inferior(139.0, 129.0, 76.0);	//Vetor de limite inferior da cor
+      //Textura cor_areia(range_areia_superior, range_areia_inferior);
+      //Aplicando a textura ao objeto
+      //objeto_salvo->modificar_cor_pixel(cor_areia);
+      //cores_objeto = objeto_salvo->cor_esfera();
+			
+			
+      //Raio de sombra: qualquer primitiva entre o ponto e a luz deixa apenas a luz ambiente
+      bool em_sombra = false;
+      if (sombras){
+	Vetor para_luz = luz->posicao() - int_esfera;
+	double distancia_luz = para_luz.norma();
+	Vetor direcao_luz = para_luz / distancia_luz;
+	TesteEsfera teste_sombra;
+	teste_sombra.cena = cena;
+	teste_sombra.origem[0] = int_esfera.vx(); teste_sombra.origem[1] = int_esfera.vy(); teste_sombra.origem[2] = int_esfera.vz();
+	teste_sombra.direcao[0] = direcao_luz.vx(); teste_sombra.direcao[1] = direcao_luz.vy(); teste_sombra.direcao[2] = direcao_luz.vz();
+	teste_sombra.t_minimo = T_MINIMO_SOMBRA;
+	TesteTriangulo sombra_triangulos;
+	sombra_triangulos.tri = cena->triangulos();
+	for (int e = 0; e < 3; e++){
+	  sombra_triangulos.origem[e] = teste_sombra.origem[e];
+	  sombra_triangulos.direcao[e] = teste_sombra.direcao[e];
+	}
+	sombra_triangulos.t_minimo = T_MINIMO_SOMBRA;
+	TesteParticula sombra_particulas;
+	sombra_particulas.nuvem = cena->particulas();
+	for (int e = 0; e < 3; e++){
+	  sombra_particulas.origem[e] = teste_sombra.origem[e];
+	  sombra_particulas.direcao[e] = teste_sombra.direcao[e];
+	}
+	sombra_particulas.t_minimo = T_MINIMO_SOMBRA;
+	em_sombra = cena->algum_plano(teste_sombra.origem, teste_sombra.direcao, T_MINIMO_SOMBRA, distancia_luz) ||
+	  cena->bvh().alguma(int_esfera, direcao_luz, distancia_luz, teste_sombra) ||
+	  cena->bvh_triangulos().alguma(int_esfera, direcao_luz, distancia_luz, sombra_triangulos) ||
+	  (sombra_particulas.nuvem != NULL && sombra_particulas.nuvem->bvh().alguma(int_esfera, direcao_luz, distancia_luz, sombra_particulas));
+      }
+			
+      //Em sombra, apenas a luz ambiente; iluminado, as contribuicoes de luz red, blue e green sao calculadas com o pacote
+      if (em_sombra){
+	double ambiente = luz->calcula_luz_ambiente();
+	cor = Vetor(ambiente * cores_objeto.vx(), ambiente * cores_objeto.vy(), ambiente * cores_objeto.vz());
+	return false;
+      }
+      acertos.px[k] = int_esfera.vx(); acertos.py[k] = int_esfera.vy(); acertos.pz[k] = int_esfera.vz();
+      acertos.nx[k] = interseccao.normal.vx(); acertos.ny[k] = interseccao.normal.vy(); acertos.nz[k] = interseccao.normal.vz();
+      acertos.kd[k] = material.kd;
+      acertos.ks[k] = material.ks;
+      acertos.brilho[k] = material.brilho;
+      acertos.albedo_r[k] = cores_objeto.vx(); acertos.albedo_g[k] = cores_objeto.vy(); acertos.albedo_b[k] = cores_objeto.vz();
+      return true;
+    }
+    //pinta de background
+    cor = cena->cor_background();
+    return false;
   }
 	
   //------------------------------
   //	Metodos publicos
   //------------------------------
   /**
-   * \fn GLubyte Ray_tracing::print_imagem(Cena* cena, Luz* luz, Vetor* lookfrom, Vetor* lookat, 
-   GLdouble model[16], GLdouble proj[16], GLint view[4], GLubyte imagem[300][300][3]);
+   * \fn Ray_tracing::Ray_tracing();
    *
-   * \brief Metodo para a pintura pixel a pixel da imagem
+   * \brief Construtor da classe.
+   */
+  Ray_tracing::Ray_tracing(){
+    n_threads = 0;
+    escalonador = NULL;
+    sombras = false;
+    arenas = NULL;
+  }
+	
+  /**
+   * \fn Ray_tracing::~Ray_tracing();
+   *
+   * \brief Destrutor da classe. Encerra as threads de renderizacao.
+   */
+  Ray_tracing::~Ray_tracing(){
+    delete escalonador;
+    delete[] arenas;
+  }
+	
+  /**
+   * \fn void Ray_tracing::preparar_escalonador();
+   *
+   * \brief Cria o escalonador e as arenas dos trabalhadores.
+   */
+  void
+  Ray_tracing::preparar_escalonador(){
+    if (escalonador == NULL){
+      escalonador = new Escalonador(n_threads);
+      delete[] arenas;
+      arenas = new Arena[escalonador->trabalhadores()];
+    }
+  }
+	
+  /**
+   * \fn void Ray_tracing::atualizar_threads(int _n_threads);
+   *
+   * \brief Atualiza o numero de threads utilizadas na renderizacao. As threads sao recriadas na proxima renderizacao.
+   *
+   * \param _n_threads - numero de threads; 0 utiliza todos os processadores da maquina
+   */
+  void
+  Ray_tracing::atualizar_threads(int _n_threads){
+    if (_n_threads != n_threads){
+      n_threads = _n_threads;
+      delete escalonador;
+      escalonador = NULL;
+      delete[] arenas;
+      arenas = NULL;
+    }
+  }
+	
+  /**
+   * \fn int Ray_tracing::threads();
+   *
+   * \brief Retorna o numero de threads utilizadas na renderizacao.
+   */
+  int
+  Ray_tracing::threads(){
+    preparar_escalonador();
+    return escalonador->trabalhadores();
+  }
+	
+  /**
+   * \fn Escalonador* Ray_tracing::conjunto_threads();
+   *
+   * \brief Retorna o escalonador da renderizacao.
+   */
+  Escalonador*
+  Ray_tracing::conjunto_threads(){
+    preparar_escalonador();
+    return escalonador;
+  }
+	
+  /**
+   * \fn size_t Ray_tracing::pico_memoria_transitoria() const;
+   *
+   * \brief Retorna o maior pico de uso entre as arenas.
+   */
+  size_t
+  Ray_tracing::pico_memoria_transitoria() const{
+    size_t pico = arena_quadro.pico();
+    int n = (escalonador != NULL) ? escalonador->trabalhadores() : 0;
+    for (int k = 0; k < n; k++){
+      if (arenas[k].pico() > pico){
+	pico = arenas[k].pico();
+      }
+    }
+    return pico;
+  }
+	
+  /**
+   * \fn void Ray_tracing::atualizar_sombras(bool _sombras);
+   *
+   * \brief Liga ou desliga os raios de sombra.
+   *
+   * \param _sombras - true para tracar os raios de sombra (desligados por padrao)
+   */
+  void
+  Ray_tracing::atualizar_sombras(bool _sombras){
+    sombras = _sombras;
+  }
+	
+  /**
+   * \fn bool Ray_tracing::print_imagem(Cena* cena, const Luz* luz, const Vetor& lookfrom, const Vetor& lookat,
+   const double model[16], const double proj[16], const int view[4], Imagem& imagem);
+   *
+   * \brief Metodo para a pintura pixel a pixel da imagem. A cena e compilada (CenaCompilada) e em seguida renderizada.
    *
    * \param cena - Cena que sera aplicado o ray tracing
    * \param luz - Luz no objeto
    * \param lookfrom - posicao da camera
    * \param lookat - posicao para onde esta apontada a camera
    * \param model, proj, view - matrizes modelview, projection e viewport
-   * \param imagem - Imagem analisada
+   * \param imagem - Imagem pintada
+   *
+   * \return false se faltar memoria para compilar a cena ou se a camera nao puder ser montada das matrizes; a imagem nao e
+   * pintada.
    */
   //Metodo para a pintura pixel a pixel da imagem
-  //GLubyte
-  const GLvoid
-  Ray_tracing::print_imagem(Cena* cena, Luz* luz, Vetor* lookfrom, Vetor* lookat,
-			    GLdouble model[16], GLdouble proj[16], GLint view[4], GLubyte imagem[300][300][3]){
-    Cena* cena_auxiliar = new Cena();				//Objetivo de nao perder os objetos da cena
-    Objeto* objeto_salvo = new Objeto();				//Objeto que sera pintado
-    double t_aux;							//t calculado para o objeto pintado
-    for (int i = 0; i < cena->lado(); i++){				//lado
-      for (int j = 0; j < cena->altura(); j++){			//Altura
-	//Colocando valor absurdo para o t para primeiro valor
-	t_aux = -1.0;
-	//Encontrando lookat's
-	GLdouble x, y, z;
-	GLint realy = view[3] - (GLint)j - 1;
-	calculo_posicao_mundo((GLdouble) i, (GLdouble) realy, 1.0, model, proj, view, &x, &y, &z);
-	Vetor* lookat = new Vetor();
-	lookat->valores_vetor((double)x, (double)y, (double)z);
-		    
-	//Definicao do Raio
-	Raio* r = new Raio();
-		    
-	//Tenho que fazer com que o conteudo permaneca inalterado.
-	int tamanho = cena->size_objetos_pilha();
-		    
-	for (int k = 0; k < tamanho; k++){	//Varrendo objetos da cena
-	  //Retirando o objeto da cena
-	  Objeto* obj = cena->excluir_objetos_pilha();
-			    
-	  r->atualizar_vetores(lookfrom, lookat, obj);
-			    
-	  double t = r -> calcula_t();
-			    
-	  if (t > 0.0){		//Verificar se o t encontrado e maior que zero
-	    if (t_aux == -1.0){	//Nao tem nenhum valor maior que 0 que seja menor que -1
-	      t_aux = t;
-	      objeto_salvo = obj;
-	    }
-	    else{
-	      if (t < t_aux){		//Verificar se e menor que os t's encontrados
-		t_aux = t;
-		objeto_salvo = obj;
-	      }
-	    }
-	  }
-	  cena_auxiliar->incluir_objetos_pilha(obj);
-	}
-			
-	Cena* tmp = cena;
-	cena = cena_auxiliar;
-	cena_auxiliar = tmp;
-	//cena = cena_auxiliar;
-		    
-	if (t_aux > 0.0){	//esfera nao foi interceptada
-	  //atualizando o raio
-	  r->atualizar_vetores(lookfrom, lookat, objeto_salvo);
-			  
-	  //Interseccao com a esfera
-	  Vetor* int_esfera = new Vetor();
-	  int_esfera = r->interseccao_esfera(t_aux);
-		      
-	  //Atualiza a luz
-	  luz->atualizar_vetores_auxiliares(int_esfera, objeto_salvo->posicao_esfera(), lookfrom);
-			  
-	  //Pegando o valor da contribuicao red, blue e green do objeto
-	  Vetor* cores_objeto = new Vetor();
-			  
-	  //
-	  //	Textura fixa - definido no main
-	  //
-	  cores_objeto = objeto_salvo->cor_esfera();	//Determina uma cor fixa para toda a esfera
-			  
-	  //
-	  //	Textura variavel com o pixel - Aplicando textura em cada pixel da esfera
-	  //
-	  //Limites da cor do objeto
-	  //Vetor* range_areia_superior = new Vetor();	//Vetor de limite superior da cor
-	  //range_areia_superior->valores_vetor(223.0, 246.0, 143.0);
-	  //Vetor* range_areia_inferior = new Vetor();	//Vetor de limite inferior da cor
-	  //range_areia_inferior->valores_vetor(139.0, 129.0, 76.0);
-	  //Textura* cor_areia = new Textura(range_areia_superior, range_areia_inferior);
-	  //Aplicando a textura ao objeto
-	  //objeto_salvo->modificar_cor_pixel(cor_areia);
-	  //cores_objeto = objeto_salvo->cor_esfera();
-			  
-			  
-	  //Calculando as contribuicoes de luz red, blue e green para o determinado pixel
-	  Vetor* cor_luz = new Vetor();
-	  double valor_luz_vermelha = luz->calcula_luz_red();
-	  double valor_luz_verde = luz->calcula_luz_green();
-	  double valor_luz_azul = luz->calcula_luz_blue();
-	  cor_luz->valores_vetor(valor_luz_vermelha, valor_luz_verde, valor_luz_azul);
-			  
-	  //criando o dado			  
-	  imagem[i][j][0] = (GLubyte)(cor_luz->vx() * (cores_objeto->vx()/cores_objeto->norma()));
-	  imagem[i][j][1] = (GLubyte)(cor_luz->vy() * (cores_objeto->vy()/cores_objeto->norma()));
-	  imagem[i][j][2] = (GLubyte)(cor_luz->vz() * (cores_objeto->vz()/cores_objeto->norma()));
-	}
-	else{
-	  //pinta de background
-	  imagem[i][j][0] = (GLubyte)cena->cor_background_r();
-	  imagem[i][j][1] = (GLubyte)cena->cor_background_g();
-	  imagem[i][j][2] = (GLubyte)cena->cor_background_b();
-	}
+  bool
+  Ray_tracing::print_imagem(Cena* cena, const Luz* luz, const Vetor& lookfrom, const Vetor& lookat,
+			    const double model[16], const double proj[16], const int view[4], Imagem& imagem){
+    CenaCompilada cena_compilada;
+    if (!cena_compilada.compilar(cena)){
+      return false;
+    }
+    return print_imagem(cena_compilada, luz, lookfrom, model, proj, view, imagem);
+  }
+	
+  /**
+   * \fn bool Ray_tracing::print_imagem(const CenaCompilada& cena, const Luz* luz, const Vetor& lookfrom,
+   const double model[16], const double proj[16], const int view[4], Imagem& imagem);
+   *
+   * \brief Metodo para a pintura pixel a pixel de uma cena ja compilada a partir das matrizes do OpenGL. A camera e montada uma
+   * unica vez a partir das matrizes, no lugar de um gluUnProject (e uma inversao de matriz) por pixel, com os pontos de mundo no
+   * plano distante (winZ = 1.0).
+   *
+   * \param cena - Cena compilada que sera aplicado o ray tracing (apenas lida)
+   * \param luz - Luz no objeto
+   * \param lookfrom - posicao da camera
+   * \param model, proj, view - matrizes modelview, projection e viewport
+   * \param imagem - Imagem pintada
+   *
+   * \return false se (projection * modelview) nao for inversivel, caso em que a imagem nao e pintada, ou se faltar memoria para o
+   * quadro (ver print_imagem com Camera).
+   */
+  bool
+  Ray_tracing::print_imagem(const CenaCompilada& cena, const Luz* luz, const Vetor& lookfrom,
+			    const double model[16], const double proj[16], const int view[4], Imagem& imagem){
+    Camera camera;
+    if (!camera.de_matrizes(lookfrom, model, proj, view, 1.0)){
+      return false;
+    }
+    return print_imagem(cena, luz, camera, imagem);
+  }
+	
+  /**
+   * \fn bool Ray_tracing::print_imagem(const CenaCompilada& cena, const Luz* luz, const Camera& camera, Imagem& imagem);
+   *
+   * \brief Metodo para a pintura pixel a pixel de uma cena ja compilada. A imagem e dividida em ladrilhos de TAMANHO_LADRILHO x
+   * TAMANHO_LADRILHO pixels que sao distribuidos entre as threads do escalonador. Cada pixel depende apenas da cena, da luz e da
+   * camera, portanto a imagem resultante nao depende do numero de threads. O termo \f$ |O - C|^2 - r^2 \f$ de cada esfera, que so
+   * depende da posicao da camera, e calculado uma unica vez por quadro. Se as dimensoes da imagem forem diferentes das da cena, a
+   * imagem e realocada, mantendo o seu formato.
+   *
+   * \param cena - Cena compilada que sera aplicado o ray tracing (apenas lida)
+   * \param luz - Luz no objeto
+   * \param camera - Camera do quadro
+   * \param imagem - Imagem pintada
+   *
+   * \return false se faltar memoria (ver print_imagem_passada); a imagem fica incompleta.
+   */
+  bool
+  Ray_tracing::print_imagem(const CenaCompilada& cena, const Luz* luz, const Camera& camera, Imagem& imagem){
+    return print_imagem_passada(cena, luz, camera, imagem, 1, 0);
+  }
+	
+  /**
+   * \fn bool Ray_tracing::print_imagem_passada(const CenaCompilada& cena, const Luz* luz, const Camera& camera, Imagem& imagem,
+   int passo, int passo_anterior);
+   *
+   * \brief Uma passada da renderizacao progressiva. Os ladrilhos sao os mesmos de print_imagem; cada trabalhador traca apenas os
+   * pixels novos da grade de passo do seu ladrilho e os replica no seu bloco. Se nao houver memoria para realocar a imagem ou, na
+   * arena do quadro, para os termos das esferas, nada e pintado; se a arena de um trabalhador nao tiver memoria para os buffers de
+   * um ladrilho, apenas esse ladrilho nao e pintado.
+   *
+   * \param passo - passo da grade desta passada (1 traca todos os pixels)
+   * \param passo_anterior - passo da passada anterior, multiplo de passo (0 na primeira passada)
+   *
+   * \return false se faltar memoria para a imagem, para o quadro ou para algum ladrilho.
+   */
+  bool
+  Ray_tracing::print_imagem_passada(const CenaCompilada& cena, const Luz* luz, const Camera& camera, Imagem& imagem, int passo,
+				    int passo_anterior){
+    if (imagem.largura() != cena.lado() || imagem.altura() != cena.altura()){
+      if (!imagem.alocar(cena.lado(), cena.altura(), imagem.formato())){
+	return false;
       }
     }
-    //return imagem;
-    return;
+    preparar_escalonador();
+		
+    //Termos das esferas que dependem apenas da camera
+    const Vetor& lookfrom = camera.posicao();
+    int n_esferas = cena.numero_esferas();
+    double* termos_c = arena_quadro.alocar_vetor<double>(n_esferas);
+    int* perdidos = arena_quadro.alocar_vetor<int>(escalonador->trabalhadores());
+    if (termos_c == NULL || perdidos == NULL){
+      arena_quadro.reiniciar();
+      return false;
+    }
+    const double* cx = cena.centros_x();
+    const double* cy = cena.centros_y();
+    const double* cz = cena.centros_z();
+    const double* r2 = cena.raios2();
+    for (int k = 0; k < n_esferas; k++){
+      double ocx = lookfrom.vx() - cx[k], ocy = lookfrom.vy() - cy[k], ocz = lookfrom.vz() - cz[k];
+      termos_c[k] = ocx * ocx + ocy * ocy + ocz * ocz - r2[k];
+    }
+		
+    TarefaLadrilhos tarefa;
+    tarefa.ray_tracing = this;
+    tarefa.cena = &cena;
+    tarefa.luz = luz;
+    tarefa.termos_c = termos_c;
+    tarefa.lookfrom = &lookfrom;
+    tarefa.camera = &camera;
+    tarefa.altura_janela = cena.altura();
+    tarefa.imagem = &imagem;
+    tarefa.ladrilhos_lado = (cena.lado() + TAMANHO_LADRILHO - 1) / TAMANHO_LADRILHO;
+    tarefa.passo = passo;
+    tarefa.arenas = arenas;
+    tarefa.perdidos = perdidos;
+    for (int k = 0; k < escalonador->trabalhadores(); k++){
+      perdidos[k] = 0;
+    }
+    tarefa.passo_anterior = passo_anterior;
+    int ladrilhos_altura = (cena.altura() + TAMANHO_LADRILHO - 1) / TAMANHO_LADRILHO;
+		
+    escalonador->executar(&tarefa, tarefa.ladrilhos_lado * ladrilhos_altura);
+    int n_perdidos = 0;
+    for (int k = 0; k < escalonador->trabalhadores(); k++){
+      n_perdidos += perdidos[k];
+    }
+    arena_quadro.reiniciar();
+    return n_perdidos == 0;
   }
 	
 } //Fim do namespace rayTracing
@@ -24,21 +24,11 @@
 #include "luz.hpp"			//rayTracing::Luz
 #include "objeto.hpp"		//rayTracing::Objeto
 #include "cena.hpp"			//rayTracing::Cena
-
-#ifdef __unix__  // Unix
-#include <GL/gl.h>  //GLdouble, Glint, glDrawPixels
-#include <GL/glu.h>
-#include <GL/glut.h> //gluUnProject
-#else // Apple
-#include <OpenGL/gl.h>
-#include <OpenGL/glu.h>
-#include <GLUT/glut.h>
-#endif
-/*#else  // Windows
-#include <w32api/GL/gl.h> //GLdouble, Glint, glDrawPixels
-#include <w32api/GL/glu.h>
-#include <w32api/GL/glut.h> //gluUnProject
-#endif*/
+#include "escalonador.hpp"		//rayTracing::Escalonador
+#include "camera.hpp"			//rayTracing::Camera
+#include "cena_compilada.hpp"		//rayTracing::CenaCompilada
+#include "imagem.hpp"			//rayTracing::Imagem
+#include "arena.hpp"			//rayTracing::Arena
 
 /** 
  * \defgroup RayTracingNameSpace Namespace rayTracing.
@@ -51,6 +41,14 @@
  * \brief O espaco de nomes rayTracing contem todas os arquivos que sao utilizados para sua implementacao.
  */
 namespace rayTracing{
+  class TarefaLadrilhos;
+
+  /**
+   * \brief Passos das passadas da renderizacao progressiva: 1 pixel em 16, depois 1 em 4 e por fim todos.
+   */
+  const int PASSOS_PROGRESSIVOS[] = { 4, 2, 1 };
+  const int N_PASSOS_PROGRESSIVOS = 3;
+
   /**
    * \class Ray_tracing
    * 
@@ -61,42 +59,177 @@ namespace rayTracing{
     //	Atributos privados
     //------------------------------
   private:
+    int n_threads;		///< Numero de threads pedido (0 utiliza todos os processadores)
+    Escalonador* escalonador;	///< Conjunto de threads que renderiza os ladrilhos
+    bool sombras;		///< Indica se os raios de sombra sao tracados
+    Arena* arenas;		///< Arena de cada trabalhador, reiniciada ao fim de cada ladrilho
+    Arena arena_quadro;		///< Arena dos dados de um quadro, reiniciada ao fim de cada quadro
+		
     /**
-     * \fn void calculo_posicao_mundo(GLdouble winX, GLdouble winY, GLdouble winZ,
-     * GLdouble model[16], GLdouble proj[16], GLint view[4],
-     * GLdouble* objX, GLdouble* objY, GLdouble* objZ);
+     * \fn void preparar_escalonador();
      *
-     * \brief Metodo que calcula as posicoes de mundo atraves da funcao gluUnProject
+     * \brief Cria o escalonador, se ainda nao existir, e uma arena para cada um dos seus trabalhadores.
+     */
+    void preparar_escalonador();
+		
+    /**
+     * \fn bool preparar_pixel(const CenaCompilada* cena, const Luz* luz, const Vetor& lookfrom, const Vetor& direcao,
+     * double t, IdPrimitiva primitiva, AcertosPacote& acertos, int k, Vetor& cor);
      *
-     * \param winX, winY, winZ - coordenadas da janela
-     * \param model, proj, view - matrizes modelview, projection e viewport.
-     * \param objX, objY, objZ - coordenadas do objeto
+     * \brief Prepara o raio k de um pacote para o sombreamento a partir da interseccao do seu raio primario, ja encontrada pelo
+     * pacote: traca o raio de sombra e copia o ponto, a normal e o material para acertos. A cena e a luz sao apenas lidas, de modo
+     * que varios pixels podem ser preparados ao mesmo tempo.
+     *
+     * \param cena - Cena compilada que sera aplicado o ray tracing
+     * \param luz - Luz no objeto
+     * \param lookfrom - posicao da camera
+     * \param direcao - direcao normalizada do raio primario
+     * \param t - distancia ate a interseccao
+     * \param primitiva - primitiva interceptada (PRIMITIVA_NENHUMA se o raio nao atingiu nada)
+     * \param acertos - interseccoes do pacote
+     * \param k - posicao do raio no pacote
+     * \param cor - cor final do pixel, se ele nao e sombreado pelo pacote (fundo ou luz ambiente)
+     *
+     * \return true se o ponto e iluminado e deve ser sombreado por sombrear_pacote.
      */
-    void calculo_posicao_mundo(GLdouble winX, GLdouble winY, GLdouble winZ,
-			       const GLdouble model[16], const GLdouble proj[16], const GLint view[4],
-			       GLdouble* objX, GLdouble* objY, GLdouble* objZ);
+    bool preparar_pixel(const CenaCompilada* cena, const Luz* luz, const Vetor& lookfrom, const Vetor& direcao,
+			double t, IdPrimitiva primitiva, AcertosPacote& acertos, int k, Vetor& cor);
 									   
+    //Copia nao permitida
+    Ray_tracing(const Ray_tracing&);
+    Ray_tracing& operator=(const Ray_tracing&);
+		
+    friend class TarefaLadrilhos;
+		
     //GLubyte imagem[300][300][3];
     //------------------------------
     //	Metodos publicos
     //------------------------------
   public:
     /**
-     * \fn GLubyte print_imagem(Cena* cena, Luz* luz, Vetor* lookfrom, Vetor* lookat, 
-     * GLdouble model[16], GLdouble proj[16], GLint view[4], GLubyte imagem[300][300][3]);
+     * \fn Ray_tracing();
+     *
+     * \brief Construtor da classe.
+     */
+    Ray_tracing();
+		
+    /**
+     * \fn ~Ray_tracing();
+     *
+     * \brief Destrutor da classe. Encerra as threads de renderizacao.
+     */
+    ~Ray_tracing();
+		
+    /**
+     * \fn void atualizar_threads(int _n_threads);
+     *
+     * \brief Atualiza o numero de threads utilizadas na renderizacao.
+     *
+     * \param _n_threads - numero de threads; 0 utiliza todos os processadores da maquina
+     */
+    void atualizar_threads(int _n_threads);
+		
+    /**
+     * \fn int threads();
+     *
+     * \brief Retorna o numero de threads utilizadas na renderizacao.
+     */
+    int threads();
+		
+    /**
+     * \fn Escalonador* conjunto_threads();
+     *
+     * \brief Retorna as threads da renderizacao, criando-as se necessario, para que outras tarefas (como a construcao das BVHs) as
+     * reutilizem. O ponteiro deixa de valer quando o numero de threads muda.
+     */
+    Escalonador* conjunto_threads();
+		
+    /**
+     * \fn void atualizar_sombras(bool _sombras);
+     *
+     * \brief Liga ou desliga os raios de sombra. Com as sombras ligadas, um ponto que nao enxerga a luz recebe apenas a luz ambiente.
+     *
+     * \param _sombras - true para tracar os raios de sombra (desligados por padrao)
+     */
+    void atualizar_sombras(bool _sombras);
+		
+    /**
+     * \fn bool print_imagem(Cena* cena, const Luz* luz, const Vetor& lookfrom, const Vetor& lookat,
+     * const double model[16], const double proj[16], const int view[4], Imagem& imagem);
      *
-     * \brief Metodo para a pintura pixel a pixel da imagem
+     * \brief Metodo para a pintura pixel a pixel da imagem. A cena e compilada (CenaCompilada) e em seguida renderizada.
      *
      * \param cena - Cena que sera aplicado o ray tracing
      * \param luz - Luz no objeto
      * \param lookfrom - posicao da camera
      * \param lookat - posicao para onde esta apontada a camera
      * \param model, proj, view - matrizes modelview, projection e viewport
-     * \param imagem - Imagem analisada
+     * \param imagem - Imagem pintada
+     *
+     * \return false se faltar memoria para compilar a cena ou para o quadro, ou se a camera nao puder ser montada das matrizes; a
+     * imagem nao e pintada ou fica incompleta.
      */
     //Metodo para a pintura pixel a pixel da imagem
-    const GLvoid print_imagem(Cena* cena, Luz* luz, Vetor* lookfrom, Vetor* lookat,
-			      GLdouble model[16], GLdouble proj[16], GLint view[4], GLubyte imagem[300][300][3]);
+    bool print_imagem(Cena* cena, const Luz* luz, const Vetor& lookfrom, const Vetor& lookat,
+		      const double model[16], const double proj[16], const int view[4], Imagem& imagem);
+		
+    /**
+     * \fn bool print_imagem(const CenaCompilada& cena, const Luz* luz, const Vetor& lookfrom,
+     * const double model[16], const double proj[16], const int view[4], Imagem& imagem);
+     *
+     * \brief Metodo para a pintura pixel a pixel de uma cena ja compilada a partir das matrizes do OpenGL. As matrizes sao
+     * convertidas em uma Camera uma unica vez por quadro.
+     *
+     * \param cena - Cena compilada que sera aplicado o ray tracing (apenas lida)
+     * \param luz - Luz no objeto
+     * \param lookfrom - posicao da camera
+     * \param model, proj, view - matrizes modelview, projection e viewport
+     * \param imagem - Imagem pintada
+     *
+     * \return false se (projection * modelview) nao for inversivel ou se faltar memoria para o quadro.
+     */
+    bool print_imagem(const CenaCompilada& cena, const Luz* luz, const Vetor& lookfrom,
+		      const double model[16], const double proj[16], const int view[4], Imagem& imagem);
+
+    /**
+     * \fn bool print_imagem(const CenaCompilada& cena, const Luz* luz, const Camera& camera, Imagem& imagem);
+     *
+     * \brief Metodo para a pintura pixel a pixel de uma cena ja compilada. A imagem e dividida em ladrilhos que sao pintados em
+     * paralelo; o resultado nao depende do numero de threads. Nao depende de um contexto OpenGL. Se as dimensoes da imagem forem
+     * diferentes das da cena, a imagem e realocada, mantendo o seu formato.
+     *
+     * \param cena - Cena compilada que sera aplicado o ray tracing (apenas lida)
+     * \param luz - Luz no objeto
+     * \param camera - Camera do quadro (a linha y = 0 da janela e a ultima linha da imagem)
+     * \param imagem - Imagem pintada
+     *
+     * \return false se faltar memoria para realocar a imagem ou nas arenas; o quadro (ou apenas os ladrilhos afetados) nao e pintado.
+     */
+    bool print_imagem(const CenaCompilada& cena, const Luz* luz, const Camera& camera, Imagem& imagem);
+
+    /**
+     * \fn bool print_imagem_passada(const CenaCompilada& cena, const Luz* luz, const Camera& camera, Imagem& imagem, int passo,
+     * int passo_anterior);
+     *
+     * \brief Uma passada da renderizacao progressiva: apenas os pixels (x, y) com x e y multiplos de passo sao tracados, e cada um e
+     * copiado para o seu bloco passo x passo (vizinho mais proximo). Os pixels da grade de passo_anterior ja foram tracados pela
+     * passada anterior e nao sao tracados de novo, de modo que as passadas PASSOS_PROGRESSIVOS, uma apos a outra, tracam cada pixel
+     * uma unica vez e a ultima imagem e identica a de print_imagem.
+     *
+     * \param passo - passo da grade desta passada (1 traca todos os pixels)
+     * \param passo_anterior - passo da passada anterior, multiplo de passo (0 na primeira passada)
+     *
+     * \return false se faltar memoria, como em print_imagem.
+     */
+    bool print_imagem_passada(const CenaCompilada& cena, const Luz* luz, const Camera& camera, Imagem& imagem, int passo,
+			      int passo_anterior);
+
+    /**
+     * \fn size_t pico_memoria_transitoria() const;
+     *
+     * \brief Retorna o maior pico de uso (em bytes) entre as arenas dos trabalhadores e a arena do quadro.
+     */
+    size_t pico_memoria_transitoria() const;
     /* GLubyte print_imagem(Cena* cena, Luz* luz, Vetor* lookfrom, Vetor* lookat,
        GLdouble model[16], GLdouble proj[16], GLint view[4]); */
     /* GLvoid* print_imagem(Cena* cena, Luz* luz, Vetor* lookfrom, Vetor* lookat,
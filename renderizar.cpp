@@ -0,0 +1,359 @@
+/**
+ * \file renderizar.cpp
+ *
+ * \brief Renderizador de linha de comando: pinta a cena de demonstracao, ou a cena descrita em um arquivo .cena, sem janela e sem
+ * OpenGL e grava o resultado em um arquivo PPM. Usa a mesma camera que o visualizador, de modo que a 300 x 300 pixels a imagem e a mesma que aparece na janela.
+ *
+ * Uso: ./renderizar [--cena arquivo.cena] [--largura N] [--altura N] [--threads N] [--sombras] [--nucleos escalar|sse4|avx2|avx512]
+ *                   [--formato rgb8|rgba8|float] [--progressivo] [--obj malha.obj] [--escala-obj S] [--posicao-obj X Y Z]
+ *                   [--cache-obj malha.cache] [--particulas arquivo.bin|arquivo.csv] [--cor-particulas] [--quantizar-particulas]
+ *                   [--bvh sah|morton] [--bins-bvh N] [--largura-bvh 2|4|8] [--saida arquivo.ppm]
+ *
+ * \author
+ * Petrucio Ricardo Tavares de Medeiros \n
+ * Universidade Federal do Rio Grande do Norte \n
+ * Departamento de Computacao e Automacao Industrial \n
+ * petrucior at gmail (dot) com
+ *
+ * \version 0.1
+ * \date Outubro 2013
+ */
+
+#include <iostream> //std::endl, std::cerr e std::cout
+#include <cstdlib> //atoi e atof
+#include <cstring> //strcmp
+#include <sys/time.h> //gettimeofday
+#include "cena_exemplo.hpp" //rayTracing::CenaExemplo
+#include "cena_compilada.hpp" //rayTracing::CenaCompilada
+#include "camera.hpp" //rayTracing::Camera
+#include "ray_tracing.hpp" //rayTracing::Ray_tracing
+#include "nucleos.hpp" //rayTracing::selecionar_nucleos
+#include "imagem.hpp" //rayTracing::Imagem
+#include "leitor_obj.hpp" //rayTracing::carregar_obj
+#include "cache_malha.hpp" //rayTracing::MalhaMapeada
+#include "leitor_cena.hpp" //rayTracing::DescricaoCena
+#include "particulas.hpp" //rayTracing::NuvemParticulas
+
+using rayTracing::CenaExemplo;
+using rayTracing::CenaCompilada;
+using rayTracing::Camera;
+using rayTracing::Ray_tracing;
+using rayTracing::selecionar_nucleos;
+using rayTracing::nucleos_ativos;
+using rayTracing::Imagem;
+using rayTracing::FormatoPixel;
+using rayTracing::Vetor;
+using rayTracing::ArmazemPrimitivas;
+using rayTracing::MalhaMapeada;
+using rayTracing::DescricaoCena;
+using rayTracing::NuvemParticulas;
+using rayTracing::Cena;
+using rayTracing::Luz;
+using rayTracing::BVH;
+using rayTracing::OpcoesBVH;
+using rayTracing::EstatisticasBVH;
+
+/**
+ * \fn double relogio();
+ *
+ * \brief Retorna o tempo de parede em segundos.
+ */
+double relogio(){
+  struct timeval agora;
+  gettimeofday(&agora, NULL);
+  return agora.tv_sec + agora.tv_usec * 1e-6;
+}
+
+/**
+ * \fn void informar_bvh(const char* nome, const BVH& bvh);
+ *
+ * \brief Escreve as estatisticas da construcao de uma BVH.
+ */
+void informar_bvh(const char* nome, const BVH& bvh){
+  const EstatisticasBVH& e = bvh.estatisticas();
+  if (e.threads == 0){
+    std::cout << "bvh " << nome << ": " << e.nos << " nos (cache mapeado)";
+    if (e.largura > 2){
+      std::cout << ", " << e.nos_largos << " nos de " << e.largura << " filhos";
+    }
+    std::cout << std::endl;
+    return;
+  }
+  std::cout << "bvh " << nome << ": " << e.nos << " nos, " << e.folhas << " folhas, profundidade " << e.profundidade
+	    << ", custo SAH " << e.custo_sah << ", " << e.segundos << " segundos, " << e.threads << " threads";
+  if (e.largura > 2){
+    std::cout << ", " << e.nos_largos << " nos de " << e.largura << " filhos";
+  }
+  std::cout << ", " << bvh.bytes_nos() / 1024.0 << " KiB de nos" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  const char* arquivo_cena = NULL; //Cena descrita em arquivo (NULL renderiza a cena de demonstracao)
+  int largura = 0, altura = 0; //Dimensoes da imagem (0 usa as da cena; 300 x 300 na cena de demonstracao)
+  int numero_threads = -1; //Numero de threads da renderizacao (0 utiliza todos os processadores, -1 usa o da cena)
+  bool tracar_sombras = false; //Indica se os raios de sombra sao tracados
+  const char* nome_nucleos = NULL; //Variante dos nucleos vetoriais pedida (NULL escolhe pelo processador)
+  FormatoPixel formato = rayTracing::FORMATO_RGB8;
+  const char* saida = "imagem.ppm";
+  bool progressivo = false; //Renderiza pelas passadas progressivas, informando o tempo de cada uma
+  const char* malha = NULL; //Arquivo OBJ incluido na cena de demonstracao
+  double escala_malha = 1.0;
+  Vetor posicao_malha;
+  const char* cache_malha = NULL; //Arquivo de cache binario da malha (mapeado nas execucoes seguintes)
+  const char* particulas = NULL; //Arquivo de particulas (binario ou CSV) incluido na cena
+  bool cor_particulas = false; //Registros binarios com cor
+  bool quantizar_particulas = false; //Particulas guardadas em 16 bits
+  OpcoesBVH opcoes_bvh; //Construcao das BVHs
+
+  for (int i = 1; i < argc; i++){
+    if (strcmp(argv[i], "--cena") == 0 && i + 1 < argc){
+      arquivo_cena = argv[++i];
+    }
+    else if (strcmp(argv[i], "--largura") == 0 && i + 1 < argc){
+      largura = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--altura") == 0 && i + 1 < argc){
+      altura = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc){
+      numero_threads = atoi(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--sombras") == 0){
+      tracar_sombras = true;
+    }
+    else if (strcmp(argv[i], "--nucleos") == 0 && i + 1 < argc){
+      nome_nucleos = argv[++i];
+    }
+    else if (strcmp(argv[i], "--formato") == 0 && i + 1 < argc){
+      i++;
+      if (strcmp(argv[i], "rgb8") == 0) formato = rayTracing::FORMATO_RGB8;
+      else if (strcmp(argv[i], "rgba8") == 0) formato = rayTracing::FORMATO_RGBA8;
+      else if (strcmp(argv[i], "float") == 0) formato = rayTracing::FORMATO_RGB_FLOAT;
+      else{
+	std::cerr << "formato desconhecido: " << argv[i] << std::endl;
+	return 1;
+      }
+    }
+    else if (strcmp(argv[i], "--progressivo") == 0){
+      progressivo = true;
+    }
+    else if (strcmp(argv[i], "--obj") == 0 && i + 1 < argc){
+      malha = argv[++i];
+    }
+    else if (strcmp(argv[i], "--escala-obj") == 0 && i + 1 < argc){
+      escala_malha = atof(argv[++i]);
+    }
+    else if (strcmp(argv[i], "--posicao-obj") == 0 && i + 3 < argc){
+      posicao_malha = Vetor(atof(argv[i + 1]), atof(argv[i + 2]), atof(argv[i + 3]));
+      i += 3;
+    }
+    else if (strcmp(argv[i], "--cache-obj") == 0 && i + 1 < argc){
+      cache_malha = argv[++i];
+    }
+    else if (strcmp(argv[i], "--particulas") == 0 && i + 1 < argc){
+      particulas = argv[++i];
+    }
+    else if (strcmp(argv[i], "--cor-particulas") == 0){
+      cor_particulas = true;
+    }
+    else if (strcmp(argv[i], "--quantizar-particulas") == 0){
+      quantizar_particulas = true;
+    }
+    else if (strcmp(argv[i], "--bvh") == 0 && i + 1 < argc){
+      i++;
+      if (strcmp(argv[i], "sah") == 0) opcoes_bvh.metodo = rayTracing::BVH_SAH;
+      else if (strcmp(argv[i], "morton") == 0) opcoes_bvh.metodo = rayTracing::BVH_MORTON;
+      else{
+	std::cerr << "metodo de construcao da bvh desconhecido: " << argv[i] << std::endl;
+	return 1;
+      }
+    }
+    else if (strcmp(argv[i], "--bins-bvh") == 0 && i + 1 < argc){
+      opcoes_bvh.bins = atoi(argv[++i]);
+      if (opcoes_bvh.bins < 2 || opcoes_bvh.bins > rayTracing::BINS_BVH_MAXIMO){
+	std::cerr << "--bins-bvh deve estar entre 2 e " << rayTracing::BINS_BVH_MAXIMO << std::endl;
+	return 1;
+      }
+    }
+    else if (strcmp(argv[i], "--largura-bvh") == 0 && i + 1 < argc){
+      opcoes_bvh.largura = atoi(argv[++i]);
+      if (opcoes_bvh.largura != 2 && opcoes_bvh.largura != 4 && opcoes_bvh.largura != rayTracing::LARGURA_BVH_MAXIMA){
+	std::cerr << "--largura-bvh deve ser 2, 4 ou " << rayTracing::LARGURA_BVH_MAXIMA << std::endl;
+	return 1;
+      }
+    }
+    else if (strcmp(argv[i], "--saida") == 0 && i + 1 < argc){
+      saida = argv[++i];
+    }
+    else{
+      std::cerr << "uso: " << argv[0] << " [--cena arquivo.cena] [--largura N] [--altura N] [--threads N] [--sombras]"
+		<< " [--nucleos escalar|sse4|avx2|avx512] [--formato rgb8|rgba8|float] [--progressivo]"
+		<< " [--obj malha.obj] [--escala-obj S] [--posicao-obj X Y Z] [--cache-obj malha.cache]"
+		<< " [--particulas arquivo.bin|arquivo.csv] [--cor-particulas] [--quantizar-particulas] [--bvh sah|morton] [--bins-bvh N]"
+		<< " [--largura-bvh 2|4|8] [--saida arquivo.ppm]" << std::endl;
+      return 1;
+    }
+  }
+  //As opcoes da linha de comando prevalecem sobre as da cena
+  DescricaoCena descricao;
+  if (arquivo_cena != NULL){
+    double inicio_cena = relogio();
+    if (!descricao.carregar(arquivo_cena)){
+      std::cerr << arquivo_cena << ":" << descricao.linha_erro() << ": " << descricao.mensagem_erro() << std::endl;
+      return 1;
+    }
+    std::cout << "cena: " << descricao.cena()->primitivas().numero_primitivas() << " primitivas em " << (relogio() - inicio_cena)
+	      << " segundos" << std::endl;
+    if (largura == 0) largura = descricao.lado();
+    if (altura == 0) altura = descricao.altura();
+    if (numero_threads < 0) numero_threads = descricao.threads();
+    tracar_sombras = tracar_sombras || descricao.sombras();
+  }
+  if (largura == 0) largura = 300;
+  if (altura == 0) altura = 300;
+  if (numero_threads < 0) numero_threads = 0;
+  if (largura <= 0 || altura <= 0){
+    std::cerr << "dimensoes invalidas: " << largura << "x" << altura << std::endl;
+    return 1;
+  }
+  selecionar_nucleos(nome_nucleos);
+
+  //As BVHs sao construidas com as threads da renderizacao
+  Ray_tracing obj_ray_tracing;
+  obj_ray_tracing.atualizar_threads(numero_threads);
+  obj_ray_tracing.atualizar_sombras(tracar_sombras);
+  opcoes_bvh.escalonador = obj_ray_tracing.conjunto_threads();
+
+  CenaExemplo* exemplo = NULL;
+  Cena* cena_montada;
+  const Luz* luz;
+  if (arquivo_cena != NULL){
+    cena_montada = descricao.cena();
+    cena_montada->dimensao_imagem(largura, altura);
+    luz = descricao.luz();
+  }
+  else{
+    exemplo = new CenaExemplo(largura, altura);
+    if (!exemplo->montada()){
+      std::cerr << "sem memoria para montar a cena de demonstracao" << std::endl;
+      return 1;
+    }
+    cena_montada = exemplo->cena();
+    luz = exemplo->luz();
+  }
+  MalhaMapeada malha_mapeada; //Deve existir enquanto a cena compilada for usada
+  int material_malha = -1;
+  if (malha != NULL){
+    ArmazemPrimitivas& armazem = cena_montada->primitivas();
+    //A malha mapeada ocupa a BVH dos triangulos da cena compilada, portanto nao pode somar-se aos triangulos da cena
+    if (cache_malha != NULL && armazem.numero_triangulos() > 0){
+      std::cerr << "--cache-obj nao pode ser usado com uma cena que ja tem triangulos" << std::endl;
+      return 1;
+    }
+    material_malha = armazem.incluir_material(Vetor(200.0, 200.0, 200.0), 0.3, 0.3);
+    if (material_malha < 0){
+      std::cerr << "sem memoria para o material da malha" << std::endl;
+      return 1;
+    }
+    int linha = 0;
+    const char* mensagem = NULL;
+    bool do_cache = false;
+    double inicio_malha = relogio();
+    bool carregada = (cache_malha != NULL) ?
+      rayTracing::carregar_obj_cache(malha, cache_malha, malha_mapeada, escala_malha, posicao_malha, &do_cache, &linha, &mensagem) :
+      rayTracing::carregar_obj(malha, armazem, material_malha, escala_malha, posicao_malha, &linha, &mensagem);
+    if (!carregada){
+      std::cerr << malha << ":" << linha << ": " << mensagem << std::endl;
+      return 1;
+    }
+    int triangulos = malha_mapeada.aberta() ? malha_mapeada.numero_triangulos() : armazem.numero_triangulos();
+    std::cout << "malha: " << triangulos << " triangulos em " << (relogio() - inicio_malha) << " segundos"
+	      << (do_cache ? " (cache mapeado)" : "") << std::endl;
+  }
+  NuvemParticulas nuvem; //Deve existir enquanto a cena compilada for usada
+  if (particulas != NULL){
+    ArmazemPrimitivas& armazem = cena_montada->primitivas();
+    int material_particulas = armazem.incluir_material(Vetor(200.0, 200.0, 200.0), 0.3, 0.3);
+    if (material_particulas < 0){
+      std::cerr << "sem memoria para o material das particulas" << std::endl;
+      return 1;
+    }
+    double inicio_particulas = relogio();
+    if (!nuvem.carregar(particulas, armazem, material_particulas, quantizar_particulas, cor_particulas, opcoes_bvh)){
+      std::cerr << particulas << ":" << nuvem.linha_erro() << ": " << nuvem.mensagem_erro() << std::endl;
+      return 1;
+    }
+    std::cout << "particulas: " << nuvem.numero_particulas() << " em " << (relogio() - inicio_particulas) << " segundos, "
+	      << (double) nuvem.bytes() / nuvem.numero_particulas() << " bytes por particula"
+	      << (nuvem.quantizada() ? " (quantizadas)" : "") << std::endl;
+  }
+  CenaCompilada cena;
+  if (!cena.compilar(cena_montada, opcoes_bvh)){
+    std::cerr << "sem memoria para compilar a cena" << std::endl;
+    return 1;
+  }
+  if (malha_mapeada.aberta() && !cena.anexar_malha(malha_mapeada, material_malha, opcoes_bvh)){
+    if (cena.numero_triangulos() > 0){
+      std::cerr << "--cache-obj nao pode ser usado com uma cena que ja tem triangulos" << std::endl;
+    }
+    else{
+      std::cerr << "sem memoria para anexar a malha" << std::endl;
+    }
+    return 1;
+  }
+  if (nuvem.numero_particulas() > 0){
+    cena.anexar_particulas(nuvem);
+  }
+  informar_bvh("esferas", cena.bvh());
+  if (cena.bvh_triangulos().numero_nos() > 0){
+    informar_bvh("triangulos", cena.bvh_triangulos());
+  }
+  if (nuvem.numero_particulas() > 0){
+    informar_bvh("particulas", nuvem.bvh());
+  }
+  Camera camera;
+  if (exemplo != NULL){
+    camera.de_janela_ortografica(exemplo->lookfrom(), largura, altura);
+  }
+  else if (!descricao.montar_camera(camera, descricao.lookfrom(), largura, altura)){
+    std::cerr << "camera invalida para a imagem " << largura << "x" << altura << std::endl;
+    return 1;
+  }
+
+  Imagem imagem;
+  if (!imagem.alocar(largura, altura, formato)){
+    std::cerr << "sem memoria para a imagem " << largura << "x" << altura << std::endl;
+    return 1;
+  }
+
+  double inicio = relogio();
+  bool pintada = true;
+  if (progressivo){
+    int passo_anterior = 0;
+    for (int k = 0; k < rayTracing::N_PASSOS_PROGRESSIVOS && pintada; k++){
+      int passo = rayTracing::PASSOS_PROGRESSIVOS[k];
+      pintada = obj_ray_tracing.print_imagem_passada(cena, luz, camera, imagem, passo, passo_anterior);
+      std::cout << "passo " << passo << ": " << (relogio() - inicio) << " segundos" << std::endl;
+      passo_anterior = passo;
+    }
+  }
+  else{
+    pintada = obj_ray_tracing.print_imagem(cena, luz, camera, imagem);
+  }
+  if (!pintada){
+    std::cerr << "sem memoria para pintar a imagem" << std::endl;
+    return 1;
+  }
+  double fim = relogio();
+  std::cout << "time: " << (fim - inicio) << " segundos, " << largura << "x" << altura << ", "
+	    << obj_ray_tracing.threads() << " threads, nucleos " << nucleos_ativos->nome << std::endl;
+  std::cout << "memoria transitoria: pico de " << obj_ray_tracing.pico_memoria_transitoria() << " bytes por arena" << std::endl;
+
+  if (!imagem.salvar_ppm(saida)){
+    std::cerr << "nao foi possivel gravar " << saida << std::endl;
+    return 1;
+  }
+  delete exemplo;
+  return 0;
+}
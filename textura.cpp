@@ -44,8 +44,8 @@ namespace rayTracing{
   int 
   Textura::rand_red(){
     int r;
-    int x = ceil(inicio_range->vx());
-    int y = ceil(final_range->vx());
+    int x = ceil(inicio_range.vx());
+    int y = ceil(final_range.vx());
     if (x != y){	//Para evitar uma excessao de provocada no rand
       r = (rand() % x + y);
     }
@@ -63,8 +63,8 @@ namespace rayTracing{
   int 
   Textura::rand_green(){
     int g;
-    int x = ceil(inicio_range->vy());
-    int y = ceil(final_range->vy());
+    int x = ceil(inicio_range.vy());
+    int y = ceil(final_range.vy());
     if (x != y){	//Para evitar uma excessao de provocada no rand
       g = (rand() % x + y);
     }
@@ -82,8 +82,8 @@ namespace rayTracing{
   int 
   Textura::rand_blue(){
     int b;
-    int x = ceil(inicio_range->vz());
-    int y = ceil(final_range->vz());
+    int x = ceil(inicio_range.vz());
+    int y = ceil(final_range.vz());
     if (x != y){ 	//Para evitar uma excessao de provocada no rand
       b = (rand() % x + y);
     }
@@ -95,40 +95,34 @@ namespace rayTracing{
   //	Metodos privados
   //------------------------------
   /**
-   * \fn Textura::Textura(Vetor* _inicio_range, Vetor* _final_range);
+   * \fn Textura::Textura(const Vetor& _inicio_range, const Vetor& _final_range);
    *
    * \brief Construtor da classe textura.
    *
    * \param _inicio_range - inicio dos limites
    * \param _final_range - final dos limites
    */
-  Textura::Textura(Vetor* _inicio_range, Vetor* _final_range){
-    inicio_range = new Vetor();
-    final_range = new Vetor();
+  Textura::Textura(const Vetor& _inicio_range, const Vetor& _final_range){
     inicio_range = _inicio_range;
     final_range = _final_range;
   }
 		
   /**
-   * \fn Vetor* Textura::map_textura_solida();
+   * \fn Vetor Textura::map_textura_solida();
    *
    * \brief Metodo que mapeia a textura solida.
    *
    * \return Vetor com contribuicao r, g e b.
    */
-  Vetor*
+  Vetor
   Textura::map_textura_solida(){
     //Calculando randomicamente a contribuicao do r, g e b
     double r = rand_red();
     double g = rand_green();
     double b = rand_blue();
 		
-    //criando um vetor que armazenara as contribuicoes do r, g e b
-    Vetor* textura = new Vetor();
-    textura->valores_vetor(r, g, b);
-
-    //retornando o vetor de textura
-    return textura;
+    //retornando o vetor com as contribuicoes do r, g e b
+    return Vetor(r, g, b);
   }
 	
 } //Fim do namespace rayTracing
@@ -43,9 +43,9 @@ namespace rayTracing{
     //------------------------------
   private:
     //Inicio do range
-    Vetor* inicio_range;
+    Vetor inicio_range;
     //Fim do range
-    Vetor* final_range;
+    Vetor final_range;
 		
     //------------------------------
     //	Metodos privados
@@ -82,24 +82,24 @@ namespace rayTracing{
     //------------------------------
   public:
     /**
-     * \fn Textura(Vetor* _inicio_range, Vetor* _final_range);
+     * \fn Textura(const Vetor& _inicio_range, const Vetor& _final_range);
      *
      * \brief Construtor da classe textura.
      *
      * \param _inicio_range - inicio dos limites
      * \param _final_range - final dos limites
      */
-    Textura(Vetor* _inicio_range, Vetor* _final_range);
+    Textura(const Vetor& _inicio_range, const Vetor& _final_range);
 
 		
     /**
-     * \fn Vetor* map_textura_solida();
+     * \fn Vetor map_textura_solida();
      *
      * \brief Metodo que mapeia a textura solida.
      *
      * \return Vetor com contribuicao r, g e b.
      */
-    Vetor* map_textura_solida();
+    Vetor map_textura_solida();
   };
 
 } //Fim do namespace rayTracing
@@ -10,7 +10,7 @@
  * Departamento de Computacao e Automacao Industrial \n
  * petrucior at gmail (dot) com
  *
- * \version 0.0
+ * \version 0.1
  * \date Outubro 2013
  */
 
@@ -31,115 +31,10 @@ namespace rayTracing{
   //------------------------------
   //	Metodos publicos
   //------------------------------
-  /**
-   * \fn Vetor::Vetor();
-   *
-   * \brief Construtor da classe vetor.
-   */
-  Vetor::Vetor(){
-    //Todas as coordenadas estao zeradas
-    x = 0;
-    y = 0;
-    z = 0;
-    pi = 3.141592;
-  }
-	
-  /**
-   * \fn void Vetor::valores_vetor(double _x, double _y, double _z);
-   *
-   * \brief Atualiza os valores do vetor.
-   *
-   * \param _x - valor correspondente a coordenada x
-   * \param _y - valor correspondente a coordenada y
-   * \param _z - valor correspondente a coordenada z			 
-   */
-  void 
-  Vetor::valores_vetor(double _x, double _y, double _z){
-    x = _x;
-    y = _y;
-    z = _z;
-  }
-	
-  /**
-   * \fn double Vetor::vx();
-   *
-   * \brief Encontra o valor da coordenada x.
-   *
-   * \return O valor da coordenada x do vetor.
-   */
-  double 
-  Vetor::vx(){
-    return x;
-  }
-	
-  /**
-   * \fn double Vetor::vy();
-   *
-   * \brief Encontra o valor da coordenada y.
-   *
-   * \return O valor da coordenada y do vetor.
-   */
-  double 
-  Vetor::vy(){
-    return y;
-  }
-	
-  /**
-   * \fn double Vetor::vz();
-   *
-   * \brief Encontra o valor da coordenada z.
-   *
-   * \return O valor da coordenada z do vetor.
-   */
-  double 
-  Vetor::vz(){
-    return z;
-  }
-	
-  /**
-   * \fn void Vetor::vetor_diretor(Vetor& v, Vetor& r);
-   *
-   * \brief Calcula a diferenca entre vetores.
-   */
-  void 
-  Vetor::vetor_diretor(Vetor* v, Vetor* r){
-    x = v->x - r->x;
-    y = v->y - r->y;
-    z = v->z - r->z;
-    return;
-  }
-	
-  /**
-   * \fn double Vetor::norma();
-   *
-   * \brief Calcula a norma ou modulo do vetor.
-   *
-   * \return A norma do vetor.
-   */
-  double 
-  Vetor::norma(){ 
-    double aux = (x*x) + (y*y) + (z*z);
-    double value = sqrt(aux);
-    return value;
-  }
-	
-  /**
-   * \fn double Vetor::produto_escalar(const Vetor& v);
-   *
-   * \brief Calcula o produto escalar entre os dois vetores.
-   *
-   * \param v - vetor que esta realizando o produto escalar.
-   *
-   * \return O valor do produto escalar.
-   */
-  double 
-  Vetor::produto_escalar(Vetor* v){
-    double value = (x * v->x) + (y * v->y) + (z * v->z);
-    return value;
-  }
+  //Os demais metodos da classe sao definidos inline em vetor.hpp.
 	
   /**
-   * \fn double Vetor::angulo(const Vetor& v);
+   * \fn double Vetor::angulo(const Vetor& v) const;
    *
    * \brief Calcula o angulo entre vetores [em radianos], mas dentro do metodo ha uma conversao para graus.
    *
@@ -147,10 +42,11 @@ namespace rayTracing{
    *
    * \return O angulo entre os dois vetores em GRAUS.
    */
-  double Vetor::angulo(Vetor* v){
+  double Vetor::angulo(const Vetor& v) const{
+    const double pi = 3.141592;
     double produtoEscalar = produto_escalar(v);
     double normaA = norma();
-    double normaV = v->norma();
+    double normaV = v.norma();
     double ang_radianos = acos(produtoEscalar/(normaA * normaV));
     /* 360 graus -----> 2*pi
        ang -----------> ang_radianos */
@@ -1,27 +1,30 @@
 /**
  * \file vetor.hpp
  *
- * \brief Este arquivo e um pacote que contem as definicoes de calculos que deverao ser apresentados na integra no arquivo vetor.cpp, que e 
- * responsavel pela definicoes de funcoes da estrutura dos vetores.
+ * \brief Este arquivo e um pacote que contem as definicoes de calculos que deverao ser apresentados na integra no arquivo vetor.cpp, que e
+ * responsavel pela definicoes de funcoes da estrutura dos vetores. As operacoes utilizadas no laco de renderizacao sao definidas inline neste
+ * arquivo para que o vetor possa ser usado por valor sem alocacao dinamica.
  *
- * \author 
+ * \author
  * Petrucio Ricardo Tavares de Medeiros \n
  * Universidade Federal do Rio Grande do Norte \n
  * Departamento de Computacao e Automacao Industrial \n
  * petrucior at gmail (dot) com
  *
- * \version 0.0
+ * \version 0.1
  * \date Outubro 2013
  */
- 
+
 #ifndef _VETOR_HPP
 #define _VETOR_HPP
 
-/** 
+#include <math.h>		//sqrt
+
+/**
  * \defgroup RayTracingNameSpace Namespace rayTracing.
  * @{
  */
- 
+
 /**
  * \namespace rayTracing
  *
@@ -31,7 +34,8 @@ namespace rayTracing{
   /**
    * \class Vetor
    *
-   * \brief Esta classe contem a definicao de vetores que serao utilizados como estrutura para o projeto rayTracing.
+   * \brief Esta classe contem a definicao de vetores que serao utilizados como estrutura para o projeto rayTracing. O vetor e um tipo de
+   * valor (trivialmente copiavel) e deve ser passado por copia ou por referencia constante.
    *
    */
   class Vetor{
@@ -42,8 +46,7 @@ namespace rayTracing{
     double x;	///< Coordenada x
     double y;	///< Coordenada y
     double z;	///< Coordenada z
-			
-    double pi;
+
     //------------------------------
     //	Metodos publicos
     //------------------------------
@@ -54,7 +57,18 @@ namespace rayTracing{
      * \brief Construtor da classe vetor.
      */
     Vetor();
-			
+
+    /**
+     * \fn Vetor(double _x, double _y, double _z);
+     *
+     * \brief Construtor da classe vetor a partir das coordenadas.
+     *
+     * \param _x - valor correspondente a coordenada x
+     * \param _y - valor correspondente a coordenada y
+     * \param _z - valor correspondente a coordenada z
+     */
+    Vetor(double _x, double _y, double _z);
+
     /**
      * \fn void valores_vetor(double _x, double _y, double _z);
      *
@@ -62,81 +76,304 @@ namespace rayTracing{
      *
      * \param _x - valor correspondente a coordenada x
      * \param _y - valor correspondente a coordenada y
-     * \param _z - valor correspondente a coordenada z			 
+     * \param _z - valor correspondente a coordenada z
      */
     void valores_vetor(double _x, double _y, double _z);
-			
+
     /**
-     * \fn double vx();
+     * \fn double vx() const;
      *
      * \brief Encontra o valor da coordenada x.
      *
      * \return O valor da coordenada x do vetor.
      */
-    double vx();
-			
+    double vx() const;
+
     /**
-     * \fn double vy();
+     * \fn double vy() const;
      *
      * \brief Encontra o valor da coordenada y.
      *
      * \return O valor da coordenada y do vetor.
      */
-    double vy();
-			
+    double vy() const;
+
     /**
-     * \fn double vz();
+     * \fn double vz() const;
      *
      * \brief Encontra o valor da coordenada z.
      *
      * \return O valor da coordenada z do vetor.
      */
-    double vz();
-			
+    double vz() const;
+
     /**
-     * \fn void vetor_diretor(Vetor& v, Vetor& r);
+     * \fn void vetor_diretor(const Vetor& v, const Vetor& r);
      *
-     * \brief Calcula o vetor diretor.
+     * \brief Calcula o vetor diretor (v - r).
      */
-    void vetor_diretor(Vetor* v, Vetor* r);
-			
+    void vetor_diretor(const Vetor& v, const Vetor& r);
+
     /**
-     * \fn double norma();
+     * \fn double norma() const;
      *
      * \brief Calcula a norma ou modulo do vetor.
      *
      * \return A norma do vetor.
      */
-    double norma();
-			
+    double norma() const;
+
     /**
-     * \fn double produto_escalar(const Vetor& v);
+     * \fn double norma_quadrado() const;
+     *
+     * \brief Calcula o quadrado da norma do vetor, evitando a raiz quadrada.
+     *
+     * \return O quadrado da norma do vetor.
+     */
+    double norma_quadrado() const;
+
+    /**
+     * \fn double produto_escalar(const Vetor& v) const;
      *
      * \brief Calcula o produto escalar entre os dois vetores.
      *
      * \param v - vetor que esta realizando o produto escalar.
-     * 
+     *
      * \return O valor do produto escalar.
      */
-    double produto_escalar(Vetor* v);
-			
+    double produto_escalar(const Vetor& v) const;
+
+    /**
+     * \fn Vetor produto_vetorial(const Vetor& v) const;
+     *
+     * \brief Calcula o produto vetorial entre os dois vetores.
+     *
+     * \param v - vetor que esta realizando o produto vetorial.
+     *
+     * \return O vetor resultante do produto vetorial.
+     */
+    Vetor produto_vetorial(const Vetor& v) const;
+
     /**
-     * \fn double angulo(const Vetor& v);
+     * \fn Vetor normalizado() const;
+     *
+     * \brief Calcula o vetor unitario com a mesma direcao do vetor.
+     *
+     * \return O vetor normalizado.
+     */
+    Vetor normalizado() const;
+
+    /**
+     * \fn double angulo(const Vetor& v) const;
      *
      * \brief Calcula o angulo entre vetores.
      *
-     * \param v - vetor que se deseja encontrar o angulo. 
+     * \param v - vetor que se deseja encontrar o angulo.
      *
      * \return O angulo entre os dois vetores em GRAUS.
      */
-    double angulo(Vetor* v);
-			
+    double angulo(const Vetor& v) const;
+
+    //Operadores aritmeticos
+    Vetor operator+(const Vetor& v) const;	///< Soma de vetores
+    Vetor operator-(const Vetor& v) const;	///< Diferenca de vetores
+    Vetor operator-() const;			///< Vetor oposto
+    Vetor operator*(double s) const;		///< Produto por escalar
+    Vetor operator/(double s) const;		///< Divisao por escalar
+    Vetor& operator+=(const Vetor& v);		///< Soma acumulada
+    Vetor& operator-=(const Vetor& v);		///< Diferenca acumulada
+    Vetor& operator*=(double s);		///< Produto por escalar acumulado
   };
-	
+
+  /**
+   * \fn Vetor operator*(double s, const Vetor& v);
+   *
+   * \brief Produto de um escalar por um vetor.
+   */
+  Vetor operator*(double s, const Vetor& v);
+
+  //------------------------------
+  //	Definicoes inline
+  //------------------------------
+  /**
+   * \fn Vetor::Vetor();
+   *
+   * \brief Construtor da classe vetor. Todas as coordenadas estao zeradas.
+   */
+  inline
+  Vetor::Vetor() : x(0.0), y(0.0), z(0.0){
+  }
+
+  /**
+   * \fn Vetor::Vetor(double _x, double _y, double _z);
+   *
+   * \brief Construtor da classe vetor a partir das coordenadas.
+   */
+  inline
+  Vetor::Vetor(double _x, double _y, double _z) : x(_x), y(_y), z(_z){
+  }
+
+  /**
+   * \fn void Vetor::valores_vetor(double _x, double _y, double _z);
+   *
+   * \brief Atualiza os valores do vetor.
+   */
+  inline void
+  Vetor::valores_vetor(double _x, double _y, double _z){
+    x = _x;
+    y = _y;
+    z = _z;
+  }
+
+  /**
+   * \fn double Vetor::vx() const;
+   *
+   * \brief Encontra o valor da coordenada x.
+   */
+  inline double
+  Vetor::vx() const{
+    return x;
+  }
+
+  /**
+   * \fn double Vetor::vy() const;
+   *
+   * \brief Encontra o valor da coordenada y.
+   */
+  inline double
+  Vetor::vy() const{
+    return y;
+  }
+
+  /**
+   * \fn double Vetor::vz() const;
+   *
+   * \brief Encontra o valor da coordenada z.
+   */
+  inline double
+  Vetor::vz() const{
+    return z;
+  }
+
+  /**
+   * \fn void Vetor::vetor_diretor(const Vetor& v, const Vetor& r);
+   *
+   * \brief Calcula a diferenca entre vetores.
+   */
+  inline void
+  Vetor::vetor_diretor(const Vetor& v, const Vetor& r){
+    x = v.x - r.x;
+    y = v.y - r.y;
+    z = v.z - r.z;
+  }
+
+  /**
+   * \fn double Vetor::norma() const;
+   *
+   * \brief Calcula a norma ou modulo do vetor.
+   */
+  inline double
+  Vetor::norma() const{
+    return sqrt((x*x) + (y*y) + (z*z));
+  }
+
+  /**
+   * \fn double Vetor::norma_quadrado() const;
+   *
+   * \brief Calcula o quadrado da norma do vetor.
+   */
+  inline double
+  Vetor::norma_quadrado() const{
+    return (x*x) + (y*y) + (z*z);
+  }
+
+  /**
+   * \fn double Vetor::produto_escalar(const Vetor& v) const;
+   *
+   * \brief Calcula o produto escalar entre os dois vetores.
+   */
+  inline double
+  Vetor::produto_escalar(const Vetor& v) const{
+    return (x * v.x) + (y * v.y) + (z * v.z);
+  }
+
+  /**
+   * \fn Vetor Vetor::produto_vetorial(const Vetor& v) const;
+   *
+   * \brief Calcula o produto vetorial entre os dois vetores.
+   */
+  inline Vetor
+  Vetor::produto_vetorial(const Vetor& v) const{
+    return Vetor((y * v.z) - (z * v.y), (z * v.x) - (x * v.z), (x * v.y) - (y * v.x));
+  }
+
+  /**
+   * \fn Vetor Vetor::normalizado() const;
+   *
+   * \brief Calcula o vetor unitario com a mesma direcao do vetor.
+   */
+  inline Vetor
+  Vetor::normalizado() const{
+    double n = norma();
+    return Vetor(x/n, y/n, z/n);
+  }
+
+  inline Vetor
+  Vetor::operator+(const Vetor& v) const{
+    return Vetor(x + v.x, y + v.y, z + v.z);
+  }
+
+  inline Vetor
+  Vetor::operator-(const Vetor& v) const{
+    return Vetor(x - v.x, y - v.y, z - v.z);
+  }
+
+  inline Vetor
+  Vetor::operator-() const{
+    return Vetor(-x, -y, -z);
+  }
+
+  inline Vetor
+  Vetor::operator*(double s) const{
+    return Vetor(x * s, y * s, z * s);
+  }
+
+  inline Vetor
+  Vetor::operator/(double s) const{
+    return Vetor(x / s, y / s, z / s);
+  }
+
+  inline Vetor&
+  Vetor::operator+=(const Vetor& v){
+    x += v.x;
+    y += v.y;
+    z += v.z;
+    return *this;
+  }
+
+  inline Vetor&
+  Vetor::operator-=(const Vetor& v){
+    x -= v.x;
+    y -= v.y;
+    z -= v.z;
+    return *this;
+  }
+
+  inline Vetor&
+  Vetor::operator*=(double s){
+    x *= s;
+    y *= s;
+    z *= s;
+    return *this;
+  }
+
+  inline Vetor
+  operator*(double s, const Vetor& v){
+    return v * s;
+  }
+
 } ////Fim do namespace rayTracing
- 
+
 /** @} */ //Fim do grupo class
 
 #endif
-
-